@@ -0,0 +1,455 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Registered buffers.
+ *
+ * The memory of a buffer is an iobuf of the iobuf pool of the virtual
+ * mount, so writes hand it down the stack, in the iobref of the fop, instead
+ * of copying the data into a new iobuf. Reads take over the iobuf the reply
+ * was received into, when nobody else holds it, instead of copying the data
+ * out of it.
+ *
+ * Between two calls the memory of a buffer is only used by the application.
+ * When an xlator keeps the iobuf of a write (e.g. write-behind, until the
+ * write is flushed), the buffer gets a new iobuf, and the old one is left to
+ * the xlator.
+ */
+
+#include "glfs-internal.h"
+#include "glfs-mem-types.h"
+#include <glusterfs/syncop.h>
+#include "glfs.h"
+#include "gfapi-messages.h"
+
+struct glfs_buf {
+    struct list_head list; /* in fs->buffers */
+    struct glfs *fs;
+
+    struct iobref *iobref;
+    struct iobuf *iobuf; /* the iobuf of @iobref holding @ptr */
+    char *ptr;
+    size_t size;
+};
+
+/* Bytes available from @ptr to the end of the page of @iobuf, 0 if @ptr is
+ * not in it or if the size of the page is unknown. */
+static size_t
+glfs_buf_room(struct iobuf *iobuf, char *ptr)
+{
+    char *base = NULL;
+    size_t page_size = 0;
+
+    /* standard allocations for big sizes are not part of an arena */
+    if (!iobuf->iobuf_arena || !iobuf->iobuf_arena->mem_base)
+        return 0;
+
+    /* page aligned iobufs keep the start of the page in free_ptr */
+    base = iobuf->free_ptr ? iobuf->free_ptr : iobuf->ptr;
+    page_size = iobuf_pagesize(iobuf);
+
+    if ((ptr < base) || (ptr >= base + page_size))
+        return 0;
+
+    return base + page_size - ptr;
+}
+
+/* Whether @iobuf of @iobref is referenced by anybody else than the buffer. */
+static gf_boolean_t
+glfs_buf_shared(struct iobref *iobref, struct iobuf *iobuf)
+{
+    return (GF_ATOMIC_GET(iobref->ref) > 1) || (GF_ATOMIC_GET(iobuf->ref) > 1);
+}
+
+static int
+glfs_buf_attach(struct glfs_buf *buf, struct iobuf_pool *iobuf_pool)
+{
+    struct iobref *iobref = NULL;
+    struct iobuf *iobuf = NULL;
+
+    iobuf = iobuf_get2(iobuf_pool, buf->size);
+    if (!iobuf)
+        return -1;
+
+    iobref = iobref_new();
+    if (!iobref) {
+        iobuf_unref(iobuf);
+        return -1;
+    }
+
+    if (iobref_add(iobref, iobuf)) {
+        iobuf_unref(iobuf);
+        iobref_unref(iobref);
+        return -1;
+    }
+
+    /* the iobref holds the only reference */
+    iobuf_unref(iobuf);
+
+    buf->iobref = iobref;
+    buf->iobuf = iobuf;
+    buf->ptr = iobuf_ptr(iobuf);
+
+    return 0;
+}
+
+/* Gives new memory to a buffer which couldn't get it after a write. */
+static int
+glfs_buf_ready(struct glfs_buf *buf)
+{
+    if (buf->ptr)
+        return 0;
+
+    return glfs_buf_attach(buf, buf->fs->ctx->iobuf_pool);
+}
+
+static void
+glfs_buf_detach(struct glfs_buf *buf)
+{
+    if (buf->iobref)
+        iobref_unref(buf->iobref);
+
+    buf->iobref = NULL;
+    buf->iobuf = NULL;
+    buf->ptr = NULL;
+}
+
+/* Take over the memory of a read reply, if it's not shared with any cache
+ * and has room for the whole buffer. */
+static gf_boolean_t
+glfs_buf_adopt(struct glfs_buf *buf, struct iobref *iobref, char *ptr)
+{
+    struct iobuf *iobuf = NULL;
+    int i = 0;
+
+    if (GF_ATOMIC_GET(iobref->ref) > 1)
+        return _gf_false;
+
+    for (i = 0; i < iobref->allocated; i++) {
+        iobuf = iobref->iobrefs[i];
+        if (iobuf && (glfs_buf_room(iobuf, ptr) >= buf->size))
+            break;
+        iobuf = NULL;
+    }
+
+    if (!iobuf || (GF_ATOMIC_GET(iobuf->ref) > 1))
+        return _gf_false;
+
+    glfs_buf_detach(buf);
+
+    buf->iobref = iobref_ref(iobref);
+    buf->iobuf = iobuf;
+    buf->ptr = ptr;
+
+    return _gf_true;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_buf_alloc, 9.0)
+struct glfs_buf *
+pub_glfs_buf_alloc(struct glfs *fs, size_t size)
+{
+    struct glfs_buf *buf = NULL;
+
+    DECLARE_OLD_THIS;
+    __GLFS_ENTRY_VALIDATE_FS(fs, invalid_fs);
+
+    if (size == 0) {
+        errno = EINVAL;
+        goto out;
+    }
+
+    buf = GF_CALLOC(1, sizeof(*buf), glfs_mt_buf_t);
+    if (!buf) {
+        errno = ENOMEM;
+        goto out;
+    }
+
+    buf->fs = fs;
+    buf->size = size;
+    INIT_LIST_HEAD(&buf->list);
+
+    if (glfs_buf_attach(buf, fs->ctx->iobuf_pool)) {
+        GF_FREE(buf);
+        buf = NULL;
+        errno = ENOMEM;
+        goto out;
+    }
+
+    glfs_lock(fs, _gf_false);
+    {
+        list_add(&buf->list, &fs->buffers);
+    }
+    glfs_unlock(fs);
+
+out:
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return buf;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_buf_free, 9.0)
+void
+pub_glfs_buf_free(struct glfs_buf *buf)
+{
+    if (!buf)
+        return;
+
+    glfs_lock(buf->fs, _gf_false);
+    {
+        list_del_init(&buf->list);
+    }
+    glfs_unlock(buf->fs);
+
+    glfs_buf_detach(buf);
+    GF_FREE(buf);
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_buf_ptr, 9.0)
+void *
+pub_glfs_buf_ptr(struct glfs_buf *buf)
+{
+    void *ptr = NULL;
+
+    if (!buf) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    DECLARE_OLD_THIS;
+    __GLFS_ENTRY_VALIDATE_FS(buf->fs, invalid_fs);
+
+    if (glfs_buf_ready(buf)) {
+        errno = ENOMEM;
+        goto out;
+    }
+
+    ptr = buf->ptr;
+out:
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return ptr;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_buf_pread, 9.0)
+ssize_t
+pub_glfs_buf_pread(struct glfs_fd *glfd, struct glfs_buf *buf, size_t count,
+                   off_t offset, int flags, struct glfs_stat *poststat)
+{
+    xlator_t *subvol = NULL;
+    ssize_t ret = -1;
+    struct iovec *iov = NULL;
+    struct iovec bufvec = {
+        0,
+    };
+    int cnt = 0;
+    struct iobref *iobref = NULL;
+    fd_t *fd = NULL;
+    struct iatt iatt = {
+        0,
+    };
+    dict_t *fop_attr = NULL;
+
+    DECLARE_OLD_THIS;
+    __GLFS_ENTRY_VALIDATE_FD(glfd, invalid_fs);
+
+    GF_REF_GET(glfd);
+
+    if (!buf || (buf->fs != glfd->fs) || (count > buf->size)) {
+        ret = -1;
+        errno = EINVAL;
+        goto out;
+    }
+
+    if (glfs_buf_ready(buf)) {
+        ret = -1;
+        errno = ENOMEM;
+        goto out;
+    }
+
+    subvol = glfs_active_subvol(glfd->fs);
+    if (!subvol) {
+        ret = -1;
+        errno = EIO;
+        goto out;
+    }
+
+    fd = glfs_resolve_fd(glfd->fs, subvol, glfd);
+    if (!fd) {
+        ret = -1;
+        errno = EBADFD;
+        goto out;
+    }
+
+    ret = get_fop_attr_thrd_key(&fop_attr);
+    if (ret)
+        gf_msg_debug("gfapi", 0, "Getting leaseid from thread failed");
+
+    ret = syncop_readv(subvol, fd, count, offset, flags, &iov, &cnt, &iobref,
+                       &iatt, fop_attr, NULL);
+    DECODE_SYNCOP_ERR(ret);
+
+    if (ret >= 0 && poststat)
+        glfs_iatt_to_statx(glfd->fs, &iatt, poststat);
+
+    if (ret <= 0)
+        goto out;
+
+    if ((cnt != 1) || !iobref ||
+        !glfs_buf_adopt(buf, iobref, iov[0].iov_base)) {
+        bufvec.iov_base = buf->ptr;
+        bufvec.iov_len = count;
+        ret = iov_copy(&bufvec, 1, iov, cnt);
+    }
+
+    glfd->offset = (offset + ret);
+out:
+    if (iov)
+        GF_FREE(iov);
+    if (iobref)
+        iobref_unref(iobref);
+
+    if (fd)
+        fd_unref(fd);
+    if (glfd)
+        GF_REF_PUT(glfd);
+    if (fop_attr)
+        dict_unref(fop_attr);
+
+    glfs_subvol_done(glfd->fs, subvol);
+
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return ret;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_buf_pwrite, 9.0)
+ssize_t
+pub_glfs_buf_pwrite(struct glfs_fd *glfd, struct glfs_buf *buf, size_t count,
+                    off_t offset, int flags, struct glfs_stat *prestat,
+                    struct glfs_stat *poststat)
+{
+    xlator_t *subvol = NULL;
+    ssize_t ret = -1;
+    struct iovec iov = {
+        0,
+    };
+    fd_t *fd = NULL;
+    struct iatt preiatt =
+                    {
+                        0,
+                    },
+                postiatt = {
+                    0,
+                };
+    dict_t *fop_attr = NULL;
+
+    DECLARE_OLD_THIS;
+    __GLFS_ENTRY_VALIDATE_FD(glfd, invalid_fs);
+
+    GF_REF_GET(glfd);
+
+    if (!buf || (buf->fs != glfd->fs) || (count > buf->size)) {
+        ret = -1;
+        errno = EINVAL;
+        goto out;
+    }
+
+    if (glfs_buf_ready(buf)) {
+        ret = -1;
+        errno = ENOMEM;
+        goto out;
+    }
+
+    subvol = glfs_active_subvol(glfd->fs);
+    if (!subvol) {
+        ret = -1;
+        errno = EIO;
+        goto out;
+    }
+
+    fd = glfs_resolve_fd(glfd->fs, subvol, glfd);
+    if (!fd) {
+        ret = -1;
+        errno = EBADFD;
+        goto out;
+    }
+
+    iov.iov_base = buf->ptr;
+    iov.iov_len = count;
+
+    ret = get_fop_attr_thrd_key(&fop_attr);
+    if (ret)
+        gf_msg_debug("gfapi", 0, "Getting leaseid from thread failed");
+
+    ret = syncop_writev(subvol, fd, &iov, 1, offset, buf->iobref, flags,
+                        &preiatt, &postiatt, fop_attr, NULL);
+    DECODE_SYNCOP_ERR(ret);
+
+    /* The data may still be cached by an xlator, which must not see the
+     * application reusing the buffer. Leave the iobuf to it. Without new
+     * memory the buffer can't be used, so the caller is told, even though
+     * the data was written. */
+    if (glfs_buf_shared(buf->iobref, buf->iobuf)) {
+        glfs_buf_detach(buf);
+        if (glfs_buf_attach(buf, subvol->ctx->iobuf_pool)) {
+            gf_smsg("gfapi", GF_LOG_WARNING, ENOMEM, API_MSG_BUF_REPLACE_FAILED,
+                    "size=%zu", buf->size, NULL);
+            if (ret >= 0) {
+                ret = -1;
+                errno = ENOMEM;
+            }
+        }
+    }
+
+    if (ret >= 0) {
+        if (prestat)
+            glfs_iatt_to_statx(glfd->fs, &preiatt, prestat);
+        if (poststat)
+            glfs_iatt_to_statx(glfd->fs, &postiatt, poststat);
+    }
+
+    if (ret <= 0)
+        goto out;
+
+    glfd->offset = (offset + ret);
+out:
+    if (fd)
+        fd_unref(fd);
+    if (glfd)
+        GF_REF_PUT(glfd);
+    if (fop_attr)
+        dict_unref(fop_attr);
+
+    glfs_subvol_done(glfd->fs, subvol);
+
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return ret;
+}
+
+/* Releases the buffers the application didn't free, called from glfs_fini()
+ * before the iobuf pool is destroyed. */
+void
+glfs_buf_release_all(struct glfs *fs)
+{
+    struct glfs_buf *buf = NULL;
+    struct glfs_buf *tmp = NULL;
+
+    list_for_each_entry_safe(buf, tmp, &fs->buffers, list)
+    {
+        list_del_init(&buf->list);
+        glfs_buf_detach(buf);
+        GF_FREE(buf);
+    }
+}
@@ -224,6 +224,8 @@ struct glfs {
     void *up_data;          /* Opaque data provided by application
                              * during upcall registration */
     struct list_head waitq; /* waiting synctasks */
+
+    struct list_head buffers; /* registered buffers, glfs_buf_alloc() */
 };
 
 /* This enum is used to maintain the state of glfd. In case of async fops
@@ -568,6 +570,9 @@ glfs_loc_touchup(loc_t *loc) GFAPI_PRIVATE(glfs_loc_touchup, 3.4.0);
 void
 glfs_iatt_to_stat(struct glfs *fs, struct iatt *iatt, struct stat *stat);
 void
+glfs_iatt_to_statx(struct glfs *fs, const struct iatt *iatt,
+                   struct glfs_stat *statx);
+void
 glfs_iatt_from_stat(struct stat *stat, int valid, struct iatt *iatt,
                     int *gvalid);
 int
@@ -716,6 +721,9 @@ get_fop_attr_thrd_key(dict_t **fop_attr);
 void
 unset_fop_attr(dict_t **fop_attr);
 
+void
+glfs_buf_release_all(struct glfs *fs);
+
 /*
   SYNOPSIS
   glfs_statx: Fetch extended file attributes for the given path.
@@ -30,6 +30,8 @@ enum glfs_mem_types_ {
     glfs_mt_upcall_inode_t,
     glfs_mt_realpath_t,
     glfs_mt_xreaddirp_stat_t,
+    glfs_mt_ring_t,
+    glfs_mt_buf_t,
     glfs_mt_end
 };
 #endif
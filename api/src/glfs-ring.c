@@ -0,0 +1,478 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Batched asynchronous IO.
+ *
+ * A ring has a fixed number of request slots, allocated when it's created.
+ * glfs_ring_submit() winds a whole batch of requests with a single pass over
+ * the ring lock and the active subvolume, and each completion just stores
+ * the result in the completion queue of the ring. The application collects
+ * them with glfs_ring_reap(), from its own thread, so there are no callbacks
+ * run on the event threads and no per-request allocations besides the
+ * frames, which come from the mem-pools.
+ *
+ * A slot is used from submission until its completion is reaped, so the
+ * completion queue never overflows.
+ */
+
+#include "glfs-internal.h"
+#include "glfs-mem-types.h"
+#include <glusterfs/syncop.h>
+#include <glusterfs/timespec.h>
+#include "glfs.h"
+
+struct glfs_ring_req {
+    struct glfs_ring *ring;
+    struct glfs_ring_req *next;
+    struct glfs_fd *glfd;
+    fd_t *fd;
+    xlator_t *subvol;
+    struct iovec iov;
+    struct glfs_ring_sqe sqe;
+};
+
+struct glfs_ring {
+    struct glfs *fs;
+
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    unsigned int entries;
+    unsigned int pending; /* submitted and not reaped yet */
+    unsigned int waiters;
+
+    struct glfs_ring_req *reqs;
+    struct glfs_ring_req *free_reqs;
+
+    /* completions not reaped yet, from cq_head */
+    struct glfs_ring_cqe *cq;
+    unsigned int cq_head;
+    unsigned int cq_count;
+};
+
+static void
+glfs_ring_complete(struct glfs_ring_req *req, ssize_t res)
+{
+    struct glfs_ring *ring = req->ring;
+    struct glfs_ring_cqe *cqe = NULL;
+
+    if (req->fd)
+        fd_unref(req->fd);
+    if (req->glfd)
+        GF_REF_PUT(req->glfd);
+    if (req->subvol)
+        glfs_subvol_done(ring->fs, req->subvol);
+
+    pthread_mutex_lock(&ring->lock);
+    {
+        cqe = &ring->cq[(ring->cq_head + ring->cq_count) % ring->entries];
+        cqe->user_data = req->sqe.user_data;
+        cqe->res = res;
+        ring->cq_count++;
+
+        req->next = ring->free_reqs;
+        ring->free_reqs = req;
+
+        if (ring->waiters)
+            pthread_cond_broadcast(&ring->cond);
+    }
+    pthread_mutex_unlock(&ring->lock);
+}
+
+static int
+glfs_ring_fop_done(call_frame_t *frame, int32_t op_ret, int32_t op_errno,
+                   ssize_t res)
+{
+    struct glfs_ring_req *req = frame->local;
+
+    frame->local = NULL;
+    STACK_DESTROY(frame->root);
+
+    glfs_ring_complete(req, (op_ret < 0) ? -op_errno : res);
+
+    return 0;
+}
+
+static int
+glfs_ring_readv_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iovec *iovec,
+                    int32_t count, struct iatt *stbuf, struct iobref *iobref,
+                    dict_t *xdata)
+{
+    struct glfs_ring_req *req = frame->local;
+    ssize_t res = 0;
+
+    if (op_ret > 0) {
+        if (!iovec) {
+            op_ret = -1;
+            op_errno = EINVAL;
+        } else {
+            res = iov_copy(&req->iov, 1, iovec, count);
+        }
+    }
+
+    return glfs_ring_fop_done(frame, op_ret, op_errno, res);
+}
+
+static int
+glfs_ring_writev_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                     int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                     struct iatt *postbuf, dict_t *xdata)
+{
+    return glfs_ring_fop_done(frame, op_ret, op_errno, op_ret);
+}
+
+static int
+glfs_ring_fstat_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iatt *buf,
+                    dict_t *xdata)
+{
+    struct glfs_ring_req *req = frame->local;
+
+    if ((op_ret == 0) && buf)
+        glfs_iatt_to_stat(req->ring->fs, buf, req->sqe.buf);
+
+    return glfs_ring_fop_done(frame, op_ret, op_errno, 0);
+}
+
+static int
+glfs_ring_fsync_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iatt *prebuf,
+                    struct iatt *postbuf, dict_t *xdata)
+{
+    return glfs_ring_fop_done(frame, op_ret, op_errno, 0);
+}
+
+/* Winds the request, or returns an errno if it couldn't be started. */
+static int
+glfs_ring_wind(struct glfs_ring_req *req, dict_t *fop_attr)
+{
+    struct glfs_ring_sqe *sqe = &req->sqe;
+    struct glfs_fd *glfd = sqe->fd;
+    struct iobref *iobref = NULL;
+    struct iobuf *iobuf = NULL;
+    call_frame_t *frame = NULL;
+    xlator_t *subvol = req->subvol;
+    int ret = 0;
+
+    if (!glfd || (glfd->fs != req->ring->fs))
+        return EINVAL;
+
+    if (!glfd->fd || !glfd->fd->inode || (glfd->state != GLFD_OPEN))
+        return EBADF;
+
+    switch (sqe->opcode) {
+        case GLFS_RING_OP_PREAD:
+        case GLFS_RING_OP_PWRITE:
+            if (!sqe->buf && sqe->count)
+                return EINVAL;
+            break;
+        case GLFS_RING_OP_FSTAT:
+            if (!sqe->buf)
+                return EINVAL;
+            break;
+        case GLFS_RING_OP_FSYNC:
+        case GLFS_RING_OP_FDATASYNC:
+            break;
+        default:
+            return EINVAL;
+    }
+
+    /* keep the glfd until the request completes */
+    GF_REF_GET(glfd);
+    req->glfd = glfd;
+
+    req->fd = glfs_resolve_fd(req->ring->fs, subvol, glfd);
+    if (!req->fd)
+        return EBADFD;
+
+    frame = syncop_create_frame(THIS);
+    if (!frame)
+        return ENOMEM;
+    frame->local = req;
+
+    req->iov.iov_base = sqe->buf;
+    req->iov.iov_len = sqe->count;
+
+    switch (sqe->opcode) {
+        case GLFS_RING_OP_PREAD:
+            STACK_WIND(frame, glfs_ring_readv_cbk, subvol, subvol->fops->readv,
+                       req->fd, sqe->count, sqe->offset, sqe->flags,
+                       fop_attr);
+            break;
+
+        case GLFS_RING_OP_PWRITE:
+            /* the data is copied, as write-behind may complete the write
+             * before it's sent */
+            ret = iobuf_copy(subvol->ctx->iobuf_pool, &req->iov, 1, &iobref,
+                             &iobuf, &req->iov);
+            if (ret) {
+                frame->local = NULL;
+                STACK_DESTROY(frame->root);
+                return ENOMEM;
+            }
+
+            STACK_WIND(frame, glfs_ring_writev_cbk, subvol,
+                       subvol->fops->writev, req->fd, &req->iov, 1,
+                       sqe->offset, sqe->flags, iobref, fop_attr);
+
+            iobuf_unref(iobuf);
+            iobref_unref(iobref);
+            break;
+
+        case GLFS_RING_OP_FSTAT:
+            STACK_WIND(frame, glfs_ring_fstat_cbk, subvol, subvol->fops->fstat,
+                       req->fd, NULL);
+            break;
+
+        case GLFS_RING_OP_FSYNC:
+        case GLFS_RING_OP_FDATASYNC:
+            STACK_WIND(frame, glfs_ring_fsync_cbk, subvol, subvol->fops->fsync,
+                       req->fd, (sqe->opcode == GLFS_RING_OP_FDATASYNC),
+                       NULL);
+            break;
+    }
+
+    return 0;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_ring_new, 9.0)
+struct glfs_ring *
+pub_glfs_ring_new(struct glfs *fs, unsigned int entries)
+{
+    struct glfs_ring *ring = NULL;
+    unsigned int i = 0;
+
+    DECLARE_OLD_THIS;
+    __GLFS_ENTRY_VALIDATE_FS(fs, invalid_fs);
+
+    if ((entries == 0) || (entries > GLFS_RING_MAX_ENTRIES)) {
+        errno = EINVAL;
+        goto out;
+    }
+
+    ring = GF_CALLOC(1, sizeof(*ring), glfs_mt_ring_t);
+    if (!ring) {
+        errno = ENOMEM;
+        goto out;
+    }
+
+    ring->reqs = GF_CALLOC(entries, sizeof(*ring->reqs), glfs_mt_ring_t);
+    ring->cq = GF_CALLOC(entries, sizeof(*ring->cq), glfs_mt_ring_t);
+    if (!ring->reqs || !ring->cq) {
+        errno = ENOMEM;
+        goto err;
+    }
+
+    if (pthread_mutex_init(&ring->lock, NULL) != 0) {
+        errno = ENOMEM;
+        goto err;
+    }
+    if (pthread_cond_init(&ring->cond, NULL) != 0) {
+        pthread_mutex_destroy(&ring->lock);
+        errno = ENOMEM;
+        goto err;
+    }
+
+    ring->fs = fs;
+    ring->entries = entries;
+    for (i = 0; i < entries; i++) {
+        ring->reqs[i].ring = ring;
+        ring->reqs[i].next = ring->free_reqs;
+        ring->free_reqs = &ring->reqs[i];
+    }
+
+    goto out;
+
+err:
+    GF_FREE(ring->reqs);
+    GF_FREE(ring->cq);
+    GF_FREE(ring);
+    ring = NULL;
+out:
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return ring;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_ring_submit, 9.0)
+int
+pub_glfs_ring_submit(struct glfs_ring *ring, const struct glfs_ring_sqe *sqes,
+                     unsigned int count)
+{
+    struct glfs_ring_req *batch = NULL;
+    struct glfs_ring_req *req = NULL;
+    xlator_t *subvol = NULL;
+    dict_t *fop_attr = NULL;
+    struct glfs *fs = NULL;
+    unsigned int n = 0;
+    unsigned int i = 0;
+    int ret = -1;
+
+    DECLARE_OLD_THIS;
+
+    if (!ring || (!sqes && count)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fs = ring->fs;
+    __GLFS_ENTRY_VALIDATE_FS(fs, invalid_fs);
+
+    /* take the slots of the whole batch at once */
+    pthread_mutex_lock(&ring->lock);
+    {
+        n = min(count, ring->entries - ring->pending);
+        for (i = 0; i < n; i++) {
+            req = ring->free_reqs;
+            ring->free_reqs = req->next;
+            req->next = batch;
+            batch = req;
+        }
+        ring->pending += n;
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    if (n == 0) {
+        errno = count ? EAGAIN : 0;
+        ret = count ? -1 : 0;
+        goto out;
+    }
+
+    /* One reference on the subvolume for each request of the batch, each
+     * of them is released when the request completes. */
+    subvol = glfs_active_subvol(fs);
+    if (subvol && (n > 1)) {
+        glfs_lock(fs, _gf_false);
+        {
+            subvol->winds += n - 1;
+        }
+        glfs_unlock(fs);
+    }
+
+    if (get_fop_attr_thrd_key(&fop_attr))
+        gf_msg_debug("gfapi", 0, "Getting leaseid from thread failed");
+
+    for (i = 0; i < n; i++) {
+        req = batch;
+        batch = req->next;
+
+        req->next = NULL;
+        req->sqe = sqes[i];
+        req->glfd = NULL;
+        req->fd = NULL;
+        req->subvol = subvol;
+
+        ret = subvol ? glfs_ring_wind(req, fop_attr) : EIO;
+        if (ret)
+            glfs_ring_complete(req, -ret);
+    }
+
+    if (fop_attr)
+        dict_unref(fop_attr);
+
+    ret = n;
+out:
+    __GLFS_EXIT_FS;
+
+invalid_fs:
+    return ret;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_ring_reap, 9.0)
+int
+pub_glfs_ring_reap(struct glfs_ring *ring, struct glfs_ring_cqe *cqes,
+                   unsigned int count, unsigned int wait_nr, int timeout_ms)
+{
+    struct timespec deadline = {
+        0,
+    };
+    unsigned int n = 0;
+    unsigned int i = 0;
+    int ret = 0;
+
+    if (!ring || (!cqes && count)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (wait_nr > count)
+        wait_nr = count;
+
+    if (timeout_ms > 0) {
+        timespec_now_realtime(&deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (timeout_ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    {
+        /* don't wait for more than what is in flight */
+        while ((ring->cq_count < wait_nr) &&
+               (ring->cq_count < ring->pending) && (timeout_ms != 0)) {
+            ring->waiters++;
+            if (timeout_ms < 0)
+                ret = pthread_cond_wait(&ring->cond, &ring->lock);
+            else
+                ret = pthread_cond_timedwait(&ring->cond, &ring->lock,
+                                             &deadline);
+            ring->waiters--;
+
+            if (ret == ETIMEDOUT)
+                break;
+        }
+
+        n = min(count, ring->cq_count);
+        for (i = 0; i < n; i++)
+            cqes[i] = ring->cq[(ring->cq_head + i) % ring->entries];
+
+        ring->cq_head = (ring->cq_head + n) % ring->entries;
+        ring->cq_count -= n;
+        ring->pending -= n;
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    return n;
+}
+
+GFAPI_SYMVER_PUBLIC_DEFAULT(glfs_ring_free, 9.0)
+int
+pub_glfs_ring_free(struct glfs_ring *ring)
+{
+    if (!ring) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* the requests in flight still point to the ring */
+    pthread_mutex_lock(&ring->lock);
+    {
+        while (ring->cq_count < ring->pending) {
+            ring->waiters++;
+            pthread_cond_wait(&ring->cond, &ring->lock);
+            ring->waiters--;
+        }
+    }
+    pthread_mutex_unlock(&ring->lock);
+
+    pthread_cond_destroy(&ring->cond);
+    pthread_mutex_destroy(&ring->lock);
+    GF_FREE(ring->reqs);
+    GF_FREE(ring->cq);
+    GF_FREE(ring);
+
+    return 0;
+}
@@ -736,6 +736,7 @@ glfs_new_fs(const char *volname)
     INIT_LIST_HEAD(&fs->openfds);
     INIT_LIST_HEAD(&fs->upcall_list);
     INIT_LIST_HEAD(&fs->waitq);
+    INIT_LIST_HEAD(&fs->buffers);
 
     PTHREAD_MUTEX_INIT(&fs->mutex, NULL, fs->pthread_flags, GLFS_INIT_MUTEX,
                        err);
@@ -1371,6 +1372,9 @@ pub_glfs_fini(struct glfs *fs)
             ret = -1;
     }
 
+    /* the memory of the buffers comes from the iobuf pool */
+    glfs_buf_release_all(fs);
+
     /* Avoid dispatching events to mgmt after freed,
      * unreference mgmt after the event_dispatch_destroy */
     if (ctx->mgmt) {
@@ -1481,5 +1481,196 @@ int
 glfs_set_statedump_path(struct glfs *fs, const char *path) __THROW
     GFAPI_PUBLIC(glfs_set_statedump_path, 7.0);
 
+/*
+  SYNOPSIS
+
+  glfs_ring_new: Create a ring for batched asynchronous IO.
+  glfs_ring_submit: Submit a batch of IO requests.
+  glfs_ring_reap: Collect the completions of the submitted requests.
+  glfs_ring_free: Wait for the requests in flight and release the ring.
+
+  DESCRIPTION
+
+  A ring is an alternative to the glfs_*_async() calls for applications
+  that issue many small requests. A batch of requests is submitted with a
+  single call, and the results are not delivered through callbacks run on
+  the event threads: they are queued in the ring until the application
+  collects them with glfs_ring_reap(), from its own threads, either polling
+  or waiting for them.
+
+  Every request is described by a struct glfs_ring_sqe:
+
+  @opcode: GLFS_RING_OP_PREAD, GLFS_RING_OP_PWRITE, GLFS_RING_OP_FSTAT,
+           GLFS_RING_OP_FSYNC or GLFS_RING_OP_FDATASYNC.
+
+  @flags: Flags of the read or the write, as in glfs_pread()/glfs_pwrite().
+
+  @fd: The fd, which must have been opened on the same virtual mount as
+       the ring.
+
+  @buf, @count, @offset: For reads and writes, the buffer, its size and the
+       file offset. For GLFS_RING_OP_FSTAT, @buf points to a struct stat.
+       Reads and fstat fill the buffer before the completion is queued. The
+       data of writes is copied when they are submitted.
+
+  @user_data: An opaque value returned in the completion of the request.
+
+  Requests may complete in any order. Every completion, struct
+  glfs_ring_cqe, carries the @user_data of the request and its result in
+  @res: the number of bytes read or written, 0 for the other operations, or
+  a negative errno on failure. Requests which can't be started, e.g. because
+  the fd is closed or invalid, also complete with an error.
+
+  A ring has a fixed number of @entries. A request uses one of them from its
+  submission until its completion is reaped, so at most @entries requests
+  can be in flight or waiting to be reaped.
+
+  glfs_ring_reap() stores up to @count completions in @cqes. It waits until
+  at least @wait_nr completions are available, or until @timeout_ms
+  milliseconds have passed. It never waits for more completions than
+  requests are in flight. A @timeout_ms of 0 doesn't wait at all, and a
+  negative one waits without limit.
+
+  A ring may be used from several threads. It must be freed before the
+  virtual mount is released with glfs_fini().
+
+  RETURN VALUES
+
+  glfs_ring_new: The ring, or NULL on failure with @errno set.
+
+  glfs_ring_submit: The number of requests submitted, which is less than
+  @count if the ring doesn't have enough free entries. -1 with @errno set to
+  EAGAIN if no entry is free.
+
+  glfs_ring_reap: The number of completions stored in @cqes.
+
+  glfs_ring_free: 0 on success.
+
+  All of them return -1 with @errno set to EINVAL when called with invalid
+  arguments.
+
+ */
+
+#define GLFS_RING_MAX_ENTRIES 65536
+
+enum glfs_ring_op {
+    GLFS_RING_OP_PREAD = 1,
+    GLFS_RING_OP_PWRITE,
+    GLFS_RING_OP_FSTAT,
+    GLFS_RING_OP_FSYNC,
+    GLFS_RING_OP_FDATASYNC,
+};
+
+struct glfs_ring_sqe {
+    int opcode;
+    int flags;
+    glfs_fd_t *fd;
+    void *buf;
+    size_t count;
+    off_t offset;
+    uint64_t user_data;
+};
+
+struct glfs_ring_cqe {
+    uint64_t user_data;
+    ssize_t res;
+};
+
+struct glfs_ring;
+typedef struct glfs_ring glfs_ring_t;
+
+glfs_ring_t *
+glfs_ring_new(glfs_t *fs, unsigned int entries) __THROW
+    GFAPI_PUBLIC(glfs_ring_new, 9.0);
+
+int
+glfs_ring_submit(glfs_ring_t *ring, const struct glfs_ring_sqe *sqes,
+                 unsigned int count) __THROW
+    GFAPI_PUBLIC(glfs_ring_submit, 9.0);
+
+int
+glfs_ring_reap(glfs_ring_t *ring, struct glfs_ring_cqe *cqes,
+               unsigned int count, unsigned int wait_nr,
+               int timeout_ms) __THROW GFAPI_PUBLIC(glfs_ring_reap, 9.0);
+
+int
+glfs_ring_free(glfs_ring_t *ring) __THROW GFAPI_PUBLIC(glfs_ring_free, 9.0);
+
+/*
+  SYNOPSIS
+
+  glfs_buf_alloc: Allocate a buffer registered with the virtual mount.
+  glfs_buf_free: Release a registered buffer.
+  glfs_buf_ptr: Get the memory of a registered buffer.
+  glfs_buf_pread: Read into a registered buffer.
+  glfs_buf_pwrite: Write from a registered buffer.
+
+  DESCRIPTION
+
+  glfs_pread()/glfs_pwrite() copy the data between the application buffer
+  and the buffers used by the IO stack. Registered buffers avoid these
+  copies: their memory is allocated by libgfapi and is passed to the stack
+  as is, so large reads and writes don't pay for a memcpy() each.
+
+  glfs_buf_alloc() allocates a buffer of @size bytes. glfs_buf_ptr() returns
+  the address of its memory, which may change after every read or write
+  through the buffer, and must be fetched again before accessing it:
+
+  - glfs_buf_pread() may replace the memory of @buf by the one the data was
+    received into. The data read is at the start of the memory returned by
+    glfs_buf_ptr(), and the whole @size bytes may be used.
+
+  - glfs_buf_pwrite() writes the first @count bytes of the buffer. When the
+    data is kept by the stack after the write returns (e.g. by
+    write-behind), the buffer gets new memory, and its content is undefined.
+
+  Between calls, the memory of a buffer is only used by the application. A
+  buffer must not be used by several calls at the same time. @flags,
+  @prestat and @poststat are the same as for glfs_pread()/glfs_pwrite(),
+  and the offset of @fd is updated the same way.
+
+  Buffers must be used with fds of the virtual mount they were allocated
+  for. Buffers still allocated when glfs_fini() is called are released by
+  it.
+
+  RETURN VALUES
+
+  glfs_buf_alloc: The buffer, or NULL on failure with @errno set.
+
+  glfs_buf_ptr: The memory of the buffer, or NULL with @errno set to ENOMEM
+  if it couldn't be replaced after a write. The next calls on the buffer try
+  to replace it again.
+
+  glfs_buf_pread, glfs_buf_pwrite: The number of bytes read or written, or
+  -1 with @errno set on failure. EINVAL if @count is larger than the buffer.
+  ENOMEM from glfs_buf_pwrite() if the data was written but the buffer
+  couldn't get new memory.
+
+ */
+
+struct glfs_buf;
+typedef struct glfs_buf glfs_buf_t;
+
+glfs_buf_t *
+glfs_buf_alloc(glfs_t *fs, size_t size) __THROW
+    GFAPI_PUBLIC(glfs_buf_alloc, 9.0);
+
+void
+glfs_buf_free(glfs_buf_t *buf) __THROW GFAPI_PUBLIC(glfs_buf_free, 9.0);
+
+void *
+glfs_buf_ptr(glfs_buf_t *buf) __THROW GFAPI_PUBLIC(glfs_buf_ptr, 9.0);
+
+ssize_t
+glfs_buf_pread(glfs_fd_t *fd, glfs_buf_t *buf, size_t count, off_t offset,
+               int flags, struct glfs_stat *poststat) __THROW
+    GFAPI_PUBLIC(glfs_buf_pread, 9.0);
+
+ssize_t
+glfs_buf_pwrite(glfs_fd_t *fd, glfs_buf_t *buf, size_t count, off_t offset,
+                int flags, struct glfs_stat *prestat,
+                struct glfs_stat *poststat) __THROW
+    GFAPI_PUBLIC(glfs_buf_pwrite, 9.0);
+
 __END_DECLS
 #endif /* !_GLFS_H */
@@ -5587,12 +5587,14 @@ cli_cmd_bitrot_parse(const char **words, int wordcount, dict_t **options)
     char *volname = NULL;
     static char *opwords[] = {"enable",          "disable", "scrub-throttle",
                               "scrub-frequency", "scrub",   "signing-time",
-                              "signer-threads",  NULL};
+                              "signer-threads",  "signature-type",
+                              NULL};
     static char *scrub_throt_values[] = {"lazy", "normal", "aggressive", NULL};
     static char *scrub_freq_values[] = {
         "hourly", "daily", "weekly", "biweekly", "monthly", "minute", NULL};
     static char *scrub_values[] = {"pause", "resume", "status", "ondemand",
                                    NULL};
+    static char *signature_type_values[] = {"sha256", "xxh64", NULL};
     dict_t *dict = NULL;
     gf_bitrot_type type = GF_BITROT_OPTION_TYPE_NONE;
     int32_t expiry_time = 0;
@@ -5802,6 +5804,27 @@ cli_cmd_bitrot_parse(const char **words, int wordcount, dict_t **options)
             }
             goto set_type;
         }
+    } else if (!strcmp(words[3], "signature-type")) {
+        if (!words[4]) {
+            cli_err("Missing signature-type value for bitrot option");
+            ret = -1;
+            goto out;
+        } else {
+            w = str_getunamb(words[4], signature_type_values);
+            if (!w) {
+                cli_err("Invalid signature-type option for bitrot");
+                ret = -1;
+                goto out;
+            }
+
+            type = GF_BITROT_OPTION_TYPE_SIGNATURE_TYPE;
+            ret = dict_set_str(dict, "signature-type-value", w);
+            if (ret) {
+                cli_out("Failed to set dict for bitrot");
+                goto out;
+            }
+            goto set_type;
+        }
     } else {
         cli_err(
             "Invalid option %s for bitrot. Please enter valid "
@@ -2973,6 +2973,10 @@ struct cli_cmd bitrot_cmds[] = {
      "Number of signing process threads. Usually set to number of available "
      "cores"},
 
+    {"volume bitrot <VOLNAME> signature-type {sha256|xxh64}",
+     NULL, /*cli_cmd_bitrot_cbk,*/
+     "Hash used to sign objects of volume <VOLNAME>"},
+
     {"volume bitrot <VOLNAME> scrub-throttle {lazy|normal|aggressive}",
      NULL, /*cli_cmd_bitrot_cbk,*/
      "Set the speed of the scrubber for volume <VOLNAME>"},
@@ -2990,6 +2994,7 @@ struct cli_cmd bitrot_cmds[] = {
     {"volume bitrot <VOLNAME> {enable|disable}\n"
      "volume bitrot <VOLNAME> signing-time <time-in-secs>\n"
      "volume bitrot <VOLNAME> signer-threads <count>\n"
+     "volume bitrot <VOLNAME> signature-type {sha256|xxh64}\n"
      "volume bitrot <volname> scrub-throttle {lazy|normal|aggressive}\n"
      "volume bitrot <volname> scrub-frequency {hourly|daily|weekly|biweekly"
      "|monthly}\n"
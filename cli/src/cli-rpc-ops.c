@@ -5391,6 +5391,35 @@ cmd_profile_volume_brick_out(dict_t *dict, int count, int interval)
         if (ret) {
             gf_log("cli", GF_LOG_DEBUG, "failed to get %s from dict", key);
         }
+
+        /* bricks running older versions don't send percentiles */
+        snprintf(key, sizeof(key), "%d-%d-%d-p50latency", count, interval, i);
+        ret = dict_get_double(dict, key, &profile_info[i].p50_latency);
+        if (!ret) {
+            profile_info[i].has_percentiles = _gf_true;
+
+            snprintf(key, sizeof(key), "%d-%d-%d-p90latency", count, interval,
+                     i);
+            ret = dict_get_double(dict, key, &profile_info[i].p90_latency);
+            if (ret) {
+                gf_log("cli", GF_LOG_DEBUG, "failed to get %s from dict",
+                       key);
+            }
+            snprintf(key, sizeof(key), "%d-%d-%d-p99latency", count, interval,
+                     i);
+            ret = dict_get_double(dict, key, &profile_info[i].p99_latency);
+            if (ret) {
+                gf_log("cli", GF_LOG_DEBUG, "failed to get %s from dict",
+                       key);
+            }
+            snprintf(key, sizeof(key), "%d-%d-%d-p999latency", count, interval,
+                     i);
+            ret = dict_get_double(dict, key, &profile_info[i].p999_latency);
+            if (ret) {
+                gf_log("cli", GF_LOG_DEBUG, "failed to get %s from dict",
+                       key);
+            }
+        }
         profile_info[i].fop_name = (char *)gf_fop_list[i];
 
         total_percentage_latency += (profile_info[i].fop_hits *
@@ -5477,13 +5506,30 @@ cmd_profile_volume_brick_out(dict_t *dict, int count, int interval)
         if (profile_info[i].fop_hits == 0)
             continue;
         if (is_header_printed == 0) {
-            cli_out("%10s %13s %13s %13s %14s %11s", "%-latency", "Avg-latency",
-                    "Min-Latency", "Max-Latency", "No. of calls", "Fop");
-            cli_out("%10s %13s %13s %13s %14s %11s", "---------", "-----------",
-                    "-----------", "-----------", "------------", "----");
+            /* percentiles go after the fop name, so that the position of
+             * the other columns doesn't change */
+            cli_out("%10s %13s %13s %13s %14s %11s %13s %13s %13s %13s",
+                    "%-latency", "Avg-latency", "Min-Latency", "Max-Latency",
+                    "No. of calls", "Fop", "P50-Latency", "P90-Latency",
+                    "P99-Latency", "P99.9-Latency");
+            cli_out("%10s %13s %13s %13s %14s %11s %13s %13s %13s %13s",
+                    "---------", "-----------", "-----------", "-----------",
+                    "------------", "----", "-----------", "-----------",
+                    "-----------", "-------------");
             is_header_printed = 1;
         }
-        if (profile_info[i].fop_hits) {
+        if (profile_info[i].fop_hits && profile_info[i].has_percentiles) {
+            cli_out(
+                "%10.2lf %10.2lf us %10.2lf us %10.2lf us"
+                " %14" PRId64
+                " %11s %10.2lf us %10.2lf us %10.2lf us %10.2lf us",
+                profile_info[i].percentage_avg_latency,
+                profile_info[i].avg_latency, profile_info[i].min_latency,
+                profile_info[i].max_latency, profile_info[i].fop_hits,
+                profile_info[i].fop_name, profile_info[i].p50_latency,
+                profile_info[i].p90_latency, profile_info[i].p99_latency,
+                profile_info[i].p999_latency);
+        } else if (profile_info[i].fop_hits) {
             cli_out(
                 "%10.2lf %10.2lf us %10.2lf us %10.2lf us"
                 " %14" PRId64 " %11s",
@@ -1927,11 +1927,14 @@ cli_xml_output_vol_profile_stats(xmlTextWriterPtr writer, dict_t *dict,
     double avg_latency = 0.0;
     double max_latency = 0.0;
     double min_latency = 0.0;
+    double pct_latency = 0.0;
     uint64_t duration = 0;
     uint64_t total_read = 0;
     uint64_t total_write = 0;
     char key[1024] = {0};
+    static char *percentiles[] = {"p50", "p90", "p99", "p999"};
     int i = 0;
+    int j = 0;
 
     /* <cumulativeStats> || <intervalStats> */
     if (interval == -1)
@@ -2032,6 +2035,19 @@ cli_xml_output_vol_profile_stats(xmlTextWriterPtr writer, dict_t *dict,
                                               "%f", max_latency);
         XML_RET_CHECK_AND_GOTO(ret, out);
 
+        /* <p50Latency>, <p90Latency>, <p99Latency>, <p999Latency> */
+        for (j = 0; j < sizeof(percentiles) / sizeof(percentiles[0]); j++) {
+            snprintf(key, sizeof(key), "%d-%d-%d-%slatency", brick_index,
+                     interval, i, percentiles[j]);
+            if (dict_get_double(dict, key, &pct_latency))
+                continue;
+
+            snprintf(key, sizeof(key), "%sLatency", percentiles[j]);
+            ret = xmlTextWriterWriteFormatElement(writer, (xmlChar *)key, "%f",
+                                                  pct_latency);
+            XML_RET_CHECK_AND_GOTO(ret, out);
+        }
+
         /* </fop> */
         ret = xmlTextWriterEndElement(writer);
         XML_RET_CHECK_AND_GOTO(ret, out);
@@ -35,7 +35,8 @@ GLFS_MSGID(
     glusterfsd_msg_32, glusterfsd_msg_33, glusterfsd_msg_34, glusterfsd_msg_35,
     glusterfsd_msg_36, glusterfsd_msg_37, glusterfsd_msg_38, glusterfsd_msg_39,
     glusterfsd_msg_40, glusterfsd_msg_41, glusterfsd_msg_42, glusterfsd_msg_43,
-    glusterfsd_msg_029, glusterfsd_msg_041, glusterfsd_msg_042);
+    glusterfsd_msg_029, glusterfsd_msg_041, glusterfsd_msg_042,
+    glusterfsd_msg_44);
 
 #define glusterfsd_msg_1_STR "Could not create absolute mountpoint path"
 #define glusterfsd_msg_2_STR "Could not get current working directory"
@@ -89,5 +90,8 @@ GLFS_MSGID(
 #define glusterfsd_msg_041_STR "can't detach. flie not found"
 #define glusterfsd_msg_042_STR                                                 \
     "couldnot detach old graph. Aborting the reconfiguration operation"
+#define glusterfsd_msg_44_STR                                                  \
+    "could not pin connections to event threads, they share one epoll "       \
+    "instance"
 
 #endif /* !_GLUSTERFSD_MESSAGES_H_ */
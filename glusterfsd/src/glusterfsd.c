@@ -199,6 +199,8 @@ static struct argp_option gf_options[] = {
      "Enables thin mount and connects via gfproxyd daemon"},
     {"global-threading", ARGP_GLOBAL_THREADING_KEY, "BOOL", OPTION_ARG_OPTIONAL,
      "Use the global thread pool instead of io-threads"},
+    {"event-pinning", ARGP_EVENT_PINNING_KEY, "BOOL", OPTION_ARG_OPTIONAL,
+     "Poll every connection from a single event thread [default: off]"},
     {0, 0, 0, 0, "Fuse options:"},
     {"direct-io-mode", ARGP_DIRECT_IO_MODE_KEY, "BOOL|auto",
      OPTION_ARG_OPTIONAL, "Specify direct I/O strategy [default: \"auto\"]"},
@@ -220,6 +222,9 @@ static struct argp_option gf_options[] = {
     {"invalidate-limit", ARGP_FUSE_INVALIDATE_LIMIT_KEY, "N", 0,
      "Suspend inode invalidations implied by 'lru-limit' if the number of "
      "outstanding invalidations reaches N"},
+    {"max-write", ARGP_FUSE_MAX_WRITE_KEY, "BYTES", 0,
+     "Set the largest read or write request fuse module sends to BYTES "
+     "[default: 1MB]"},
     {"background-qlen", ARGP_FUSE_BACKGROUND_QLEN_KEY, "N", 0,
      "Set fuse module's background queue length to N "
      "[default: 64]"},
@@ -436,6 +441,11 @@ set_fuse_mount_options(glusterfs_ctx_t *ctx, dict_t *options)
                      cmd_args->invalidate_limit, glusterfsd_msg_3);
     }
 
+    if (cmd_args->fuse_max_write) {
+        DICT_SET_VAL(dict_set_uint64, options, "max-write",
+                     cmd_args->fuse_max_write, glusterfsd_msg_3);
+    }
+
     if (cmd_args->background_qlen) {
         DICT_SET_VAL(dict_set_int32_sizen, options, "background-qlen",
                      cmd_args->background_qlen, glusterfsd_msg_3);
@@ -1131,6 +1141,13 @@ parse_opts(int key, char *arg, struct argp_state *state)
                          arg);
             break;
 
+        case ARGP_FUSE_MAX_WRITE_KEY:
+            if (!gf_string2bytesize_uint64(arg, &cmd_args->fuse_max_write))
+                break;
+
+            argp_failure(state, -1, 0, "unknown max write option %s", arg);
+            break;
+
         case ARGP_FUSE_BACKGROUND_QLEN_KEY:
             if (!gf_string2int(arg, &cmd_args->background_qlen))
                 break;
@@ -1364,6 +1381,20 @@ parse_opts(int key, char *arg, struct argp_state *state)
                          "Invalid value for global threading \"%s\"", arg);
             break;
 
+        case ARGP_EVENT_PINNING_KEY:
+            if (!arg || (*arg == 0)) {
+                arg = "yes";
+            }
+
+            if (gf_string2boolean(arg, &b) == 0) {
+                cmd_args->event_pinning = b;
+                break;
+            }
+
+            argp_failure(state, -1, 0, "Invalid value for event pinning \"%s\"",
+                         arg);
+            break;
+
         case ARGP_FUSE_DEV_EPERM_RATELIMIT_NS_KEY:
             if (gf_string2uint32(arg, &cmd_args->fuse_dev_eperm_ratelimit_ns)) {
                 argp_failure(state, -1, 0,
@@ -2725,6 +2756,11 @@ main(int argc, char *argv[])
         goto out;
     }
 
+    /* before the graph registers its first fd */
+    if (cmd->event_pinning && gf_event_pin_threads(ctx->event_pool)) {
+        gf_smsg("glusterfs", GF_LOG_WARNING, 0, glusterfsd_msg_44, NULL);
+    }
+
     ret = glusterfs_volumes_init(ctx);
     if (ret)
         goto out;
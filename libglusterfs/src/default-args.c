@@ -1649,3 +1649,107 @@ args_cbk_init(default_args_cbk_t *args_cbk)
 {
     INIT_LIST_HEAD(&args_cbk->entries);
 }
+
+/* The xdata of a compound is the one it's wound with, @args->xdata is only
+ * set by the protocol client and is not owned by @args. */
+compound_args_t *
+compound_fop_alloc(unsigned int length)
+{
+    compound_args_t *args = NULL;
+
+    args = GF_CALLOC(1, sizeof(*args), gf_mt_compound_req_t);
+    if (!args)
+        return NULL;
+
+    args->fop_length = length;
+
+    args->enum_list = GF_CALLOC(length, sizeof(*args->enum_list),
+                                gf_common_mt_int);
+    if (!args->enum_list)
+        goto err;
+
+    args->req_list = GF_CALLOC(length, sizeof(*args->req_list),
+                               gf_mt_compound_req_t);
+    if (!args->req_list)
+        goto err;
+
+    return args;
+err:
+    GF_FREE(args->enum_list);
+    GF_FREE(args);
+    return NULL;
+}
+
+void
+compound_args_cleanup(compound_args_t *args)
+{
+    unsigned int i = 0;
+
+    if (!args)
+        return;
+
+    if (args->req_list) {
+        for (i = 0; i < args->fop_length; i++)
+            args_wipe(&args->req_list[i]);
+    }
+
+    GF_FREE(args->enum_list);
+    GF_FREE(args->req_list);
+    GF_FREE(args);
+}
+
+compound_args_cbk_t *
+compound_args_cbk_alloc(unsigned int length, dict_t *xdata)
+{
+    compound_args_cbk_t *args_cbk = NULL;
+    unsigned int i = 0;
+
+    args_cbk = GF_CALLOC(1, sizeof(*args_cbk), gf_mt_compound_rsp_t);
+    if (!args_cbk)
+        return NULL;
+
+    args_cbk->fop_length = length;
+
+    args_cbk->enum_list = GF_CALLOC(length, sizeof(*args_cbk->enum_list),
+                                    gf_common_mt_int);
+    if (!args_cbk->enum_list)
+        goto err;
+
+    args_cbk->rsp_list = GF_CALLOC(length, sizeof(*args_cbk->rsp_list),
+                                   gf_mt_compound_rsp_t);
+    if (!args_cbk->rsp_list)
+        goto err;
+
+    for (i = 0; i < length; i++)
+        args_cbk_init(&args_cbk->rsp_list[i]);
+
+    if (xdata)
+        args_cbk->xdata = dict_ref(xdata);
+
+    return args_cbk;
+err:
+    GF_FREE(args_cbk->enum_list);
+    GF_FREE(args_cbk);
+    return NULL;
+}
+
+void
+compound_args_cbk_cleanup(compound_args_cbk_t *args_cbk)
+{
+    unsigned int i = 0;
+
+    if (!args_cbk)
+        return;
+
+    if (args_cbk->rsp_list) {
+        for (i = 0; i < args_cbk->fop_length; i++)
+            args_cbk_wipe(&args_cbk->rsp_list[i]);
+    }
+
+    if (args_cbk->xdata)
+        dict_unref(args_cbk->xdata);
+
+    GF_FREE(args_cbk->enum_list);
+    GF_FREE(args_cbk->rsp_list);
+    GF_FREE(args_cbk);
+}
@@ -61,44 +61,72 @@ get_new_data()
     return data;
 }
 
+/* Formats the value of a new data_t, keeping it inside the data_t when it
+ * fits. Returns the length like gf_asprintf(). */
+static int
+data_printf(data_t *data, const char *fmt, ...)
+{
+    va_list ap;
+    int len;
+
+    va_start(ap, fmt);
+    len = vsnprintf(data->inline_value, GF_DATA_INLINE_LEN, fmt, ap);
+    va_end(ap);
+
+    if ((len >= 0) && (len < GF_DATA_INLINE_LEN)) {
+        data->data = data->inline_value;
+        return len;
+    }
+
+    va_start(ap, fmt);
+    len = gf_vasprintf(&data->data, fmt, ap);
+    va_end(ap);
+
+    return len;
+}
+
+static void
+data_set_copy(data_t *data, const char *value, int32_t len)
+{
+    if (len <= GF_DATA_INLINE_LEN) {
+        memcpy(data->inline_value, value, len);
+        data->data = data->inline_value;
+    } else {
+        data->data = gf_memdup(value, len);
+    }
+}
+
 static dict_t *
 get_new_dict_full(int size_hint)
 {
-    dict_t *dict = mem_get0(THIS->ctx->dict_pool);
+    dict_t *dict = mem_get(THIS->ctx->dict_pool);
+    int32_t size = GF_DICT_INLINE_SLOTS;
 
     if (!dict) {
         return NULL;
     }
 
-    dict->hash_size = size_hint;
-    if (size_hint == 1) {
-        /*
-         * This is the only case we ever see currently.  If we ever
-         * need to support resizing the hash table, the resize function
-         * will have to take into account the possibility that
-         * "members" is not separately allocated (i.e. don't just call
-         * realloc() blindly.
-         */
-        dict->members = &dict->members_internal;
+    /* Only the header and the index need to be cleared, the inline
+     * pairs and key storage are tracked by pairs_used and keys_used. */
+    memset(dict, 0, offsetof(dict_t, pairs_internal));
+
+    /* The index is kept at most 3/4 full, size it for the hinted number
+     * of keys so that a copy of a large dict does not have to grow. */
+    while ((size_hint * 4) > (size * 3))
+        size *= 2;
+
+    dict->hash_size = size;
+    if (size == GF_DICT_INLINE_SLOTS) {
+        dict->members = dict->members_internal;
     } else {
-        /*
-         * We actually need to allocate space for size_hint *pointers*
-         * but we actually allocate space for one *structure*.  Since
-         * a data_pair_t consists of five pointers, we're wasting four
-         * pointers' worth for N=1, and will overrun what we allocated
-         * for N>5.  If anybody ever starts using size_hint, we'll need
-         * to fix this.
-         */
-        GF_ASSERT(size_hint <= (sizeof(data_pair_t) / sizeof(data_pair_t *)));
-        dict->members = mem_get0(THIS->ctx->dict_pair_pool);
+        dict->members = GF_CALLOC(size, sizeof(data_pair_t *),
+                                  gf_common_mt_pointer);
         if (!dict->members) {
             mem_put(dict);
             return NULL;
         }
     }
 
-    dict->free_pair.key = NULL;
-    dict->totkvlen = 0;
     LOCK_INIT(&dict->lock);
 
     return dict;
@@ -107,7 +135,7 @@ get_new_dict_full(int size_hint)
 dict_t *
 dict_new(void)
 {
-    dict_t *dict = get_new_dict_full(1);
+    dict_t *dict = get_new_dict_full(0);
 
     if (dict)
         dict_ref(dict);
@@ -294,7 +322,7 @@ void
 data_destroy(data_t *data)
 {
     if (data) {
-        if (!data->is_static)
+        if (!data->is_static && (data->data != data->inline_value))
             GF_FREE(data->data);
 
         data->len = 0xbabababa;
@@ -318,7 +346,7 @@ data_copy(data_t *old)
 
     newdata->len = old->len;
     if (old->data) {
-        newdata->data = gf_memdup(old->data, old->len);
+        data_set_copy(newdata, old->data, old->len);
         if (!newdata->data)
             goto err_out;
     }
@@ -336,24 +364,192 @@ err_out:
  * Always this and key variables are not null -
  * checked by callers.
  */
+static int32_t
+__dict_lookup_slot(const dict_t *this, const char *key, const uint32_t hash)
+{
+    uint32_t mask = this->hash_size - 1;
+    uint32_t slot = hash & mask;
+    data_pair_t *pair;
+
+    /* The index is never full, the probe always ends on an empty slot. */
+    while ((pair = this->members[slot]) != NULL) {
+        if ((hash == pair->key_hash) && !strcmp(pair->key, key))
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+
+    return -1;
+}
+
 static data_pair_t *
 dict_lookup_common(const dict_t *this, const char *key, const uint32_t hash)
 {
-    int hashval = 0;
-    data_pair_t *pair;
+    int32_t slot = __dict_lookup_slot(this, key, hash);
 
-    /* If the divisor is 1, the modulo is always 0,
-     * in such case avoid hash calculation.
-     */
-    if (this->hash_size != 1)
-        hashval = hash % this->hash_size;
+    if (slot < 0)
+        return NULL;
+
+    return this->members[slot];
+}
+
+static void
+__dict_index_insert(data_pair_t **members, int32_t size, data_pair_t *pair)
+{
+    uint32_t mask = size - 1;
+    uint32_t slot = pair->key_hash & mask;
+
+    while (members[slot])
+        slot = (slot + 1) & mask;
+
+    members[slot] = pair;
+}
+
+/* Removes the pair at 'slot' from the index. The entries following it in
+ * the same probe sequence are shifted back, so that lookups never need
+ * tombstones to skip over. */
+static void
+__dict_index_remove(dict_t *this, uint32_t slot)
+{
+    uint32_t mask = this->hash_size - 1;
+    uint32_t next = slot;
+    uint32_t home;
 
-    for (pair = this->members[hashval]; pair != NULL; pair = pair->hash_next) {
-        if (pair->key && (hash == pair->key_hash) && !strcmp(pair->key, key))
-            return pair;
+    for (;;) {
+        this->members[slot] = NULL;
+
+        for (;;) {
+            next = (next + 1) & mask;
+            if (!this->members[next])
+                return;
+
+            /* the entry can fill the hole only if its home slot is not
+             * cyclically within (slot, next] */
+            home = this->members[next]->key_hash & mask;
+            if (slot <= next) {
+                if ((slot < home) && (home <= next))
+                    continue;
+            } else if ((slot < home) || (home <= next)) {
+                continue;
+            }
+            break;
+        }
+
+        this->members[slot] = this->members[next];
+        slot = next;
     }
+}
 
-    return NULL;
+/* Makes room in the index for one more pair, keeping it at most 3/4 full. */
+static int
+__dict_index_reserve(dict_t *this)
+{
+    data_pair_t **members = NULL;
+    data_pair_t *pair = NULL;
+    int32_t size = this->hash_size;
+
+    if (((this->count + 1) * 4) <= (size * 3))
+        return 0;
+
+    size *= 2;
+    members = GF_CALLOC(size, sizeof(data_pair_t *), gf_common_mt_pointer);
+    if (!members)
+        return -1;
+
+    for (pair = this->members_list; pair; pair = pair->next)
+        __dict_index_insert(members, size, pair);
+
+    if (this->members != this->members_internal)
+        GF_FREE(this->members);
+
+    this->members = members;
+    this->hash_size = size;
+
+    return 0;
+}
+
+static data_pair_t *
+__dict_pair_new(dict_t *this)
+{
+    int idx;
+
+    if (this->pairs_used != ((1U << GF_DICT_INLINE_PAIRS) - 1)) {
+        idx = __builtin_ctz(~this->pairs_used);
+        this->pairs_used |= (1U << idx);
+        return &this->pairs_internal[idx];
+    }
+
+    return mem_get(THIS->ctx->dict_pair_pool);
+}
+
+static void
+__dict_pair_free(dict_t *this, data_pair_t *pair)
+{
+    if ((pair >= this->pairs_internal) &&
+        (pair < (this->pairs_internal + GF_DICT_INLINE_PAIRS))) {
+        this->pairs_used &= ~(1U << (pair - this->pairs_internal));
+        return;
+    }
+
+    mem_put(pair);
+}
+
+static char *
+__dict_key_dup(dict_t *this, const char *key, const int keylen)
+{
+    char *dup = NULL;
+
+    if ((this->keys_used + keylen + 1) <= GF_DICT_INLINE_KEYS) {
+        dup = this->key_arena + this->keys_used;
+        this->keys_used += keylen + 1;
+    } else {
+        dup = GF_MALLOC(keylen + 1, gf_common_mt_char);
+        if (!dup)
+            return NULL;
+    }
+
+    memcpy(dup, key, keylen);
+    dup[keylen] = '\0';
+
+    return dup;
+}
+
+static gf_boolean_t
+__dict_key_is_inline(dict_t *this, char *key)
+{
+    return ((key >= this->key_arena) &&
+            (key < (this->key_arena + GF_DICT_INLINE_KEYS)));
+}
+
+static void
+__dict_key_free(dict_t *this, char *key, const int keylen)
+{
+    if (!__dict_key_is_inline(this, key)) {
+        GF_FREE(key);
+        return;
+    }
+
+    /* space is reclaimed only for the most recent key, which covers a
+     * key being set and deleted again */
+    if ((key + keylen + 1) == (this->key_arena + this->keys_used))
+        this->keys_used -= keylen + 1;
+}
+
+/* Adds a new pair to the index and the members list, the key is owned by
+ * the dict from here on. */
+static void
+__dict_link_pair(dict_t *this, data_pair_t *pair)
+{
+    __dict_index_insert(this->members, this->hash_size, pair);
+
+    pair->next = this->members_list;
+    pair->prev = NULL;
+    if (this->members_list)
+        this->members_list->prev = pair;
+    this->members_list = pair;
+    this->count++;
+
+    if (this->max_count < this->count)
+        this->max_count = this->count;
 }
 
 int32_t
@@ -387,7 +583,6 @@ static int32_t
 dict_set_lk(dict_t *this, char *key, const int key_len, data_t *value,
             const uint32_t hash, gf_boolean_t replace)
 {
-    int hashval = 0;
     data_pair_t *pair;
     int key_free = 0;
     uint32_t key_hash;
@@ -420,15 +615,17 @@ dict_set_lk(dict_t *this, char *key, const int key_len, data_t *value,
         }
     }
 
-    if (this->free_pair.key) { /* the free_pair is used */
-        pair = mem_get(THIS->ctx->dict_pair_pool);
-        if (!pair) {
-            if (key_free)
-                GF_FREE(key);
-            return -1;
-        }
-    } else { /* assign the pair to the free pair */
-        pair = &this->free_pair;
+    if (__dict_index_reserve(this) != 0) {
+        if (key_free)
+            GF_FREE(key);
+        return -1;
+    }
+
+    pair = __dict_pair_new(this);
+    if (!pair) {
+        if (key_free)
+            GF_FREE(key);
+        return -1;
     }
 
     if (key_free) {
@@ -436,40 +633,18 @@ dict_set_lk(dict_t *this, char *key, const int key_len, data_t *value,
         pair->key = key;
         key_free = 0;
     } else {
-        pair->key = (char *)GF_MALLOC(keylen + 1, gf_common_mt_char);
+        pair->key = __dict_key_dup(this, key, keylen);
         if (!pair->key) {
-            if (pair != &this->free_pair) {
-                mem_put(pair);
-            }
+            __dict_pair_free(this, pair);
             return -1;
         }
-        strcpy(pair->key, key);
     }
     pair->key_hash = key_hash;
     pair->value = data_ref(value);
     this->totkvlen += (keylen + 1 + value->len);
 
-    /* If the divisor is 1, the modulo is always 0,
-     * in such case avoid hash calculation.
-     */
-    if (this->hash_size != 1) {
-        hashval = (key_hash % this->hash_size);
-    }
-    pair->hash_next = this->members[hashval];
-    this->members[hashval] = pair;
-
-    pair->next = this->members_list;
-    pair->prev = NULL;
-    if (this->members_list)
-        this->members_list->prev = pair;
-    this->members_list = pair;
-    this->count++;
-
-    if (key_free)
-        GF_FREE(key);
+    __dict_link_pair(this, pair);
 
-    if (this->max_count < this->count)
-        this->max_count = this->count;
     return 0;
 }
 
@@ -616,7 +791,8 @@ dict_del(dict_t *this, char *key)
 void
 dict_deln(dict_t *this, char *key, const int keylen)
 {
-    int hashval = 0;
+    data_pair_t *pair = NULL;
+    int32_t slot;
     uint32_t hash;
 
     if (!this || !key) {
@@ -629,46 +805,26 @@ dict_deln(dict_t *this, char *key, const int keylen)
 
     LOCK(&this->lock);
 
-    /* If the divisor is 1, the modulo is always 0,
-     * in such case avoid hash calculation.
-     */
-    if (this->hash_size != 1)
-        hashval = hash % this->hash_size;
-
-    data_pair_t *pair = this->members[hashval];
-    data_pair_t *prev = NULL;
-
-    while (pair) {
-        if ((hash == pair->key_hash) && strcmp(pair->key, key) == 0) {
-            if (prev)
-                prev->hash_next = pair->hash_next;
-            else
-                this->members[hashval] = pair->hash_next;
+    slot = __dict_lookup_slot(this, key, hash);
+    if (slot >= 0) {
+        pair = this->members[slot];
+        __dict_index_remove(this, slot);
 
-            this->totkvlen -= pair->value->len;
-            data_unref(pair->value);
+        this->totkvlen -= pair->value->len;
+        data_unref(pair->value);
 
-            if (pair->prev)
-                pair->prev->next = pair->next;
-            else
-                this->members_list = pair->next;
+        if (pair->prev)
+            pair->prev->next = pair->next;
+        else
+            this->members_list = pair->next;
 
-            if (pair->next)
-                pair->next->prev = pair->prev;
+        if (pair->next)
+            pair->next->prev = pair->prev;
 
-            this->totkvlen -= (strlen(pair->key) + 1);
-            GF_FREE(pair->key);
-            if (pair == &this->free_pair) {
-                this->free_pair.key = NULL;
-            } else {
-                mem_put(pair);
-            }
-            this->count--;
-            break;
-        }
-
-        prev = pair;
-        pair = pair->hash_next;
+        this->totkvlen -= (keylen + 1);
+        __dict_key_free(this, pair->key, keylen);
+        __dict_pair_free(this, pair);
+        this->count--;
     }
 
     UNLOCK(&this->lock);
@@ -696,19 +852,16 @@ dict_destroy(dict_t *this)
     while (prev) {
         pair = pair->next;
         data_unref(prev->value);
-        GF_FREE(prev->key);
-        if (prev != &this->free_pair) {
-            mem_put(prev);
-        } else {
-            this->free_pair.key = NULL;
-        }
+        if (!__dict_key_is_inline(this, prev->key))
+            GF_FREE(prev->key);
+        __dict_pair_free(this, prev);
         total_pairs++;
         prev = pair;
     }
 
     this->totkvlen = 0;
-    if (this->members != &this->members_internal) {
-        mem_put(this->members);
+    if (this->members != this->members_internal) {
+        GF_FREE(this->members);
     }
 
     free(this->extra_stdfree);
@@ -806,7 +959,7 @@ int_to_data(int64_t value)
         return NULL;
     }
 
-    data->len = gf_asprintf(&data->data, "%" PRId64, value);
+    data->len = data_printf(data, "%" PRId64, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -826,7 +979,7 @@ data_from_int64(int64_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRId64, value);
+    data->len = data_printf(data, "%" PRId64, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -846,7 +999,7 @@ data_from_int32(int32_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRId32, value);
+    data->len = data_printf(data, "%" PRId32, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -867,7 +1020,7 @@ data_from_int16(int16_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRId16, value);
+    data->len = data_printf(data, "%" PRId16, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -888,7 +1041,7 @@ data_from_int8(int8_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%d", value);
+    data->len = data_printf(data, "%d", value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -909,7 +1062,7 @@ data_from_uint64(uint64_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRIu64, value);
+    data->len = data_printf(data, "%" PRIu64, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -931,7 +1084,7 @@ data_from_double(double value)
         return NULL;
     }
 
-    data->len = gf_asprintf(&data->data, "%f", value);
+    data->len = data_printf(data, "%f", value);
     if (data->len == -1) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -951,7 +1104,7 @@ data_from_uint32(uint32_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRIu32, value);
+    data->len = data_printf(data, "%" PRIu32, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -972,7 +1125,7 @@ data_from_uint16(uint16_t value)
     if (!data) {
         return NULL;
     }
-    data->len = gf_asprintf(&data->data, "%" PRIu16, value);
+    data->len = data_printf(data, "%" PRIu16, value);
     if (-1 == data->len) {
         gf_msg_debug("dict", 0, "asprintf failed");
         data_destroy(data);
@@ -1444,7 +1597,7 @@ dict_copy(dict_t *dict, dict_t *new)
     }
 
     if (!new)
-        new = get_new_dict_full(dict->hash_size);
+        new = get_new_dict_full(dict->count);
 
     dict_foreach(dict, dict_copy_one, new);
 
@@ -2101,7 +2254,6 @@ _dict_modify_flag(dict_t *this, char *key, int flag, int op)
     int ret = 0;
     data_pair_t *pair = NULL;
     char *ptr = NULL;
-    int hashval = 0;
     uint32_t hash;
 
     if (!this || !key) {
@@ -2152,42 +2304,34 @@ _dict_modify_flag(dict_t *this, char *key, int flag, int op)
             else
                 BIT_CLEAR((unsigned char *)(data->data), flag);
 
-            if (this->free_pair.key) { /* the free pair is in use */
-                pair = mem_get0(THIS->ctx->dict_pair_pool);
-                if (!pair) {
-                    gf_smsg("dict", GF_LOG_ERROR, ENOMEM, LG_MSG_NO_MEMORY,
-                            "dict pair", NULL);
-                    ret = -ENOMEM;
-                    goto err;
-                }
-            } else { /* use the free pair */
-                pair = &this->free_pair;
+            if (__dict_index_reserve(this) != 0) {
+                gf_smsg("dict", GF_LOG_ERROR, ENOMEM, LG_MSG_NO_MEMORY,
+                        "dict index", NULL);
+                ret = -ENOMEM;
+                goto err;
             }
 
-            pair->key = (char *)GF_MALLOC(strlen(key) + 1, gf_common_mt_char);
+            pair = __dict_pair_new(this);
+            if (!pair) {
+                gf_smsg("dict", GF_LOG_ERROR, ENOMEM, LG_MSG_NO_MEMORY,
+                        "dict pair", NULL);
+                ret = -ENOMEM;
+                goto err;
+            }
+
+            pair->key = __dict_key_dup(this, key, strlen(key));
             if (!pair->key) {
                 gf_smsg("dict", GF_LOG_ERROR, ENOMEM, LG_MSG_NO_MEMORY,
                         "dict pair", NULL);
+                __dict_pair_free(this, pair);
                 ret = -ENOMEM;
                 goto err;
             }
-            strcpy(pair->key, key);
             pair->key_hash = hash;
             pair->value = data_ref(data);
             this->totkvlen += (strlen(key) + 1 + data->len);
-            hashval = hash % this->hash_size;
-            pair->hash_next = this->members[hashval];
-            this->members[hashval] = pair;
-
-            pair->next = this->members_list;
-            pair->prev = NULL;
-            if (this->members_list)
-                this->members_list->prev = pair;
-            this->members_list = pair;
-            this->count++;
-
-            if (this->max_count < this->count)
-                this->max_count = this->count;
+
+            __dict_link_pair(this, pair);
         }
     }
 
@@ -2198,16 +2342,6 @@ err:
     if (key && this)
         UNLOCK(&this->lock);
 
-    if (pair) {
-        if (pair->key) {
-            GF_FREE(pair->key);
-            pair->key = NULL;
-        }
-        if (pair != &this->free_pair) {
-            mem_put(pair);
-        }
-    }
-
     if (data)
         data_destroy(data);
 
@@ -3181,7 +3315,7 @@ dict_unserialize(char *orig_buf, int32_t size, dict_t **fill)
             goto out;
         }
         value->len = vallen;
-        value->data = gf_memdup(buf, vallen);
+        data_set_copy(value, buf, vallen);
         value->data_type = GF_DATA_TYPE_STR_OLD;
         value->is_static = _gf_false;
         buf += vallen;
@@ -19,6 +19,12 @@
 
 #ifdef HAVE_SYS_EPOLL_H
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+/* events fetched by one epoll_wait() of a pinned thread */
+#define EVENT_PINNED_BATCH 64
+/* event_data.idx of a pinned thread's wakeup eventfd */
+#define EVENT_WAKE_IDX -1
 
 struct event_slot_epoll {
     int fd;
@@ -33,6 +39,15 @@ struct event_slot_epoll {
     event_handler_t handler;
     gf_lock_t lock;
     struct list_head poller_death;
+    int poller;  /* pinned thread polling the fd */
+    int move_to; /* thread to hand the fd to once its handler returns */
+};
+
+struct event_poller_epoll {
+    int epfd;
+    int wakefd;       /* makes the thread look at eventthreadcount */
+    gf_atomic_t load; /* fds polled by the thread */
+    gf_boolean_t unusable; /* the thread could not be started */
 };
 
 struct event_thread_data {
@@ -71,6 +86,138 @@ event_slot_ref(struct event_slot_epoll *slot)
     return GF_ATOMIC_INC(slot->ref);
 }
 
+static int
+__event_poller_init(struct event_pool *event_pool, int index)
+{
+    struct event_poller_epoll *poller = &event_pool->pinned[index];
+    struct epoll_event epoll_event = {
+        0,
+    };
+    struct event_data *ev_data = (void *)&epoll_event.data;
+
+    if (poller->epfd != -1)
+        return 0;
+
+    poller->epfd = epoll_create(event_pool->count);
+    if (poller->epfd == -1) {
+        gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_CREATE_FAILED,
+                NULL);
+        return -1;
+    }
+
+    poller->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (poller->wakefd == -1)
+        goto err;
+
+    epoll_event.events = EPOLLIN;
+    ev_data->idx = EVENT_WAKE_IDX;
+    ev_data->gen = 0;
+    if (epoll_ctl(poller->epfd, EPOLL_CTL_ADD, poller->wakefd, &epoll_event) ==
+        -1) {
+        gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_ADD_FAILED,
+                "fd=%d", poller->wakefd, "epoll_fd=%d", poller->epfd, NULL);
+        sys_close(poller->wakefd);
+        poller->wakefd = -1;
+        goto err;
+    }
+
+    return 0;
+err:
+    sys_close(poller->epfd);
+    poller->epfd = -1;
+    return -1;
+}
+
+static void
+__event_poller_wake(struct event_pool *event_pool, int index)
+{
+    uint64_t one = 1;
+
+    if (event_pool->pinned[index].wakefd != -1)
+        (void)sys_write(event_pool->pinned[index].wakefd, &one, sizeof(one));
+}
+
+/* least loaded of the first @count pinned threads that are running, or
+ * could still be started */
+static int
+__event_poller_pick(struct event_pool *event_pool, int count)
+{
+    int i = 0;
+    int best = -1;
+
+    if (count > EVENT_MAX_THREADS)
+        count = EVENT_MAX_THREADS;
+
+    for (i = 0; i < count; i++) {
+        if (event_pool->pinned[i].unusable)
+            continue;
+        if ((best == -1) || (GF_ATOMIC_GET(event_pool->pinned[i].load) <
+                             GF_ATOMIC_GET(event_pool->pinned[best].load)))
+            best = i;
+    }
+
+    /* the first thread always runs, dispatching fails otherwise */
+    return (best == -1) ? 0 : best;
+}
+
+static int
+__event_slot_epfd(struct event_pool *event_pool, struct event_slot_epoll *slot)
+{
+    if (event_pool->pinned)
+        return event_pool->pinned[slot->poller].epfd;
+
+    return event_pool->fd;
+}
+
+/* Hands the fd over to slot->move_to; called under slot->lock while no
+ * handler runs for it. On failure it stays with its current thread. */
+static int
+__event_slot_move(struct event_pool *event_pool, struct event_slot_epoll *slot,
+                  int idx)
+{
+    struct event_poller_epoll *from = &event_pool->pinned[slot->poller];
+    struct event_poller_epoll *to = NULL;
+    struct epoll_event epoll_event = {
+        0,
+    };
+    struct event_data *ev_data = (void *)&epoll_event.data;
+    int ret = 0;
+
+    if (slot->move_to == -1 || slot->move_to == slot->poller)
+        goto out;
+
+    to = &event_pool->pinned[slot->move_to];
+
+    epoll_event.events = slot->events;
+    ev_data->idx = idx;
+    ev_data->gen = slot->gen;
+
+    /* fails for an fd that is not registered yet or any more */
+    ret = epoll_ctl(from->epfd, EPOLL_CTL_DEL, slot->fd, NULL);
+    if (ret == -1)
+        goto out;
+
+    /* an event already fetched by the old thread is dropped by
+     * event_dispatch_epoll_handler(), the new one reports it again */
+    ret = epoll_ctl(to->epfd, EPOLL_CTL_ADD, slot->fd, &epoll_event);
+    if (ret == -1) {
+        gf_msg_debug("epoll", errno, "moving fd=%d to epoll_fd=%d failed",
+                     slot->fd, to->epfd);
+        ret = epoll_ctl(from->epfd, EPOLL_CTL_ADD, slot->fd, &epoll_event);
+        if (ret == -1)
+            gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_ADD_FAILED,
+                    "fd=%d", slot->fd, "epoll_fd=%d", from->epfd, NULL);
+        goto out;
+    }
+
+    GF_ATOMIC_DEC(from->load);
+    GF_ATOMIC_INC(to->load);
+    slot->poller = slot->move_to;
+out:
+    slot->move_to = -1;
+    return ret;
+}
+
 static int
 __event_slot_alloc(struct event_pool *event_pool, int fd,
                    char notify_poller_death, struct event_slot_epoll **slot)
@@ -123,6 +270,12 @@ retry:
             INIT_LIST_HEAD(&table[j].poller_death);
 
             table[j].fd = fd;
+            table[j].move_to = -1;
+            if (event_pool->pinned) {
+                table[j].poller = __event_poller_pick(
+                    event_pool, event_pool->eventthreadcount);
+                GF_ATOMIC_INC(event_pool->pinned[table[j].poller].load);
+            }
             if (notify_poller_death) {
                 table[j].idx = table_idx * EVENT_EPOLL_SLOTS + j;
                 list_add_tail(&table[j].poller_death,
@@ -185,8 +338,11 @@ __event_slot_dealloc(struct event_pool *event_pool, int idx)
     slot->handled_error = 0;
     slot->in_handler = 0;
     list_del_init(&slot->poller_death);
-    if (fd != -1)
+    if (fd != -1) {
         event_pool->slots_used[table_idx]--;
+        if (event_pool->pinned)
+            GF_ATOMIC_DEC(event_pool->pinned[slot->poller].load);
+    }
 
     return;
 }
@@ -408,6 +564,10 @@ event_register_epoll(struct event_pool *event_pool, int fd,
         */
 
         slot->events = EPOLLPRI | EPOLLHUP | EPOLLERR | EPOLLONESHOT;
+        /* a pinned fd is polled by a single thread, that can't pick up
+           another event on it while its handler runs */
+        if (event_pool->pinned)
+            slot->events &= ~EPOLLONESHOT;
         slot->handler = handler;
         slot->data = data;
 
@@ -417,7 +577,8 @@ event_register_epoll(struct event_pool *event_pool, int fd,
         ev_data->idx = idx;
         ev_data->gen = slot->gen;
 
-        ret = epoll_ctl(event_pool->fd, EPOLL_CTL_ADD, fd, &epoll_event);
+        ret = epoll_ctl(__event_slot_epfd(event_pool, slot), EPOLL_CTL_ADD, fd,
+                        &epoll_event);
         /* check ret after UNLOCK() to avoid deadlock in
            event_slot_unref()
         */
@@ -426,7 +587,7 @@ event_register_epoll(struct event_pool *event_pool, int fd,
 
     if (ret == -1) {
         gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_ADD_FAILED,
-                "fd=%d", fd, "epoll_fd=%d", event_pool->fd, NULL);
+                "fd=%d", fd, NULL);
         event_slot_unref(event_pool, slot, idx);
         idx = -1;
     }
@@ -441,6 +602,7 @@ event_unregister_epoll_common(struct event_pool *event_pool, int fd, int idx,
                               int do_close)
 {
     int ret = -1;
+    int epfd = -1;
     struct event_slot_epoll *slot = NULL;
 
     GF_VALIDATE_OR_GOTO("event", event_pool, out);
@@ -464,14 +626,17 @@ event_unregister_epoll_common(struct event_pool *event_pool, int fd, int idx,
 
     LOCK(&slot->lock);
     {
-        ret = epoll_ctl(event_pool->fd, EPOLL_CTL_DEL, fd, NULL);
+        epfd = __event_slot_epfd(event_pool, slot);
+        ret = epoll_ctl(epfd, EPOLL_CTL_DEL, fd, NULL);
 
         if (ret == -1) {
             gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_DEL_FAILED,
-                    "fd=%d", fd, "epoll_fd=%d", event_pool->fd, NULL);
+                    "fd=%d", fd, "epoll_fd=%d", epfd, NULL);
             goto unlock;
         }
 
+        slot->move_to = -1;
+
         slot->do_close = do_close;
         slot->gen++; /* detect unregister in dispatch_handler() */
     }
@@ -535,7 +700,7 @@ event_select_on_epoll(struct event_pool *event_pool, int fd, int idx,
         ev_data->idx = idx;
         ev_data->gen = slot->gen;
 
-        if (slot->in_handler)
+        if (slot->in_handler && !event_pool->pinned)
             /*
              * in_handler indicates at least one thread
              * executing event_dispatch_epoll_handler()
@@ -550,7 +715,8 @@ event_select_on_epoll(struct event_pool *event_pool, int fd, int idx,
              */
             goto unlock;
 
-        ret = epoll_ctl(event_pool->fd, EPOLL_CTL_MOD, fd, &epoll_event);
+        ret = epoll_ctl(__event_slot_epfd(event_pool, slot), EPOLL_CTL_MOD, fd,
+                        &epoll_event);
         if (ret == -1) {
             gf_smsg("epoll", GF_LOG_ERROR, errno, LG_MSG_EPOLL_FD_MODIFY_FAILED,
                     "fd=%d", fd, "events=%d", epoll_event.events, NULL);
@@ -567,7 +733,7 @@ out:
 
 static int
 event_dispatch_epoll_handler(struct event_pool *event_pool,
-                             struct epoll_event *event)
+                             struct epoll_event *event, int poller)
 {
     struct event_data *ev_data = NULL;
     struct event_slot_epoll *slot = NULL;
@@ -612,6 +778,10 @@ event_dispatch_epoll_handler(struct event_pool *event_pool,
             goto pre_unlock;
         }
 
+        if (event_pool->pinned && slot->poller != poller)
+            /* fetched just before the fd moved to another thread */
+            goto pre_unlock;
+
         handler = slot->handler;
         data = slot->data;
 
@@ -650,8 +820,13 @@ out:
 static void *
 event_dispatch_epoll_worker(void *data)
 {
-    struct epoll_event event;
+    struct epoll_event events[EVENT_PINNED_BATCH];
+    struct event_data *event_data = NULL;
     int ret = -1;
+    int i = 0;
+    int epfd = -1;
+    int maxevents = 1;
+    uint64_t wakeups = 0;
     struct event_thread_data *ev_data = data;
     struct event_pool *event_pool;
     int myindex = -1;
@@ -672,6 +847,11 @@ event_dispatch_epoll_worker(void *data)
     pthread_mutex_lock(&event_pool->mutex);
     {
         event_pool->activethreadcount++;
+        epfd = event_pool->fd;
+        if (event_pool->pinned) {
+            epfd = event_pool->pinned[myindex - 1].epfd;
+            maxevents = EVENT_PINNED_BATCH;
+        }
     }
     pthread_mutex_unlock(&event_pool->mutex);
 
@@ -738,7 +918,7 @@ event_dispatch_epoll_worker(void *data)
             }
         }
 
-        ret = epoll_wait(event_pool->fd, &event, 1, -1);
+        ret = epoll_wait(epfd, events, maxevents, -1);
 
         if (ret == 0)
             /* timeout */
@@ -748,10 +928,19 @@ event_dispatch_epoll_worker(void *data)
             /* sys call */
             continue;
 
-        ret = event_dispatch_epoll_handler(event_pool, &event);
-        if (ret) {
-            gf_smsg("epoll", GF_LOG_ERROR, 0, LG_MSG_DISPATCH_HANDLER_FAILED,
-                    NULL);
+        for (i = 0; i < ret; i++) {
+            event_data = (void *)&events[i].data;
+            if (event_data->idx == EVENT_WAKE_IDX) {
+                (void)sys_read(event_pool->pinned[myindex - 1].wakefd,
+                               &wakeups, sizeof(wakeups));
+                continue;
+            }
+
+            if (event_dispatch_epoll_handler(event_pool, &events[i],
+                                             myindex - 1)) {
+                gf_smsg("epoll", GF_LOG_ERROR, 0,
+                        LG_MSG_DISPATCH_HANDLER_FAILED, NULL);
+            }
         }
     }
 out:
@@ -760,6 +949,55 @@ out:
     return NULL;
 }
 
+/* Moves fds off the pinned threads that are to die, that could not be
+ * started or that poll more than their share, to the least loaded of the
+ * first @count threads. An fd whose handler is running moves when
+ * event_handled() is called for it. */
+static void
+__event_pinned_rebalance(struct event_pool *event_pool, int count)
+{
+    struct event_slot_epoll *table = NULL;
+    struct event_slot_epoll *slot = NULL;
+    int64_t total = 0;
+    int64_t share = 0;
+    int from = 0;
+    int i = 0;
+    int j = 0;
+
+    for (i = 0; i < EVENT_MAX_THREADS; i++)
+        total += GF_ATOMIC_GET(event_pool->pinned[i].load);
+
+    share = (total + count - 1) / count;
+
+    for (i = 0; i < EVENT_EPOLL_TABLES; i++) {
+        table = event_pool->ereg[i];
+        if (!table || !event_pool->slots_used[i])
+            continue;
+
+        for (j = 0; j < EVENT_EPOLL_SLOTS; j++) {
+            slot = &table[j];
+
+            LOCK(&slot->lock);
+            {
+                if (slot->fd == -1)
+                    goto next;
+
+                from = slot->poller;
+                if (from < count && !event_pool->pinned[from].unusable &&
+                    GF_ATOMIC_GET(event_pool->pinned[from].load) <= share)
+                    goto next;
+
+                slot->move_to = __event_poller_pick(event_pool, count);
+                if (!slot->in_handler)
+                    __event_slot_move(event_pool, slot,
+                                      i * EVENT_EPOLL_SLOTS + j);
+            }
+        next:
+            UNLOCK(&slot->lock);
+        }
+    }
+}
+
 /* Attempts to start the # of configured pollers, ensuring at least the first
  * is started in a joinable state */
 static int
@@ -769,6 +1007,7 @@ event_dispatch_epoll(struct event_pool *event_pool)
     pthread_t t_id;
     int pollercount = 0;
     int ret = -1;
+    gf_boolean_t lost = _gf_false;
     struct event_thread_data *ev_data = NULL;
 
     /* Start the configured number of pollers */
@@ -795,7 +1034,11 @@ event_dispatch_epoll(struct event_pool *event_pool)
                     break;
                 } else {
                     /* Inability to create other threads
-                     * are a lesser evil, and ignored */
+                     * are a lesser evil, their fds go to
+                     * the others */
+                    if (event_pool->pinned)
+                        event_pool->pinned[i].unusable = _gf_true;
+                    lost = _gf_true;
                     continue;
                 }
             }
@@ -822,10 +1065,17 @@ event_dispatch_epoll(struct event_pool *event_pool)
                     break;
                 } else {
                     GF_FREE(ev_data);
+                    if (event_pool->pinned)
+                        event_pool->pinned[i].unusable = _gf_true;
+                    lost = _gf_true;
                     continue;
                 }
             }
         }
+
+        /* no fd may stay pinned to a thread that is not polling */
+        if (lost && event_pool->pinned && (event_pool->pollers[0] != 0))
+            __event_pinned_rebalance(event_pool, pollercount);
     }
     pthread_mutex_unlock(&event_pool->mutex);
 
@@ -884,6 +1134,16 @@ event_reconfigure_threads_epoll(struct event_pool *event_pool, int value)
 
         oldthreadcount = event_pool->eventthreadcount;
 
+        if (event_pool->pinned) {
+            for (i = 0; i < value; i++) {
+                if (__event_poller_init(event_pool, i)) {
+                    /* fewer threads are better than unpolled fds */
+                    value = (i > 0) ? i : 1;
+                    break;
+                }
+            }
+        }
+
         /* Start 'worker' threads as necessary only if event_dispatch()
          * was called before. If event_dispatch() was not called, there
          * will be no epoll 'worker' threads running yet. */
@@ -899,6 +1159,8 @@ event_reconfigure_threads_epoll(struct event_pool *event_pool, int value)
                     ev_data = GF_CALLOC(1, sizeof(*ev_data),
                                         gf_common_mt_event_pool);
                     if (!ev_data) {
+                        if (event_pool->pinned)
+                            event_pool->pinned[i].unusable = _gf_true;
                         continue;
                     }
 
@@ -913,9 +1175,13 @@ event_reconfigure_threads_epoll(struct event_pool *event_pool, int value)
                                 LG_MSG_START_EPOLL_THREAD_FAILED, "index=%d", i,
                                 NULL);
                         GF_FREE(ev_data);
+                        if (event_pool->pinned)
+                            event_pool->pinned[i].unusable = _gf_true;
                     } else {
                         pthread_detach(t_id);
                         event_pool->pollers[i] = t_id;
+                        if (event_pool->pinned)
+                            event_pool->pinned[i].unusable = _gf_false;
                     }
                 }
             }
@@ -923,6 +1189,16 @@ event_reconfigure_threads_epoll(struct event_pool *event_pool, int value)
 
         /* if value decreases, threads will terminate, themselves */
         event_pool->eventthreadcount = value;
+
+        if (event_pool->pinned && (value != oldthreadcount)) {
+            if (value > 0)
+                __event_pinned_rebalance(event_pool, value);
+
+            /* a pinned thread only notices the new count when its own
+             * epoll instance reports something */
+            for (i = value; i < oldthreadcount && i < EVENT_MAX_THREADS; i++)
+                __event_poller_wake(event_pool, i);
+        }
     }
     pthread_mutex_unlock(&event_pool->mutex);
 
@@ -941,6 +1217,16 @@ event_pool_destroy_epoll(struct event_pool *event_pool)
 
     ret = sys_close(event_pool->fd);
 
+    if (event_pool->pinned) {
+        for (i = 0; i < EVENT_MAX_THREADS; i++) {
+            if (event_pool->pinned[i].wakefd != -1)
+                sys_close(event_pool->pinned[i].wakefd);
+            if (event_pool->pinned[i].epfd != -1)
+                sys_close(event_pool->pinned[i].epfd);
+        }
+        GF_FREE(event_pool->pinned);
+    }
+
     for (i = 0; i < EVENT_EPOLL_TABLES; i++) {
         if (event_pool->ereg[i]) {
             table = event_pool->ereg[i];
@@ -1001,6 +1287,18 @@ event_handled_epoll(struct event_pool *event_pool, int fd, int idx, int gen)
            thread calling event_select_on_epoll() while this
            thread was busy in handler()
         */
+        /* The handler keeps the fd after an EPOLLERR (e.g. it only had
+         * to drain the error queue), so the next errors must reach it. */
+        slot->handled_error = 0;
+
+        if (event_pool->pinned) {
+            /* nothing to re-arm, but a rebalance may have been waiting for
+             * the handler to return */
+            if (slot->in_handler == 0)
+                __event_slot_move(event_pool, slot, idx);
+            goto unlock;
+        }
+
         if (slot->in_handler == 0) {
             epoll_event.events = slot->events;
             ev_data->idx = idx;
@@ -1017,6 +1315,73 @@ unlock:
     return ret;
 }
 
+static int
+event_pin_threads_epoll(struct event_pool *event_pool)
+{
+    struct event_poller_epoll *pinned = NULL;
+    int count = 0;
+    int ret = -1;
+    int i = 0;
+
+    pthread_mutex_lock(&event_pool->mutex);
+    {
+        if (event_pool->pinned) {
+            ret = 0;
+            goto unlock;
+        }
+
+        /* fds already in the shared epoll instance can't be told apart
+         * from the ones that would be added to the per-thread ones */
+        if (event_pool_dispatched_unlocked(event_pool) || event_pool->destroy)
+            goto unlock;
+        for (i = 0; i < EVENT_EPOLL_TABLES; i++) {
+            if (event_pool->slots_used[i])
+                goto unlock;
+        }
+
+        pinned = GF_CALLOC(EVENT_MAX_THREADS, sizeof(*pinned),
+                           gf_common_mt_event_pool);
+        if (!pinned)
+            goto unlock;
+
+        for (i = 0; i < EVENT_MAX_THREADS; i++) {
+            pinned[i].epfd = -1;
+            pinned[i].wakefd = -1;
+            GF_ATOMIC_INIT(pinned[i].load, 0);
+        }
+        event_pool->pinned = pinned;
+
+        count = event_pool->eventthreadcount;
+        if (count > EVENT_MAX_THREADS)
+            count = EVENT_MAX_THREADS;
+        if (count <= 0)
+            count = 1;
+
+        for (i = 0; i < count; i++) {
+            if (__event_poller_init(event_pool, i))
+                break;
+        }
+
+        if (i < count) {
+            for (i = 0; i < count; i++) {
+                if (pinned[i].wakefd != -1)
+                    sys_close(pinned[i].wakefd);
+                if (pinned[i].epfd != -1)
+                    sys_close(pinned[i].epfd);
+            }
+            event_pool->pinned = NULL;
+            GF_FREE(pinned);
+            goto unlock;
+        }
+
+        ret = 0;
+    }
+unlock:
+    pthread_mutex_unlock(&event_pool->mutex);
+
+    return ret;
+}
+
 struct event_ops event_ops_epoll = {
     .new = event_pool_new_epoll,
     .event_register = event_register_epoll,
@@ -1027,6 +1392,7 @@ struct event_ops event_ops_epoll = {
     .event_reconfigure_threads = event_reconfigure_threads_epoll,
     .event_pool_destroy = event_pool_destroy_epoll,
     .event_handled = event_handled_epoll,
+    .event_pin_threads = event_pin_threads_epoll,
 };
 
 #endif
@@ -303,3 +303,20 @@ gf_event_handled(struct event_pool *event_pool, int fd, int idx, int gen)
 
     return ret;
 }
+
+/* Gives every event thread its own epoll instance and spreads the fds over
+ * them, so an fd is always handled by the same thread. Must be called before
+ * any fd is registered; returns -1 when the event backend can't do it. */
+int
+gf_event_pin_threads(struct event_pool *event_pool)
+{
+    int ret = -1;
+
+    GF_VALIDATE_OR_GOTO("event", event_pool, out);
+
+    if (event_pool->ops->event_pin_threads)
+        ret = event_pool->ops->event_pin_threads(event_pool);
+
+out:
+    return ret;
+}
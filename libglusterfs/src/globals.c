@@ -314,6 +314,8 @@ glusterfs_cleanup(void *ptr)
         GF_FREE(thread_syncopctx.groups);
     }
 
+    iobuf_tcache_destructor();
+
     mem_pool_thread_destructor(NULL);
 }
 
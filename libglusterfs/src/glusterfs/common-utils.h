@@ -130,6 +130,7 @@ trap(void);
 /* Default value of signing waiting time to sign a file for bitrot */
 #define SIGNING_TIMEOUT "120"
 #define BR_WORKERS "4"
+#define BR_SIGNATURE_HASH "sha256"
 
 /* xxhash */
 #define GF_XXH64_DIGEST_LENGTH 8
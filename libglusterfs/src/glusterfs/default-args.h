@@ -452,4 +452,16 @@ args_copy_file_range_store(default_args_t *args, fd_t *fd_in, off64_t off_in,
 
 void
 args_cbk_init(default_args_cbk_t *args_cbk);
+
+compound_args_t *
+compound_fop_alloc(unsigned int length);
+
+void
+compound_args_cleanup(compound_args_t *args);
+
+compound_args_cbk_t *
+compound_args_cbk_alloc(unsigned int length, dict_t *xdata);
+
+void
+compound_args_cbk_cleanup(compound_args_cbk_t *args_cbk);
 #endif /* _DEFAULT_ARGS_H */
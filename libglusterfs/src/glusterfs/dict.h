@@ -91,16 +91,31 @@ typedef struct _data_pair data_pair_t;
 #define DICT_DATA_HDR_KEY_LEN 4
 #define DICT_DATA_HDR_VAL_LEN 4
 
+/* Values up to this size (e.g. formatted integers) are kept inside the
+ * data_t itself instead of in a separate allocation. */
+#define GF_DATA_INLINE_LEN 24
+
+/* Storage embedded in every dict_t, enough for the typical xdata of a fop
+ * to be built without any allocation besides the dict and its values:
+ * - GF_DICT_INLINE_SLOTS: initial size of the open-addressing index, must
+ *   be a power of two.
+ * - GF_DICT_INLINE_PAIRS: pairs handed out before the pair pool is used.
+ * - GF_DICT_INLINE_KEYS: bytes of key storage before keys are malloc'ed.
+ */
+#define GF_DICT_INLINE_SLOTS 16
+#define GF_DICT_INLINE_PAIRS 8
+#define GF_DICT_INLINE_KEYS 256
+
 struct _data {
     char *data;
     gf_atomic_t refcount;
     gf_dict_data_type_t data_type;
     uint32_t len;
     gf_boolean_t is_static;
+    char inline_value[GF_DATA_INLINE_LEN];
 };
 
 struct _data_pair {
-    struct _data_pair *hash_next;
     struct _data_pair *prev;
     struct _data_pair *next;
     data_t *value;
@@ -110,17 +125,25 @@ struct _data_pair {
 
 struct _dict {
     uint64_t max_count;
+    /* number of slots in 'members', always a power of two */
     int32_t hash_size;
     int32_t count;
     gf_atomic_t refcount;
+    /* open-addressing (linear probing) index of the pairs, either
+     * members_internal or a separately allocated array once grown */
     data_pair_t **members;
     data_pair_t *members_list;
     char *extra_stdfree;
     gf_lock_t lock;
-    data_pair_t *members_internal;
-    data_pair_t free_pair;
     /* Variable to store total keylen + value->len */
     uint32_t totkvlen;
+    /* bitmap of the entries of pairs_internal[] in use */
+    uint32_t pairs_used;
+    /* bytes of key_arena[] handed out */
+    uint32_t keys_used;
+    data_pair_t *members_internal[GF_DICT_INLINE_SLOTS];
+    data_pair_t pairs_internal[GF_DICT_INLINE_PAIRS];
+    char key_arena[GF_DICT_INLINE_KEYS];
 };
 
 typedef gf_boolean_t (*dict_match_t)(dict_t *d, char *k, data_t *v, void *data);
@@ -19,6 +19,7 @@ struct event_pool;
 struct event_ops;
 struct event_slot_poll;
 struct event_slot_epoll;
+struct event_poller_epoll;
 struct event_data {
     int idx;
     int gen;
@@ -82,6 +83,11 @@ struct event_pool {
      * TBD: consider auto-scaling for clients as well
      */
     int auto_thread_count;
+
+    /* With pinned event threads every thread polls its own epoll
+     * instance and each fd is handled by exactly one of them; NULL while
+     * all threads share event_pool->fd. */
+    struct event_poller_epoll *pinned;
 };
 
 struct event_destroy_data {
@@ -111,6 +117,7 @@ struct event_ops {
     int (*event_pool_destroy)(struct event_pool *event_pool);
     int (*event_handled)(struct event_pool *event_pool, int fd, int idx,
                          int gen);
+    int (*event_pin_threads)(struct event_pool *event_pool);
 };
 
 struct event_pool *
@@ -136,5 +143,7 @@ int
 gf_event_dispatch_destroy(struct event_pool *event_pool);
 int
 gf_event_handled(struct event_pool *event_pool, int fd, int idx, int gen);
+int
+gf_event_pin_threads(struct event_pool *event_pool);
 
 #endif /* _GF_EVENT_H_ */
@@ -534,6 +534,7 @@ struct _cmd_args {
     unsigned uid_map_root;
     int32_t lru_limit;
     int32_t invalidate_limit;
+    uint64_t fuse_max_write;
     int background_qlen;
     int congestion_threshold;
     char *fuse_mountopts;
@@ -581,6 +582,7 @@ struct _cmd_args {
 
     bool global_threading;
     bool brick_mux;
+    bool event_pinning;
 
     uint32_t fuse_dev_eperm_ratelimit_ns;
 };
@@ -18,6 +18,8 @@
 #define LOOKUP_NOT_NEEDED 2
 
 #define DEFAULT_INODE_MEMPOOL_ENTRIES 32 * 1024
+/* number of locks striped over the buckets of each of the hash tables */
+#define GF_INODE_HASH_SHARDS 64
 #define INODE_PATH_FMT "<gfid:%s>"
 struct _inode_table;
 typedef struct _inode_table inode_table_t;
@@ -42,6 +44,11 @@ struct _inode_table {
     uint32_t lru_limit; /* maximum LRU cache size */
     struct list_head *inode_hash; /* buckets for inode hash table */
     struct list_head *name_hash;  /* buckets for dentry hash table */
+    /* Modifying a hash chain requires both table->lock and the shard lock
+     * of the bucket, so lookups which only need to find an already active
+     * inode can walk the chain holding nothing but the shard lock. */
+    pthread_mutex_t inode_hash_lock[GF_INODE_HASH_SHARDS];
+    pthread_mutex_t name_hash_lock[GF_INODE_HASH_SHARDS];
     struct list_head active; /* list of inodes currently active (in an fop) */
     uint32_t active_size;    /* count of inodes in active list */
     struct list_head lru;    /* list of inodes recently used.
@@ -90,10 +97,10 @@ struct _inode_ctx {
         uint64_t value2;
         void *ptr2;
     };
-    int ref; /* This is for debugging inode ref leaks,
-                basically helps in identifying the xlator
-                causing th ref leak, it is printed in
-                statedump */
+    gf_atomic_int32_t ref; /* This is for debugging inode ref leaks,
+                              basically helps in identifying the xlator
+                              causing th ref leak, it is printed in
+                              statedump */
 };
 
 struct _inode {
@@ -103,7 +110,8 @@ struct _inode {
     gf_atomic_t nlookup;
     uint32_t fd_count;            /* Open fd count */
     uint32_t active_fd_count;     /* Active open fd count */
-    uint32_t ref;                 /* reference count on this inode */
+    gf_atomic_uint32_t ref;       /* reference count on this inode. It only
+                                     moves from/to 0 under table->lock */
     ia_type_t ia_type;            /* what kind of file */
     struct list_head fd_list;     /* list of open files on this inode */
     struct list_head dentry_list; /* list of directory entries for this inode */
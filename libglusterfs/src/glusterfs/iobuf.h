@@ -22,6 +22,9 @@
 
 #define GF_RDMA_DEVICE_COUNT 8
 
+/* upper bound on the number of iobufs a thread caches per page size */
+#define GF_IOBUF_TCACHE_MAX 16
+
 /* Lets try to define the new anonymous mapping
  * flag, in case the system is still using the
  * now deprecated MAP_ANON flag.
@@ -105,6 +108,30 @@ struct iobuf_arena {
     int max_active; /* max active buffers at a given time */
 };
 
+/* per-thread cache ("magazine") of free iobufs of one page size. iobufs
+ * parked here still count as active in their arena, they are only handed
+ * back to the arena in batches when the bin overflows or the thread exits */
+struct iobuf_tcache_bin {
+    struct iobuf *iobufs[GF_IOBUF_TCACHE_MAX];
+    int count;
+    int limit; /* 0 disables caching for this page size */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t refills;
+    uint64_t drains;
+};
+
+struct iobuf_tcache {
+    struct list_head list; /* iobuf_pool->tcaches */
+    struct iobuf_pool *iobuf_pool;
+
+    /* only contended on pool destruction, the owner thread is the only one
+     * doing get/put on the bins */
+    pthread_mutex_t lock;
+
+    struct iobuf_tcache_bin bins[GF_VARIABLE_IOBUF_COUNT];
+};
+
 struct iobuf_pool {
     pthread_mutex_t mutex;
     size_t arena_size;        /* size of memory region in
@@ -124,6 +151,9 @@ struct iobuf_pool {
 
     uint64_t request_misses; /* mostly the requests for higher
                                value of iobufs */
+
+    struct list_head tcaches; /* per-thread caches bound to this pool,
+                                 protected by the global tcache lock */
     int arena_cnt;
     int rdma_device_count;
     struct list_head *mr_list[GF_RDMA_DEVICE_COUNT];
@@ -146,6 +176,8 @@ void
 iobuf_pool_destroy(struct iobuf_pool *iobuf_pool);
 void
 iobuf_to_iovec(struct iobuf *iob, struct iovec *iov);
+void
+iobuf_tcache_destructor(void);
 
 #define iobuf_ptr(iob) ((iob)->ptr)
 #define iobpool_default_pagesize(iobpool) ((iobpool)->default_page_size)
@@ -14,6 +14,8 @@
 #include <inttypes.h>
 #include <time.h>
 
+#include "glusterfs/atomic.h"
+
 typedef struct _gf_latency {
     uint64_t min;   /* min time for the call (nanoseconds) */
     uint64_t max;   /* max time for the call (nanoseconds) */
@@ -21,6 +23,24 @@ typedef struct _gf_latency {
     uint64_t count;
 } gf_latency_t;
 
+/* Log-linear latency histogram. Values below GF_LATENCY_HIST_SUB_BUCKETS are
+ * counted exactly; above that each power of two is split in
+ * GF_LATENCY_HIST_SUB_BUCKETS buckets of equal width, so the error of a
+ * reported percentile is bounded by 1/(2 * GF_LATENCY_HIST_SUB_BUCKETS) of
+ * its value. Values of 2^GF_LATENCY_HIST_MAX_BITS and above are accounted in
+ * the last bucket. Updates are a single atomic increment, so histograms can
+ * be shared between threads without any lock. */
+#define GF_LATENCY_HIST_SUB_BITS 3
+#define GF_LATENCY_HIST_SUB_BUCKETS (1 << GF_LATENCY_HIST_SUB_BITS)
+#define GF_LATENCY_HIST_MAX_BITS 32
+#define GF_LATENCY_HIST_BUCKETS                                                \
+    ((GF_LATENCY_HIST_MAX_BITS - GF_LATENCY_HIST_SUB_BITS + 1)                 \
+     << GF_LATENCY_HIST_SUB_BITS)
+
+typedef struct _gf_latency_hist {
+    gf_atomic_t buckets[GF_LATENCY_HIST_BUCKETS];
+} gf_latency_hist_t;
+
 gf_latency_t *
 gf_latency_new(size_t n);
 
@@ -30,4 +50,16 @@ gf_latency_reset(gf_latency_t *lat);
 void
 gf_latency_update(gf_latency_t *lat, struct timespec *begin,
                   struct timespec *end);
+
+void
+gf_latency_hist_reset(gf_latency_hist_t *hist);
+
+void
+gf_latency_hist_update(gf_latency_hist_t *hist, uint64_t value);
+
+uint64_t
+gf_latency_hist_count(gf_latency_hist_t *hist);
+
+uint64_t
+gf_latency_hist_percentile(gf_latency_hist_t *hist, double percentile);
 #endif /* __LATENCY_H__ */
@@ -22,6 +22,21 @@
 #define SYNCENV_PROC_MIN 2
 #define SYNCPROC_IDLE_TIME 600
 
+/* released stacks kept for reuse, per processor of a syncenv */
+#define SYNCENV_STACKS_PER_PROC 4
+
+/*
+ * Where the architecture allows it, tasks are switched by saving and
+ * restoring the callee-saved registers only. swapcontext() also saves and
+ * restores the signal mask, which takes a system call on every switch.
+ * Address sanitizer and shadow stacks need to be told about the switches,
+ * so they keep using swapcontext().
+ */
+#if (defined(__x86_64__) || defined(__aarch64__)) && defined(__ELF__) &&     \
+    !defined(__SANITIZE_ADDRESS__) && !(defined(__CET__) && (__CET__ & 2))
+#define SYNCTASK_FAST_SWITCH 1
+#endif
+
 /*
  * Flags for syncopctx valid elements
  */
@@ -45,6 +60,14 @@ typedef int (*synctask_cbk_t)(int ret, call_frame_t *frame, void *opaque);
 
 typedef int (*synctask_fn_t)(void *opaque);
 
+#ifdef SYNCTASK_FAST_SWITCH
+typedef struct {
+    void *sp; /* callee-saved registers are pushed on the stack */
+} synctask_context_t;
+#else
+typedef ucontext_t synctask_context_t;
+#endif
+
 typedef enum {
     SYNCTASK_INIT = 0,
     SYNCTASK_RUN,
@@ -68,6 +91,7 @@ struct synctask {
     struct synccond *synccond;
     void *opaque;
     void *stack;
+    size_t stacksize;
     synctask_state_t state;
     int woken;
     int slept;
@@ -83,7 +107,7 @@ struct synctask {
     } tsan;
 #endif
 
-    ucontext_t ctx;
+    synctask_context_t ctx;
     struct syncproc *proc;
 
     pthread_mutex_t mutex; /* for synchronous spawning of synctask */
@@ -103,7 +127,7 @@ struct syncproc {
     } tsan;
 #endif
 
-    ucontext_t sched;
+    synctask_context_t sched;
     struct syncenv *env;
     struct synctask *current;
 };
@@ -128,6 +152,10 @@ struct syncenv {
 
     size_t stacksize;
 
+    void **stacks; /* released stacks of @stacksize, ready for new tasks */
+    int stacks_count;
+    int stacks_max;
+
     int destroy; /* FLAG to mark syncenv is in destroy mode
                     so that no more synctasks are accepted*/
 };
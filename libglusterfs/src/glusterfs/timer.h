@@ -16,8 +16,33 @@
 #include <sys/time.h>
 #include <pthread.h>
 
+#ifdef URCU_OLD
+#include "wfstack.h"
+#else
+#include <urcu/wfstack.h>
+#endif
+
+/* Timers are kept in a hierarchical timing wheel with a resolution of
+ * GF_TIMER_WHEEL_TICK nanoseconds. Each level has GF_TIMER_WHEEL_SLOTS slots,
+ * and a slot of level 'n' covers GF_TIMER_WHEEL_SLOTS^n ticks. A timer is
+ * placed in the lowest level where it doesn't wrap around, and it's moved
+ * down to the lower levels as the time advances, so adding, cancelling and
+ * expiring a timer are O(1) regardless of the number of pending timers. */
+#define GF_TIMER_WHEEL_TICK 1000000ULL
+#define GF_TIMER_WHEEL_BITS 6
+#define GF_TIMER_WHEEL_SLOTS (1 << GF_TIMER_WHEEL_BITS)
+#define GF_TIMER_WHEEL_LEVELS                                                  \
+    ((64 + GF_TIMER_WHEEL_BITS - 1) / GF_TIMER_WHEEL_BITS)
+
 typedef void (*gf_timer_cbk_t)(void *);
 
+typedef enum {
+    GF_TIMER_QUEUED,    /* added, not yet moved into the wheel */
+    GF_TIMER_ARMED,     /* in the wheel or in the expired list */
+    GF_TIMER_CANCELLED, /* cancelled before being moved into the wheel */
+    GF_TIMER_FIRED,     /* the callback is being called */
+} gf_timer_state_t;
+
 struct _gf_timer {
     union {
         struct list_head list;
@@ -26,18 +51,28 @@ struct _gf_timer {
             struct _gf_timer *prev;
         };
     };
+    struct cds_wfs_node queued;
     struct timespec at;
     gf_timer_cbk_t callbk;
     void *data;
     xlator_t *xl;
-    gf_boolean_t fired;
+    uint64_t expires; /* in ticks */
+    int32_t slot;     /* in the wheel, or -1 if already expired */
+    int32_t state;    /* gf_timer_state_t */
 };
 
 struct _gf_timer_registry {
-    struct list_head active;
+    /* Timers are pushed here without taking the lock, and moved into the
+     * wheel by the timer thread. */
+    struct __cds_wfs_stack queued;
     pthread_mutex_t lock;
     pthread_cond_t cond;
     pthread_t th;
+    uint64_t next_wakeup; /* next wake up of the timer thread, in ticks */
+    uint64_t now;         /* time of the wheel, in ticks */
+    uint64_t busy[GF_TIMER_WHEEL_LEVELS]; /* bitmaps of non-empty slots */
+    struct list_head wheel[GF_TIMER_WHEEL_LEVELS * GF_TIMER_WHEEL_SLOTS];
+    struct list_head expired;
     char fin;
 };
 
@@ -161,15 +161,33 @@ hash_gfid(uuid_t uuid, int mod)
     return ((uuid[15] + (uuid[14] << 8)) % mod);
 }
 
+static pthread_mutex_t *
+__inode_hash_shard(inode_table_t *table, const int hash)
+{
+    return &table->inode_hash_lock[hash % GF_INODE_HASH_SHARDS];
+}
+
+static pthread_mutex_t *
+__name_hash_shard(inode_table_t *table, const int hash)
+{
+    return &table->name_hash_lock[hash % GF_INODE_HASH_SHARDS];
+}
+
 static void
 __dentry_hash(dentry_t *dentry, const int hash)
 {
     inode_table_t *table = NULL;
+    pthread_mutex_t *shard = NULL;
 
     table = dentry->inode->table;
+    shard = __name_hash_shard(table, hash);
 
-    list_del_init(&dentry->hash);
-    list_add(&dentry->hash, &table->name_hash[hash]);
+    pthread_mutex_lock(shard);
+    {
+        list_del_init(&dentry->hash);
+        list_add(&dentry->hash, &table->name_hash[hash]);
+    }
+    pthread_mutex_unlock(shard);
 }
 
 static int
@@ -181,7 +199,23 @@ __is_dentry_hashed(dentry_t *dentry)
 static void
 __dentry_unhash(dentry_t *dentry)
 {
-    list_del_init(&dentry->hash);
+    inode_table_t *table = NULL;
+    pthread_mutex_t *shard = NULL;
+    int hash = 0;
+
+    if (!__is_dentry_hashed(dentry))
+        return;
+
+    /* a hashed dentry always has its parent set */
+    table = dentry->inode->table;
+    hash = hash_dentry(dentry->parent, dentry->name, table->hashsize);
+    shard = __name_hash_shard(table, hash);
+
+    pthread_mutex_lock(shard);
+    {
+        list_del_init(&dentry->hash);
+    }
+    pthread_mutex_unlock(shard);
 }
 
 static void
@@ -282,25 +316,43 @@ __is_dentry_cyclic(dentry_t *dentry)
     return ret;
 }
 
-static void
-__inode_unhash(inode_t *inode)
-{
-    list_del_init(&inode->hash);
-}
-
 static int
 __is_inode_hashed(inode_t *inode)
 {
     return !list_empty(&inode->hash);
 }
 
+static void
+__inode_unhash(inode_t *inode)
+{
+    pthread_mutex_t *shard = NULL;
+
+    if (!__is_inode_hashed(inode))
+        return;
+
+    shard = __inode_hash_shard(inode->table, hash_gfid(inode->gfid, 65536));
+
+    pthread_mutex_lock(shard);
+    {
+        list_del_init(&inode->hash);
+    }
+    pthread_mutex_unlock(shard);
+}
+
 static void
 __inode_hash(inode_t *inode, const int hash)
 {
     inode_table_t *table = inode->table;
+    pthread_mutex_t *shard = NULL;
+
+    shard = __inode_hash_shard(table, hash);
 
-    list_del_init(&inode->hash);
-    list_add(&inode->hash, &table->inode_hash[hash]);
+    pthread_mutex_lock(shard);
+    {
+        list_del_init(&inode->hash);
+        list_add(&inode->hash, &table->inode_hash[hash]);
+    }
+    pthread_mutex_unlock(shard);
 }
 
 static dentry_t *
@@ -462,6 +514,7 @@ __inode_unref(inode_t *inode, bool clear)
     int index = 0;
     xlator_t *this = NULL;
     uint64_t nlookup = 0;
+    uint32_t ref = 0;
 
     /*
      * Root inode should always be in active list of inode table. So unrefs
@@ -475,7 +528,7 @@ __inode_unref(inode_t *inode, bool clear)
      * as __inode_unref is called after acquiding
      * the inode table's lock.
      */
-    if (inode->table->cleanup_started && !inode->ref)
+    if (inode->table->cleanup_started && !GF_ATOMIC_GET(inode->ref))
         /*
          * There is a good chance that, the inode
          * on which unref came has already been
@@ -512,17 +565,17 @@ __inode_unref(inode_t *inode, bool clear)
         inode->table->invalidate_size--;
         __inode_activate(inode);
     }
-    GF_ASSERT(inode->ref);
+    GF_ASSERT(GF_ATOMIC_GET(inode->ref));
 
-    --inode->ref;
+    ref = GF_ATOMIC_DEC(inode->ref);
 
     index = __inode_get_xl_index(inode, this);
     if (index >= 0) {
         inode->_ctx[index].xl_key = this;
-        inode->_ctx[index].ref--;
+        GF_ATOMIC_DEC(inode->_ctx[index].ref);
     }
 
-    if (!inode->ref && !inode->in_invalidate_list) {
+    if (!ref && !inode->in_invalidate_list) {
         inode->table->active_size--;
 
         nlookup = GF_ATOMIC_GET(inode->nlookup);
@@ -554,10 +607,10 @@ __inode_ref(inode_t *inode, bool is_invalidate)
      * in inode table increases which is wrong. So just keep the ref
      * count as 1 always
      */
-    if (__is_root_gfid(inode->gfid) && inode->ref)
+    if (__is_root_gfid(inode->gfid) && GF_ATOMIC_GET(inode->ref))
         return inode;
 
-    if (!inode->ref) {
+    if (!GF_ATOMIC_GET(inode->ref)) {
         if (inode->in_invalidate_list) {
             inode->in_invalidate_list = false;
             inode->table->invalidate_size--;
@@ -573,17 +626,48 @@ __inode_ref(inode_t *inode, bool is_invalidate)
         }
     }
 
-    inode->ref++;
+    GF_ATOMIC_INC(inode->ref);
 
     index = __inode_get_xl_index(inode, this);
     if (index >= 0) {
         inode->_ctx[index].xl_key = this;
-        inode->_ctx[index].ref++;
+        GF_ATOMIC_INC(inode->_ctx[index].ref);
     }
 
     return inode;
 }
 
+/* Takes or drops a reference without table->lock. This is only possible
+ * when the inode stays active, i.e. when the count neither moves from nor
+ * to zero (which would need the active/lru lists to be updated), and when
+ * the calling xlator already owns its ctx slot. Returns false if the
+ * caller has to go through the locked path. */
+static bool
+inode_ref_fast(inode_t *inode, int32_t delta)
+{
+    xlator_t *this = NULL;
+    uint32_t ref = 0;
+
+    if (inode == inode->table->root) {
+        /* see __inode_ref() and __inode_unref() */
+        return (delta < 0) || GF_ATOMIC_GET(inode->ref);
+    }
+
+    this = THIS;
+    if (inode->_ctx[this->xl_id].xl_key != this)
+        return false;
+
+    do {
+        ref = GF_ATOMIC_GET(inode->ref);
+        if ((ref == 0) || ((delta < 0) && (ref == 1)))
+            return false;
+    } while (!GF_ATOMIC_CMP_SWAP(inode->ref, ref, ref + delta));
+
+    GF_ATOMIC_ADD(inode->_ctx[this->xl_id].ref, delta);
+
+    return true;
+}
+
 inode_t *
 inode_unref(inode_t *inode)
 {
@@ -592,6 +676,10 @@ inode_unref(inode_t *inode)
     if (!inode)
         return NULL;
 
+    /* nothing to passivate or purge if this is not the last reference */
+    if (inode_ref_fast(inode, -1))
+        return inode;
+
     table = inode->table;
 
     pthread_mutex_lock(&table->lock);
@@ -613,6 +701,9 @@ inode_ref(inode_t *inode)
     if (!inode)
         return NULL;
 
+    if (inode_ref_fast(inode, 1))
+        return inode;
+
     table = inode->table;
 
     pthread_mutex_lock(&table->lock);
@@ -722,15 +813,16 @@ static inode_t *
 __inode_ref_reduce_by_n(inode_t *inode, uint64_t nref)
 {
     uint64_t nlookup = 0;
+    uint32_t ref = 0;
 
-    GF_ASSERT(inode->ref >= nref);
-
-    inode->ref -= nref;
+    GF_ASSERT(GF_ATOMIC_GET(inode->ref) >= nref);
 
     if (!nref)
-        inode->ref = 0;
+        GF_ATOMIC_INIT(inode->ref, 0);
+    else
+        ref = GF_ATOMIC_SUB(inode->ref, nref);
 
-    if (!inode->ref) {
+    if (!ref) {
         inode->table->active_size--;
 
         nlookup = GF_ATOMIC_GET(inode->nlookup);
@@ -793,6 +885,20 @@ inode_grep(inode_table_t *table, inode_t *parent, const char *name)
     }
 
     int hash = hash_dentry(parent, name, table->hashsize);
+    pthread_mutex_t *shard = __name_hash_shard(table, hash);
+
+    pthread_mutex_lock(shard);
+    {
+        dentry = __dentry_grep(table, parent, name, hash);
+        if (dentry)
+            inode = dentry->inode;
+        if (inode && !inode_ref_fast(inode, 1))
+            inode = NULL;
+    }
+    pthread_mutex_unlock(shard);
+
+    if (inode || !dentry)
+        return inode;
 
     pthread_mutex_lock(&table->lock);
     {
@@ -869,8 +975,11 @@ inode_grep_for_gfid(inode_table_t *table, inode_t *parent, const char *name,
     }
 
     int hash = hash_dentry(parent, name, table->hashsize);
+    pthread_mutex_t *shard = __name_hash_shard(table, hash);
 
-    pthread_mutex_lock(&table->lock);
+    /* the inode of a hashed dentry cannot be retired while the shard lock
+     * is held, no reference is needed just to read its identity */
+    pthread_mutex_lock(shard);
     {
         dentry = __dentry_grep(table, parent, name, hash);
         if (dentry) {
@@ -882,7 +991,7 @@ inode_grep_for_gfid(inode_table_t *table, inode_t *parent, const char *name,
             }
         }
     }
-    pthread_mutex_unlock(&table->lock);
+    pthread_mutex_unlock(shard);
 
     return ret;
 }
@@ -933,6 +1042,21 @@ inode_find(inode_table_t *table, uuid_t gfid)
     }
 
     int hash = hash_gfid(gfid, 65536);
+    pthread_mutex_t *shard = __inode_hash_shard(table, hash);
+    bool found = false;
+
+    pthread_mutex_lock(shard);
+    {
+        inode = __inode_find(table, gfid, hash);
+        found = (inode != NULL);
+        if (inode && !inode_ref_fast(inode, 1))
+            inode = NULL;
+    }
+    pthread_mutex_unlock(shard);
+
+    /* inodes in the lru list need table->lock to be activated */
+    if (inode || !found)
+        return inode;
 
     pthread_mutex_lock(&table->lock);
     {
@@ -1715,6 +1839,11 @@ inode_table_with_invalidator(uint32_t lru_limit, xlator_t *xl,
         INIT_LIST_HEAD(&new->name_hash[i]);
     }
 
+    for (i = 0; i < GF_INODE_HASH_SHARDS; i++) {
+        pthread_mutex_init(&new->inode_hash_lock[i], NULL);
+        pthread_mutex_init(&new->name_hash_lock[i], NULL);
+    }
+
     INIT_LIST_HEAD(&new->active);
     INIT_LIST_HEAD(&new->lru);
     INIT_LIST_HEAD(&new->purge);
@@ -1850,6 +1979,7 @@ void
 inode_table_destroy(inode_table_t *inode_table)
 {
     inode_t *trav = NULL;
+    int i = 0;
 
     if (inode_table == NULL)
         return;
@@ -1915,7 +2045,7 @@ inode_table_destroy(inode_table_t *inode_table)
                                  LG_MSG_REF_COUNT,
                                  "Active inode(%p) with refcount"
                                  "(%d) found during cleanup",
-                                 trav, trav->ref);
+                                 trav, GF_ATOMIC_GET(trav->ref));
             inode_forget_atomic(trav, 0);
             __inode_ref_reduce_by_n(trav, 0);
         }
@@ -1934,6 +2064,10 @@ inode_table_destroy(inode_table_t *inode_table)
         mem_pool_destroy(inode_table->fd_mem_pool);
 
     pthread_mutex_destroy(&inode_table->lock);
+    for (i = 0; i < GF_INODE_HASH_SHARDS; i++) {
+        pthread_mutex_destroy(&inode_table->inode_hash_lock[i]);
+        pthread_mutex_destroy(&inode_table->name_hash_lock[i]);
+    }
 
     GF_FREE(inode_table->name);
     GF_FREE(inode_table);
@@ -2412,7 +2546,7 @@ inode_dump(inode_t *inode, char *prefix)
         gf_proc_dump_write("nlookup", "%" PRIu64, nlookup);
         gf_proc_dump_write("fd-count", "%u", inode->fd_count);
         gf_proc_dump_write("active-fd-count", "%u", inode->active_fd_count);
-        gf_proc_dump_write("ref", "%u", inode->ref);
+        gf_proc_dump_write("ref", "%u", GF_ATOMIC_GET(inode->ref));
         gf_proc_dump_write("invalidate-sent", "%d", inode->invalidate_sent);
         gf_proc_dump_write("ia_type", "%d", inode->ia_type);
         if (inode->_ctx) {
@@ -2425,7 +2559,7 @@ inode_dump(inode_t *inode, char *prefix)
             for (i = 0; i < inode->table->ctxcount; i++) {
                 inode_ctx[i] = inode->_ctx[i];
                 xl = inode_ctx[i].xl_key;
-                ref = inode_ctx[i].ref;
+                ref = GF_ATOMIC_GET(inode_ctx[i].ref);
                 if (ref != 0 && xl) {
                     gf_proc_dump_build_key(key, "ref_by_xl:", "%s", xl->name);
                     gf_proc_dump_write(key, "%d", ref);
@@ -2523,7 +2657,7 @@ inode_dump_to_dict(inode_t *inode, char *prefix, dict_t *dict)
         goto out;
 
     snprintf(key, sizeof(key), "%s.ref", prefix);
-    ret = dict_set_uint32(dict, key, inode->ref);
+    ret = dict_set_uint32(dict, key, GF_ATOMIC_GET(inode->ref));
     if (ret)
         goto out;
 
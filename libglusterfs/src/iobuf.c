@@ -20,6 +20,12 @@
 #define IOBUF_ARENA_MAX_INDEX                                                  \
     (sizeof(gf_iobuf_init_config) / (sizeof(struct iobuf_init_config)))
 
+/* global lock protecting iobuf_pool->tcaches and the binding of a thread
+ * cache to its pool. Lock ordering: iobuf_tcache_lock -> tcache->lock ->
+ * iobuf_pool->mutex */
+static pthread_mutex_t iobuf_tcache_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread struct iobuf_tcache *thread_iobuf_tcache = NULL;
+
 /* Make sure this array is sorted based on pagesize */
 static const struct iobuf_init_config gf_iobuf_init_config[] = {
     /* { pagesize, num_pages }, */
@@ -58,6 +64,13 @@ gf_iobuf_get_pagesize(const size_t page_size, int *index)
     return -1;
 }
 
+static int
+gf_iobuf_tcache_limit(const int index)
+{
+    /* keep a thread from pinning more than 1/8th of an arena */
+    return min(gf_iobuf_init_config[index].num_pages / 8, GF_IOBUF_TCACHE_MAX);
+}
+
 static void
 __iobuf_arena_init_iobufs(struct iobuf_arena *iobuf_arena)
 {
@@ -235,16 +248,34 @@ __iobuf_pool_add_arena(struct iobuf_pool *iobuf_pool, const size_t page_size,
     return iobuf_arena;
 }
 
+static void
+__iobuf_put(struct iobuf *iobuf, struct iobuf_arena *iobuf_arena);
+static void
+__iobuf_tcache_release(struct iobuf_tcache *tcache);
+
 /* This function destroys all the iobufs and the iobuf_pool */
 void
 iobuf_pool_destroy(struct iobuf_pool *iobuf_pool)
 {
     struct iobuf_arena *iobuf_arena = NULL;
     struct iobuf_arena *tmp = NULL;
+    struct iobuf_tcache *tcache = NULL;
+    struct iobuf_tcache *tcache_tmp = NULL;
     int i = 0;
 
     GF_VALIDATE_OR_GOTO("iobuf", iobuf_pool, out);
 
+    /* hand back whatever the threads still cache from this pool */
+    pthread_mutex_lock(&iobuf_tcache_lock);
+    {
+        list_for_each_entry_safe(tcache, tcache_tmp, &iobuf_pool->tcaches,
+                                 list)
+        {
+            __iobuf_tcache_release(tcache);
+        }
+    }
+    pthread_mutex_unlock(&iobuf_tcache_lock);
+
     pthread_mutex_lock(&iobuf_pool->mutex);
     {
         for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
@@ -330,6 +361,7 @@ iobuf_pool_new(void)
     if (!iobuf_pool)
         goto out;
     INIT_LIST_HEAD(&iobuf_pool->all_arenas);
+    INIT_LIST_HEAD(&iobuf_pool->tcaches);
     pthread_mutex_init(&iobuf_pool->mutex, NULL);
     for (i = 0; i <= IOBUF_ARENA_MAX_INDEX; i++) {
         INIT_LIST_HEAD(&iobuf_pool->arenas[i]);
@@ -524,6 +556,228 @@ out:
     return iobuf;
 }
 
+/* Always called with tcache->lock and iobuf_pool->mutex held. Returns the
+ * @count coldest (bottom-most) iobufs of the bin to their arenas */
+static void
+__iobuf_tcache_drain(struct iobuf_tcache_bin *bin, int count)
+{
+    struct iobuf *iobuf = NULL;
+    int i = 0;
+
+    count = min(count, bin->count);
+    for (i = 0; i < count; i++) {
+        iobuf = bin->iobufs[i];
+        __iobuf_put(iobuf, iobuf->iobuf_arena);
+    }
+
+    bin->count -= count;
+    memmove(bin->iobufs, bin->iobufs + count,
+            bin->count * sizeof(*bin->iobufs));
+}
+
+/* Always called with iobuf_tcache_lock held */
+static void
+__iobuf_tcache_release(struct iobuf_tcache *tcache)
+{
+    struct iobuf_pool *iobuf_pool = NULL;
+    int i = 0;
+
+    pthread_mutex_lock(&tcache->lock);
+    {
+        iobuf_pool = tcache->iobuf_pool;
+        if (iobuf_pool) {
+            pthread_mutex_lock(&iobuf_pool->mutex);
+            {
+                for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++)
+                    __iobuf_tcache_drain(&tcache->bins[i],
+                                         tcache->bins[i].count);
+            }
+            pthread_mutex_unlock(&iobuf_pool->mutex);
+
+            list_del_init(&tcache->list);
+            tcache->iobuf_pool = NULL;
+        }
+    }
+    pthread_mutex_unlock(&tcache->lock);
+}
+
+/* Returns the cache of the calling thread if it can serve @iobuf_pool. A
+ * thread caches iobufs of a single pool at a time, it is rebound only once
+ * that pool has been destroyed. */
+static struct iobuf_tcache *
+iobuf_tcache_bind(struct iobuf_pool *iobuf_pool)
+{
+    struct iobuf_tcache *tcache = NULL;
+    int i = 0;
+
+    tcache = thread_iobuf_tcache;
+    if (tcache) {
+        if (tcache->iobuf_pool == iobuf_pool)
+            return tcache;
+        if (tcache->iobuf_pool)
+            return NULL;
+    } else {
+        tcache = CALLOC(1, sizeof(*tcache));
+        if (!tcache)
+            return NULL;
+
+        INIT_LIST_HEAD(&tcache->list);
+        pthread_mutex_init(&tcache->lock, NULL);
+        for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++)
+            tcache->bins[i].limit = gf_iobuf_tcache_limit(i);
+
+        thread_iobuf_tcache = tcache;
+
+        /* Make sure the cached iobufs are given back when the thread
+         * terminates. */
+        gf_thread_needs_cleanup();
+    }
+
+    pthread_mutex_lock(&iobuf_tcache_lock);
+    {
+        pthread_mutex_lock(&tcache->lock);
+        tcache->iobuf_pool = iobuf_pool;
+        pthread_mutex_unlock(&tcache->lock);
+
+        list_add(&tcache->list, &iobuf_pool->tcaches);
+    }
+    pthread_mutex_unlock(&iobuf_tcache_lock);
+
+    return tcache;
+}
+
+/* Serves an iobuf from the calling thread's cache. On a miss, half of the
+ * bin is refilled from the arenas under a single acquisition of the pool
+ * mutex. Returns NULL if the request has to go through the pool. */
+static struct iobuf *
+iobuf_tcache_get(struct iobuf_pool *iobuf_pool, const size_t page_size,
+                 const int index)
+{
+    struct iobuf_tcache *tcache = NULL;
+    struct iobuf_tcache_bin *bin = NULL;
+    struct iobuf *iobuf = NULL;
+    int batch = 0;
+
+    tcache = iobuf_tcache_bind(iobuf_pool);
+    if (!tcache)
+        return NULL;
+
+    bin = &tcache->bins[index];
+    if (!bin->limit)
+        return NULL;
+
+    pthread_mutex_lock(&tcache->lock);
+    {
+        if (tcache->iobuf_pool != iobuf_pool)
+            goto unlock;
+
+        if (bin->count) {
+            bin->hits++;
+        } else {
+            bin->misses++;
+            bin->refills++;
+
+            batch = max(bin->limit / 2, 1);
+            pthread_mutex_lock(&iobuf_pool->mutex);
+            {
+                while (bin->count < batch) {
+                    iobuf = __iobuf_get(iobuf_pool, page_size, index);
+                    if (!iobuf)
+                        break;
+                    bin->iobufs[bin->count++] = iobuf;
+                }
+            }
+            pthread_mutex_unlock(&iobuf_pool->mutex);
+        }
+
+        iobuf = NULL;
+        if (bin->count)
+            iobuf = bin->iobufs[--bin->count];
+    }
+unlock:
+    pthread_mutex_unlock(&tcache->lock);
+
+    if (iobuf)
+        iobuf_ref(iobuf);
+
+    return iobuf;
+}
+
+/* Parks a released iobuf in the calling thread's cache. When the bin is
+ * full, its colder half is drained back to the arenas in one go. Returns
+ * _gf_false if the iobuf has to be released to the pool instead. */
+static gf_boolean_t
+iobuf_tcache_put(struct iobuf *iobuf, struct iobuf_arena *iobuf_arena)
+{
+    struct iobuf_pool *iobuf_pool = NULL;
+    struct iobuf_tcache *tcache = NULL;
+    struct iobuf_tcache_bin *bin = NULL;
+    gf_boolean_t cached = _gf_false;
+    int index = 0;
+
+    index = gf_iobuf_get_arena_index(iobuf_arena->page_size);
+    if (index == -1)
+        return _gf_false;
+
+    iobuf_pool = iobuf_arena->iobuf_pool;
+    tcache = iobuf_tcache_bind(iobuf_pool);
+    if (!tcache)
+        return _gf_false;
+
+    bin = &tcache->bins[index];
+    if (!bin->limit)
+        return _gf_false;
+
+    pthread_mutex_lock(&tcache->lock);
+    {
+        if (tcache->iobuf_pool != iobuf_pool)
+            goto unlock;
+
+        if (bin->count == bin->limit) {
+            bin->drains++;
+            pthread_mutex_lock(&iobuf_pool->mutex);
+            {
+                __iobuf_tcache_drain(bin, max(bin->limit / 2, 1));
+            }
+            pthread_mutex_unlock(&iobuf_pool->mutex);
+        }
+
+        /* see iobuf_get_page_aligned() */
+        if (iobuf->free_ptr) {
+            iobuf->ptr = iobuf->free_ptr;
+            iobuf->free_ptr = NULL;
+        }
+
+        bin->iobufs[bin->count++] = iobuf;
+        cached = _gf_true;
+    }
+unlock:
+    pthread_mutex_unlock(&tcache->lock);
+
+    return cached;
+}
+
+void
+iobuf_tcache_destructor(void)
+{
+    struct iobuf_tcache *tcache = NULL;
+
+    tcache = thread_iobuf_tcache;
+    if (!tcache)
+        return;
+
+    pthread_mutex_lock(&iobuf_tcache_lock);
+    {
+        __iobuf_tcache_release(tcache);
+    }
+    pthread_mutex_unlock(&iobuf_tcache_lock);
+
+    pthread_mutex_destroy(&tcache->lock);
+    FREE(tcache);
+
+    thread_iobuf_tcache = NULL;
+}
+
 struct iobuf *
 iobuf_get2(struct iobuf_pool *iobuf_pool, size_t page_size)
 {
@@ -555,6 +809,10 @@ iobuf_get2(struct iobuf_pool *iobuf_pool, size_t page_size)
         return NULL;
     }
 
+    iobuf = iobuf_tcache_get(iobuf_pool, rounded_size, index);
+    if (iobuf)
+        goto post_unlock;
+
     pthread_mutex_lock(&iobuf_pool->mutex);
     {
         iobuf = __iobuf_get(iobuf_pool, rounded_size, index);
@@ -619,6 +877,11 @@ iobuf_get(struct iobuf_pool *iobuf_pool)
         return NULL;
     }
 
+    iobuf = iobuf_tcache_get(iobuf_pool, iobuf_pool->default_page_size,
+                             index);
+    if (iobuf)
+        goto out;
+
     pthread_mutex_lock(&iobuf_pool->mutex);
     {
         iobuf = __iobuf_get(iobuf_pool, iobuf_pool->default_page_size, index);
@@ -706,6 +969,9 @@ iobuf_put(struct iobuf *iobuf)
         return;
     }
 
+    if (iobuf_tcache_put(iobuf, iobuf_arena))
+        goto out;
+
     pthread_mutex_lock(&iobuf_pool->mutex);
     {
         __iobuf_put(iobuf, iobuf_arena);
@@ -1033,17 +1299,53 @@ out:
     return;
 }
 
+static void
+iobuf_tcache_stats_dump(struct iobuf_pool *iobuf_pool,
+                        struct iobuf_tcache_bin *totals, int *threads)
+{
+    struct iobuf_tcache *tcache = NULL;
+    struct iobuf_tcache_bin *bin = NULL;
+    int i = 0;
+
+    /* Counters are updated by their owner thread without synchronization,
+     * the totals might be slightly off, which is fine for a statedump. */
+    pthread_mutex_lock(&iobuf_tcache_lock);
+    {
+        list_for_each_entry(tcache, &iobuf_pool->tcaches, list)
+        {
+            for (i = 0; i < IOBUF_ARENA_MAX_INDEX; i++) {
+                bin = &tcache->bins[i];
+                totals[i].count += bin->count;
+                totals[i].hits += bin->hits;
+                totals[i].misses += bin->misses;
+                totals[i].refills += bin->refills;
+                totals[i].drains += bin->drains;
+            }
+            (*threads)++;
+        }
+    }
+    pthread_mutex_unlock(&iobuf_tcache_lock);
+}
+
 void
 iobuf_stats_dump(struct iobuf_pool *iobuf_pool)
 {
     char msg[1024];
+    char key[GF_DUMP_MAX_BUF_LEN];
     struct iobuf_arena *trav = NULL;
+    struct iobuf_tcache_bin tcache_totals[GF_VARIABLE_IOBUF_COUNT];
+    uint64_t lookups = 0;
+    int tcache_threads = 0;
     int i = 1;
     int j = 0;
     int ret = -1;
 
     GF_VALIDATE_OR_GOTO("iobuf", iobuf_pool, out);
 
+    /* must not be done with iobuf_pool->mutex held, see iobuf_tcache_lock */
+    memset(tcache_totals, 0, sizeof(tcache_totals));
+    iobuf_tcache_stats_dump(iobuf_pool, tcache_totals, &tcache_threads);
+
     ret = pthread_mutex_trylock(&iobuf_pool->mutex);
 
     if (ret) {
@@ -1058,6 +1360,31 @@ iobuf_stats_dump(struct iobuf_pool *iobuf_pool)
     gf_proc_dump_write("iobuf_pool.arena_cnt", "%d", iobuf_pool->arena_cnt);
     gf_proc_dump_write("iobuf_pool.request_misses", "%" PRId64,
                        iobuf_pool->request_misses);
+    gf_proc_dump_write("iobuf_pool.tcache.threads", "%d", tcache_threads);
+
+    for (j = 0; j < IOBUF_ARENA_MAX_INDEX; j++) {
+        if (!gf_iobuf_tcache_limit(j))
+            continue;
+
+        snprintf(msg, sizeof(msg), "iobuf_pool.tcache.%" GF_PRI_SIZET,
+                 gf_iobuf_init_config[j].pagesize);
+        lookups = tcache_totals[j].hits + tcache_totals[j].misses;
+
+        gf_proc_dump_build_key(key, msg, "cached");
+        gf_proc_dump_write(key, "%d", tcache_totals[j].count);
+        gf_proc_dump_build_key(key, msg, "hits");
+        gf_proc_dump_write(key, "%" PRIu64, tcache_totals[j].hits);
+        gf_proc_dump_build_key(key, msg, "misses");
+        gf_proc_dump_write(key, "%" PRIu64, tcache_totals[j].misses);
+        gf_proc_dump_build_key(key, msg, "hit_ratio");
+        gf_proc_dump_write(key, "%.2f",
+                           lookups ? (double)tcache_totals[j].hits / lookups
+                                   : 0.0);
+        gf_proc_dump_build_key(key, msg, "refills");
+        gf_proc_dump_write(key, "%" PRIu64, tcache_totals[j].refills);
+        gf_proc_dump_build_key(key, msg, "drains");
+        gf_proc_dump_write(key, "%" PRIu64, tcache_totals[j].drains);
+    }
 
     for (j = 0; j < IOBUF_ARENA_MAX_INDEX; j++) {
         list_for_each_entry(trav, &iobuf_pool->arenas[j], list)
@@ -82,3 +82,86 @@ gf_frame_latency_update(call_frame_t *frame)
     lat = &frame->this->stats.interval.latencies[frame->op];
     gf_latency_update(lat, &frame->begin, &frame->end);
 }
+
+static uint32_t
+gf_latency_hist_index(uint64_t value)
+{
+    uint32_t shift;
+
+    if (value < GF_LATENCY_HIST_SUB_BUCKETS)
+        return value;
+
+    shift = 63 - __builtin_clzll(value);
+    if (shift >= GF_LATENCY_HIST_MAX_BITS)
+        return GF_LATENCY_HIST_BUCKETS - 1;
+    shift -= GF_LATENCY_HIST_SUB_BITS;
+
+    return ((shift + 1) << GF_LATENCY_HIST_SUB_BITS) +
+           ((value >> shift) & (GF_LATENCY_HIST_SUB_BUCKETS - 1));
+}
+
+void
+gf_latency_hist_reset(gf_latency_hist_t *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+}
+
+void
+gf_latency_hist_update(gf_latency_hist_t *hist, uint64_t value)
+{
+    GF_ATOMIC_INC(hist->buckets[gf_latency_hist_index(value)]);
+}
+
+uint64_t
+gf_latency_hist_count(gf_latency_hist_t *hist)
+{
+    uint64_t count = 0;
+    uint32_t i;
+
+    for (i = 0; i < GF_LATENCY_HIST_BUCKETS; i++)
+        count += GF_ATOMIC_GET(hist->buckets[i]);
+
+    return count;
+}
+
+/* Returns the value below which 'percentile' percent of the samples are,
+ * using the middle of the bucket where it falls, or 0 if the histogram is
+ * empty. */
+uint64_t
+gf_latency_hist_percentile(gf_latency_hist_t *hist, double percentile)
+{
+    uint64_t count, rank, seen;
+    uint32_t i, shift;
+    double target;
+
+    count = gf_latency_hist_count(hist);
+    if (count == 0)
+        return 0;
+
+    /* rank of the sample, rounded up */
+    target = percentile * count / 100.0;
+    rank = (uint64_t)target;
+    if (rank < target)
+        rank++;
+    if (rank == 0)
+        rank = 1;
+    else if (rank > count)
+        rank = count;
+
+    seen = 0;
+    for (i = 0; i < GF_LATENCY_HIST_BUCKETS - 1; i++) {
+        seen += GF_ATOMIC_GET(hist->buckets[i]);
+        if (seen >= rank)
+            break;
+    }
+
+    if (i < GF_LATENCY_HIST_SUB_BUCKETS)
+        return i;
+
+    shift = (i >> GF_LATENCY_HIST_SUB_BITS) - 1;
+
+    return ((uint64_t)(GF_LATENCY_HIST_SUB_BUCKETS +
+                       (i & (GF_LATENCY_HIST_SUB_BUCKETS - 1)))
+            << shift) +
+           ((1ULL << shift) >> 1);
+}
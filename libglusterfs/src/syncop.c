@@ -8,6 +8,8 @@
   cases as published by the Free Software Foundation.
 */
 
+#include <sys/mman.h>
+
 #include "glusterfs/syncop.h"
 #include "glusterfs/libglusterfs-messages.h"
 
@@ -15,6 +17,207 @@
 #include <sanitizer/tsan_interface.h>
 #endif
 
+void
+synctask_wrap(void);
+
+#ifdef SYNCTASK_FAST_SWITCH
+/*
+ * synctask_context_swap(&from->sp, to->sp) pushes the callee-saved registers
+ * on the current stack, stores the stack pointer in @from, and pops the
+ * registers of @to from its stack. Everything else is saved by the caller,
+ * as for any function call. A new context is a stack prepared by
+ * synctask_context_make() to return into synctask_wrap().
+ */
+void
+synctask_context_swap(void **from, void *to);
+
+#if defined(__x86_64__)
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".globl synctask_context_swap\n"
+    ".hidden synctask_context_swap\n"
+    ".type synctask_context_swap, @function\n"
+    "synctask_context_swap:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size synctask_context_swap, .-synctask_context_swap\n");
+
+/* mxcsr and x87 control word, r15 to r12, rbx, rbp, the return address of
+ * the swap and the one of synctask_wrap() */
+#define SYNCTASK_CONTEXT_SLOTS 9
+#define SYNCTASK_CONTEXT_ENTRY 7
+#elif defined(__aarch64__)
+__asm__(
+    ".text\n"
+    ".p2align 4\n"
+    ".globl synctask_context_swap\n"
+    ".hidden synctask_context_swap\n"
+    ".type synctask_context_swap, %function\n"
+    "synctask_context_swap:\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".size synctask_context_swap, .-synctask_context_swap\n");
+
+/* x19 to x28, x29, x30 (the return address of the swap), d8 to d15 */
+#define SYNCTASK_CONTEXT_SLOTS 20
+#define SYNCTASK_CONTEXT_ENTRY 11
+#endif
+
+static int
+synctask_context_make(synctask_context_t *ctx, void *stack, size_t size)
+{
+    uintptr_t *sp = NULL;
+
+    sp = (uintptr_t *)(((uintptr_t)stack + size) & ~(uintptr_t)15);
+    sp -= SYNCTASK_CONTEXT_SLOTS;
+    memset(sp, 0, SYNCTASK_CONTEXT_SLOTS * sizeof(*sp));
+
+    sp[SYNCTASK_CONTEXT_ENTRY] = (uintptr_t)synctask_wrap;
+
+#if defined(__x86_64__)
+    /* start with the floating point settings of the creator */
+    __asm__ volatile("stmxcsr %0" : "=m"(*(uint32_t *)sp));
+    __asm__ volatile("fnstcw %0" : "=m"(*((uint16_t *)sp + 2)));
+#endif
+
+    ctx->sp = sp;
+
+    return 0;
+}
+
+static int
+synctask_context_switch(synctask_context_t *from, synctask_context_t *to)
+{
+    synctask_context_swap(&from->sp, to->sp);
+
+    return 0;
+}
+#else
+static int
+synctask_context_make(synctask_context_t *ctx, void *stack, size_t size)
+{
+    if (getcontext(ctx) < 0)
+        return -1;
+
+    ctx->uc_stack.ss_sp = stack;
+    ctx->uc_stack.ss_size = size;
+
+    makecontext(ctx, (void (*)(void))synctask_wrap, 0);
+
+    return 0;
+}
+
+static int
+synctask_context_switch(synctask_context_t *from, synctask_context_t *to)
+{
+    return swapcontext(from, to);
+}
+#endif
+
+/* Stacks are mapped with an inaccessible guard page below them, so that an
+ * overflow faults instead of corrupting the memory next to the stack. */
+static void *
+synctask_stack_map(size_t size)
+{
+    size_t guard = sysconf(_SC_PAGESIZE);
+    char *base = NULL;
+
+    base = mmap(NULL, size + guard, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    if (mprotect(base, guard, PROT_NONE) != 0) {
+        munmap(base, size + guard);
+        return NULL;
+    }
+
+    return base + guard;
+}
+
+static void
+synctask_stack_unmap(void *stack, size_t size)
+{
+    size_t guard = sysconf(_SC_PAGESIZE);
+
+    munmap((char *)stack - guard, size + guard);
+}
+
+static size_t
+synctask_stack_size(size_t size)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+
+    return (size + page - 1) & ~(page - 1);
+}
+
+/* Stacks of the default size of @env are kept for the next tasks, which
+ * then skip the mapping and find the pages they touch already faulted in. */
+static void
+synctask_stack_put(struct syncenv *env, void *stack, size_t size)
+{
+    if (!stack)
+        return;
+
+    if (size == env->stacksize) {
+        pthread_mutex_lock(&env->mutex);
+        {
+            if (env->stacks_count < env->stacks_max) {
+                env->stacks[env->stacks_count++] = stack;
+                stack = NULL;
+            }
+        }
+        pthread_mutex_unlock(&env->mutex);
+    }
+
+    if (stack)
+        synctask_stack_unmap(stack, size);
+}
+
 int
 syncopctx_setfsuid(void *uid)
 {
@@ -256,7 +459,8 @@ synctask_yield(struct synctask *task, struct timespec *delta)
 {
     xlator_t *oldTHIS = THIS;
 
-#if defined(__NetBSD__) && defined(_UC_TLSBASE)
+#if !defined(SYNCTASK_FAST_SWITCH) && defined(__NetBSD__) &&                  \
+    defined(_UC_TLSBASE)
     /* Preserve pthread private pointer through swapcontex() */
     task->proc->sched.uc_flags &= ~_UC_TLSBASE;
 #endif
@@ -271,7 +475,7 @@ synctask_yield(struct synctask *task, struct timespec *delta)
     __tsan_switch_to_fiber(task->proc->tsan.fiber, 0);
 #endif
 
-    if (swapcontext(&task->ctx, &task->proc->sched) < 0) {
+    if (synctask_context_switch(&task->ctx, &task->proc->sched) < 0) {
         gf_msg("syncop", GF_LOG_ERROR, errno, LG_MSG_SWAPCONTEXT_FAILED,
                "swapcontext failed");
     }
@@ -356,7 +560,7 @@ synctask_destroy(struct synctask *task)
     if (!task)
         return;
 
-    GF_FREE(task->stack);
+    synctask_stack_put(task->env, task->stack, task->stacksize);
 
     if (task->opframe)
         STACK_DESTROY(task->opframe->root);
@@ -412,16 +616,22 @@ synctask_create(struct syncenv *env, size_t stacksize, synctask_fn_t fn,
     struct synctask *newtask = NULL;
     xlator_t *this = THIS;
     int destroymode = 0;
+    void *stack = NULL;
 
     VALIDATE_OR_GOTO(env, err);
     VALIDATE_OR_GOTO(fn, err);
 
+    stacksize = stacksize ? synctask_stack_size(stacksize) : env->stacksize;
+
     /* Check if the syncenv is in destroymode i.e. destroy is SET.
      * If YES, then don't allow any new synctasks on it. Return NULL.
      */
     pthread_mutex_lock(&env->mutex);
     {
         destroymode = env->destroy;
+        if (!destroymode && (stacksize == env->stacksize) &&
+            (env->stacks_count > 0))
+            stack = env->stacks[--env->stacks_count];
     }
     pthread_mutex_unlock(&env->mutex);
 
@@ -429,9 +639,20 @@ synctask_create(struct syncenv *env, size_t stacksize, synctask_fn_t fn,
     if (destroymode)
         return NULL;
 
+    if (!stack) {
+        stack = synctask_stack_map(stacksize);
+        if (!stack)
+            return NULL;
+    }
+
     newtask = GF_CALLOC(1, sizeof(*newtask), gf_common_mt_synctask);
-    if (!newtask)
+    if (!newtask) {
+        synctask_stack_put(env, stack, stacksize);
         return NULL;
+    }
+
+    newtask->stack = stack;
+    newtask->stacksize = stacksize;
 
     newtask->frame = frame;
     if (!frame) {
@@ -458,28 +679,13 @@ synctask_create(struct syncenv *env, size_t stacksize, synctask_fn_t fn,
     INIT_LIST_HEAD(&newtask->all_tasks);
     INIT_LIST_HEAD(&newtask->waitq);
 
-    if (getcontext(&newtask->ctx) < 0) {
+    if (synctask_context_make(&newtask->ctx, newtask->stack,
+                              newtask->stacksize) < 0) {
         gf_msg("syncop", GF_LOG_ERROR, errno, LG_MSG_GETCONTEXT_FAILED,
                "getcontext failed");
         goto err;
     }
 
-    if (stacksize <= 0) {
-        newtask->stack = GF_CALLOC(1, env->stacksize, gf_common_mt_syncstack);
-        newtask->ctx.uc_stack.ss_size = env->stacksize;
-    } else {
-        newtask->stack = GF_CALLOC(1, stacksize, gf_common_mt_syncstack);
-        newtask->ctx.uc_stack.ss_size = stacksize;
-    }
-
-    if (!newtask->stack) {
-        goto err;
-    }
-
-    newtask->ctx.uc_stack.ss_sp = newtask->stack;
-
-    makecontext(&newtask->ctx, (void (*)(void))synctask_wrap, 0);
-
 #ifdef HAVE_TSAN_API
     newtask->tsan.fiber = __tsan_create_fiber(0);
     snprintf(newtask->tsan.name, TSAN_THREAD_NAMELEN, "<synctask of %s>",
@@ -502,7 +708,7 @@ synctask_create(struct syncenv *env, size_t stacksize, synctask_fn_t fn,
     return newtask;
 err:
     if (newtask) {
-        GF_FREE(newtask->stack);
+        synctask_stack_put(env, newtask->stack, newtask->stacksize);
         if (newtask->opframe)
             STACK_DESTROY(newtask->opframe->root);
         GF_FREE(newtask);
@@ -653,7 +859,8 @@ synctask_switchto(struct synctask *task)
     synctask_set(task);
     THIS = task->xl;
 
-#if defined(__NetBSD__) && defined(_UC_TLSBASE)
+#if !defined(SYNCTASK_FAST_SWITCH) && defined(__NetBSD__) &&                  \
+    defined(_UC_TLSBASE)
     /* Preserve pthread private pointer through swapcontex() */
     task->ctx.uc_flags &= ~_UC_TLSBASE;
 #endif
@@ -662,7 +869,7 @@ synctask_switchto(struct synctask *task)
     __tsan_switch_to_fiber(task->tsan.fiber, 0);
 #endif
 
-    if (swapcontext(&task->proc->sched, &task->ctx) < 0) {
+    if (synctask_context_switch(&task->proc->sched, &task->ctx) < 0) {
         gf_msg("syncop", GF_LOG_ERROR, errno, LG_MSG_SWAPCONTEXT_FAILED,
                "swapcontext failed");
     }
@@ -754,6 +961,10 @@ syncenv_destroy(struct syncenv *env)
     }
     pthread_mutex_unlock(&env->mutex);
 
+    while (env->stacks_count > 0)
+        synctask_stack_unmap(env->stacks[--env->stacks_count], env->stacksize);
+    GF_FREE(env->stacks);
+
     pthread_mutex_destroy(&env->mutex);
     pthread_cond_destroy(&env->cond);
 
@@ -790,11 +1001,21 @@ syncenv_new(size_t stacksize, int procmin, int procmax)
 
     newenv->stacksize = SYNCENV_DEFAULT_STACKSIZE;
     if (stacksize)
-        newenv->stacksize = stacksize;
+        newenv->stacksize = synctask_stack_size(stacksize);
     newenv->procmin = procmin;
     newenv->procmax = procmax;
     newenv->procs_idle = 0;
 
+    newenv->stacks_max = procmax * SYNCENV_STACKS_PER_PROC;
+    newenv->stacks = GF_CALLOC(newenv->stacks_max, sizeof(*newenv->stacks),
+                               gf_common_mt_syncstack);
+    if (!newenv->stacks) {
+        pthread_mutex_destroy(&newenv->mutex);
+        pthread_cond_destroy(&newenv->cond);
+        GF_FREE(newenv);
+        return NULL;
+    }
+
     for (i = 0; i < newenv->procmin; i++) {
         newenv->proc[i].env = newenv;
         ret = gf_thread_create(&newenv->proc[i].processor, NULL,
@@ -19,14 +19,169 @@
 static gf_timer_registry_t *
 gf_timer_registry_init(glusterfs_ctx_t *);
 
+static uint64_t
+gf_timer_ticks(struct timespec ts, gf_boolean_t round_up)
+{
+    uint64_t ns = TS(ts);
+
+    if (round_up)
+        ns += GF_TIMER_WHEEL_TICK - 1;
+
+    return ns / GF_TIMER_WHEEL_TICK;
+}
+
+static void
+__gf_timer_wheel_add(gf_timer_registry_t *reg, gf_timer_t *event)
+{
+    uint32_t level, slot;
+
+    if (event->expires <= reg->now) {
+        event->slot = -1;
+        list_add_tail(&event->list, &reg->expired);
+        return;
+    }
+
+    /* The timer goes to the level of the most significant bit that differs
+     * from the current time, so it never wraps around in its level. */
+    level = (63 - __builtin_clzll(event->expires ^ reg->now)) /
+            GF_TIMER_WHEEL_BITS;
+    slot = (event->expires >> (level * GF_TIMER_WHEEL_BITS)) &
+           (GF_TIMER_WHEEL_SLOTS - 1);
+
+    event->slot = level * GF_TIMER_WHEEL_SLOTS + slot;
+    list_add_tail(&event->list, &reg->wheel[event->slot]);
+    reg->busy[level] |= 1ULL << slot;
+}
+
+static void
+__gf_timer_wheel_del(gf_timer_registry_t *reg, gf_timer_t *event)
+{
+    list_del_init(&event->list);
+
+    if ((event->slot >= 0) && list_empty(&reg->wheel[event->slot])) {
+        reg->busy[event->slot / GF_TIMER_WHEEL_SLOTS] &=
+            ~(1ULL << (event->slot % GF_TIMER_WHEEL_SLOTS));
+    }
+}
+
+/* Returns the first tick at which a slot of the wheel needs to be processed,
+ * either to expire its timers or to move them to a lower level. */
+static uint64_t
+__gf_timer_wheel_next(gf_timer_registry_t *reg)
+{
+    uint64_t pending, base;
+    uint32_t level, shift, current;
+
+    for (level = 0; level < GF_TIMER_WHEEL_LEVELS; level++) {
+        shift = level * GF_TIMER_WHEEL_BITS;
+        current = (reg->now >> shift) & (GF_TIMER_WHEEL_SLOTS - 1);
+
+        /* Only the slots after the current one can be busy. Lower levels
+         * always expire before the higher ones. */
+        pending = reg->busy[level] & ~((2ULL << current) - 1);
+        if (pending == 0)
+            continue;
+
+        shift += GF_TIMER_WHEEL_BITS;
+        base = (shift >= 64) ? 0 : reg->now & ~((1ULL << shift) - 1);
+
+        return base | ((uint64_t)__builtin_ctzll(pending)
+                       << (level * GF_TIMER_WHEEL_BITS));
+    }
+
+    return UINT64_MAX;
+}
+
+static void
+__gf_timer_wheel_cascade(gf_timer_registry_t *reg, uint32_t slot)
+{
+    struct list_head timers;
+    gf_timer_t *event = NULL;
+    gf_timer_t *tmp = NULL;
+
+    INIT_LIST_HEAD(&timers);
+    list_splice_init(&reg->wheel[slot], &timers);
+    reg->busy[slot / GF_TIMER_WHEEL_SLOTS] &=
+        ~(1ULL << (slot % GF_TIMER_WHEEL_SLOTS));
+
+    list_for_each_entry_safe(event, tmp, &timers, list)
+    {
+        list_del(&event->list);
+        __gf_timer_wheel_add(reg, event);
+    }
+}
+
+/* Advances the wheel up to 'now', moving all the timers that expire until
+ * then to reg->expired. Only the slots that have timers are visited. */
+static void
+__gf_timer_wheel_advance(gf_timer_registry_t *reg, uint64_t now)
+{
+    uint64_t next;
+    uint32_t level, shift;
+
+    while ((next = __gf_timer_wheel_next(reg)) <= now) {
+        reg->now = next;
+
+        for (level = GF_TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+            shift = level * GF_TIMER_WHEEL_BITS;
+            if ((next & ((1ULL << shift) - 1)) != 0)
+                continue;
+
+            __gf_timer_wheel_cascade(
+                reg, level * GF_TIMER_WHEEL_SLOTS +
+                         ((next >> shift) & (GF_TIMER_WHEEL_SLOTS - 1)));
+        }
+        __gf_timer_wheel_cascade(reg, next & (GF_TIMER_WHEEL_SLOTS - 1));
+    }
+
+    if (reg->now < now)
+        reg->now = now;
+}
+
+/* Moves the timers added since the last call into the wheel. */
+static void
+__gf_timer_dequeue(gf_timer_registry_t *reg)
+{
+    struct cds_wfs_head *head = NULL;
+    struct cds_wfs_node *node = NULL;
+    struct cds_wfs_node *next = NULL;
+    struct list_head timers;
+    gf_timer_t *event = NULL;
+    gf_timer_t *tmp = NULL;
+
+    INIT_LIST_HEAD(&timers);
+
+    head = __cds_wfs_pop_all(&reg->queued);
+    cds_wfs_for_each_blocking_safe(head, node, next)
+    {
+        event = caa_container_of(node, gf_timer_t, queued);
+        if (uatomic_cmpxchg(&event->state, GF_TIMER_QUEUED, GF_TIMER_ARMED) !=
+            GF_TIMER_QUEUED) {
+            /* Cancelled before reaching the wheel. */
+            GF_FREE(event);
+            continue;
+        }
+
+        /* The stack returns the most recent timers first. Reverse them to
+         * fire timers with the same expiration in the order they were
+         * added. */
+        list_add(&event->list, &timers);
+    }
+
+    list_for_each_entry_safe(event, tmp, &timers, list)
+    {
+        list_del(&event->list);
+        __gf_timer_wheel_add(reg, event);
+    }
+}
+
 gf_timer_t *
 gf_timer_call_after(glusterfs_ctx_t *ctx, struct timespec delta,
                     gf_timer_cbk_t callbk, void *data)
 {
     gf_timer_registry_t *reg = NULL;
     gf_timer_t *event = NULL;
-    gf_timer_t *trav = NULL;
-    uint64_t at = 0;
+    uint64_t expires = 0;
 
     if ((ctx == NULL) || (ctx->cleanup_started)) {
         gf_msg_callingfn("timer", GF_LOG_ERROR, EINVAL, LG_MSG_INVALID_ARG,
@@ -49,23 +204,29 @@ gf_timer_call_after(glusterfs_ctx_t *ctx, struct timespec delta,
     }
     timespec_now(&event->at);
     timespec_adjust_delta(&event->at, delta);
-    at = TS(event->at);
+    expires = gf_timer_ticks(event->at, _gf_true);
+    event->expires = expires;
     event->callbk = callbk;
     event->data = data;
     event->xl = THIS;
-    pthread_mutex_lock(&reg->lock);
-    {
-        list_for_each_entry_reverse(trav, &reg->active, list)
-        {
-            if (TS(trav->at) < at)
-                break;
-        }
-        list_add(&event->list, &trav->list);
-        if (&trav->list == &reg->active) {
-            pthread_cond_signal(&reg->cond);
-        }
+    event->state = GF_TIMER_QUEUED;
+    INIT_LIST_HEAD(&event->list);
+    cds_wfs_node_init(&event->queued);
+
+    /* The event can be fired by the timer thread as soon as it's pushed,
+     * so it must not be accessed anymore. */
+    cds_wfs_push(&reg->queued, &event->queued);
+
+    /* Pairs with the barrier in gf_timer_proc(): either the timer thread
+     * sees this timer before going to sleep, or we see the time it will
+     * wake up at. */
+    cmm_smp_mb();
+    if (expires < uatomic_read(&reg->next_wakeup)) {
+        pthread_mutex_lock(&reg->lock);
+        pthread_cond_signal(&reg->cond);
+        pthread_mutex_unlock(&reg->lock);
     }
-    pthread_mutex_unlock(&reg->lock);
+
     return event;
 }
 
@@ -101,12 +262,19 @@ gf_timer_call_cancel(glusterfs_ctx_t *ctx, gf_timer_t *event)
         return -1;
     }
 
+    /* If the timer thread hasn't seen the event yet, it will release it
+     * when it does. */
+    if (uatomic_cmpxchg(&event->state, GF_TIMER_QUEUED, GF_TIMER_CANCELLED) ==
+        GF_TIMER_QUEUED) {
+        return 0;
+    }
+
     pthread_mutex_lock(&reg->lock);
     {
-        fired = event->fired;
+        fired = (event->state == GF_TIMER_FIRED);
         if (fired)
             goto unlock;
-        list_del(&event->list);
+        __gf_timer_wheel_del(reg, event);
     }
 unlock:
     pthread_mutex_unlock(&reg->lock);
@@ -118,53 +286,84 @@ unlock:
     return -1;
 }
 
+static void
+gf_timer_fire(gf_timer_t *event)
+{
+    xlator_t *old_THIS = NULL;
+
+    if (event->xl) {
+        old_THIS = THIS;
+        THIS = event->xl;
+    }
+    event->callbk(event->data);
+    GF_FREE(event);
+    if (old_THIS) {
+        THIS = old_THIS;
+    }
+}
+
 static void *
 gf_timer_proc(void *data)
 {
     gf_timer_registry_t *reg = data;
     gf_timer_t *event = NULL;
     gf_timer_t *tmp = NULL;
-    xlator_t *old_THIS = NULL;
+    struct timespec now;
+    uint64_t next = 0;
+    uint32_t i = 0;
 
     pthread_mutex_lock(&reg->lock);
 
     while (!reg->fin) {
-        if (list_empty(&reg->active)) {
-            pthread_cond_wait(&reg->cond, &reg->lock);
-        } else {
-            struct timespec now;
-
-            timespec_now(&now);
-            event = list_first_entry(&reg->active, gf_timer_t, list);
-            if (TS(now) < TS(event->at)) {
-                now = event->at;
-                pthread_cond_timedwait(&reg->cond, &reg->lock, &now);
-            } else {
-                event->fired = _gf_true;
+        __gf_timer_dequeue(reg);
+
+        timespec_now(&now);
+        __gf_timer_wheel_advance(reg, gf_timer_ticks(now, _gf_false));
+
+        /* Once fired, a timer can't be cancelled anymore. The expired
+         * timers are fired one at a time, so that a callback can still
+         * cancel the ones that follow it. */
+        if (!list_empty(&reg->expired)) {
+            do {
+                event = list_first_entry(&reg->expired, gf_timer_t, list);
                 list_del_init(&event->list);
+                event->state = GF_TIMER_FIRED;
 
                 pthread_mutex_unlock(&reg->lock);
 
-                old_THIS = NULL;
-                if (event->xl) {
-                    old_THIS = THIS;
-                    THIS = event->xl;
-                }
-                event->callbk(event->data);
-                GF_FREE(event);
-                if (old_THIS) {
-                    THIS = old_THIS;
-                }
+                gf_timer_fire(event);
 
                 pthread_mutex_lock(&reg->lock);
-            }
+            } while (!list_empty(&reg->expired));
+            continue;
+        }
+
+        next = __gf_timer_wheel_next(reg);
+        uatomic_set(&reg->next_wakeup, next);
+
+        /* Pairs with the barrier in gf_timer_call_after(). */
+        cmm_smp_mb();
+        if (!cds_wfs_empty(&reg->queued))
+            continue;
+
+        if (next == UINT64_MAX) {
+            pthread_cond_wait(&reg->cond, &reg->lock);
+        } else {
+            next *= GF_TIMER_WHEEL_TICK;
+            now.tv_sec = next / 1000000000ULL;
+            now.tv_nsec = next % 1000000000ULL;
+            pthread_cond_timedwait(&reg->cond, &reg->lock, &now);
         }
     }
 
     /* Do not call gf_timer_call_cancel(),
      * it will lead to deadlock
      */
-    list_for_each_entry_safe(event, tmp, &reg->active, list)
+    __gf_timer_dequeue(reg);
+    for (i = 0; i < GF_TIMER_WHEEL_LEVELS * GF_TIMER_WHEEL_SLOTS; i++)
+        list_splice_init(&reg->wheel[i], &reg->expired);
+
+    list_for_each_entry_safe(event, tmp, &reg->expired, list)
     {
         list_del(&event->list);
         /* TODO Possible resource leak
@@ -187,6 +386,7 @@ gf_timer_registry_init(glusterfs_ctx_t *ctx)
 {
     gf_timer_registry_t *reg = NULL;
     int ret = -1;
+    int i = 0;
     pthread_condattr_t attr;
 
     LOCK(&ctx->lock);
@@ -206,7 +406,10 @@ gf_timer_registry_init(glusterfs_ctx_t *ctx)
         pthread_condattr_init(&attr);
         pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
         pthread_cond_init(&reg->cond, &attr);
-        INIT_LIST_HEAD(&reg->active);
+        __cds_wfs_init(&reg->queued);
+        for (i = 0; i < GF_TIMER_WHEEL_LEVELS * GF_TIMER_WHEEL_SLOTS; i++)
+            INIT_LIST_HEAD(&reg->wheel[i]);
+        INIT_LIST_HEAD(&reg->expired);
     }
     UNLOCK(&ctx->lock);
     ret = gf_thread_create(&reg->th, NULL, gf_timer_proc, reg, "timer");
@@ -0,0 +1,209 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Microbenchmark for the dict_t life cycle of a fop's xdata.
+ *
+ * For a given number of keys, each iteration does what a client stack and
+ * a brick do with the xdata of a lookup: create a dict, set the keys
+ * (integers, static strings and a gfid), look every key up, and release the
+ * dict. A second pass also serializes the dict and unserializes it into a
+ * new one, as the protocol layers do.
+ *
+ * The cost is reported in ns per iteration, together with the number of
+ * heap allocations per iteration. Allocations are counted by interposing
+ * malloc() and friends, so objects served from the per-thread mem-pool
+ * caches are not counted, but every GF_MALLOC()/GF_CALLOC() is.
+ *
+ * Built by "make check" in libglusterfs/src.
+ *
+ * Usage: dict_benchmark [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "glusterfs/glusterfs.h"
+#include "glusterfs/globals.h"
+#include "glusterfs/xlator.h"
+#include "glusterfs/dict.h"
+
+extern void *
+__libc_malloc(size_t size);
+extern void *
+__libc_calloc(size_t nmemb, size_t size);
+extern void *
+__libc_realloc(void *ptr, size_t size);
+
+static __thread unsigned long bench_allocs;
+
+void *
+malloc(size_t size)
+{
+    bench_allocs++;
+    return __libc_malloc(size);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+    bench_allocs++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+    bench_allocs++;
+    return __libc_realloc(ptr, size);
+}
+
+/* keys as sent in the xdata of lookups by the usual client stacks */
+static char *bench_keys[] = {
+    "glusterfs.open-fd-count",
+    "glusterfs.inodelk-count",
+    "glusterfs.entrylk-count",
+    "trusted.glusterfs.dht.linkto",
+    "glusterfs.gfid.req",
+    "trusted.afr.dirty",
+    "security.selinux",
+    "glusterfs.content",
+    "trusted.glusterfs.dht",
+    "trusted.glusterfs.dht.mds",
+    "glusterfs.posixlk-count",
+    "trusted.ec.version",
+    "trusted.ec.size",
+    "trusted.ec.dirty",
+    "glusterfs.parent-entrylk",
+    "link-count",
+};
+
+static dict_t *
+bench_fill(int keys)
+{
+    static uuid_t gfid = {
+        1,
+    };
+    dict_t *xdata = dict_new();
+    int ret = 0;
+    int i = 0;
+
+    for (i = 0; i < keys; i++) {
+        switch (i % 3) {
+            case 0:
+                ret = dict_set_int32(xdata, bench_keys[i], i);
+                break;
+            case 1:
+                ret = dict_set_str(xdata, bench_keys[i], "value");
+                break;
+            default:
+                ret = dict_set_static_bin(xdata, bench_keys[i], gfid,
+                                          sizeof(uuid_t));
+                break;
+        }
+
+        if (ret) {
+            fprintf(stderr, "setting key %s failed\n", bench_keys[i]);
+            abort();
+        }
+    }
+
+    return xdata;
+}
+
+static void
+bench_lookup(dict_t *xdata, int keys)
+{
+    int i = 0;
+
+    for (i = 0; i < keys; i++) {
+        if (!dict_get(xdata, bench_keys[i])) {
+            fprintf(stderr, "key %s not found\n", bench_keys[i]);
+            abort();
+        }
+    }
+}
+
+static void
+bench_run(const char *name, int keys, long iterations, gf_boolean_t wire)
+{
+    struct timespec start, end;
+    unsigned long allocs = 0;
+    dict_t *xdata = NULL;
+    dict_t *copy = NULL;
+    char *buf = NULL;
+    unsigned int len = 0;
+    double ns = 0;
+    long i = 0;
+
+    /* warm up the mem-pools */
+    xdata = bench_fill(keys);
+    dict_unref(xdata);
+
+    allocs = bench_allocs;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < iterations; i++) {
+        xdata = bench_fill(keys);
+
+        if (wire) {
+            dict_allocate_and_serialize(xdata, &buf, &len);
+            copy = dict_new();
+            dict_unserialize(buf, len, &copy);
+            bench_lookup(copy, keys);
+            dict_unref(copy);
+            GF_FREE(buf);
+        } else {
+            bench_lookup(xdata, keys);
+        }
+
+        dict_unref(xdata);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    allocs = bench_allocs - allocs;
+
+    ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) /
+         iterations;
+    printf("%-12s keys: %2d  ns/op: %8.1f  allocs/op: %6.2f\n", name, keys, ns,
+           (double)allocs / iterations);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static int key_counts[] = {1, 2, 4, 8, 16};
+    glusterfs_ctx_t *ctx = NULL;
+    long iterations = 0;
+    int i = 0;
+
+    iterations = (argc > 1) ? atol(argv[1]) : 1000000;
+
+    ctx = glusterfs_ctx_new();
+    if (!ctx || glusterfs_globals_init(ctx))
+        return EXIT_FAILURE;
+    THIS->ctx = ctx;
+    mem_pools_init();
+
+    ctx->dict_pool = mem_pool_new(dict_t, 1024);
+    ctx->dict_pair_pool = mem_pool_new(data_pair_t, 1024);
+    ctx->dict_data_pool = mem_pool_new(data_t, 1024);
+    if (!ctx->dict_pool || !ctx->dict_pair_pool || !ctx->dict_data_pool)
+        return EXIT_FAILURE;
+
+    for (i = 0; i < sizeof(key_counts) / sizeof(key_counts[0]); i++)
+        bench_run("set+get", key_counts[i], iterations, _gf_false);
+
+    for (i = 0; i < sizeof(key_counts) / sizeof(key_counts[0]); i++)
+        bench_run("serialized", key_counts[i], iterations / 4, _gf_true);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Microbenchmark for lookups on a shared inode table.
+ *
+ * A table is populated with a flat directory of linked inodes, then each
+ * thread repeatedly resolves random entries with inode_grep() (parent +
+ * name) and inode_find() (gfid) and drops the reference again, which is
+ * what a FUSE client or brick does on every lookup of a cached entry.
+ * Aggregate throughput is printed for 1, 2, 4, ... up to the requested
+ * number of threads, so the scaling with thread count can be compared.
+ *
+ * Built by "make check" in libglusterfs/src.
+ *
+ * Usage: inode_table_benchmark [max-threads] [inodes] [lookups-per-thread]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "glusterfs/glusterfs.h"
+#include "glusterfs/globals.h"
+#include "glusterfs/xlator.h"
+#include "glusterfs/inode.h"
+
+static inode_table_t *bench_table;
+static inode_t **bench_inodes;
+static int bench_inode_count;
+static long bench_lookups;
+static xlator_t *bench_xl;
+
+static void *
+bench_worker(void *arg)
+{
+    unsigned int seed = (unsigned int)(uintptr_t)arg;
+    char name[32];
+    inode_t *inode = NULL;
+    long i = 0;
+    int idx = 0;
+
+    THIS = bench_xl;
+
+    for (i = 0; i < bench_lookups; i++) {
+        idx = rand_r(&seed) % bench_inode_count;
+
+        if (i & 1) {
+            inode = inode_find(bench_table, bench_inodes[idx]->gfid);
+        } else {
+            snprintf(name, sizeof(name), "file-%d", idx);
+            inode = inode_grep(bench_table, bench_table->root, name);
+        }
+
+        if (!inode) {
+            fprintf(stderr, "lookup of entry %d failed\n", idx);
+            abort();
+        }
+
+        inode_unref(inode);
+    }
+
+    return NULL;
+}
+
+static double
+bench_run(int threads)
+{
+    pthread_t tids[threads];
+    struct timespec start, end;
+    int i = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (i = 0; i < threads; i++)
+        pthread_create(&tids[i], NULL, bench_worker, (void *)(uintptr_t)i);
+    for (i = 0; i < threads; i++)
+        pthread_join(tids[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+}
+
+int
+main(int argc, char *argv[])
+{
+    glusterfs_ctx_t *ctx = NULL;
+    glusterfs_graph_t *graph = NULL;
+    struct iatt iatt = {
+        0,
+    };
+    char name[32];
+    inode_t *inode = NULL;
+    int max_threads = 16;
+    int threads = 0;
+    double secs = 0;
+    int i = 0;
+
+    if (argc > 1)
+        max_threads = atoi(argv[1]);
+    bench_inode_count = (argc > 2) ? atoi(argv[2]) : 100000;
+    bench_lookups = (argc > 3) ? atol(argv[3]) : 1000000;
+
+    ctx = glusterfs_ctx_new();
+    if (!ctx || glusterfs_globals_init(ctx))
+        return EXIT_FAILURE;
+    THIS->ctx = ctx;
+    mem_pools_init();
+
+    graph = GF_CALLOC(1, sizeof(*graph), gf_common_mt_glusterfs_graph_t);
+    bench_xl = GF_CALLOC(1, sizeof(*bench_xl), gf_common_mt_xlator_t);
+    if (!graph || !bench_xl)
+        return EXIT_FAILURE;
+
+    graph->xl_count = 1;
+    bench_xl->name = "inode-table-benchmark";
+    bench_xl->ctx = ctx;
+    bench_xl->graph = graph;
+    bench_xl->xl_id = 1;
+    THIS = bench_xl;
+
+    /* no lru limit, all the entries stay cached */
+    bench_table = inode_table_new(0, bench_xl);
+    bench_inodes = GF_CALLOC(bench_inode_count, sizeof(*bench_inodes),
+                             gf_common_mt_inode_t);
+    if (!bench_table || !bench_inodes)
+        return EXIT_FAILURE;
+
+    iatt.ia_type = IA_IFREG;
+    for (i = 0; i < bench_inode_count; i++) {
+        inode = inode_new(bench_table);
+        gf_uuid_generate(iatt.ia_gfid);
+        snprintf(name, sizeof(name), "file-%d", i);
+
+        /* keep one reference per entry, as an open fd or a kernel
+         * lookup count would */
+        bench_inodes[i] = inode_link(inode, bench_table->root, name, &iatt);
+        inode_lookup(bench_inodes[i]);
+        inode_unref(inode);
+    }
+
+    printf("%d inodes, %ld lookups per thread\n", bench_inode_count,
+           bench_lookups);
+
+    for (threads = 1; threads <= max_threads; threads *= 2) {
+        secs = bench_run(threads);
+        printf("threads: %3d  lookups/sec: %12.0f\n", threads,
+               (threads * bench_lookups) / secs);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Microbenchmark for synctasks.
+ *
+ * The "spawn" pass creates tasks that return at once, keeping a bounded
+ * number of them in flight, and reports the tasks completed per second.
+ * This is dominated by the setup of a task: its frame, its stack and its
+ * context.
+ *
+ * The "yield" pass runs a single task which yields to its processor and is
+ * put back on the run queue at once, and reports the cost of a round trip,
+ * i.e. of two context switches and the run queue handling around them.
+ *
+ * Both run on a syncenv with a single processor, so that the numbers do not
+ * depend on how the tasks are spread over the threads.
+ *
+ * Built by "make check" in libglusterfs/src.
+ *
+ * Usage: synctask_benchmark [tasks] [yields]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "glusterfs/glusterfs.h"
+#include "glusterfs/globals.h"
+#include "glusterfs/xlator.h"
+#include "glusterfs/syncop.h"
+
+#define BENCH_INFLIGHT 64
+
+static pthread_mutex_t bench_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bench_cond = PTHREAD_COND_INITIALIZER;
+static long bench_done;
+
+static double
+bench_elapsed(struct timespec *start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start->tv_sec) * 1e9 +
+           (end.tv_nsec - start->tv_nsec);
+}
+
+static int
+bench_nop(void *opaque)
+{
+    return 0;
+}
+
+static int
+bench_nop_cbk(int ret, call_frame_t *frame, void *opaque)
+{
+    pthread_mutex_lock(&bench_mutex);
+    {
+        bench_done++;
+        pthread_cond_signal(&bench_cond);
+    }
+    pthread_mutex_unlock(&bench_mutex);
+
+    return 0;
+}
+
+static void
+bench_spawn(struct syncenv *env, long tasks)
+{
+    struct timespec start;
+    long spawned = 0;
+    double ns = 0;
+
+    bench_done = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    while (spawned < tasks) {
+        pthread_mutex_lock(&bench_mutex);
+        {
+            while (spawned - bench_done >= BENCH_INFLIGHT)
+                pthread_cond_wait(&bench_cond, &bench_mutex);
+        }
+        pthread_mutex_unlock(&bench_mutex);
+
+        if (synctask_new(env, bench_nop, bench_nop_cbk, NULL, NULL) != 0) {
+            fprintf(stderr, "synctask_new failed\n");
+            abort();
+        }
+        spawned++;
+    }
+
+    pthread_mutex_lock(&bench_mutex);
+    {
+        while (bench_done < tasks)
+            pthread_cond_wait(&bench_cond, &bench_mutex);
+    }
+    pthread_mutex_unlock(&bench_mutex);
+
+    ns = bench_elapsed(&start);
+    printf("spawn  tasks: %8ld  tasks/s: %10.0f  ns/task: %8.1f\n", tasks,
+           tasks * 1e9 / ns, ns / tasks);
+}
+
+static int
+bench_yield(void *opaque)
+{
+    struct synctask *task = synctask_get();
+    long *yields = opaque;
+    long i = 0;
+
+    for (i = 0; i < *yields; i++) {
+        /* ask to be run again as soon as it has switched out */
+        task->woken = 1;
+        synctask_yield(task, NULL);
+    }
+
+    return 0;
+}
+
+static void
+bench_switch(struct syncenv *env, long yields)
+{
+    struct timespec start;
+    double ns = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if (synctask_new(env, bench_yield, NULL, NULL, &yields) != 0) {
+        fprintf(stderr, "synctask_new failed\n");
+        abort();
+    }
+
+    ns = bench_elapsed(&start);
+    printf("yield  count: %8ld  ns/yield: %8.1f\n", yields, ns / yields);
+}
+
+int
+main(int argc, char *argv[])
+{
+    glusterfs_ctx_t *ctx = NULL;
+    struct syncenv *env = NULL;
+    long tasks = 0;
+    long yields = 0;
+
+    tasks = (argc > 1) ? atol(argv[1]) : 200000;
+    yields = (argc > 2) ? atol(argv[2]) : 2000000;
+
+    ctx = glusterfs_ctx_new();
+    if (!ctx || glusterfs_globals_init(ctx))
+        return EXIT_FAILURE;
+    THIS->ctx = ctx;
+    mem_pools_init();
+
+    ctx->pool = calloc(1, sizeof(call_pool_t));
+    if (!ctx->pool)
+        return EXIT_FAILURE;
+    INIT_LIST_HEAD(&ctx->pool->all_frames);
+    LOCK_INIT(&ctx->pool->lock);
+    ctx->pool->frame_mem_pool = mem_pool_new(call_frame_t, 4096);
+    ctx->pool->stack_mem_pool = mem_pool_new(call_stack_t, 1024);
+    if (!ctx->pool->frame_mem_pool || !ctx->pool->stack_mem_pool)
+        return EXIT_FAILURE;
+
+    env = syncenv_new(0, 1, 1);
+    if (!env)
+        return EXIT_FAILURE;
+
+    /* warm up the pools */
+    bench_spawn(env, BENCH_INFLIGHT);
+
+    bench_spawn(env, tasks);
+    bench_switch(env, yields);
+
+    syncenv_destroy(env);
+
+    return EXIT_SUCCESS;
+}
@@ -189,6 +189,10 @@ struct rpc_transport {
 
     uint64_t total_bytes_read;
     uint64_t total_bytes_write;
+    uint64_t total_writes;         /* system calls writing the bytes */
+    uint64_t zerocopy_sends;       /* writes with MSG_ZEROCOPY */
+    uint64_t zerocopy_completions; /* of zero-copy writes */
+    uint64_t zerocopy_copied; /* completions where the kernel copied anyway */
     uint32_t xid; /* RPC/XID used for callbacks */
     int32_t outstanding_rpc_count;
 
@@ -32,6 +32,9 @@
 #include <errno.h>
 #include <rpc/xdr.h>
 #include <sys/ioctl.h>
+#ifdef GF_SOCKET_ZEROCOPY
+#include <linux/errqueue.h>
+#endif
 #define GF_LOG_ERRNO(errno) ((errno == ENOTCONN) ? GF_LOG_DEBUG : GF_LOG_ERROR)
 #define SA(ptr) ((struct sockaddr *)ptr)
 
@@ -728,8 +731,10 @@ __socket_rwv(rpc_transport_t *this, struct iovec *vector, int count,
             if ((ret == 0) || ((ret < 0) && (errno == EAGAIN))) {
                 /* done for now */
                 break;
-            } else if (ret > 0)
+            } else if (ret > 0) {
                 this->total_bytes_write += ret;
+                this->total_writes++;
+            }
         } else {
             ret = __socket_cached_read(this, opvector, opcount);
             if (ret == 0) {
@@ -1005,6 +1010,27 @@ __socket_nonblock(int fd)
     return ret;
 }
 
+static void
+__socket_zerocopy_setup(rpc_transport_t *this)
+{
+#ifdef GF_SOCKET_ZEROCOPY
+    socket_private_t *priv = this->private;
+    int on = 1;
+
+    if (!priv->zerocopy || priv->use_ssl)
+        return;
+
+    if (setsockopt(priv->sock, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) != 0) {
+        gf_log(this->name, GF_LOG_WARNING,
+               "setsockopt() failed for SO_ZEROCOPY (%s)", strerror(errno));
+        return;
+    }
+
+    priv->zc.enabled = 1;
+    priv->zc.use = 1;
+#endif
+}
+
 static int
 __socket_nodelay(int fd)
 {
@@ -1148,6 +1174,14 @@ __socket_reset(rpc_transport_t *this)
 
     memset(&priv->incoming, 0, sizeof(priv->incoming));
 
+    /* sequence numbers of zero-copy sends are per socket */
+    priv->zc.done_mask = 0;
+    priv->zc.next = 0;
+    priv->zc.done_upto = 0;
+    priv->zc.copied_run = 0;
+    priv->zc.enabled = 0;
+    priv->zc.use = 0;
+
     gf_event_unregister_close(this->ctx->event_pool, priv->sock, priv->idx);
     if (priv->use_ssl && priv->ssl_ssl) {
         SSL_clear(priv->ssl_ssl);
@@ -1288,6 +1322,144 @@ __socket_ioq_flush(socket_private_t *priv)
         entry = priv->ioq_next;
         __socket_ioq_entry_free(entry);
     }
+
+    /* the socket is going away, the kernel won't send these anymore */
+    while (!list_empty(&priv->zc.pending)) {
+        entry = list_first_entry(&priv->zc.pending, struct ioq, list);
+        __socket_ioq_entry_free(entry);
+    }
+}
+
+#ifdef GF_SOCKET_ZEROCOPY
+static void
+__socket_zerocopy_done(rpc_transport_t *this, uint32_t lo, uint32_t hi,
+                       gf_boolean_t copied)
+{
+    socket_private_t *priv = this->private;
+    struct ioq *entry = NULL;
+    struct ioq *tmp = NULL;
+    uint32_t seq = 0;
+
+    this->zerocopy_completions += hi - lo + 1;
+
+    if (copied) {
+        this->zerocopy_copied += hi - lo + 1;
+        if (priv->zc.use &&
+            (++priv->zc.copied_run >= GF_SOCKET_ZEROCOPY_COPIED_MAX)) {
+            gf_log(this->name, GF_LOG_INFO,
+                   "zero-copy sends to %s are copied by the kernel, "
+                   "not using them anymore",
+                   this->peerinfo.identifier);
+            priv->zc.use = 0;
+        }
+    } else {
+        priv->zc.copied_run = 0;
+    }
+
+    /* completions usually come in order, but not always */
+    for (seq = lo; seq != hi + 1; seq++) {
+        if ((seq - priv->zc.done_upto) < GF_SOCKET_ZEROCOPY_WINDOW)
+            priv->zc.done_mask |= 1ULL << (seq - priv->zc.done_upto);
+    }
+
+    while (priv->zc.done_mask & 1) {
+        priv->zc.done_mask >>= 1;
+        priv->zc.done_upto++;
+    }
+
+    list_for_each_entry_safe(entry, tmp, &priv->zc.pending, list)
+    {
+        if ((int32_t)(entry->zc_seq - priv->zc.done_upto) >= 0)
+            break;
+
+        __socket_ioq_entry_free(entry);
+    }
+}
+
+/* Reads the completions of zero-copy sends from the error queue. */
+static int
+__socket_zerocopy_reap(rpc_transport_t *this)
+{
+    socket_private_t *priv = this->private;
+    struct sock_extended_err *serr = NULL;
+    struct cmsghdr *cmsg = NULL;
+    struct msghdr msg;
+    char control[128];
+    int ret = 0;
+
+    for (;;) {
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ret = recvmsg(priv->sock, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                return 0;
+            return -1;
+        }
+
+        for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (!((cmsg->cmsg_level == SOL_IP &&
+                   cmsg->cmsg_type == IP_RECVERR) ||
+                  (cmsg->cmsg_level == SOL_IPV6 &&
+                   cmsg->cmsg_type == IPV6_RECVERR)))
+                continue;
+
+            serr = (struct sock_extended_err *)CMSG_DATA(cmsg);
+            if ((serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) ||
+                (serr->ee_errno != 0))
+                continue;
+
+            __socket_zerocopy_done(this, serr->ee_info, serr->ee_data,
+                                   serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED);
+        }
+    }
+}
+
+/* Whether the next send may use MSG_ZEROCOPY: the kernel can't read from
+ * more than GF_SOCKET_ZEROCOPY_WINDOW sends we keep the memory of. */
+static gf_boolean_t
+__socket_zerocopy_usable(rpc_transport_t *this)
+{
+    socket_private_t *priv = this->private;
+
+    if (!priv->zc.use)
+        return _gf_false;
+
+    if ((priv->zc.next - priv->zc.done_upto) >= GF_SOCKET_ZEROCOPY_WINDOW)
+        __socket_zerocopy_reap(this);
+
+    return (priv->zc.next - priv->zc.done_upto) < GF_SOCKET_ZEROCOPY_WINDOW;
+}
+#endif
+
+/* An entry has been written, but a zero-copy send may still read it. */
+static void
+__socket_ioq_entry_done(socket_private_t *priv, struct ioq *entry)
+{
+    if (entry->zerocopy)
+        list_move_tail(&entry->list, &priv->zc.pending);
+    else
+        __socket_ioq_entry_free(entry);
+}
+
+static void
+__socket_ioq_entry_advance(struct ioq *entry, size_t bytes)
+{
+    while (bytes > 0) {
+        if (bytes >= entry->pending_vector[0].iov_len) {
+            bytes -= entry->pending_vector[0].iov_len;
+            entry->pending_vector++;
+            entry->pending_count--;
+        } else {
+            entry->pending_vector[0].iov_base += bytes;
+            entry->pending_vector[0].iov_len -= bytes;
+            bytes = 0;
+        }
+    }
 }
 
 static int
@@ -1307,20 +1479,150 @@ __socket_ioq_churn_entry(rpc_transport_t *this, struct ioq *entry)
     return ret;
 }
 
+/*
+ * Writes the entries at the head of the queue with a single system call,
+ * as many of them as GF_SOCKET_BATCH_IOVEC iovecs allow.
+ *
+ * return value:
+ *   0 = all the entries gathered were written
+ *  -1 = error
+ * > 0 = incomplete
+ */
+static int
+__socket_ioq_churn_batch(rpc_transport_t *this)
+{
+    socket_private_t *priv = this->private;
+    struct iovec vector[GF_SOCKET_BATCH_IOVEC];
+    struct msghdr msg = {
+        0,
+    };
+    struct ioq *entry = NULL;
+    struct ioq *tmp = NULL;
+#ifdef GF_SOCKET_ZEROCOPY
+    gf_boolean_t large = _gf_false;
+    int i = 0;
+#endif
+    ssize_t written = 0;
+    size_t len = 0;
+    uint32_t seq = 0;
+    int entries = 0;
+    int flags = 0;
+    int count = 0;
+
+    list_for_each_entry(entry, &priv->ioq, list)
+    {
+        if (count + entry->pending_count > GF_SOCKET_BATCH_IOVEC)
+            break;
+
+#ifdef GF_SOCKET_ZEROCOPY
+        for (i = 0; i < entry->pending_count; i++) {
+            if (entry->pending_vector[i].iov_len >= GF_SOCKET_ZEROCOPY_MIN)
+                large = _gf_true;
+        }
+#endif
+
+        memcpy(&vector[count], entry->pending_vector,
+               sizeof(*vector) * entry->pending_count);
+        count += entry->pending_count;
+        entries++;
+    }
+
+    msg.msg_iov = vector;
+    msg.msg_iovlen = IOV_MIN(count);
+
+#ifdef GF_SOCKET_ZEROCOPY
+    if (large && __socket_zerocopy_usable(this))
+        flags = MSG_ZEROCOPY;
+#endif
+
+    for (;;) {
+        written = sendmsg(priv->sock, &msg, flags);
+        if (written >= 0)
+            break;
+
+        if (errno == EINTR)
+            continue;
+
+        /* out of memory to pin the pages, copy them instead */
+        if ((errno == ENOBUFS) && flags) {
+            flags = 0;
+            continue;
+        }
+
+        break;
+    }
+
+    if (written < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+            return 1;
+
+        if (__does_socket_rwv_error_need_logging(priv, 1)) {
+            GF_LOG_OCCASIONALLY(priv->log_ctr, this->name, GF_LOG_WARNING,
+                                "sendmsg on %s failed (%s)",
+                                this->peerinfo.identifier, strerror(errno));
+        }
+
+        return -1;
+    }
+
+    this->total_bytes_write += written;
+    this->total_writes++;
+
+    if (flags) {
+        seq = priv->zc.next++;
+        this->zerocopy_sends++;
+    }
+
+    list_for_each_entry_safe(entry, tmp, &priv->ioq, list)
+    {
+        if (entries-- == 0)
+            break;
+
+        if (written == 0)
+            return 1;
+
+        if (flags) {
+            entry->zc_seq = seq;
+            entry->zerocopy = 1;
+        }
+
+        len = iov_length(entry->pending_vector, entry->pending_count);
+        if (written < len) {
+            __socket_ioq_entry_advance(entry, written);
+            return 1;
+        }
+
+        written -= len;
+        entry->pending_count = 0;
+        __socket_ioq_entry_done(priv, entry);
+    }
+
+    return 0;
+}
+
+/* Writes from the head of the queue. SSL encrypts the entries one by one,
+ * other sockets get as many of them as possible in a single system call. */
+static int
+__socket_ioq_write(rpc_transport_t *this)
+{
+    socket_private_t *priv = this->private;
+
+    if (priv->use_ssl)
+        return __socket_ioq_churn_entry(this, priv->ioq_next);
+
+    return __socket_ioq_churn_batch(this);
+}
+
 static int
 __socket_ioq_churn(rpc_transport_t *this)
 {
     socket_private_t *priv = NULL;
     int ret = 0;
-    struct ioq *entry = NULL;
 
     priv = this->private;
 
     while (!list_empty(&priv->ioq)) {
-        /* pick next entry */
-        entry = priv->ioq_next;
-
-        ret = __socket_ioq_churn_entry(this, entry);
+        ret = __socket_ioq_write(this);
 
         if (ret != 0)
             break;
@@ -2849,6 +3151,44 @@ socket_complete_connection(rpc_transport_t *this)
     return ret;
 }
 
+/* EPOLLERR is also raised by the completions of zero-copy sends, queued on
+ * the error queue of the socket. Returns true if they were the only reason.
+ * Completions keep arriving while we look, so the error queue is not
+ * expected to be empty: a real failure shows up as a pending socket error
+ * or as a hang up. Completions that come in after the reap raise EPOLLERR
+ * again once the socket is rearmed. */
+static gf_boolean_t
+socket_event_poll_zerocopy(rpc_transport_t *this)
+{
+    gf_boolean_t only_zerocopy = _gf_false;
+#ifdef GF_SOCKET_ZEROCOPY
+    socket_private_t *priv = this->private;
+    struct pollfd pfd = {
+        0,
+    };
+    socklen_t optlen = sizeof(int);
+    int sock_err = 0;
+
+    pthread_mutex_lock(&priv->out_lock);
+    {
+        if (priv->zc.enabled && (priv->sock >= 0) &&
+            (__socket_zerocopy_reap(this) == 0) &&
+            (getsockopt(priv->sock, SOL_SOCKET, SO_ERROR, &sock_err,
+                        &optlen) == 0) &&
+            (sock_err == 0)) {
+            pfd.fd = priv->sock;
+            pfd.events = POLLIN;
+            if ((poll(&pfd, 1, 0) >= 0) &&
+                !(pfd.revents & (POLLHUP | POLLNVAL)))
+                only_zerocopy = _gf_true;
+        }
+    }
+    pthread_mutex_unlock(&priv->out_lock);
+#endif
+
+    return only_zerocopy;
+}
+
 /* reads rpc_requests during pollin */
 static void
 socket_event_handler(int fd, int idx, int gen, void *data, int poll_in,
@@ -2889,6 +3229,9 @@ socket_event_handler(int fd, int idx, int gen, void *data, int poll_in,
     }
     pthread_mutex_unlock(&priv->out_lock);
 
+    if (poll_err && socket_event_poll_zerocopy(this))
+        poll_err = 0;
+
     gf_log(this->name, GF_LOG_TRACE, "%s (sock:%d) in:%d, out:%d, err:%d",
            (priv->is_server ? "server" : "client"), priv->sock, poll_in,
            poll_out, poll_err);
@@ -3168,6 +3511,9 @@ socket_server_event_handler(int fd, int idx, int gen, void *data, int poll_in,
 
         new_priv->sock = new_sock;
 
+        if (new_sockaddr.ss_family != AF_UNIX)
+            __socket_zerocopy_setup(new_trans);
+
         new_priv->ssl_enabled = priv->ssl_enabled;
         new_priv->connected = 1;
         new_priv->is_server = _gf_true;
@@ -3453,6 +3799,8 @@ socket_connect(rpc_transport_t *this, int port)
                     gf_log(this->name, GF_LOG_ERROR,
                            "Failed to set keep-alive: %s", strerror(errno));
             }
+
+            __socket_zerocopy_setup(this);
         }
 
         SA(&this->myinfo.sockaddr)->sa_family = SA(&this->peerinfo.sockaddr)
@@ -3775,7 +4123,7 @@ socket_submit_outgoing_msg(rpc_transport_t *this, rpc_transport_msg_t *msg)
 {
     int ret = -1;
     char need_poll_out = 0;
-    char need_append = 1;
+    char need_write = 0;
     struct ioq *entry = NULL;
     glusterfs_ctx_t *ctx = NULL;
     socket_private_t *priv = NULL;
@@ -3802,21 +4150,16 @@ socket_submit_outgoing_msg(rpc_transport_t *this, rpc_transport_msg_t *msg)
         if (!entry)
             goto unlock;
 
-        if (list_empty(&priv->ioq)) {
-            ret = __socket_ioq_churn_entry(this, entry);
+        /* When entries are already waiting for POLLOUT, this one will be
+         * written with them. */
+        need_write = list_empty(&priv->ioq);
+        list_add_tail(&entry->list, &priv->ioq);
 
-            if (ret == 0) {
-                need_append = 0;
-            }
-            if (ret > 0) {
-                need_poll_out = 1;
-            }
-        }
+        if (need_write && (__socket_ioq_write(this) > 0))
+            need_poll_out = 1;
+
+        ret = 0;
 
-        if (need_append) {
-            list_add_tail(&entry->list, &priv->ioq);
-            ret = 0;
-        }
         if (need_poll_out) {
             /* first entry to wait. continue writing on POLLOUT */
             priv->idx = gf_event_select_on(ctx->event_pool, priv->sock,
@@ -4475,6 +4818,7 @@ socket_init(rpc_transport_t *this)
     priv->ssl_connected = _gf_false;
     priv->windowsize = GF_DEFAULT_SOCKET_WINDOW_SIZE;
     INIT_LIST_HEAD(&priv->ioq);
+    INIT_LIST_HEAD(&priv->zc.pending);
     pthread_mutex_init(&priv->notify.lock, NULL);
     pthread_cond_init(&priv->notify.cond, NULL);
 
@@ -4518,6 +4862,20 @@ socket_init(rpc_transport_t *this)
         }
     }
 
+    optstr = NULL;
+    data = dict_get_sizen(this->options, "transport.socket.zerocopy");
+    if (data) {
+        optstr = data_to_str(data);
+
+        if (gf_string2boolean(optstr, &tmp_bool) != 0) {
+            gf_log(this->name, GF_LOG_ERROR,
+                   "'transport.socket.zerocopy' takes only "
+                   "boolean options, not taking any action");
+            tmp_bool = 0;
+        }
+        priv->zerocopy = tmp_bool;
+    }
+
     optstr = NULL;
     if (dict_get_str_sizen(this->options, "tcp-window-size", &optstr) == 0) {
         if (gf_string2uint64(optstr, &windowsize) != 0) {
@@ -4743,6 +5101,14 @@ struct volume_options options[] = {
      .op_version = {GD_OP_VERSION_3_10_2},
      .default_value = "9"},
     {.key = {"transport.socket.read-fail-log"}, .type = GF_OPTION_TYPE_BOOL},
+    {.key = {"transport.socket.zerocopy"},
+     .type = GF_OPTION_TYPE_BOOL,
+     .op_version = {GD_OP_VERSION_9_0},
+     .default_value = "off",
+     .description = "Send large buffers with MSG_ZEROCOPY, letting the "
+                    "kernel read them from their iobufs instead of copying "
+                    "them. Only worth it for buffers of tens of KB on real "
+                    "network devices. Takes effect on new connections."},
     {.key = {SSL_ENABLED_OPT}, .type = GF_OPTION_TYPE_BOOL},
     {.key = {SSL_OWN_CERT_OPT}, .type = GF_OPTION_TYPE_STR},
     {.key = {SSL_PRIVATE_KEY_OPT}, .type = GF_OPTION_TYPE_STR},
@@ -30,6 +30,21 @@
 
 #define GF_DEFAULT_SOCKET_LISTEN_PORT GF_DEFAULT_BASE_PORT
 
+/* iovecs of queued messages gathered into a single system call */
+#define GF_SOCKET_BATCH_IOVEC 256
+
+#if defined(GF_LINUX_HOST_OS) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define GF_SOCKET_ZEROCOPY 1
+#endif
+
+/* sends with a buffer at least this large use MSG_ZEROCOPY */
+#define GF_SOCKET_ZEROCOPY_MIN (32 * GF_UNIT_KB)
+/* zero-copy sends waiting for their completion, at most */
+#define GF_SOCKET_ZEROCOPY_WINDOW 64
+/* completions in a row where the kernel had to copy the data anyway, after
+ * which zero-copy is not worth it on this connection */
+#define GF_SOCKET_ZEROCOPY_COPIED_MAX 32
+
 #define RPC_MAX_FRAGMENT_SIZE 0x7fffffff
 
 /* The default window size will be 0, indicating not to set
@@ -109,7 +124,20 @@ struct ioq {
     int pending_count;
     struct iobref *iobref;
     uint32_t fraghdr;
-    char _pad[4];
+    uint32_t zc_seq; /* last zero-copy send of data of this entry */
+    char zerocopy;   /* the kernel may read this entry until zc_seq is done */
+    char _pad[7];
+};
+
+struct gf_sock_zerocopy {
+    struct list_head pending; /* written entries the kernel may still read */
+    uint64_t done_mask;       /* bit n: send done_upto + n has completed */
+    uint32_t next;            /* sequence number of the next zero-copy send */
+    uint32_t done_upto;       /* all the sends before it have completed */
+    int copied_run; /* completions in a row where the kernel copied */
+    char enabled;   /* SO_ZEROCOPY is set on the socket */
+    char use;       /* large sends use MSG_ZEROCOPY */
+    char _pad[2];
 };
 
 typedef struct {
@@ -235,6 +263,7 @@ typedef struct {
     char *ssl_ca_list;
     char *crl_path;
     struct gf_sock_incoming incoming;
+    struct gf_sock_zerocopy zc;
     mgmt_ssl_t srvr_ssl;
     /* -1 = not connected. 0 = in progress. 1 = connected */
     char connected;
@@ -245,6 +274,7 @@ typedef struct {
     char connect_finish_log;
     char submit_log;
     char nodelay;
+    char zerocopy;
     gf_boolean_t read_fail_log;
     gf_boolean_t ssl_enabled; /* outbound I/O */
     gf_boolean_t mgmt_ssl;    /* outbound mgmt */
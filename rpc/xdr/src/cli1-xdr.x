@@ -69,6 +69,7 @@ enum gf_bitrot_type {
         GF_BITROT_CMD_SCRUB_STATUS,
         GF_BITROT_CMD_SCRUB_ONDEMAND,
         GF_BITROT_OPTION_TYPE_SIGNER_THREADS,
+        GF_BITROT_OPTION_TYPE_SIGNATURE_TYPE,
         GF_BITROT_OPTION_TYPE_MAX
 };
 
@@ -795,3 +795,36 @@ struct gfs4_entrylk_contention_req {
         string                domain<>;
         opaque                xdata<>;
 };
+
+/* Compound fops: the fops of a request are run by the server one after the
+ * other, whatever the result of the previous ones, and are answered with a
+ * single reply holding the reply of each of them. A write is the exception:
+ * it is only run if all the fops before it succeeded. Its payload follows
+ * the request, so a compound holds at most one write. */
+union compound_req_v2 switch (int fop_enum) {
+        case GF_FOP_INODELK:  gfx_inodelk_req  compound_inodelk_req;
+        case GF_FOP_FINODELK: gfx_finodelk_req compound_finodelk_req;
+        case GF_FOP_XATTROP:  gfx_xattrop_req  compound_xattrop_req;
+        case GF_FOP_FXATTROP: gfx_fxattrop_req compound_fxattrop_req;
+        case GF_FOP_WRITE:    gfx_write_req    compound_write_req;
+};
+
+struct gfx_compound_req {
+        compound_req_v2 compound_req_array<>;
+        gfx_dict        xdata;
+};
+
+union compound_rsp_v2 switch (int fop_enum) {
+        case GF_FOP_INODELK:  gfx_common_rsp       compound_inodelk_rsp;
+        case GF_FOP_FINODELK: gfx_common_rsp       compound_finodelk_rsp;
+        case GF_FOP_XATTROP:  gfx_common_dict_rsp  compound_xattrop_rsp;
+        case GF_FOP_FXATTROP: gfx_common_dict_rsp  compound_fxattrop_rsp;
+        case GF_FOP_WRITE:    gfx_common_2iatt_rsp compound_write_rsp;
+};
+
+struct gfx_compound_rsp {
+        int             op_ret;
+        int             op_errno;
+        compound_rsp_v2 compound_rsp_array<>;
+        gfx_dict        xdata;
+};
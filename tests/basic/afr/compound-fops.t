@@ -0,0 +1,78 @@
+#!/bin/bash
+#Test that writes sent along with their pre-op, and data and metadata
+#transactions ending with a compound post-op and unlock leave the bricks in
+#sync, without pending heals.
+
+. $(dirname $0)/../../include.rc
+. $(dirname $0)/../../volume.rc
+
+function compound_fops_sent {
+        local statedump=$(generate_mount_statedump $V0)
+        grep -a "^compound_fops=" $statedump | cut -f2 -d'=' | \
+                awk '{sum += $1} END {print sum + 0}'
+        rm -f $statedump
+}
+
+function frames_in_flight {
+        local statedump=$(generate_mount_statedump $V0)
+        grep -a "^callpool.cnt=" $statedump | cut -f2 -d'='
+        rm -f $statedump
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+TEST $CLI volume create $V0 replica 3 $H0:$B0/brick{0,1,2}
+TEST $CLI volume set $V0 cluster.use-compound-fops on
+TEST $CLI volume set $V0 performance.write-behind off
+TEST $CLI volume set $V0 cluster.self-heal-daemon off
+TEST $CLI volume start $V0
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0;
+
+#Eager-locked writes, the first one goes with the pre-op and the last one
+#unlocks with the post-op
+TEST dd of=$M0/file if=/dev/urandom bs=128k count=16 conv=fsync
+#Non eager-locked metadata transactions
+TEST chmod 0600 $M0/file
+TEST setfattr -n user.compound -v value $M0/file
+TEST truncate -s 1M $M0/file
+
+#Writes from two fds contend for the eager-lock
+TEST fd_open 3 'w' "$M0/file"
+TEST fd_open 4 'w' "$M0/file"
+TEST fd_write 3 "abc"
+TEST fd_write 4 "def"
+TEST fd_close 3
+TEST fd_close 4
+
+EXPECT "0" get_pending_heal_count $V0
+#The pre-op and write, post-op and unlock must have gone out as COMPOUND
+#requests
+TEST [ $(compound_fops_sent) -gt 0 ]
+#and the transactions unlocked that way must all be done
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "^0$" frames_in_flight
+
+md5sum0=$(md5sum $B0/brick0/file | awk '{print $1}')
+EXPECT "$md5sum0" echo $(md5sum $B0/brick1/file | awk '{print $1}')
+EXPECT "$md5sum0" echo $(md5sum $B0/brick2/file | awk '{print $1}')
+EXPECT "value" echo $(getfattr -n user.compound --only-values $B0/brick2/file)
+EXPECT "600" stat -c %a $B0/brick1/file
+
+#With a brick down the post-op must still mark the pending data
+TEST kill_brick $V0 $H0 $B0/brick2
+TEST dd of=$M0/file if=/dev/urandom bs=128k count=4 conv=fsync,notrunc
+EXPECT "^1$" get_pending_heal_count $V0
+
+TEST $CLI volume start $V0 force
+EXPECT_WITHIN $CHILD_UP_TIMEOUT "1" afr_child_up_status $V0 2
+TEST $CLI volume set $V0 cluster.self-heal-daemon on
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "Y" glustershd_up_status
+EXPECT_WITHIN $CHILD_UP_TIMEOUT "1" afr_child_up_status_in_shd $V0 2
+TEST $CLI volume heal $V0
+EXPECT_WITHIN $HEAL_TIMEOUT "0" get_pending_heal_count $V0
+
+md5sum0=$(md5sum $B0/brick0/file | awk '{print $1}')
+EXPECT "$md5sum0" echo $(md5sum $B0/brick2/file | awk '{print $1}')
+
+cleanup;
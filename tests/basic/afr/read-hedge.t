@@ -0,0 +1,46 @@
+#!/bin/bash
+
+## With cluster.read-hedge on, a read that is held up on one brick is also
+## sent to the other one and answered from there.
+
+. $(dirname $0)/../../include.rc
+. $(dirname $0)/../../volume.rc
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+TEST $CLI volume create $V0 replica 2 $H0:$B0/${V0}{0,1}
+
+TEST $CLI volume set $V0 cluster.choose-local off
+TEST $CLI volume set $V0 cluster.read-hedge on
+TEST $CLI volume set $V0 performance.quick-read off
+TEST $CLI volume set $V0 performance.io-cache off
+TEST $CLI volume set $V0 performance.read-ahead off
+TEST $CLI volume set $V0 performance.open-behind off
+TEST $CLI volume set $V0 delay-gen posix
+TEST $CLI volume set $V0 delay-gen.delay-duration 3000000
+TEST $CLI volume set $V0 delay-gen.delay-percentage 10
+TEST $CLI volume set $V0 delay-gen.enable read
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+EXPECT "1" mount_get_option_value $M0 $V0-replicate-0 read-hedge
+
+TEST dd if=/dev/urandom of=$B0/src bs=64k count=64
+TEST cp $B0/src $M0/file
+
+## 64 reads with one in ten stalled for 3s would take about 20s unhedged
+start=$(date +%s)
+TEST dd if=$M0/file of=$B0/dst bs=64k iflag=direct
+TEST [ $(($(date +%s) - start)) -lt 15 ]
+TEST cmp $B0/src $B0/dst
+
+TEST [ $(mount_get_option_value $M0 $V0-replicate-0 read_hedges) -gt 0 ]
+TEST [ $(mount_get_option_value $M0 $V0-replicate-0 read_hedges_won) -gt 0 ]
+
+TEST $CLI volume set $V0 cluster.read-hedge off
+EXPECT_WITHIN $CONFIG_UPDATE_TIMEOUT "0" mount_get_option_value $M0 $V0-replicate-0 read-hedge
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
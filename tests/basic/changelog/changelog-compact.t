@@ -0,0 +1,63 @@
+#!/bin/bash
+
+## Changes journalled with the compact encoding, synced in batches, are
+## decoded by libgfchangelog into the same records as the ascii encoding.
+
+. $(dirname $0)/../../include.rc
+. $(dirname $0)/../../volume.rc
+. $(dirname $0)/../../env.rc
+
+cleanup;
+
+HISTORY_BIN_PATH=$(dirname $0)/../../utils/changelog
+build_tester $HISTORY_BIN_PATH/test-history-api.c -lgfchangelog
+
+PROCESSED=/tmp/scratch_v1/.history/.processed
+ROLLOVER_TIME=2
+
+function count_records {
+        cat $PROCESSED/CHANGELOG.* 2>/dev/null | grep -c -- "$1"
+}
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 changelog.changelog on
+TEST $CLI volume set $V0 changelog.encoding compact
+TEST $CLI volume set $V0 changelog.fsync-interval 0
+TEST $CLI volume set $V0 changelog.capture-del-path on
+TEST $CLI volume set $V0 changelog.rollover-time $ROLLOVER_TIME
+TEST $CLI volume start $V0
+
+sleep 3
+start=$(date '+%s')
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0;
+
+TEST mkdir $M0/dir1
+for i in {1..20}; do echo "data" > "$M0/dir1/file $i" & done
+wait
+TEST chmod 600 "$M0/dir1/file 1"
+TEST mkdir $M0/dir2
+TEST mv $M0/dir2 $M0/dir1/dir3
+TEST rm -f "$M0/dir1/file 2"
+
+sleep $((ROLLOVER_TIME + 1))
+end=$(date '+%s')
+sleep 2
+
+EXPECT "0" $HISTORY_BIN_PATH/test-history-api $start $end
+
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "Y" processed_changelogs $PROCESSED
+EXPECT "2" count_records " MKDIR "
+EXPECT "20" count_records " CREATE "
+EXPECT "1" count_records "/file%201$"
+EXPECT "1" count_records " SETATTR"
+EXPECT "1" count_records " RENAME .*/dir2 .*/dir3$"
+EXPECT "1" count_records " UNLINK .*/file%202 dir1/file%202$"
+
+TEST rm $HISTORY_BIN_PATH/test-history-api
+rm -rf /tmp/scratch_v1
+
+cleanup;
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+. $(dirname $0)/../../include.rc
+. $(dirname $0)/../../volume.rc
+. $(dirname $0)/../../dht.rc
+
+# Migrate regular and sparse files with several blocks in flight and check
+# that their contents survive the rebalance.
+
+cleanup;
+
+TEST glusterd;
+TEST pidof glusterd;
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}{1,2};
+TEST $CLI volume set $V0 cluster.rebal-inflight-blocks 8
+TEST $CLI volume start $V0;
+EXPECT 'Started' volinfo_field $V0 'Status';
+
+TEST glusterfs --volfile-id=$V0 --volfile-server=$H0 --entry-timeout=0 $M0;
+
+TEST mkdir $M0/dir
+for i in {1..10}; do
+        # sizes that are not a multiple of the block size
+        TEST dd if=/dev/urandom of=$M0/dir/file-$i bs=1k count=$((i * 1500 + 7))
+done
+
+# data segments separated by holes, some of them larger than a block
+for i in {1..5}; do
+        TEST dd if=/dev/urandom of=$M0/dir/sparse-$i bs=1M count=3 seek=0
+        TEST dd if=/dev/urandom of=$M0/dir/sparse-$i bs=1k count=100 \
+                seek=$((i * 4096)) conv=notrunc
+        TEST dd if=/dev/urandom of=$M0/dir/sparse-$i bs=1M count=2 \
+                seek=$((i * 8)) conv=notrunc
+done
+
+checksums=$(cd $M0/dir && md5sum *)
+
+TEST $CLI volume add-brick $V0 $H0:$B0/${V0}3;
+TEST $CLI volume rebalance $V0 start force;
+EXPECT_WITHIN $REBALANCE_TIMEOUT "0" rebalance_completed;
+
+# some files must have been moved to the new brick
+TEST [ $(ls $B0/${V0}3/dir | wc -l) -gt 0 ]
+
+TEST [ "$checksums" == "$(cd $M0/dir && md5sum *)" ]
+
+cleanup;
@@ -0,0 +1,56 @@
+#!/bin/bash
+
+## Bricks started with config.event-pinning poll each connection from a
+## single event thread and keep serving I/O when server.event-threads is
+## raised or lowered.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function epoll_threads {
+        ps hH -o comm $(get_brick_pid $V0 $H0 $B0/${V0}0) | grep -c glfs_epoll
+}
+
+function brick_pinned {
+        ps -o args= -p $(get_brick_pid $V0 $H0 $B0/${V0}0) | \
+                grep -c -- "--event-pinning"
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 config.event-pinning on
+TEST $CLI volume set $V0 server.event-threads 2
+TEST $CLI volume start $V0
+EXPECT "1" brick_pinned
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M1
+
+for i in {1..4}; do
+        dd if=/dev/urandom of=$M0/file$i bs=64k count=32 2>/dev/null &
+        dd if=/dev/urandom of=$M1/data$i bs=64k count=32 2>/dev/null &
+done
+wait
+
+TEST $CLI volume set $V0 server.event-threads 6
+EXPECT_WITHIN $CONFIG_UPDATE_TIMEOUT "^[6-9]$" epoll_threads
+for i in {1..4}; do
+        TEST cmp $M0/file$i $M1/file$i
+        TEST cmp $M0/data$i $M1/data$i
+done
+
+TEST $CLI volume set $V0 server.event-threads 1
+EXPECT_WITHIN $CONFIG_UPDATE_TIMEOUT "^[1-3]$" epoll_threads
+for i in {1..4}; do
+        TEST cp $M0/file$i $M0/copy$i
+        TEST cmp $M1/copy$i $M1/file$i
+done
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M1
+
+cleanup;
@@ -0,0 +1,41 @@
+#!/bin/bash
+
+## A mount started with --max-write asks the kernel for requests of that
+## size and reads back what it wrote.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function mount_max_read {
+        grep " $M0 fuse" /proc/mounts | sed -n 's/.*max_read=\([0-9]*\).*/\1/p'
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --max-write=1MB $M0
+EXPECT "1048576" mount_max_read
+
+TEST dd if=/dev/urandom of=$B0/src bs=1M count=16
+TEST dd if=$B0/src of=$M0/file bs=4M oflag=direct
+TEST dd if=$M0/file of=$B0/dst bs=4M iflag=direct
+TEST cmp $B0/src $B0/dst
+TEST cmp $B0/src $B0/${V0}0/file
+
+## small writes are copied out of the buffer /dev/fuse was read into
+TEST dd if=$B0/src of=$M0/small bs=4k count=1024 conv=fsync
+TEST cmp -n 4194304 $B0/src $B0/${V0}0/small
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --max-write=128KB $M0
+EXPECT "131072" mount_max_read
+TEST cmp $B0/src $M0/file
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
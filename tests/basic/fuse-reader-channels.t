@@ -0,0 +1,43 @@
+#!/bin/bash
+
+## With more than one reader thread each reader gets its own clone of the
+## /dev/fuse channel, and requests are answered on the channel they came
+## in on.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function cloned_channels {
+        local statedump=$(generate_mount_statedump $V0 $M0)
+        grep -a "^cloned_channels=" $statedump | cut -f2 -d'='
+        rm -f $statedump
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --reader-thread-count=4 $M0
+TEST ls $M0
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "3" cloned_channels
+
+for j in {1..8}; do
+        (
+                mkdir $M0/dir$j
+                for i in {1..100}; do echo $i > $M0/dir$j/file$i; done
+                for i in {1..100}; do stat $M0/dir$j/file$i > /dev/null; done
+        ) &
+done
+wait
+
+EXPECT "800" echo $(ls $M0/dir* | grep -c ^file)
+EXPECT "800" echo $(cat $M0/dir*/file* | wc -l)
+TEST rm -rf $M0/dir*
+EXPECT "0" echo $(ls $M0 | wc -l)
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
@@ -0,0 +1,163 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glusterfs/api/glfs.h>
+
+#define VALIDATE_AND_GOTO_LABEL_ON_ERROR(func, ret, label)                     \
+    do {                                                                       \
+        if (ret < 0) {                                                         \
+            fprintf(stderr, "%s : returned error %d (%s)\n", func, ret,        \
+                    strerror(errno));                                          \
+            goto label;                                                        \
+        }                                                                      \
+    } while (0)
+
+#define BLOCKS 64
+#define BLOCK_SIZE (128 * 1024)
+
+static char *
+buf_ptr(glfs_buf_t *buf)
+{
+    char *ptr = glfs_buf_ptr(buf);
+
+    if (ptr == NULL)
+        fprintf(stderr, "buffer has no memory\n");
+
+    return ptr;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int ret = -1;
+    glfs_t *fs = NULL;
+    glfs_fd_t *fd = NULL;
+    glfs_buf_t *buf = NULL;
+    char *volname = NULL;
+    char *logfile = NULL;
+    const char *filename = "file_buf";
+    char *ptr = NULL;
+    char *expected = NULL;
+    struct glfs_stat sb;
+    int i = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "Invalid argument\n");
+        return 1;
+    }
+
+    volname = argv[1];
+    logfile = argv[2];
+
+    expected = malloc(BLOCK_SIZE);
+    if (!expected)
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("malloc", ret, out);
+
+    fs = glfs_new(volname);
+    if (!fs)
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_new", ret, out);
+
+    ret = glfs_set_volfile_server(fs, "tcp", "localhost", 24007);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_volfile_server", ret, out);
+
+    ret = glfs_set_logging(fs, logfile, 7);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_logging", ret, out);
+
+    ret = glfs_init(fs);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_init", ret, out);
+
+    fd = glfs_creat(fs, filename, O_RDWR | O_TRUNC, 0644);
+    if (fd == NULL) {
+        ret = -1;
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_creat", ret, out);
+    }
+
+    buf = glfs_buf_alloc(fs, BLOCK_SIZE);
+    if (buf == NULL) {
+        ret = -1;
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_buf_alloc", ret, out);
+    }
+
+    /* the memory may change after every write */
+    for (i = 0; i < BLOCKS; i++) {
+        ptr = buf_ptr(buf);
+        if (ptr == NULL) {
+            ret = -1;
+            goto out;
+        }
+        memset(ptr, 'a' + (i % 26), BLOCK_SIZE);
+
+        ret = glfs_buf_pwrite(fd, buf, BLOCK_SIZE, (off_t)i * BLOCK_SIZE, 0,
+                              NULL, NULL);
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_buf_pwrite", ret, out);
+        if (ret != BLOCK_SIZE) {
+            fprintf(stderr, "short write of block %d: %d\n", i, ret);
+            ret = -1;
+            goto out;
+        }
+    }
+
+    ret = glfs_fsync(fd, NULL, NULL);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_fsync", ret, out);
+
+    for (i = 0; i < BLOCKS; i++) {
+        memset(expected, 'a' + (i % 26), BLOCK_SIZE);
+
+        ret = glfs_buf_pread(fd, buf, BLOCK_SIZE, (off_t)i * BLOCK_SIZE, 0,
+                             &sb);
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_buf_pread", ret, out);
+
+        ptr = buf_ptr(buf);
+        if ((ret != BLOCK_SIZE) || (ptr == NULL) ||
+            memcmp(ptr, expected, BLOCK_SIZE)) {
+            fprintf(stderr, "block %d differs\n", i);
+            ret = -1;
+            goto out;
+        }
+    }
+
+    if (sb.glfs_st_size != (off_t)BLOCKS * BLOCK_SIZE) {
+        fprintf(stderr, "wrong size %jd should be %jd\n",
+                (intmax_t)sb.glfs_st_size, (intmax_t)BLOCKS * BLOCK_SIZE);
+        ret = -1;
+        goto out;
+    }
+
+    /* a buffer filled by a read can be written as is */
+    ret = glfs_buf_pwrite(fd, buf, BLOCK_SIZE, (off_t)BLOCKS * BLOCK_SIZE, 0,
+                          NULL, NULL);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_buf_pwrite", ret, out);
+
+    ret = glfs_pread(fd, expected, BLOCK_SIZE, (off_t)BLOCKS * BLOCK_SIZE, 0,
+                     NULL);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_pread", ret, out);
+    for (i = 0; i < BLOCK_SIZE; i++) {
+        if (expected[i] != 'a' + ((BLOCKS - 1) % 26)) {
+            fprintf(stderr, "copied block differs at %d\n", i);
+            ret = -1;
+            goto out;
+        }
+    }
+
+    /* larger than the buffer */
+    ret = glfs_buf_pread(fd, buf, BLOCK_SIZE + 1, 0, 0, NULL);
+    if ((ret != -1) || (errno != EINVAL)) {
+        fprintf(stderr, "oversized read returned %d\n", ret);
+        ret = -1;
+        goto out;
+    }
+
+    ret = 0;
+out:
+    if (buf != NULL)
+        glfs_buf_free(buf);
+    if (fd != NULL)
+        glfs_close(fd);
+    if (fs)
+        (void)glfs_fini(fs);
+    free(expected);
+
+    return ret;
+}
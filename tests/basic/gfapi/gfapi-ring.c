@@ -0,0 +1,201 @@
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glusterfs/api/glfs.h>
+
+#define VALIDATE_AND_GOTO_LABEL_ON_ERROR(func, ret, label)                     \
+    do {                                                                       \
+        if (ret < 0) {                                                         \
+            fprintf(stderr, "%s : returned error %d (%s)\n", func, ret,        \
+                    strerror(errno));                                          \
+            goto label;                                                        \
+        }                                                                      \
+    } while (0)
+
+#define RING_ENTRIES 32
+#define BLOCKS 256
+#define BLOCK_SIZE 4096
+
+static char wbuf[BLOCKS][BLOCK_SIZE];
+static char rbuf[BLOCKS][BLOCK_SIZE];
+
+static void
+prep_rw(struct glfs_ring_sqe *sqe, int opcode, glfs_fd_t *fd, char *buf,
+        int block)
+{
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->buf = buf;
+    sqe->count = BLOCK_SIZE;
+    sqe->offset = (off_t)block * BLOCK_SIZE;
+    sqe->user_data = block;
+}
+
+/* Submits all the blocks, keeping the ring as full as possible, and checks
+ * every completion. */
+static int
+run_blocks(glfs_ring_t *ring, glfs_fd_t *fd, int opcode)
+{
+    struct glfs_ring_sqe sqes[RING_ENTRIES];
+    struct glfs_ring_cqe cqes[RING_ENTRIES];
+    uint64_t block = 0;
+    int submitted = 0;
+    int completed = 0;
+    int count = 0;
+    int ret = 0;
+    int i = 0;
+
+    while (completed < BLOCKS) {
+        for (count = 0; (count < RING_ENTRIES) && (submitted + count < BLOCKS);
+             count++) {
+            i = submitted + count;
+            prep_rw(&sqes[count], opcode, fd,
+                    (opcode == GLFS_RING_OP_PWRITE) ? wbuf[i] : rbuf[i], i);
+        }
+
+        ret = glfs_ring_submit(ring, sqes, count);
+        if ((ret < 0) && (errno != EAGAIN))
+            VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_ring_submit", ret, out);
+        if (ret > 0)
+            submitted += ret;
+
+        ret = glfs_ring_reap(ring, cqes, RING_ENTRIES, 1, -1);
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_ring_reap", ret, out);
+
+        for (i = 0; i < ret; i++) {
+            block = cqes[i].user_data;
+            if (cqes[i].res != BLOCK_SIZE) {
+                fprintf(stderr, "block %" PRIu64 " returned %zd\n", block,
+                        cqes[i].res);
+                return -1;
+            }
+            if ((opcode == GLFS_RING_OP_PREAD) &&
+                memcmp(rbuf[block], wbuf[block], BLOCK_SIZE)) {
+                fprintf(stderr, "block %" PRIu64 " differs\n", block);
+                return -1;
+            }
+        }
+        completed += ret;
+    }
+
+    ret = 0;
+out:
+    return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int ret = -1;
+    glfs_t *fs = NULL;
+    glfs_fd_t *fd = NULL;
+    glfs_ring_t *ring = NULL;
+    char *volname = NULL;
+    char *logfile = NULL;
+    const char *filename = "file_ring";
+    struct glfs_ring_sqe sqes[3];
+    struct glfs_ring_cqe cqes[3];
+    struct stat sb;
+    int i = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "Invalid argument\n");
+        return 1;
+    }
+
+    volname = argv[1];
+    logfile = argv[2];
+
+    for (i = 0; i < BLOCKS; i++)
+        memset(wbuf[i], 'a' + (i % 26), BLOCK_SIZE);
+
+    fs = glfs_new(volname);
+    if (!fs)
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_new", ret, out);
+
+    ret = glfs_set_volfile_server(fs, "tcp", "localhost", 24007);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_volfile_server", ret, out);
+
+    ret = glfs_set_logging(fs, logfile, 7);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_logging", ret, out);
+
+    ret = glfs_init(fs);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_init", ret, out);
+
+    fd = glfs_creat(fs, filename, O_RDWR | O_TRUNC, 0644);
+    if (fd == NULL) {
+        ret = -1;
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_creat", ret, out);
+    }
+
+    ring = glfs_ring_new(fs, RING_ENTRIES);
+    if (ring == NULL) {
+        ret = -1;
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_ring_new", ret, out);
+    }
+
+    ret = run_blocks(ring, fd, GLFS_RING_OP_PWRITE);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("ring writes", ret, out);
+
+    /* a batch mixing a sync, a stat and an invalid request */
+    memset(sqes, 0, sizeof(sqes));
+    sqes[0].opcode = GLFS_RING_OP_FSYNC;
+    sqes[0].fd = fd;
+    sqes[1].opcode = GLFS_RING_OP_FSTAT;
+    sqes[1].fd = fd;
+    sqes[1].buf = &sb;
+    sqes[1].user_data = 1;
+    sqes[2].opcode = -1;
+    sqes[2].fd = fd;
+    sqes[2].user_data = 2;
+
+    ret = glfs_ring_submit(ring, sqes, 3);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_ring_submit", ret, out);
+
+    ret = glfs_ring_reap(ring, cqes, 3, 3, 10000);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_ring_reap", ret, out);
+    if (ret != 3) {
+        fprintf(stderr, "reaped %d completions instead of 3\n", ret);
+        ret = -1;
+        goto out;
+    }
+
+    for (i = 0; i < 3; i++) {
+        if (cqes[i].res != ((cqes[i].user_data == 2) ? -EINVAL : 0)) {
+            fprintf(stderr, "request %" PRIu64 " returned %zd\n",
+                    cqes[i].user_data, cqes[i].res);
+            ret = -1;
+            goto out;
+        }
+    }
+
+    if (sb.st_size != (off_t)BLOCKS * BLOCK_SIZE) {
+        fprintf(stderr, "wrong size %jd should be %jd\n", (intmax_t)sb.st_size,
+                (intmax_t)BLOCKS * BLOCK_SIZE);
+        ret = -1;
+        goto out;
+    }
+
+    ret = run_blocks(ring, fd, GLFS_RING_OP_PREAD);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("ring reads", ret, out);
+
+    /* nothing is in flight, this must not block */
+    ret = glfs_ring_reap(ring, cqes, 3, 1, -1);
+    if (ret != 0) {
+        fprintf(stderr, "reaped %d completions from an idle ring\n", ret);
+        ret = -1;
+    }
+
+out:
+    if (ring != NULL)
+        glfs_ring_free(ring);
+    if (fd != NULL)
+        glfs_close(fd);
+    if (fs)
+        (void)glfs_fini(fs);
+
+    return ret;
+}
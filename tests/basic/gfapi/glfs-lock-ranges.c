@@ -0,0 +1,171 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <glusterfs/api/glfs.h>
+
+#define VALIDATE_AND_GOTO_LABEL_ON_ERROR(func, ret, label)                     \
+    do {                                                                       \
+        if (ret < 0) {                                                         \
+            fprintf(stderr, "%s : returned error %d (%s)\n", func, ret,        \
+                    strerror(errno));                                          \
+            goto label;                                                        \
+        }                                                                      \
+    } while (0)
+
+#define HELD 10000
+#define RANGE 4096
+
+static char ownera[8] = "ownera", ownerb[8] = "ownerb", ownerc[8] = "ownerc";
+
+static int
+set_lock(glfs_fd_t *fd, char *owner, int cmd, short type, off_t start,
+         off_t len)
+{
+    struct flock lock = {
+        0,
+    };
+    int ret = 0;
+
+    ret = glfs_fd_set_lkowner(fd, owner, sizeof(ownera));
+    if (ret < 0)
+        return ret;
+
+    lock.l_type = type;
+    lock.l_whence = SEEK_SET;
+    lock.l_start = start;
+    lock.l_len = len;
+
+    return glfs_posix_lock(fd, cmd, &lock);
+}
+
+static int
+expect_lock(glfs_fd_t *fd, char *owner, short type, off_t start, off_t len,
+            int granted)
+{
+    int ret = set_lock(fd, owner, F_SETLK, type, start, len);
+
+    if ((ret == 0) != granted) {
+        fprintf(stderr, "%s lock %s %jd+%jd: expected %s, got %d (%s)\n",
+                (type == F_WRLCK) ? "write" : "read", owner, (intmax_t)start,
+                (intmax_t)len, granted ? "granted" : "conflict", ret,
+                strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int ret = -1;
+    glfs_t *fs = NULL;
+    glfs_fd_t *fd1 = NULL;
+    glfs_fd_t *fd2 = NULL;
+    char *volname = NULL;
+    char *logfile = NULL;
+    const char *filename = "file_lock_ranges";
+    struct flock getlk = {
+        0,
+    };
+    int i = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "Invalid argument\n");
+        return 1;
+    }
+
+    volname = argv[1];
+    logfile = argv[2];
+
+    fs = glfs_new(volname);
+    if (!fs)
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_new", ret, out);
+
+    ret = glfs_set_volfile_server(fs, "tcp", "localhost", 24007);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_volfile_server", ret, out);
+
+    ret = glfs_set_logging(fs, logfile, 7);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_set_logging", ret, out);
+
+    ret = glfs_init(fs);
+    VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_init", ret, out);
+
+    fd1 = glfs_creat(fs, filename, O_RDWR, 0644);
+    fd2 = glfs_open(fs, filename, O_RDWR);
+    if ((fd1 == NULL) || (fd2 == NULL)) {
+        ret = -1;
+        VALIDATE_AND_GOTO_LABEL_ON_ERROR("glfs_open", ret, out);
+    }
+
+    ret = -1;
+
+    /* many disjoint ranges held by one owner */
+    for (i = 0; i < HELD; i++) {
+        if (expect_lock(fd1, ownera, F_WRLCK, (off_t)i * 2 * RANGE, RANGE, 1))
+            goto out;
+    }
+
+    /* the gaps are free for another owner, the ranges are not */
+    for (i = 0; i < HELD; i += 97) {
+        if (expect_lock(fd2, ownerb, F_WRLCK, (off_t)(i * 2 + 1) * RANGE,
+                        RANGE, 1) ||
+            expect_lock(fd2, ownerb, F_UNLCK, (off_t)(i * 2 + 1) * RANGE,
+                        RANGE, 1) ||
+            expect_lock(fd2, ownerb, F_RDLCK, (off_t)i * 2 * RANGE + RANGE - 1,
+                        2, 0))
+            goto out;
+    }
+
+    getlk.l_type = F_WRLCK;
+    getlk.l_whence = SEEK_SET;
+    getlk.l_start = (off_t)(HELD - 1) * 2 * RANGE + 10;
+    getlk.l_len = 1;
+    if (glfs_fd_set_lkowner(fd2, ownerb, sizeof(ownerb)) ||
+        glfs_posix_lock(fd2, F_GETLK, &getlk))
+        goto out;
+    if ((getlk.l_type != F_WRLCK) ||
+        (getlk.l_start != (off_t)(HELD - 1) * 2 * RANGE) ||
+        (getlk.l_len != RANGE)) {
+        fprintf(stderr, "unexpected conflict %d %jd+%jd\n", getlk.l_type,
+                (intmax_t)getlk.l_start, (intmax_t)getlk.l_len);
+        goto out;
+    }
+
+    /* a read lock of the same owner over two ranges and a gap replaces them */
+    if (expect_lock(fd1, ownera, F_RDLCK, 0, 3 * RANGE, 1) ||
+        expect_lock(fd2, ownerb, F_RDLCK, RANGE, 2 * RANGE, 1) ||
+        expect_lock(fd2, ownerb, F_WRLCK, 2 * RANGE, 1, 0) ||
+        expect_lock(fd2, ownerb, F_UNLCK, RANGE, 2 * RANGE, 1))
+        goto out;
+
+    /* releasing everything leaves the whole file free */
+    if (expect_lock(fd1, ownera, F_UNLCK, 0, 0, 1) ||
+        expect_lock(fd2, ownerb, F_WRLCK, 0, 0, 1) ||
+        expect_lock(fd2, ownerb, F_UNLCK, 0, 0, 1))
+        goto out;
+
+    /* overlapping read locks of one owner are merged, even when a read lock
+     * of another owner overlaps them too, so that a single unlock releases
+     * all of them */
+    if (expect_lock(fd2, ownerb, F_RDLCK, 5, 10, 1) ||
+        expect_lock(fd1, ownera, F_RDLCK, 0, 10, 1) ||
+        expect_lock(fd1, ownera, F_RDLCK, 8, 12, 1) ||
+        expect_lock(fd1, ownera, F_UNLCK, 0, 20, 1) ||
+        expect_lock(fd1, ownerc, F_WRLCK, 15, 5, 1))
+        goto out;
+
+    ret = 0;
+out:
+    if (fd1 != NULL)
+        glfs_close(fd1);
+    if (fd2 != NULL)
+        glfs_close(fd2);
+    if (fs)
+        (void)glfs_fini(fs);
+
+    return ret;
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+## A file read more than once stays in io-cache while a sequential read of
+## a file larger than the cache goes through it.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function ioc_shard_total {
+        local statedump=$(generate_mount_statedump $V0 $M0)
+        grep -a "^shard\[[0-9]*\]\.$1=" $statedump | cut -f2 -d'=' | \
+                awk '{ total += $1 } END { print total }'
+        rm -f $statedump
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 performance.io-cache on
+TEST $CLI volume set $V0 performance.io-cache-size 32MB
+TEST $CLI volume set $V0 performance.read-ahead off
+TEST $CLI volume set $V0 performance.quick-read off
+TEST $CLI volume set $V0 performance.open-behind off
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --direct-io-mode=yes $M0
+
+TEST dd if=/dev/urandom of=$M0/hot bs=128k count=64
+TEST dd if=/dev/zero of=$M0/scan bs=1M count=128
+sleep 2
+
+## reading the hot file again hits the cache and protects its pages
+TEST dd if=$M0/hot of=/dev/null bs=128k
+TEST dd if=$M0/hot of=/dev/null bs=128k
+TEST dd if=$M0/hot of=/dev/null bs=128k
+TEST [ $(ioc_shard_total protected) -gt 0 ]
+
+TEST dd if=$M0/scan of=/dev/null bs=128k
+TEST [ $(ioc_shard_total evictions) -gt 0 ]
+
+misses=$(ioc_shard_total misses)
+TEST dd if=$M0/hot of=/dev/null bs=128k
+EXPECT "$misses" ioc_shard_total misses
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
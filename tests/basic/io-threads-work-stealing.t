@@ -0,0 +1,53 @@
+#!/bin/bash
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+# Run I/O on a brick whose io-threads use per-worker queues with work
+# stealing, and check that the queues and steal counters are dumped.
+
+function count_files {
+        ls $M0/dir 2>/dev/null | wc -l
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 performance.iot-work-stealing on
+TEST $CLI volume set $V0 performance.high-prio-threads 4
+TEST $CLI volume start $V0
+EXPECT 'Started' volinfo_field $V0 'Status'
+
+TEST $GFS -s $H0 --volfile-id $V0 $M0
+
+TEST mkdir $M0/dir
+for i in {1..8}; do
+        dd if=/dev/urandom of=$M0/dir/file-$i bs=128k count=64 &
+done
+wait
+for i in {1..8}; do
+        ls -l $M0/dir >/dev/null &
+        cat $M0/dir/file-$i >/dev/null &
+done
+wait
+
+EXPECT "8" count_files
+
+brick_pid=$(get_brick_pid $V0 $H0 $B0/${V0}0)
+statedump=$(generate_statedump $brick_pid)
+TEST [ -f "$statedump" ]
+EXPECT "on" echo $(grep -m1 "^work_stealing=" $statedump | cut -f2 -d'=')
+TEST grep -q "^worker\[0\].queue_length=" $statedump
+TEST grep -q "^steals=" $statedump
+rm -f $statedump
+
+TEST $CLI volume set $V0 performance.iot-work-stealing off
+TEST $CLI volume stop $V0
+TEST $CLI volume start $V0
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "1" brick_up_status $V0 $H0 $B0/${V0}0
+EXPECT_WITHIN $CHILD_UP_TIMEOUT "8" count_files
+
+cleanup;
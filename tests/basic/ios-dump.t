@@ -39,5 +39,9 @@ for i in {1..10}; do
 done
 
 EXPECT_WITHIN 30 "Y" check_brick_inter_stats fop.weighted_latency_ave_usec
+EXPECT_WITHIN 30 "Y" check_brick_inter_stats fop.write.latency_p99_usec
+
+# percentiles are also reported by profile info
+TEST "$CLI volume profile $V0 info | grep -q P99.9-Latency"
 
 cleanup
@@ -0,0 +1,50 @@
+#!/bin/bash
+
+## quick-read keeps small files compressed when cache-compression is on and
+## serves their reads from the compressed copy.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function qr_priv_value {
+        local statedump=$(generate_mount_statedump $V0 $M1)
+        grep -a "^$1=" $statedump | cut -f2 -d'=' | tail -1
+        rm -f $statedump
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 performance.quick-read on
+TEST $CLI volume set $V0 performance.quick-read-cache-compression on
+TEST $CLI volume set $V0 performance.quick-read-cache-timeout 60
+TEST $CLI volume set $V0 performance.io-cache off
+TEST $CLI volume set $V0 performance.read-ahead off
+TEST $CLI volume set $V0 performance.open-behind off
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+
+seq 1 5000 > $M0/text
+TEST dd if=/dev/urandom of=$M0/random bs=16k count=1
+sum_text=$(seq 1 5000 | md5sum | cut -f1 -d' ')
+sum_random=$(md5sum $M0/random | cut -f1 -d' ')
+
+## a fresh mount fetches the files with their lookups
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --direct-io-mode=yes $M1
+
+EXPECT "$sum_text" echo $(md5sum $M1/text | cut -f1 -d' ')
+EXPECT "$sum_random" echo $(md5sum $M1/random | cut -f1 -d' ')
+EXPECT "$sum_text" echo $(md5sum $M1/text | cut -f1 -d' ')
+
+## only the text file compresses
+EXPECT "2" qr_priv_value total_files_cached
+EXPECT "1" qr_priv_value files-compressed
+TEST [ $(qr_priv_value cache-hit) -gt 0 ]
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M1
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+## With features.quota-flush-interval set the marker batches the size
+## updates of a directory's children and still ends up with the same
+## accounting, including after a brick dies with changes not yet flushed.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function quota_dirty {
+        getfattr -n trusted.glusterfs.quota.dirty -e hex $B0/${V0}/$1 \
+                2>/dev/null | grep dirty | cut -f2 -d'='
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}
+TEST $CLI volume set $V0 features.quota-flush-interval 3
+TEST $CLI volume set $V0 features.quota-flush-threshold 0
+TEST $CLI volume start $V0
+
+TEST $CLI volume quota $V0 enable
+TEST $CLI volume quota $V0 hard-timeout 0
+TEST $CLI volume quota $V0 soft-timeout 0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+
+TEST mkdir -p $M0/dir/a/b
+TEST $CLI volume quota $V0 limit-usage /dir 100MB
+
+for i in {1..8}; do
+        dd if=/dev/zero of=$M0/dir/a/b/file$i bs=64k count=8 2>/dev/null &
+done
+wait
+
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "4.0MB" quotausage "/dir"
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "8" quota_object_list_field "/dir" 4
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "0x3000" quota_dirty dir/a/b
+
+## changes still pending when the brick goes down are recovered from the
+## dirty flag left on the directory
+TEST $CLI volume set $V0 features.quota-flush-interval 600
+TEST dd if=/dev/zero of=$M0/dir/a/b/file9 bs=64k count=16
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "0x3100" quota_dirty dir/a/b
+TEST kill_brick $V0 $H0 $B0/${V0}
+TEST $CLI volume set $V0 features.quota-flush-interval 0
+TEST $CLI volume start $V0 force
+EXPECT_WITHIN $CHILD_UP_TIMEOUT "1" online_brick_count
+
+TEST ls -lR $M0/dir
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "5.0MB" quotausage "/dir"
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "0x3000" quota_dirty dir/a/b
+
+TEST rm -f $M0/dir/a/b/file*
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "0Bytes" quotausage "/dir"
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
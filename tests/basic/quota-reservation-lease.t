@@ -0,0 +1,78 @@
+#!/bin/bash
+
+## With features.quota-reservation-lease set, bricks write into the space
+## quotad reserved for them instead of validating every write against the
+## cluster-wide size. The space one brick holds on to is not granted to
+## another, so the hard limit is still enforced across bricks.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function used_bytes {
+        find $B0/${V0}{0,1}/dir -type f -printf "%s\n" | \
+                awk '{ total += $1 } END { print total }'
+}
+
+## write 1MB files on one brick until the limit is hit
+function fill_brick {
+        for f in $(ls $B0/${V0}$1/dir | grep "^f"); do
+                dd if=/dev/zero of=$M0/dir/$f bs=1M count=1 conv=fsync \
+                        2>/dev/null || break
+        done
+}
+
+function validation_count {
+        local total=0
+        local statedump
+        for i in 0 1; do
+                statedump=$(generate_brick_statedump $V0 $H0 $B0/${V0}$i)
+                total=$((total + $(grep -a "^validation-count=" $statedump | \
+                                   cut -f2 -d'=')))
+                rm -f $statedump
+        done
+        echo $total
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}{0,1}
+TEST $CLI volume start $V0
+
+TEST $CLI volume quota $V0 enable
+TEST $CLI volume quota $V0 hard-timeout 0
+TEST $CLI volume quota $V0 soft-timeout 0
+TEST $CLI volume set $V0 features.quota-reservation-lease 30
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+
+TEST mkdir $M0/dir
+TEST $CLI volume quota $V0 limit-usage /dir 20MB
+
+## every write would be validated with quotad without a reservation
+before=$(validation_count)
+TEST dd if=/dev/zero of=$M0/dir/small bs=4k count=512 conv=fsync
+TEST [ $(($(validation_count) - before)) -lt 32 ]
+
+EXPECT_WITHIN $MARKER_UPDATE_TIMEOUT "2.0MB" quotausage "/dir"
+
+## brick 1 takes a reservation with a small write, then brick 0 fills up
+## the rest: brick 1 must still be able to use its reservation without the
+## two of them going over the limit
+TEST touch $M0/dir/f{1..64}
+TEST [ $(ls $B0/${V0}0/dir | grep -c "^f") -gt 0 ]
+TEST [ $(ls $B0/${V0}1/dir | grep -c "^f") -gt 1 ]
+f=$(ls $B0/${V0}1/dir | grep "^f" | head -1)
+TEST dd if=/dev/zero of=$M0/dir/$f bs=4k count=1 conv=fsync
+fill_brick 0
+fill_brick 1
+
+TEST ! dd if=/dev/zero of=$M0/dir/large bs=1M count=1 conv=fsync
+TEST [ $(used_bytes) -ge $((19 * 1024 * 1024)) ]
+## no more than what the marker had not accounted yet, i.e. one write
+TEST [ $(used_bytes) -le $((21 * 1024 * 1024)) ]
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
@@ -0,0 +1,43 @@
+#!/bin/bash
+
+## read-ahead follows strided reads on a fd and reads ahead what the next
+## strides will read.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function ra_priv_counter {
+        local statedump=$(generate_mount_statedump $V0 $M0)
+        grep -a "^$1=" $statedump | cut -f2 -d'=' | tail -1
+        rm -f $statedump
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 performance.read-ahead on
+TEST $CLI volume set $V0 performance.io-cache off
+TEST $CLI volume set $V0 performance.quick-read off
+TEST $CLI volume set $V0 performance.open-behind off
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 --direct-io-mode=yes $M0
+
+TEST dd if=/dev/urandom of=$M0/file bs=1M count=16
+
+## 64KB every 512KB: dd seeks the shared fd forward by 448KB before each read
+exec 5<$M0/file
+TEST dd bs=64k count=1 of=/dev/null <&5
+for i in {1..15}; do
+        dd bs=64k skip=7 count=1 <&5 >/dev/null 2>&1
+done
+
+TEST [ $(ra_priv_counter prefetch_hits) -gt 0 ]
+EXPECT "0" ra_priv_counter wasted
+exec 5<&-
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
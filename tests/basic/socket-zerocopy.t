@@ -0,0 +1,59 @@
+#!/bin/bash
+
+## With client.zerocopy on, large writes leave the client with MSG_ZEROCOPY.
+## Every completion reported by the kernel is reaped, and the connection
+## survives the error queue notifications.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function client_priv_counter {
+        local statedump=$(generate_mount_statedump $V0 $M0)
+        grep -a -A20 "xlator.protocol.client.$V0-client-0.priv" $statedump | \
+                grep -a "^$1=" | cut -f2 -d'=' | head -1
+        rm -f $statedump
+}
+
+function zerocopy_reaped {
+        local statedump=$(generate_mount_statedump $V0 $M0)
+        local priv=$(grep -a -A20 "xlator.protocol.client.$V0-client-0.priv" \
+                     $statedump)
+        local sends=$(echo "$priv" | grep -a "^zerocopy_sends=" | cut -f2 -d'=')
+        local done=$(echo "$priv" | grep -a "^zerocopy_completions=" | \
+                     cut -f2 -d'=')
+        rm -f $statedump
+        [ "$sends" -gt 0 ] && [ "$sends" -eq "$done" ] && echo "Y" || echo "N"
+}
+
+cleanup;
+
+TEST glusterd
+TEST pidof glusterd
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}0
+TEST $CLI volume set $V0 client.zerocopy on
+TEST $CLI volume set $V0 performance.write-behind off
+TEST $CLI volume start $V0
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+
+TEST dd if=/dev/urandom of=$B0/src bs=1M count=16
+TEST dd if=$B0/src of=$M0/file bs=1M oflag=direct
+EXPECT "$(md5sum < $B0/src)" echo "$(md5sum < $B0/${V0}0/file)"
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "Y" zerocopy_reaped
+
+## Writers running in parallel queue their requests behind each other, and
+## all of their data leaves the client, whether it's sent with zero-copy or
+## copied after the kernel ran out of pinned pages.
+written=$(client_priv_counter total_bytes_written)
+for i in {1..8}; do
+        dd if=$B0/src of=$M0/file$i bs=1M oflag=direct 2>/dev/null &
+done
+wait
+EXPECT "1" client_priv_counter connected
+TEST [ $(( $(client_priv_counter total_bytes_written) - written )) -ge $((8 * 16 * 1048576)) ]
+EXPECT "$(md5sum < $B0/src)" echo "$(md5sum < $B0/${V0}0/file8)"
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "Y" zerocopy_reaped
+
+EXPECT_WITHIN $UMOUNT_TIMEOUT "Y" force_umount $M0
+cleanup;
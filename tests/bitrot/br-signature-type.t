@@ -0,0 +1,50 @@
+#!/bin/bash
+
+## Objects are signed with the configured signature type and scrubbed
+## with the type they were signed with.
+
+. $(dirname $0)/../include.rc
+. $(dirname $0)/../volume.rc
+
+function get_signature_type {
+        getfattr -n trusted.bit-rot.signature -e hex $1 2>/dev/null | \
+                grep "^trusted.bit-rot.signature=" | cut -c29-30
+}
+
+cleanup;
+
+TEST glusterd;
+TEST pidof glusterd;
+
+TEST $CLI volume create $V0 $H0:$B0/${V0}1
+TEST $CLI volume start $V0
+
+TEST $CLI volume bitrot $V0 enable
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT "1" get_bitd_count
+
+TEST $CLI volume set $V0 features.expiry-time 1
+
+TEST ! $CLI volume bitrot $V0 signature-type md5
+
+TEST $GFS --volfile-id=$V0 --volfile-server=$H0 $M0
+
+## Signed with the default SHA256
+TEST `echo "1234" > $M0/FILE1`
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT '01' get_signature_type $B0/${V0}1/FILE1
+
+TEST $CLI volume bitrot $V0 signature-type xxh64
+EXPECT 'xxh64' volinfo_field $V0 'features.signature-type'
+
+## Signed with xxHash64
+TEST `echo "5678" > $M0/FILE2`
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT '02' get_signature_type $B0/${V0}1/FILE2
+
+## Corrupt the xxHash64 signed object only
+TEST `echo "corrupt" >> $B0/${V0}1/FILE2`
+
+TEST $CLI volume bitrot $V0 scrub ondemand
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT 'trusted.bit-rot.bad-file' check_for_xattr 'trusted.bit-rot.bad-file' "$B0/${V0}1/FILE2"
+EXPECT_WITHIN $PROCESS_UP_TIMEOUT '2' scrub_status $V0 'Number of Scrubbed files'
+TEST ! getfattr -n 'trusted.bit-rot.bad-file' $B0/${V0}1/FILE1
+
+cleanup;
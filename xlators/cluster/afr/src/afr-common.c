@@ -5648,6 +5648,8 @@ afr_priv_dump(xlator_t *this)
         gf_proc_dump_write(key, "%" PRId64, priv->child_latency[i]);
         sprintf(key, "halo_child_up[%d]", i);
         gf_proc_dump_write(key, "%d", priv->halo_child_up[i]);
+        sprintf(key, "read_latency_p95_usec[%d]", i);
+        gf_proc_dump_write(key, "%" PRIu64, afr_read_latency_p95(priv, i));
     }
     gf_proc_dump_write("data_self_heal", "%d", priv->data_self_heal);
     gf_proc_dump_write("metadata_self_heal", "%d", priv->metadata_self_heal);
@@ -5660,6 +5662,11 @@ afr_priv_dump(xlator_t *this)
                        priv->background_self_heal_count);
     gf_proc_dump_write("healers", "%d", priv->healers);
     gf_proc_dump_write("read-hash-mode", "%d", priv->hash_mode);
+    gf_proc_dump_write("read-hedge", "%d", priv->read_hedge);
+    gf_proc_dump_write("read_hedges", "%" PRIu64,
+                       GF_ATOMIC_GET(priv->read_hedges));
+    gf_proc_dump_write("read_hedges_won", "%" PRIu64,
+                       GF_ATOMIC_GET(priv->read_hedges_won));
     if (priv->quorum_count == AFR_QUORUM_AUTO) {
         gf_proc_dump_write("quorum-type", "auto");
     } else if (priv->quorum_count == 0) {
@@ -6650,6 +6657,11 @@ afr_priv_destroy(afr_private_t *priv)
     }
 
     GF_FREE(priv->pending_reads);
+    if (priv->read_latency) {
+        for (i = 0; i < priv->child_count; i++)
+            LOCK_DESTROY(&priv->read_latency[i].lock);
+        GF_FREE(priv->read_latency);
+    }
     GF_FREE(priv->local);
     GF_FREE(priv->pending_key);
     GF_FREE(priv->children);
@@ -26,6 +26,7 @@
 #include <glusterfs/compat-errno.h>
 #include <glusterfs/compat.h>
 #include <glusterfs/quota-common-utils.h>
+#include <glusterfs/timespec.h>
 
 #include "afr-transaction.h"
 #include "afr-messages.h"
@@ -1742,6 +1743,261 @@ out:
 
 /* {{{ readv */
 
+/* A readv that may be answered by either of two children. Each read is
+ * wound on a frame of its own, so that the one that loses can come back
+ * after the readv has been answered. */
+typedef struct afr_read_hedge afr_read_hedge_t;
+
+struct afr_read_hedge_attempt {
+    afr_read_hedge_t *hedge;
+    int child;
+    struct timespec start;
+};
+
+struct afr_read_hedge {
+    gf_lock_t lock;
+    xlator_t *this;
+    call_frame_t *frame; /* the readv, NULL once it has been answered */
+    gf_timer_t *timer;
+    struct afr_read_hedge_attempt read[2]; /* first choice, and the hedge */
+    int winds;                             /* reads in flight */
+    int refs;                              /* reads in flight + armed timer */
+    int32_t op_errno;
+    fd_t *fd;
+    size_t size;
+    off_t offset;
+    uint32_t flags;
+    dict_t *xdata;
+    unsigned char readable[]; /* children the hedge may go to */
+};
+
+static void
+afr_read_hedge_unref(afr_read_hedge_t *hedge)
+{
+    int refs = 0;
+
+    LOCK(&hedge->lock);
+    {
+        refs = --hedge->refs;
+    }
+    UNLOCK(&hedge->lock);
+
+    if (refs)
+        return;
+
+    fd_unref(hedge->fd);
+    if (hedge->xdata)
+        dict_unref(hedge->xdata);
+    LOCK_DESTROY(&hedge->lock);
+    GF_FREE(hedge);
+}
+
+static int
+afr_readv_hedge_cbk(call_frame_t *rframe, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iovec *vector,
+                    int32_t count, struct iatt *buf, struct iobref *iobref,
+                    dict_t *xdata)
+{
+    struct afr_read_hedge_attempt *read = cookie;
+    afr_read_hedge_t *hedge = read->hedge;
+    afr_private_t *priv = this->private;
+    afr_local_t *local = NULL;
+    call_frame_t *frame = NULL;
+    gf_boolean_t hedged = (read == &hedge->read[1]);
+    int i = 0;
+
+    afr_read_latency_update(priv, read->child, &read->start);
+    if (hedged)
+        afr_pending_read_decrement(priv, read->child);
+
+    LOCK(&hedge->lock);
+    {
+        hedge->winds--;
+        if (op_ret < 0)
+            hedge->op_errno = op_errno;
+        /* the first good reply answers the readv, a failure only once
+         * there is no other read left to wait for */
+        if (hedge->frame && (op_ret >= 0 || hedge->winds == 0)) {
+            frame = hedge->frame;
+            hedge->frame = NULL;
+            /* The timeout takes the lock before anything else, so the
+             * timer cannot have been freed yet. If it could not be
+             * cancelled, the timeout drops its own reference. This read
+             * still holds one, so refs does not reach 0 here. */
+            if (hedge->timer &&
+                gf_timer_call_cancel(this->ctx, hedge->timer) == 0)
+                hedge->refs--;
+            hedge->timer = NULL;
+        }
+    }
+    UNLOCK(&hedge->lock);
+
+    if (frame && op_ret >= 0) {
+        if (hedged)
+            GF_ATOMIC_INC(priv->read_hedges_won);
+        AFR_STACK_UNWIND(readv, frame, op_ret, op_errno, vector, count, buf,
+                         iobref, xdata);
+    } else if (frame) {
+        local = frame->local;
+        for (i = 0; i < 2; i++)
+            if (hedge->read[i].child != -1)
+                local->read_attempted[hedge->read[i].child] = 1;
+        local->op_ret = -1;
+        local->op_errno = hedge->op_errno;
+
+        afr_read_txn_continue(frame, this, hedge->read[0].child);
+    }
+
+    STACK_DESTROY(rframe->root);
+    afr_read_hedge_unref(hedge);
+    return 0;
+}
+
+static void
+afr_read_hedge_send(afr_read_hedge_t *hedge, int idx, call_frame_t *rframe)
+{
+    afr_private_t *priv = hedge->this->private;
+    struct afr_read_hedge_attempt *read = &hedge->read[idx];
+
+    timespec_now(&read->start);
+    STACK_WIND_COOKIE(rframe, afr_readv_hedge_cbk, read,
+                      priv->children[read->child],
+                      priv->children[read->child]->fops->readv, hedge->fd,
+                      hedge->size, hedge->offset, hedge->flags, hedge->xdata);
+}
+
+/* the readable child with the fewest reads pending */
+static int
+__afr_read_hedge_child(afr_private_t *priv, afr_read_hedge_t *hedge)
+{
+    int64_t pending = 0;
+    int64_t least = INT64_MAX;
+    int child = -1;
+    int i = 0;
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (!hedge->readable[i] || !priv->child_up[i])
+            continue;
+        pending = GF_ATOMIC_GET(priv->pending_reads[i]);
+        if (pending < least) {
+            least = pending;
+            child = i;
+        }
+    }
+
+    return child;
+}
+
+static void
+afr_readv_hedge_timeout(void *data)
+{
+    afr_read_hedge_t *hedge = data;
+    xlator_t *this = hedge->this;
+    afr_private_t *priv = this->private;
+    call_frame_t *rframe = NULL;
+    int child = -1;
+
+    LOCK(&hedge->lock);
+    {
+        hedge->timer = NULL;
+        if (!hedge->frame)
+            goto unlock;
+
+        child = __afr_read_hedge_child(priv, hedge);
+        if (child == -1)
+            goto unlock;
+
+        rframe = copy_frame(hedge->frame);
+        if (!rframe)
+            goto unlock;
+
+        hedge->read[1].child = child;
+        hedge->winds++;
+        hedge->refs++;
+    }
+unlock:
+    UNLOCK(&hedge->lock);
+
+    if (rframe) {
+        gf_msg_debug(this->name, 0, "hedging read of %s on %s",
+                     uuid_utoa(hedge->fd->inode->gfid),
+                     priv->children[child]->name);
+        GF_ATOMIC_INC(priv->read_hedges);
+        afr_pending_read_increment(priv, child);
+        afr_read_hedge_send(hedge, 1, rframe);
+    }
+
+    afr_read_hedge_unref(hedge);
+}
+
+/* Wind the read to @subvol and, if it has not answered within its recent
+ * p95 latency, to another readable child too. Returns -1 if there is no
+ * other child to hedge to. */
+static int
+afr_readv_hedged_wind(call_frame_t *frame, xlator_t *this, int subvol)
+{
+    afr_local_t *local = frame->local;
+    afr_private_t *priv = this->private;
+    afr_read_hedge_t *hedge = NULL;
+    call_frame_t *rframe = NULL;
+    uint64_t delay = 0;
+    int candidates = 0;
+    int i = 0;
+
+    hedge = GF_CALLOC(1, sizeof(*hedge) + priv->child_count,
+                      gf_afr_mt_read_hedge_t);
+    if (!hedge)
+        return -1;
+
+    for (i = 0; i < priv->child_count; i++) {
+        hedge->readable[i] = (i != subvol && local->readable[i] &&
+                              !local->read_attempted[i]);
+        candidates += hedge->readable[i];
+    }
+    if (!candidates)
+        goto err;
+
+    rframe = copy_frame(frame);
+    if (!rframe)
+        goto err;
+
+    LOCK_INIT(&hedge->lock);
+    hedge->this = this;
+    hedge->frame = frame;
+    hedge->read[0] = (struct afr_read_hedge_attempt){hedge, subvol};
+    hedge->read[1] = (struct afr_read_hedge_attempt){hedge, -1};
+    hedge->winds = 1;
+    hedge->refs = 2;
+    hedge->fd = fd_ref(local->fd);
+    hedge->size = local->cont.readv.size;
+    hedge->offset = local->cont.readv.offset;
+    hedge->flags = local->cont.readv.flags;
+    if (local->xdata_req)
+        hedge->xdata = dict_ref(local->xdata_req);
+
+    delay = max(afr_read_latency_p95(priv, subvol),
+                priv->read_hedge_min_delay * 1000ULL);
+
+    /* held so that the timer cannot go off before it is recorded */
+    LOCK(&hedge->lock);
+    {
+        hedge->timer = gf_timer_call_after(
+            this->ctx,
+            (struct timespec){delay / 1000000, (delay % 1000000) * 1000},
+            afr_readv_hedge_timeout, hedge);
+        if (!hedge->timer)
+            hedge->refs--;
+    }
+    UNLOCK(&hedge->lock);
+
+    afr_read_hedge_send(hedge, 0, rframe);
+    return 0;
+
+err:
+    GF_FREE(hedge);
+    return -1;
+}
+
 int
 afr_readv_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
               int32_t op_errno, struct iovec *vector, int32_t count,
@@ -1779,6 +2035,9 @@ afr_readv_wind(call_frame_t *frame, xlator_t *this, int subvol)
         return 0;
     }
 
+    if (priv->read_hedge && afr_readv_hedged_wind(frame, this, subvol) == 0)
+        return 0;
+
     STACK_WIND_COOKIE(
         frame, afr_readv_cbk, (void *)(long)subvol, priv->children[subvol],
         priv->children[subvol]->fops->readv, local->fd, local->cont.readv.size,
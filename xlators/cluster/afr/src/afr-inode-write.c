@@ -402,6 +402,25 @@ afr_arbiter_writev_wind(call_frame_t *frame, xlator_t *this, int subvol)
     return 0;
 }
 
+/* The write was sent along with the pre-op, the reply kept for it completes
+ * it now. */
+static void
+afr_writev_wind_sent(call_frame_t *frame, xlator_t *this, int subvol)
+{
+    afr_local_t *local = frame->local;
+    struct afr_reply reply = local->replies[subvol];
+
+    local->replies[subvol].valid = 0;
+    local->replies[subvol].xdata = NULL;
+
+    afr_writev_wind_cbk(frame, (void *)(long)subvol, this, reply.op_ret,
+                        reply.op_errno, &reply.prestat, &reply.poststat,
+                        reply.xdata);
+
+    if (reply.xdata)
+        dict_unref(reply.xdata);
+}
+
 int
 afr_writev_wind(call_frame_t *frame, xlator_t *this, int subvol)
 {
@@ -411,6 +430,11 @@ afr_writev_wind(call_frame_t *frame, xlator_t *this, int subvol)
     local = frame->local;
     priv = this->private;
 
+    if (local->transaction.fop_sent) {
+        afr_writev_wind_sent(frame, this, subvol);
+        return 0;
+    }
+
     if (AFR_IS_ARBITER_BRICK(priv, subvol)) {
         afr_arbiter_writev_wind(frame, this, subvol);
         return 0;
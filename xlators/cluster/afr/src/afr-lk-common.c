@@ -756,6 +756,66 @@ out:
     return ret;
 }
 
+/* Whether afr_unlock() would release the inodelks of the transaction if it
+ * was called now: no other transaction shares its eager lock, and none can
+ * join it anymore as it is being released. */
+gf_boolean_t
+afr_unlock_is_final(call_frame_t *frame, xlator_t *this)
+{
+    afr_local_t *local = NULL;
+    afr_lock_t *lock = NULL;
+    gf_boolean_t final = _gf_false;
+
+    local = frame->local;
+
+    if (!local->transaction.eager_lock_on)
+        return _gf_true;
+
+    lock = &local->inode_ctx->lock[local->transaction.type];
+    LOCK(&local->inode->lock);
+    {
+        final = lock->release && list_empty(&lock->owners) &&
+                list_is_singular(&lock->post_op) &&
+                (lock->post_op.next == &local->transaction.owner_list);
+    }
+    UNLOCK(&local->inode->lock);
+
+    return final;
+}
+
+/* Accounts for an unlock of the inodelk of the transaction on @child_index
+ * which was sent along with another fop instead of by afr_unlock_now(). */
+void
+afr_unlock_sent(call_frame_t *frame, xlator_t *this, int child_index,
+                int32_t op_ret, int32_t op_errno)
+{
+    afr_local_t *local = NULL;
+    afr_private_t *priv = NULL;
+    afr_internal_lock_t *int_lock = NULL;
+
+    local = frame->local;
+    int_lock = &local->internal_lock;
+    priv = this->private;
+
+    if (op_ret < 0 && op_errno != ENOTCONN && op_errno != EBADFD) {
+        afr_log_locks_failure(frame, priv->children[child_index]->name,
+                              "unlock", op_errno);
+    }
+
+    /* afr_unlock_now() sends as many unlocks as locked_count says */
+    LOCK(&frame->lock);
+    {
+        if (int_lock->lockee[0].locked_nodes[child_index] & LOCKED_YES) {
+            int_lock->lockee[0].locked_nodes[child_index] &= LOCKED_NO;
+            int_lock->lockee[0].locked_count--;
+        }
+    }
+    UNLOCK(&frame->lock);
+
+    if (local->transaction.type == AFR_DATA_TRANSACTION)
+        afr_write_subvol_reset(frame, this);
+}
+
 int32_t
 afr_unlock(call_frame_t *frame, xlator_t *this)
 {
@@ -8,6 +8,7 @@
   cases as published by the Free Software Foundation.
 */
 
+#include <glusterfs/timespec.h>
 #include "afr.h"
 #include "afr-transaction.h"
 #include "afr-messages.h"
@@ -30,6 +31,107 @@ afr_pending_read_decrement(afr_private_t *priv, int child_index)
     GF_ATOMIC_DEC(priv->pending_reads[child_index]);
 }
 
+static int
+afr_read_latency_bucket(uint64_t usec)
+{
+    int msb = 0;
+    int bucket = 0;
+
+    if (usec < 2)
+        return 0;
+
+    msb = 63 - __builtin_clzll(usec);
+    bucket = 2 * msb + ((usec >> (msb - 1)) & 1);
+
+    return min(bucket, AFR_READ_LATENCY_BUCKETS - 1);
+}
+
+/* the largest latency that falls in @bucket */
+static uint64_t
+afr_read_latency_bound(int bucket)
+{
+    uint64_t base = 0;
+
+    if (bucket < 2)
+        return 2;
+
+    base = 1ULL << (bucket / 2);
+
+    return (bucket & 1) ? 2 * base : base + base / 2;
+}
+
+void
+afr_read_latency_update(afr_private_t *priv, int child_index,
+                        struct timespec *start)
+{
+    afr_read_latency_t *lat = NULL;
+    struct timespec now = {
+        0,
+    };
+    struct timespec delta = {
+        0,
+    };
+    uint64_t usec = 0;
+    int i = 0;
+
+    if (!priv->read_latency || child_index < 0 ||
+        child_index >= priv->child_count)
+        return;
+
+    timespec_now(&now);
+    timespec_sub(start, &now, &delta);
+    usec = delta.tv_sec * 1000000ULL + delta.tv_nsec / 1000;
+
+    lat = &priv->read_latency[child_index];
+    LOCK(&lat->lock);
+    {
+        lat->count[afr_read_latency_bucket(usec)]++;
+        if (++lat->samples >= AFR_READ_LATENCY_DECAY) {
+            for (i = 0; i < AFR_READ_LATENCY_BUCKETS; i++)
+                lat->count[i] /= 2;
+            lat->samples = 0;
+        }
+    }
+    UNLOCK(&lat->lock);
+}
+
+/* 95th percentile of the recent read latencies of a child in microseconds,
+ * or 0 if too few reads have been seen yet */
+uint64_t
+afr_read_latency_p95(afr_private_t *priv, int child_index)
+{
+    afr_read_latency_t *lat = NULL;
+    uint64_t p95 = 0;
+    uint32_t total = 0;
+    uint32_t seen = 0;
+    int i = 0;
+
+    if (!priv->read_latency || child_index < 0 ||
+        child_index >= priv->child_count)
+        return 0;
+
+    lat = &priv->read_latency[child_index];
+    LOCK(&lat->lock);
+    {
+        for (i = 0; i < AFR_READ_LATENCY_BUCKETS; i++)
+            total += lat->count[i];
+        if (total < AFR_READ_LATENCY_MIN_SAMPLES)
+            goto unlock;
+
+        for (i = 0; i < AFR_READ_LATENCY_BUCKETS; i++) {
+            seen += lat->count[i];
+            if (seen * 100ULL >= total * 95ULL) {
+                p95 = afr_read_latency_bound(i);
+                break;
+            }
+        }
+    }
+unlock:
+    UNLOCK(&lat->lock);
+
+    return p95;
+}
+
 void
 afr_read_txn_wind(call_frame_t *frame, xlator_t *this, int subvol)
 {
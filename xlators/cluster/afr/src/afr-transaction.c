@@ -74,6 +74,10 @@ afr_changelog_post_op_done(call_frame_t *frame, xlator_t *this);
 static void
 afr_changelog_post_op_fail(call_frame_t *frame, xlator_t *this, int op_errno);
 
+static gf_boolean_t
+afr_changelog_post_op_unlock(call_frame_t *frame, xlator_t *this,
+                             dict_t *xattr);
+
 void
 afr_ta_locked_priv_invalidate(afr_private_t *priv)
 {
@@ -1440,8 +1444,9 @@ set_dirty:
         goto out;
     }
 
-    afr_changelog_do(frame, this, xattr, afr_changelog_post_op_done,
-                     AFR_TRANSACTION_POST_OP);
+    if (!afr_changelog_post_op_unlock(frame, this, xattr))
+        afr_changelog_do(frame, this, xattr, afr_changelog_post_op_done,
+                         AFR_TRANSACTION_POST_OP);
 out:
     if (xattr)
         dict_unref(xattr);
@@ -1877,6 +1882,337 @@ afr_changelog_do(call_frame_t *frame, xlator_t *this, dict_t *xattr,
     return 0;
 }
 
+static int
+afr_changelog_post_op_unlock_cbk(call_frame_t *frame, void *cookie,
+                                 xlator_t *this, int op_ret, int op_errno,
+                                 void *data, dict_t *xdata)
+{
+    afr_local_t *local = NULL;
+    compound_args_cbk_t *args_cbk = data;
+    default_args_cbk_t *post_op = NULL;
+    default_args_cbk_t *unlock = NULL;
+    int call_count = -1;
+    int child_index = -1;
+
+    local = frame->local;
+    child_index = (long)cookie;
+
+    if (op_ret >= 0 && args_cbk && args_cbk->fop_length == 2) {
+        post_op = &args_cbk->rsp_list[0];
+        unlock = &args_cbk->rsp_list[1];
+    }
+
+    if (!post_op || post_op->op_ret == -1) {
+        local->op_errno = post_op ? post_op->op_errno : op_errno;
+        afr_transaction_fop_failed(frame, this, child_index);
+    }
+
+    if (post_op && post_op->xattr)
+        local->transaction.changelog_xdata[child_index] = dict_ref(
+            post_op->xattr);
+
+    /* Without a reply for the unlock, the brick is still considered locked
+     * and afr_unlock() sends it an unlock of its own. */
+    if (unlock)
+        afr_unlock_sent(frame, this, child_index, unlock->op_ret,
+                        unlock->op_errno);
+
+    call_count = afr_frame_return(frame);
+
+    if (call_count == 0) {
+        local->transaction.changelog_resume(frame, this);
+    }
+
+    return 0;
+}
+
+/* Sends the post-op of a data or metadata transaction along with the unlock
+ * of its inodelk, as a compound fop, when the post-op is the last thing done
+ * under the lock on every brick it's sent to. The post-op then completes as
+ * usual, with afr_unlock() finding nothing left to unlock. Returns whether
+ * the post-op was sent. */
+static gf_boolean_t
+afr_changelog_post_op_unlock(call_frame_t *frame, xlator_t *this,
+                             dict_t *xattr)
+{
+    afr_local_t *local = NULL;
+    afr_private_t *priv = NULL;
+    afr_internal_lock_t *int_lock = NULL;
+    compound_args_t **args = NULL;
+    unsigned char *locked_nodes = NULL;
+    struct gf_flock flock = {
+        0,
+    };
+    dict_t *xdata = NULL;
+    dict_t *newloc_xdata = NULL;
+    gf_boolean_t post_op = _gf_false;
+    gf_boolean_t locked = _gf_false;
+    int call_count = 0;
+    int i = 0;
+
+    local = frame->local;
+    priv = this->private;
+    int_lock = &local->internal_lock;
+
+    if (!priv->use_compound_fops || priv->thin_arbiter_count)
+        return _gf_false;
+
+    if ((local->transaction.type != AFR_DATA_TRANSACTION &&
+         local->transaction.type != AFR_METADATA_TRANSACTION) ||
+        (int_lock->lockee_count != 1))
+        return _gf_false;
+
+    /* the bricks getting the post-op must be exactly the locked ones */
+    locked_nodes = afr_locked_nodes_get(local->transaction.type, int_lock);
+    for (i = 0; i < priv->child_count; i++) {
+        post_op = local->transaction.pre_op[i] &&
+                  !local->transaction.failed_subvols[i];
+        locked = !!locked_nodes[i];
+        if (post_op != locked)
+            return _gf_false;
+        if (post_op && !priv->children[i]->fops->compound)
+            return _gf_false;
+    }
+
+    if (!afr_unlock_is_final(frame, this))
+        return _gf_false;
+
+    args = alloca0(priv->child_count * sizeof(*args));
+    flock = int_lock->lockee[0].flock;
+    flock.l_type = F_UNLCK;
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (!locked_nodes[i])
+            continue;
+
+        args[i] = compound_fop_alloc(2);
+        if (!args[i])
+            goto out;
+
+        if (local->fd) {
+            args[i]->enum_list[0] = GF_FOP_FXATTROP;
+            args_fxattrop_store(&args[i]->req_list[0], local->fd,
+                                GF_XATTROP_ADD_ARRAY, xattr, NULL);
+            args[i]->enum_list[1] = GF_FOP_FINODELK;
+            args_finodelk_store(&args[i]->req_list[1], int_lock->domain,
+                                int_lock->lockee[0].fd, F_SETLK, &flock,
+                                NULL);
+        } else {
+            args[i]->enum_list[0] = GF_FOP_XATTROP;
+            args_xattrop_store(&args[i]->req_list[0], &local->loc,
+                               GF_XATTROP_ADD_ARRAY, xattr, NULL);
+            args[i]->enum_list[1] = GF_FOP_INODELK;
+            args_inodelk_store(&args[i]->req_list[1], int_lock->domain,
+                               &int_lock->lockee[0].loc, F_SETLK, &flock,
+                               NULL);
+        }
+    }
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (local->transaction.changelog_xdata[i]) {
+            dict_unref(local->transaction.changelog_xdata[i]);
+            local->transaction.changelog_xdata[i] = NULL;
+        }
+    }
+
+    if (afr_changelog_prepare(this, frame, &call_count,
+                              afr_changelog_post_op_done,
+                              AFR_TRANSACTION_POST_OP, &xdata, &newloc_xdata))
+        goto cleanup;
+
+    /* the arguments are only used while the compound is wound down to the
+     * protocol client, which serializes them */
+    for (i = 0; i < priv->child_count; i++) {
+        if (!args[i])
+            continue;
+
+        STACK_WIND_COOKIE(frame, afr_changelog_post_op_unlock_cbk,
+                          (void *)(long)i, priv->children[i],
+                          priv->children[i]->fops->compound, args[i], xdata);
+        if (!--call_count)
+            break;
+    }
+
+cleanup:
+    for (i = 0; i < priv->child_count; i++)
+        compound_args_cleanup(args[i]);
+
+    if (xdata)
+        dict_unref(xdata);
+    if (newloc_xdata)
+        dict_unref(newloc_xdata);
+
+    return _gf_true;
+out:
+    for (i = 0; i < priv->child_count; i++)
+        compound_args_cleanup(args[i]);
+
+    return _gf_false;
+}
+
+static int
+afr_changelog_pre_op_write_cbk(call_frame_t *frame, void *cookie,
+                               xlator_t *this, int op_ret, int op_errno,
+                               void *data, dict_t *xdata)
+{
+    afr_local_t *local = NULL;
+    compound_args_cbk_t *args_cbk = data;
+    default_args_cbk_t *pre_op = NULL;
+    default_args_cbk_t *write = NULL;
+    struct afr_reply *reply = NULL;
+    int call_count = -1;
+    int child_index = -1;
+
+    local = frame->local;
+    child_index = (long)cookie;
+
+    if (op_ret >= 0 && args_cbk && args_cbk->fop_length == 2) {
+        pre_op = &args_cbk->rsp_list[0];
+        write = &args_cbk->rsp_list[1];
+    }
+
+    if (!pre_op || pre_op->op_ret == -1) {
+        local->op_errno = pre_op ? pre_op->op_errno : op_errno;
+        afr_transaction_fop_failed(frame, this, child_index);
+    } else {
+        /* kept for afr_writev_wind() */
+        reply = &local->replies[child_index];
+        reply->valid = 1;
+        reply->op_ret = write->op_ret;
+        reply->op_errno = write->op_errno;
+        reply->prestat = write->prestat;
+        reply->poststat = write->poststat;
+        if (write->xdata)
+            reply->xdata = dict_ref(write->xdata);
+    }
+
+    if (pre_op && pre_op->xattr)
+        local->transaction.changelog_xdata[child_index] = dict_ref(
+            pre_op->xattr);
+
+    call_count = afr_frame_return(frame);
+
+    if (call_count == 0) {
+        /* afr_transaction_perform_fop() switches to it again */
+        afr_restore_lk_owner(frame);
+        local->transaction.changelog_resume(frame, this);
+    }
+
+    return 0;
+}
+
+/* Sends the pre-op of a write along with the write itself, as a compound fop,
+ * saving a round trip to every brick. A brick only runs the write if the
+ * pre-op succeeded on it. The transaction then goes on as if the pre-op was
+ * sent alone, the write completing when afr_transaction_fop() winds it.
+ *
+ * The checks made before winding the fop can no longer keep the data from
+ * the bricks: if they fail the transaction, the bricks written to blame the
+ * others in the post-op. They are only sent the compound if all of them are
+ * good copies of the data, which keeps that blame from making a stale brick
+ * a source. Returns whether the pre-op was sent. */
+static gf_boolean_t
+afr_changelog_pre_op_write(call_frame_t *frame, xlator_t *this, dict_t *xattr)
+{
+    afr_local_t *local = NULL;
+    afr_private_t *priv = NULL;
+    compound_args_t **args = NULL;
+    dict_t *xdata = NULL;
+    dict_t *newloc_xdata = NULL;
+    uint16_t datamap = 0;
+    int call_count = 0;
+    int i = 0;
+
+    local = frame->local;
+    priv = this->private;
+
+    /* an arbiter decides whether to write once the pre-op is done */
+    if (!priv->use_compound_fops || priv->arbiter_count ||
+        priv->thin_arbiter_count)
+        return _gf_false;
+
+    if (local->op != GF_FOP_WRITE || !local->fd ||
+        local->transaction.inherited)
+        return _gf_false;
+
+    afr_write_subvol_set(frame, this);
+    datamap = (afr_write_subvol_get(frame, this) & 0x00000000ffff0000) >> 16;
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (!local->transaction.pre_op[i] ||
+            local->transaction.failed_subvols[i])
+            continue;
+        if (!(datamap & (1 << i)) || !priv->children[i]->fops->compound)
+            return _gf_false;
+    }
+
+    args = alloca0(priv->child_count * sizeof(*args));
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (!local->transaction.pre_op[i] ||
+            local->transaction.failed_subvols[i])
+            continue;
+
+        args[i] = compound_fop_alloc(2);
+        if (!args[i])
+            goto out;
+
+        args[i]->enum_list[0] = GF_FOP_FXATTROP;
+        args_fxattrop_store(&args[i]->req_list[0], local->fd,
+                            GF_XATTROP_ADD_ARRAY, xattr, NULL);
+        args[i]->enum_list[1] = GF_FOP_WRITE;
+        args_writev_store(&args[i]->req_list[1], local->fd,
+                          local->cont.writev.vector, local->cont.writev.count,
+                          local->cont.writev.offset, local->cont.writev.flags,
+                          local->cont.writev.iobref, local->xdata_req);
+    }
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (local->transaction.changelog_xdata[i]) {
+            dict_unref(local->transaction.changelog_xdata[i]);
+            local->transaction.changelog_xdata[i] = NULL;
+        }
+    }
+
+    if (afr_changelog_prepare(this, frame, &call_count,
+                              afr_transaction_perform_fop,
+                              AFR_TRANSACTION_PRE_OP, &xdata, &newloc_xdata))
+        goto cleanup;
+
+    /* as afr_transaction_perform_fop() does for the fop, restored once all
+     * the replies are in */
+    local->transaction.fop_sent = _gf_true;
+    afr_save_lk_owner(frame);
+    frame->root->lk_owner = local->transaction.main_frame->root->lk_owner;
+
+    for (i = 0; i < priv->child_count; i++) {
+        if (!args[i])
+            continue;
+
+        STACK_WIND_COOKIE(frame, afr_changelog_pre_op_write_cbk,
+                          (void *)(long)i, priv->children[i],
+                          priv->children[i]->fops->compound, args[i], xdata);
+        if (!--call_count)
+            break;
+    }
+
+cleanup:
+    for (i = 0; i < priv->child_count; i++)
+        compound_args_cleanup(args[i]);
+
+    if (xdata)
+        dict_unref(xdata);
+    if (newloc_xdata)
+        dict_unref(newloc_xdata);
+
+    return _gf_true;
+out:
+    for (i = 0; i < priv->child_count; i++)
+        compound_args_cleanup(args[i]);
+
+    return _gf_false;
+}
+
 static void
 afr_init_optimistic_changelog_for_txn(xlator_t *this, afr_local_t *local)
 {
@@ -1988,8 +2324,9 @@ afr_changelog_pre_op(call_frame_t *frame, xlator_t *this)
         goto next;
     }
 
-    afr_changelog_do(frame, this, xdata_req, afr_transaction_perform_fop,
-                     AFR_TRANSACTION_PRE_OP);
+    if (!afr_changelog_pre_op_write(frame, this, xdata_req))
+        afr_changelog_do(frame, this, xdata_req, afr_transaction_perform_fop,
+                         AFR_TRANSACTION_PRE_OP);
 
     if (xdata_req)
         dict_unref(xdata_req);
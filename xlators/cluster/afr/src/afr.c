@@ -211,6 +211,10 @@ reconfigure(xlator_t *this, dict_t *options)
 
     GF_OPTION_RECONF("read-hash-mode", priv->hash_mode, options, uint32, out);
 
+    GF_OPTION_RECONF("read-hedge", priv->read_hedge, options, bool, out);
+    GF_OPTION_RECONF("read-hedge-min-delay", priv->read_hedge_min_delay,
+                     options, uint32, out);
+
     if (read_subvol) {
         index = xlator_subvolume_index(this, read_subvol);
         if (index == -1) {
@@ -260,6 +264,9 @@ reconfigure(xlator_t *this, dict_t *options)
     GF_OPTION_RECONF("ensure-durability", priv->ensure_durability, options,
                      bool, out);
 
+    GF_OPTION_RECONF("use-compound-fops", priv->use_compound_fops, options,
+                     bool, out);
+
     enabled_old = priv->shd.enabled;
     GF_OPTION_RECONF("self-heal-daemon", priv->shd.enabled, options, bool, out);
 
@@ -470,6 +477,12 @@ init(xlator_t *this)
 
     GF_OPTION_INIT("read-hash-mode", priv->hash_mode, uint32, out);
 
+    GF_OPTION_INIT("read-hedge", priv->read_hedge, bool, out);
+    GF_OPTION_INIT("read-hedge-min-delay", priv->read_hedge_min_delay, uint32,
+                   out);
+    GF_ATOMIC_INIT(priv->read_hedges, 0);
+    GF_ATOMIC_INIT(priv->read_hedges_won, 0);
+
     priv->favorite_child = -1;
 
     GF_OPTION_INIT("favorite-child-policy", fav_child_policy, str, out);
@@ -533,6 +546,7 @@ init(xlator_t *this)
 
     GF_OPTION_INIT("post-op-delay-secs", priv->post_op_delay_secs, uint32, out);
     GF_OPTION_INIT("ensure-durability", priv->ensure_durability, bool, out);
+    GF_OPTION_INIT("use-compound-fops", priv->use_compound_fops, bool, out);
 
     GF_OPTION_INIT("self-heal-daemon", priv->shd.enabled, bool, out);
 
@@ -570,6 +584,15 @@ init(xlator_t *this)
     for (i = 0; i < child_count; i++)
         priv->child_latency[i] = -1;
 
+    priv->read_latency = GF_CALLOC(child_count, sizeof(*priv->read_latency),
+                                   gf_afr_mt_read_latency_t);
+    if (!priv->read_latency) {
+        ret = -ENOMEM;
+        goto out;
+    }
+    for (i = 0; i < child_count; i++)
+        LOCK_INIT(&priv->read_latency[i].lock);
+
     priv->children = GF_CALLOC(sizeof(xlator_t *), child_count,
                                gf_afr_mt_xlator_t);
     if (!priv->children) {
@@ -837,6 +860,31 @@ struct volume_options options[] = {
         .description = "Choose a local subvolume (i.e. Brick) to read from"
                        " if read-subvolume is not explicitly set.",
     },
+    {
+        .key = {"read-hedge"},
+        .type = GF_OPTION_TYPE_BOOL,
+        .default_value = "off",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .tags = {"replicate"},
+        .description = "If a read has not been answered by the brick it was "
+                       "sent to within that brick's recent 95th percentile "
+                       "read latency, send it to another readable brick as "
+                       "well and use whichever reply comes first.",
+    },
+    {
+        .key = {"read-hedge-min-delay"},
+        .type = GF_OPTION_TYPE_INT,
+        .min = 1,
+        .max = 60000,
+        .default_value = "10",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .tags = {"replicate"},
+        .description = "Time in milliseconds a read waits at least before it "
+                       "is hedged, also used until enough reads have been "
+                       "seen to know a brick's latency.",
+    },
     {.key = {"background-self-heal-count"},
      .type = GF_OPTION_TYPE_INT,
      .min = 0,
@@ -1281,11 +1329,13 @@ struct volume_options options[] = {
     {.key = {"use-compound-fops"},
      .type = GF_OPTION_TYPE_BOOL,
      .default_value = "no",
-     .op_version = {GD_OP_VERSION_3_8_4},
+     .op_version = {GD_OP_VERSION_9_0},
      .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
      .tags = {"replicate"},
-     .description = "This option exists only for backward compatibility "
-                    "and configuring it doesn't have any effect"},
+     .description = "Send the pre-op of a write along with the write, and "
+                    "the post-op and the unlock ending a transaction "
+                    "together, as compound fops, saving a round trip to "
+                    "every brick."},
     {.key = {NULL}},
 };
 
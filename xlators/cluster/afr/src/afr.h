@@ -43,11 +43,24 @@
 
 #define AFR_HALO_MAX_LATENCY 99999
 
+/* Read latencies are kept in microseconds, two buckets per power of two.
+ * All counts are halved every AFR_READ_LATENCY_DECAY samples, so that the
+ * percentiles follow what a child has been doing lately. */
+#define AFR_READ_LATENCY_BUCKETS 48
+#define AFR_READ_LATENCY_DECAY 512
+#define AFR_READ_LATENCY_MIN_SAMPLES 100
+
 #define PFLAG_PENDING (1 << 0)
 #define PFLAG_SBRAIN (1 << 1)
 
 typedef int (*afr_lock_cbk_t)(call_frame_t *frame, xlator_t *this);
 
+typedef struct afr_read_latency {
+    gf_lock_t lock;
+    uint32_t samples;
+    uint32_t count[AFR_READ_LATENCY_BUCKETS];
+} afr_read_latency_t;
+
 typedef int (*afr_read_txn_wind_t)(call_frame_t *frame, xlator_t *this,
                                    int subvol);
 
@@ -275,10 +288,19 @@ typedef struct _afr_private {
     gf_boolean_t esh_granular;
     gf_boolean_t consistent_io;
     gf_boolean_t data_self_heal; /* on/off */
+    gf_boolean_t use_compound_fops;
 
     /*For lock healing.*/
     struct list_head saved_locks;
     struct list_head lk_healq;
+
+    /* Hedged reads: a readv not answered within the p95 latency of its
+     * child is sent to another readable child as well. */
+    gf_boolean_t read_hedge;
+    uint32_t read_hedge_min_delay; /* msec */
+    afr_read_latency_t *read_latency;
+    gf_atomic_t read_hedges;     /* reads sent to a second child */
+    gf_atomic_t read_hedges_won; /* ... that answered first */
 } afr_private_t;
 
 typedef enum {
@@ -902,6 +924,12 @@ typedef struct _afr_local {
         gf_boolean_t uninherit_value;
 
         gf_boolean_t disable_delayed_post_op;
+
+        /* @fop_sent: the fop was sent along with the pre-op, in a
+           compound fop. The replies to it are kept in local->replies
+           and winding it only hands them over to its callback.
+        */
+        gf_boolean_t fop_sent;
     } transaction;
 
     syncbarrier_t barrier;
@@ -1056,6 +1084,13 @@ afr_set_lock_number(call_frame_t *frame, xlator_t *this);
 int32_t
 afr_unlock(call_frame_t *frame, xlator_t *this);
 
+gf_boolean_t
+afr_unlock_is_final(call_frame_t *frame, xlator_t *this);
+
+void
+afr_unlock_sent(call_frame_t *frame, xlator_t *this, int child_index,
+                int32_t op_ret, int32_t op_errno);
+
 int
 afr_lock_nonblocking(call_frame_t *frame, xlator_t *this);
 
@@ -691,6 +691,9 @@ struct dht_conf {
 
     gf_boolean_t force_migration;
 
+    /* blocks of a file copied in parallel during migration */
+    int32_t rebal_inflight_blocks;
+
     gf_boolean_t lookup_optimize;
 
     gf_boolean_t unhashed_sticky_bit;
@@ -993,160 +993,319 @@ out:
     return ret;
 }
 
+/* A block of the file being migrated. Up to conf->rebal_inflight_blocks
+ * blocks are in flight at a time; each one is written to the destination as
+ * soon as its own read from the source completes. */
+typedef struct dht_migrate_block {
+    syncbarrier_t *barrier;
+    call_frame_t *frame;
+    xlator_t *to;
+    fd_t *dst;
+    dict_t *xdata;
+    off_t offset;
+    size_t size;
+    int op_ret;
+    int op_errno;
+} dht_migrate_block_t;
+
+static int32_t
+dht_migrate_block_writev_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                             int32_t op_ret, int32_t op_errno,
+                             struct iatt *prebuf, struct iatt *postbuf,
+                             dict_t *xdata)
+{
+    dht_migrate_block_t *block = cookie;
+
+    block->op_ret = op_ret;
+    block->op_errno = op_errno;
+    syncbarrier_wake(block->barrier);
+
+    return 0;
+}
+
+static int32_t
+dht_migrate_block_readv_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                            int32_t op_ret, int32_t op_errno,
+                            struct iovec *vector, int32_t count,
+                            struct iatt *stbuf, struct iobref *iobref,
+                            dict_t *xdata)
+{
+    dht_migrate_block_t *block = cookie;
+
+    if (op_ret <= 0) {
+        block->op_ret = op_ret;
+        block->op_errno = op_errno;
+        syncbarrier_wake(block->barrier);
+        return 0;
+    }
+
+    STACK_WIND_COOKIE(frame, dht_migrate_block_writev_cbk, block, block->to,
+                      block->to->fops->writev, block->dst, vector, count,
+                      block->offset, 0, iobref, block->xdata);
+
+    return 0;
+}
+
+static call_frame_t *
+dht_migrate_block_frame(xlator_t *this)
+{
+    struct synctask *task = NULL;
+    call_frame_t *frame = NULL;
+
+    /* same credentials as the syncops issued by this task */
+    task = synctask_get();
+    if (!task)
+        return syncop_create_frame(this);
+
+    frame = copy_frame(task->opframe);
+    if (frame) {
+        frame->root->uid = task->uid;
+        frame->root->gid = task->gid;
+    }
+
+    return frame;
+}
+
 static int
 __dht_rebalance_migrate_data(xlator_t *this, gf_defrag_info_t *defrag,
                              xlator_t *from, xlator_t *to, fd_t *src, fd_t *dst,
                              uint64_t ia_size, int hole_exists, int *fop_errno)
 {
     int ret = 0;
-    int count = 0;
+    int i = 0;
+    int inflight = 0;
+    int window = 0;
     off_t offset = 0;
     off_t data_offset = 0;
     off_t hole_offset = 0;
-    struct iovec *vector = NULL;
-    struct iobref *iobref = NULL;
     uint64_t total = 0;
+    uint64_t planned = 0;
     size_t read_size = 0;
     size_t data_block_size = 0;
+    gf_boolean_t eof = _gf_false;
     dict_t *xdata = NULL;
     dht_conf_t *conf = NULL;
+    dht_migrate_block_t *blocks = NULL;
+    syncbarrier_t barrier;
 
     conf = this->private;
 
-    /* if file size is '0', no need to enter this loop */
-    while (total < ia_size) {
-        /* This is a regular file - read it sequentially */
-        if (!hole_exists) {
-            read_size = (((ia_size - total) > DHT_REBALANCE_BLKSIZE)
-                             ? DHT_REBALANCE_BLKSIZE
-                             : (ia_size - total));
-        } else {
-            /* This is a sparse file - read only the data segments in the file
-             */
+    window = conf->rebal_inflight_blocks;
+    if (window < 1)
+        window = 1;
 
-            /* If the previous data block is fully copied, find the next data
-             * segment
-             * starting at the offset of the last read and written byte,  */
-            if (data_block_size <= 0) {
-                ret = syncop_seek(from, src, offset, GF_SEEK_DATA, NULL,
-                                  &data_offset);
-                if (ret) {
-                    if (ret == -ENXIO)
-                        ret = 0; /* No more data segments */
-                    else
-                        *fop_errno = -ret; /* Error occurred */
+    blocks = GF_CALLOC(window, sizeof(*blocks), gf_dht_mt_migrate_block_t);
+    if (!blocks) {
+        *fop_errno = ENOMEM;
+        return -1;
+    }
 
-                    break;
-                }
+    if (syncbarrier_init(&barrier)) {
+        GF_FREE(blocks);
+        *fop_errno = errno;
+        return -1;
+    }
 
-                /* If the position of the current data segment is greater than
-                 * the position of the next hole, find the next hole in order to
-                 * calculate the length of the new data segment */
-                if (data_offset > hole_offset) {
-                    /* Starting at the offset of the last data segment, find the
-                     * next hole */
-                    ret = syncop_seek(from, src, data_offset, GF_SEEK_HOLE,
-                                      NULL, &hole_offset);
+    if (!conf->force_migration && !dht_is_tier_xlator(this)) {
+        xdata = dict_new();
+        if (!xdata) {
+            gf_msg("dht", GF_LOG_ERROR, 0, DHT_MSG_MIGRATE_FILE_FAILED,
+                   "insufficient memory");
+            ret = -1;
+            *fop_errno = ENOMEM;
+            goto out;
+        }
+
+        /* Fail this write and abort rebalance if we
+         * detect a write from client since migration of
+         * this file started. This is done to avoid
+         * potential data corruption due to out of order
+         * writes from rebalance and client to the same
+         * region (as compared between src and dst
+         * files). See
+         * https://github.com/gluster/glusterfs/issues/308
+         * for more details.
+         */
+        ret = dict_set_int32_sizen(xdata, GF_AVOID_OVERWRITE, 1);
+        if (ret) {
+            gf_msg("dht", GF_LOG_ERROR, 0, ENOMEM, "failed to set dict");
+            ret = -1;
+            *fop_errno = ENOMEM;
+            goto out;
+        }
+    }
+
+    /* if file size is '0', no need to enter this loop */
+    while ((total < ia_size) && !eof) {
+        /* Split the next part of the file into up to 'window' blocks. The
+         * offsets only advance here; they are rewound below if a block
+         * completes short. */
+        planned = total;
+        for (inflight = 0; (inflight < window) && (planned < ia_size);
+             inflight++) {
+            /* This is a regular file - read it sequentially */
+            if (!hole_exists) {
+                read_size = (((ia_size - planned) > DHT_REBALANCE_BLKSIZE)
+                                 ? DHT_REBALANCE_BLKSIZE
+                                 : (ia_size - planned));
+            } else {
+                /* This is a sparse file - read only the data segments in the
+                 * file */
+
+                /* If the previous data block is fully planned, find the next
+                 * data segment starting at the end of the last planned
+                 * block */
+                if (data_block_size <= 0) {
+                    ret = syncop_seek(from, src, offset, GF_SEEK_DATA, NULL,
+                                      &data_offset);
                     if (ret) {
-                        /* If an error occurred here it's a real error because
-                         * if the seek for a data segment was successful then
-                         * necessarily another hole must exist (EOF is a hole)
-                         */
-                        *fop_errno = -ret;
-                        break;
+                        if (ret == -ENXIO) {
+                            ret = 0; /* No more data segments */
+                            eof = _gf_true;
+                            break;
+                        }
+
+                        *fop_errno = -ret; /* Error occurred */
+                        goto out;
                     }
 
-                    /* Calculate the total size of the current data block */
-                    data_block_size = hole_offset - data_offset;
+                    /* If the current data segment does not start before the
+                     * last hole found, find the next hole in order to
+                     * calculate the length of the new data segment. This
+                     * includes a segment starting at offset 0, before any
+                     * hole has been looked up. */
+                    if (data_offset >= hole_offset) {
+                        /* Starting at the offset of the last data segment,
+                         * find the next hole */
+                        ret = syncop_seek(from, src, data_offset, GF_SEEK_HOLE,
+                                          NULL, &hole_offset);
+                        if (ret) {
+                            /* If an error occurred here it's a real error
+                             * because if the seek for a data segment was
+                             * successful then necessarily another hole must
+                             * exist (EOF is a hole) */
+                            *fop_errno = -ret;
+                            goto out;
+                        }
+
+                        /* Calculate the total size of the current data
+                         * block */
+                        data_block_size = hole_offset - data_offset;
+                    }
+                } else {
+                    /* There is still data in the current segment, move the
+                     * data_offset to the end of the last planned block */
+                    data_offset = offset;
                 }
-            } else {
-                /* There is still data in the current segment, move the
-                 * data_offset to the position of the last written byte */
-                data_offset = offset;
+
+                /* Calculate how much data needs to be read and written. If
+                 * the data segment's length is bigger than
+                 * DHT_REBALANCE_BLKSIZE, read and write DHT_REBALANCE_BLKSIZE
+                 * data length and the rest in the next block(s) */
+                read_size = ((data_block_size > DHT_REBALANCE_BLKSIZE)
+                                 ? DHT_REBALANCE_BLKSIZE
+                                 : data_block_size);
+
+                /* Calculate the remaining size of the data block - maybe
+                 * there's no need to seek for data for the next block */
+                data_block_size -= read_size;
+
+                /* Set offset to the offset of the data segment so read and
+                 * write will have the correct position */
+                offset = data_offset;
             }
 
-            /* Calculate how much data needs to be read and written. If the data
-             * segment's length is bigger than DHT_REBALANCE_BLKSIZE, read and
-             * write DHT_REBALANCE_BLKSIZE data length and the rest in the
-             * next iteration(s) */
-            read_size = ((data_block_size > DHT_REBALANCE_BLKSIZE)
-                             ? DHT_REBALANCE_BLKSIZE
-                             : data_block_size);
-
-            /* Calculate the remaining size of the data block - maybe there's no
-             * need to seek for data in the next iteration */
-            data_block_size -= read_size;
-
-            /* Set offset to the offset of the data segment so read and write
-             * will have the correct position */
-            offset = data_offset;
+            if (!read_size)
+                break;
+
+            blocks[inflight].offset = offset;
+            blocks[inflight].size = read_size;
+            offset += read_size;
+            planned += read_size;
         }
 
-        ret = syncop_readv(from, src, read_size, offset, 0, &vector, &count,
-                           &iobref, NULL, NULL, NULL);
+        if (!inflight)
+            break;
 
-        if (!ret || (ret < 0)) {
-            if (!ret) {
-                /* File was probably truncated*/
-                ret = -1;
-                *fop_errno = ENOSPC;
-            } else {
-                *fop_errno = -ret;
+        barrier.waitfor = inflight;
+        for (i = 0; i < inflight; i++) {
+            blocks[i].barrier = &barrier;
+            blocks[i].to = to;
+            blocks[i].dst = dst;
+            blocks[i].xdata = xdata;
+            blocks[i].op_ret = -1;
+            blocks[i].op_errno = ENOMEM;
+            blocks[i].frame = dht_migrate_block_frame(this);
+            if (!blocks[i].frame) {
+                syncbarrier_wake(&barrier);
+                continue;
             }
-            break;
+
+            STACK_WIND_COOKIE(blocks[i].frame, dht_migrate_block_readv_cbk,
+                              &blocks[i], from, from->fops->readv, src,
+                              blocks[i].size, blocks[i].offset, 0, NULL);
         }
+        syncbarrier_wait(&barrier, inflight);
+
+        /* Account the completed blocks in file order, stopping at the
+         * first failure or short write. */
+        for (i = 0; i < inflight; i++) {
+            if (blocks[i].frame) {
+                STACK_DESTROY(blocks[i].frame->root);
+                blocks[i].frame = NULL;
+            }
 
-        if (!conf->force_migration && !dht_is_tier_xlator(this)) {
-            if (!xdata) {
-                xdata = dict_new();
-                if (!xdata) {
-                    gf_msg("dht", GF_LOG_ERROR, 0, DHT_MSG_MIGRATE_FILE_FAILED,
-                           "insufficient memory");
-                    ret = -1;
-                    *fop_errno = ENOMEM;
-                    break;
-                }
+            if (ret < 0)
+                continue;
 
-                /* Fail this write and abort rebalance if we
-                 * detect a write from client since migration of
-                 * this file started. This is done to avoid
-                 * potential data corruption due to out of order
-                 * writes from rebalance and client to the same
-                 * region (as compared between src and dst
-                 * files). See
-                 * https://github.com/gluster/glusterfs/issues/308
-                 * for more details.
-                 */
-                ret = dict_set_int32_sizen(xdata, GF_AVOID_OVERWRITE, 1);
-                if (ret) {
-                    gf_msg("dht", GF_LOG_ERROR, 0, ENOMEM,
-                           "failed to set dict");
-                    ret = -1;
-                    *fop_errno = ENOMEM;
-                    break;
+            if (blocks[i].op_ret <= 0) {
+                if (!blocks[i].op_ret) {
+                    /* File was probably truncated*/
+                    *fop_errno = ENOSPC;
+                } else {
+                    *fop_errno = blocks[i].op_errno;
                 }
+                ret = -1;
+                continue;
+            }
+
+            total += blocks[i].op_ret;
+            if ((size_t)blocks[i].op_ret < blocks[i].size) {
+                /* The blocks after this one have to be copied again from
+                 * where this one stopped. */
+                offset = blocks[i].offset + blocks[i].op_ret;
+                data_block_size = 0;
+                hole_offset = 0;
+                eof = _gf_false;
+                ret = -EAGAIN;
             }
         }
 
-        ret = syncop_writev(to, dst, vector, count, offset, iobref, 0, NULL,
-                            NULL, xdata, NULL);
-        if (ret < 0) {
-            *fop_errno = -ret;
+        if (ret == -EAGAIN)
+            ret = 0;
+        if (ret < 0)
             break;
-        }
+    }
 
-        offset += ret;
-        total += ret;
+    /* Nothing left to plan before the end of the file was reached: the
+     * data segments no longer add up, e.g. the file changed under us.
+     * Don't let the destination replace the source with data missing. */
+    if ((ret >= 0) && (total < ia_size) && !eof) {
+        gf_msg(this->name, GF_LOG_ERROR, 0, DHT_MSG_MIGRATE_FILE_FAILED,
+               "%s: copied %" PRIu64 " of %" PRIu64
+               " bytes before running out of data to migrate",
+               uuid_utoa(src->inode->gfid), total, ia_size);
+        *fop_errno = EIO;
+        ret = -1;
+    }
 
-        GF_FREE(vector);
-        if (iobref)
-            iobref_unref(iobref);
-        iobref = NULL;
-        vector = NULL;
+out:
+    for (i = 0; i < window; i++) {
+        if (blocks[i].frame)
+            STACK_DESTROY(blocks[i].frame->root);
     }
-    if (iobref)
-        iobref_unref(iobref);
-    GF_FREE(vector);
+    GF_FREE(blocks);
+    syncbarrier_destroy(&barrier);
 
     if (ret >= 0)
         ret = 0;
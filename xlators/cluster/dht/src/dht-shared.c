@@ -475,6 +475,9 @@ dht_reconfigure(xlator_t *this, dict_t *options)
     GF_OPTION_RECONF("force-migration", conf->force_migration, options, bool,
                      out);
 
+    GF_OPTION_RECONF("rebal-inflight-blocks", conf->rebal_inflight_blocks,
+                     options, int32, out);
+
     if (conf->defrag) {
         if (dict_get_str(options, "rebal-throttle", &temp_str) == 0) {
             ret = dht_configure_throttle(this, conf, temp_str);
@@ -744,6 +747,9 @@ dht_init(xlator_t *this)
 
     GF_OPTION_INIT("force-migration", conf->force_migration, bool, err);
 
+    GF_OPTION_INIT("rebal-inflight-blocks", conf->rebal_inflight_blocks, int32,
+                   err);
+
     if (defrag) {
         defrag->lock_migration_enabled = conf->lock_migration_enabled;
 
@@ -1172,6 +1178,19 @@ struct volume_options dht_options[] = {
      .level = OPT_STATUS_ADVANCED,
      .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC},
 
+    {.key = {"rebal-inflight-blocks"},
+     .type = GF_OPTION_TYPE_INT,
+     .min = 1,
+     .max = 64,
+     .default_value = "4",
+     .description = "Number of 1MB blocks of a file that rebalance reads from "
+                    "the source and writes to the destination in parallel "
+                    "while migrating it. A value of 1 copies the file one "
+                    "block at a time.",
+     .op_version = {GD_OP_VERSION_9_0},
+     .level = OPT_STATUS_ADVANCED,
+     .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC},
+
     {.key = {NULL}},
 };
 
@@ -0,0 +1,172 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Throughput benchmark for ec_method_encode() and ec_method_decode().
+ *
+ * For every code generator supported by the CPU and for several k+m
+ * configurations, a buffer of random data is encoded into k+m fragments,
+ * and decoded back using the m redundancy fragments plus the last k-m data
+ * fragments (the most expensive decoding matrix). The decoded data is
+ * compared with the original, so this also checks that all the generators
+ * produce the same fragments.
+ *
+ * Throughput is reported in MB/s of user data.
+ *
+ * Dynamic code is written to a temporary file in GLUSTERFS_LIBEXECDIR, which
+ * must be writable for the JIT generators to be used.
+ *
+ * Built by "make check" in xlators/cluster/ec/src.
+ *
+ * Usage: ec_method_benchmark [MB per test]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "glusterfs/glusterfs.h"
+#include "glusterfs/globals.h"
+#include "glusterfs/xlator.h"
+
+#include "ec-method.h"
+#include "ec-code.h"
+
+struct bench_config {
+    uint32_t fragments;
+    uint32_t redundancy;
+};
+
+static struct bench_config bench_configs[] = {
+    {2, 1}, {4, 2}, {8, 3}, {8, 4}, {16, 4},
+};
+
+static char *bench_gens[] = {"none", "x64", "sse", "avx", "avx512"};
+
+static double
+bench_elapsed(struct timespec *start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start->tv_sec) +
+           (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static int
+bench_run(xlator_t *xl, const char *gen, struct bench_config *cfg,
+          uint64_t total)
+{
+    ec_matrix_list_t list = {
+        0,
+    };
+    uint32_t nodes = cfg->fragments + cfg->redundancy;
+    uint32_t rows[EC_METHOD_MAX_FRAGMENTS];
+    void *fragments[nodes];
+    void *out[nodes];
+    void *in[EC_METHOD_MAX_FRAGMENTS];
+    uintptr_t mask = 0;
+    struct timespec start;
+    double encode_secs = 0;
+    double decode_secs = 0;
+    uint64_t size = 0;
+    uint64_t fsize = 0;
+    uint64_t done = 0;
+    char *data = NULL;
+    char *decoded = NULL;
+    int ret = -1;
+    uint32_t i = 0;
+
+    if (ec_method_init(xl, &list, cfg->fragments, nodes, nodes * 2, gen) != 0)
+        return -1;
+
+    /* 1MB of fragments per brick, like a big write */
+    fsize = 1024 * 1024;
+    size = fsize * cfg->fragments;
+
+    data = aligned_alloc(EC_METHOD_WORD_SIZE, size);
+    decoded = aligned_alloc(EC_METHOD_WORD_SIZE, size);
+    for (i = 0; i < nodes; i++)
+        fragments[i] = aligned_alloc(EC_METHOD_WORD_SIZE, fsize);
+
+    for (i = 0; i < size; i++)
+        data[i] = random();
+
+    /* decode from the redundancy fragments and the last data fragments */
+    for (i = 0; i < cfg->fragments; i++) {
+        rows[i] = nodes - cfg->fragments + i + 1;
+        in[i] = fragments[rows[i] - 1];
+        mask |= 1ULL << (rows[i] - 1);
+    }
+
+    for (done = 0; done < total; done += size) {
+        memcpy(out, fragments, sizeof(out));
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ec_method_encode(&list, size, data, out);
+        encode_secs += bench_elapsed(&start);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        if (ec_method_decode(&list, fsize, mask, rows, in, decoded) != 0)
+            goto out;
+        decode_secs += bench_elapsed(&start);
+    }
+
+    if (memcmp(data, decoded, size) != 0) {
+        fprintf(stderr, "%s %u+%u: decoded data differs\n", gen,
+                cfg->fragments, cfg->redundancy);
+        goto out;
+    }
+
+    /* the requested generator may not be supported by this CPU */
+    printf("%-8s %2u+%u  encode: %8.1f MB/s  decode: %8.1f MB/s\n",
+           (list.code->gen != NULL) ? list.code->gen->name : "none",
+           cfg->fragments, cfg->redundancy, done / encode_secs / 1e6,
+           done / decode_secs / 1e6);
+
+    ret = 0;
+
+out:
+    for (i = 0; i < nodes; i++)
+        free(fragments[i]);
+    free(decoded);
+    free(data);
+    ec_method_fini(&list);
+
+    return ret;
+}
+
+int
+main(int argc, char *argv[])
+{
+    glusterfs_ctx_t *ctx = NULL;
+    uint64_t total = 0;
+    int ret = EXIT_SUCCESS;
+    int i = 0;
+    int j = 0;
+
+    total = ((argc > 1) ? atoll(argv[1]) : 256) * 1024 * 1024;
+
+    ctx = glusterfs_ctx_new();
+    if (!ctx || glusterfs_globals_init(ctx))
+        return EXIT_FAILURE;
+    THIS->ctx = ctx;
+    mem_pools_init();
+
+    for (i = 0; i < sizeof(bench_gens) / sizeof(bench_gens[0]); i++) {
+        for (j = 0; j < sizeof(bench_configs) / sizeof(bench_configs[0]);
+             j++) {
+            if (bench_run(THIS, bench_gens[i], &bench_configs[j], total))
+                ret = EXIT_FAILURE;
+        }
+    }
+
+    return ret;
+}
@@ -22,6 +22,7 @@ enum gf_io_stats_mem_types_ {
     gf_io_stats_mt_ios_stat_list,
     gf_io_stats_mt_ios_sample_buf,
     gf_io_stats_mt_ios_sample,
+    gf_io_stats_mt_ios_latency_hist,
     gf_io_stats_mt_end
 };
 #endif
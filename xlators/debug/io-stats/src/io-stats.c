@@ -128,6 +128,20 @@ struct ios_lat {
     uint64_t total;
 };
 
+/* latency percentiles reported for every fop */
+#define IOS_LATENCY_PERCENTILES 4
+
+static const struct {
+    double percentile;
+    char *name;  /* used in dict and json keys */
+    char *title; /* used in statedumps */
+} ios_latency_percentiles[IOS_LATENCY_PERCENTILES] = {
+    {50.0, "p50", "P50"},
+    {90.0, "p90", "P90"},
+    {99.0, "p99", "P99"},
+    {99.9, "p999", "P99.9"},
+};
+
 struct ios_global_stats {
     gf_atomic_t data_written;
     gf_atomic_t data_read;
@@ -137,6 +151,8 @@ struct ios_global_stats {
     gf_atomic_t upcall_hits[GF_UPCALL_FLAGS_MAXVALUE];
     time_t started_at;
     struct ios_lat latency[GF_FOP_MAXVALUE];
+    /* GF_FOP_MAXVALUE histograms of latencies in usecs */
+    gf_latency_hist_t *latency_hist;
     uint64_t nr_opens;
     uint64_t max_nr_opens;
     struct timeval max_openfd_time;
@@ -763,6 +779,31 @@ err:
     return ret;
 }
 
+/* Fills 'values' with the latency percentiles of 'op' in usecs. Returns
+ * _gf_false if there are no histograms for these stats. */
+static gf_boolean_t
+ios_get_latency_percentiles(struct ios_global_stats *stats, int op,
+                            double *values)
+{
+    int i = 0;
+
+    if (!stats->latency_hist)
+        return _gf_false;
+
+    for (i = 0; i < IOS_LATENCY_PERCENTILES; i++) {
+        values[i] = gf_latency_hist_percentile(
+            &stats->latency_hist[op], ios_latency_percentiles[i].percentile);
+
+        /* the middle of a bucket can be out of the observed range */
+        if (values[i] > stats->latency[op].max)
+            values[i] = stats->latency[op].max;
+        if (values[i] < stats->latency[op].min)
+            values[i] = stats->latency[op].min;
+    }
+
+    return _gf_true;
+}
+
 int
 io_stats_dump_global_to_json_logfp(xlator_t *this,
                                    struct ios_global_stats *stats, time_t now,
@@ -781,6 +822,7 @@ io_stats_dump_global_to_json_logfp(xlator_t *this,
     float fop_lat_ave;
     float fop_lat_min;
     float fop_lat_max;
+    double fop_lat_pct[IOS_LATENCY_PERCENTILES];
     double interval_sec;
     double fop_ave_usec = 0.0;
     double fop_ave_usec_sum = 0.0;
@@ -857,11 +899,13 @@ io_stats_dump_global_to_json_logfp(xlator_t *this,
         fop_lat_ave = 0.0;
         fop_lat_min = 0.0;
         fop_lat_max = 0.0;
+        memset(fop_lat_pct, 0, sizeof(fop_lat_pct));
         if (fop_hits) {
             if (stats->latency[i].avg) {
                 fop_lat_ave = stats->latency[i].avg;
                 fop_lat_min = stats->latency[i].min;
                 fop_lat_max = stats->latency[i].max;
+                ios_get_latency_percentiles(stats, i, fop_lat_pct);
             }
         }
         if (interval == -1) {
@@ -879,6 +923,11 @@ io_stats_dump_global_to_json_logfp(xlator_t *this,
                 key_prefix, str_prefix, lc_fop_name, fop_lat_min);
         ios_log(this, logfp, "\"%s.%s.fop.%s.latency_max_usec\": %0.2lf,",
                 key_prefix, str_prefix, lc_fop_name, fop_lat_max);
+        for (j = 0; j < IOS_LATENCY_PERCENTILES; j++) {
+            ios_log(this, logfp, "\"%s.%s.fop.%s.latency_%s_usec\": %0.2lf,",
+                    key_prefix, str_prefix, lc_fop_name,
+                    ios_latency_percentiles[j].name, fop_lat_pct[j]);
+        }
 
         fop_ave_usec_sum += fop_lat_ave;
         weighted_fop_ave_usec_sum += fop_hits * fop_lat_ave;
@@ -1213,6 +1262,7 @@ io_stats_dump_global_to_logfp(xlator_t *this, struct ios_global_stats *stats,
     uint64_t fop_hits = 0;
     uint64_t block_count_read = 0;
     uint64_t block_count_write = 0;
+    double fop_lat_pct[IOS_LATENCY_PERCENTILES];
 
     conf = this->private;
 
@@ -1274,10 +1324,12 @@ io_stats_dump_global_to_logfp(xlator_t *this, struct ios_global_stats *stats,
         ios_log(this, logfp, "%s\n", str_write);
     }
 
-    ios_log(this, logfp, "%-13s %10s %14s %14s %14s", "Fop", "Call Count",
-            "Avg-Latency", "Min-Latency", "Max-Latency");
-    ios_log(this, logfp, "%-13s %10s %14s %14s %14s", "---", "----------",
-            "-----------", "-----------", "-----------");
+    ios_log(this, logfp, "%-13s %10s %14s %14s %14s %14s %14s %14s %14s",
+            "Fop", "Call Count", "Avg-Latency", "Min-Latency", "Max-Latency",
+            "P50-Latency", "P90-Latency", "P99-Latency", "P99.9-Latency");
+    ios_log(this, logfp, "%-13s %10s %14s %14s %14s %14s %14s %14s %14s",
+            "---", "----------", "-----------", "-----------", "-----------",
+            "-----------", "-----------", "-----------", "-------------");
 
     for (i = 0; i < GF_FOP_MAXVALUE; i++) {
         fop_hits = GF_ATOMIC_GET(stats->fop_hits[i]);
@@ -1285,15 +1337,22 @@ io_stats_dump_global_to_logfp(xlator_t *this, struct ios_global_stats *stats,
             ios_log(this, logfp,
                     "%-13s %10" GF_PRI_ATOMIC
                     " %11s "
-                    "us %11s us %11s us",
-                    gf_fop_list[i], fop_hits, "0", "0", "0");
-        else if (fop_hits && stats->latency[i].avg)
+                    "us %11s us %11s us %11s us %11s us %11s us %11s us",
+                    gf_fop_list[i], fop_hits, "0", "0", "0", "0", "0", "0",
+                    "0");
+        else if (fop_hits && stats->latency[i].avg) {
+            memset(fop_lat_pct, 0, sizeof(fop_lat_pct));
+            ios_get_latency_percentiles(stats, i, fop_lat_pct);
             ios_log(this, logfp,
                     "%-13s %10" GF_PRI_ATOMIC
                     " "
-                    "%11.2lf us %11.2lf us %11.2lf us",
+                    "%11.2lf us %11.2lf us %11.2lf us %11.2lf us %11.2lf us "
+                    "%11.2lf us %11.2lf us",
                     gf_fop_list[i], fop_hits, stats->latency[i].avg,
-                    stats->latency[i].min, stats->latency[i].max);
+                    stats->latency[i].min, stats->latency[i].max,
+                    fop_lat_pct[0], fop_lat_pct[1], fop_lat_pct[2],
+                    fop_lat_pct[3]);
+        }
     }
 
     for (i = 0; i < GF_UPCALL_FLAGS_MAXVALUE; i++) {
@@ -1372,8 +1431,10 @@ io_stats_dump_global_to_dict(xlator_t *this, struct ios_global_stats *stats,
     char key[64] = {0};
     uint64_t sec = 0;
     int i = 0;
+    int j = 0;
     uint64_t count = 0;
     uint64_t fop_hits = 0;
+    double fop_lat_pct[IOS_LATENCY_PERCENTILES];
 
     GF_ASSERT(stats);
     GF_ASSERT(now);
@@ -1494,6 +1555,22 @@ io_stats_dump_global_to_dict(xlator_t *this, struct ios_global_stats *stats,
                    gf_fop_list[i], interval, stats->latency[i].max);
             goto out;
         }
+
+        if (!ios_get_latency_percentiles(stats, i, fop_lat_pct))
+            continue;
+        for (j = 0; j < IOS_LATENCY_PERCENTILES; j++) {
+            snprintf(key, sizeof(key), "%d-%d-%slatency", interval, i,
+                     ios_latency_percentiles[j].name);
+            ret = dict_set_double(dict, key, fop_lat_pct[j]);
+            if (ret) {
+                gf_log(this->name, GF_LOG_ERROR,
+                       "failed to set %s "
+                       "%slatency(%d) with %f",
+                       gf_fop_list[i], ios_latency_percentiles[j].name,
+                       interval, fop_lat_pct[j]);
+                goto out;
+            }
+        }
     }
     for (i = 0; i < GF_UPCALL_FLAGS_MAXVALUE; i++) {
         fop_hits = GF_ATOMIC_GET(stats->upcall_hits[i]);
@@ -1576,10 +1653,15 @@ ios_dump_args_init(struct ios_dump_args *args, ios_dump_type_t type,
 static void
 ios_global_stats_clear(struct ios_global_stats *stats, time_t now)
 {
+    gf_latency_hist_t *latency_hist = NULL;
+
     GF_ASSERT(stats);
     GF_ASSERT(now);
 
+    latency_hist = stats->latency_hist;
     memset(stats, 0, sizeof(*stats));
+    memset(latency_hist, 0, GF_FOP_MAXVALUE * sizeof(*latency_hist));
+    stats->latency_hist = latency_hist;
     stats->started_at = now;
 }
 
@@ -1590,6 +1672,7 @@ io_stats_dump(xlator_t *this, struct ios_dump_args *args, ios_info_op_t op,
     struct ios_conf *conf = NULL;
     struct ios_global_stats cumulative = {};
     struct ios_global_stats incremental = {};
+    gf_latency_hist_t *latency_hist = NULL;
     int increment = 0;
     time_t now = 0;
 
@@ -1601,6 +1684,12 @@ io_stats_dump(xlator_t *this, struct ios_dump_args *args, ios_info_op_t op,
     conf = this->private;
     now = gf_time();
 
+    /* The histograms are not copied with the rest of the stats, so a copy
+     * of the incremental ones is needed if they are going to be cleared. */
+    if ((op == GF_IOS_INFO_ALL || op == GF_IOS_INFO_INCREMENTAL) && !is_peek)
+        latency_hist = GF_MALLOC(GF_FOP_MAXVALUE * sizeof(*latency_hist),
+                                 gf_io_stats_mt_ios_latency_hist);
+
     LOCK(&conf->lock);
     {
         if (op == GF_IOS_INFO_ALL || op == GF_IOS_INFO_CUMULATIVE)
@@ -1613,6 +1702,11 @@ io_stats_dump(xlator_t *this, struct ios_dump_args *args, ios_info_op_t op,
             if (!is_peek) {
                 increment = conf->increment++;
 
+                if (latency_hist)
+                    memcpy(latency_hist, conf->incremental.latency_hist,
+                           GF_FOP_MAXVALUE * sizeof(*latency_hist));
+                incremental.latency_hist = latency_hist;
+
                 ios_global_stats_clear(&conf->incremental, now);
             }
         }
@@ -1625,6 +1719,8 @@ io_stats_dump(xlator_t *this, struct ios_dump_args *args, ios_info_op_t op,
     if (op == GF_IOS_INFO_ALL || op == GF_IOS_INFO_INCREMENTAL)
         io_stats_dump_global(this, &incremental, now, increment, args);
 
+    GF_FREE(latency_hist);
+
     return 0;
 }
 
@@ -1744,6 +1840,8 @@ update_ios_latency_stats(struct ios_global_stats *stats, double elapsed,
     if (stats->latency[op].max < elapsed)
         stats->latency[op].max = elapsed;
 
+    gf_latency_hist_update(&stats->latency_hist[op], elapsed);
+
     avg = stats->latency[op].avg;
 
     stats->latency[op].avg = avg + (elapsed - avg) /
@@ -3591,6 +3689,16 @@ io_stats_clear(struct ios_conf *conf)
     UNLOCK(&conf->lock);
 }
 
+static void
+ios_dump_latency_percentiles(char *key, double *pct)
+{
+    gf_proc_dump_write(key, "%s=%.03f,%s=%.03f,%s=%.03f,%s=%.03f",
+                       ios_latency_percentiles[0].title, pct[0],
+                       ios_latency_percentiles[1].title, pct[1],
+                       ios_latency_percentiles[2].title, pct[2],
+                       ios_latency_percentiles[3].title, pct[3]);
+}
+
 int32_t
 io_priv(xlator_t *this)
 {
@@ -3599,6 +3707,7 @@ io_priv(xlator_t *this)
     char key_prefix_cumulative[GF_DUMP_MAX_BUF_LEN];
     char key_prefix_incremental[GF_DUMP_MAX_BUF_LEN];
     double min, max, avg;
+    double pct[IOS_LATENCY_PERCENTILES];
     uint64_t count, total;
     struct ios_conf *conf = NULL;
 
@@ -3637,6 +3746,14 @@ io_priv(xlator_t *this)
         gf_proc_dump_write(key, "%" PRId64 ",%" PRId64 ",%.03f,%.03f,%.03f",
                            count, total, min, max, avg);
 
+        if (count) {
+            ios_get_latency_percentiles(&conf->cumulative, i, pct);
+            gf_proc_dump_build_key(key, key_prefix_cumulative,
+                                   "%s.latency-percentiles",
+                                   (char *)gf_fop_list[i]);
+            ios_dump_latency_percentiles(key, pct);
+        }
+
         count = GF_ATOMIC_GET(conf->incremental.fop_hits[i]);
         total = conf->incremental.latency[i].total;
         min = conf->incremental.latency[i].min;
@@ -3648,6 +3765,14 @@ io_priv(xlator_t *this)
 
         gf_proc_dump_write(key, "%" PRId64 ",%" PRId64 ",%.03f,%.03f,%.03f",
                            count, total, min, max, avg);
+
+        if (count) {
+            ios_get_latency_percentiles(&conf->incremental, i, pct);
+            gf_proc_dump_build_key(key, key_prefix_incremental,
+                                   "%s.latency-percentiles",
+                                   (char *)gf_fop_list[i]);
+            ios_dump_latency_percentiles(key, pct);
+        }
     }
 
     return 0;
@@ -3828,12 +3953,14 @@ ios_conf_destroy(struct ios_conf *conf)
     ios_destroy_top_stats(conf);
     _ios_destroy_dump_thread(conf);
     ios_destroy_sample_buf(conf->ios_sample_buf);
+    GF_FREE(conf->cumulative.latency_hist);
+    GF_FREE(conf->incremental.latency_hist);
     LOCK_DESTROY(&conf->lock);
     gf_dnscache_deinit(conf->dnscache);
     GF_FREE(conf);
 }
 
-static void
+static int
 ios_init_stats(struct ios_global_stats *stats)
 {
     int i = 0;
@@ -3852,7 +3979,15 @@ ios_init_stats(struct ios_global_stats *stats)
     for (i = 0; i < GF_UPCALL_FLAGS_MAXVALUE; i++)
         GF_ATOMIC_INIT(stats->upcall_hits[i], 0);
 
+    stats->latency_hist = GF_CALLOC(GF_FOP_MAXVALUE,
+                                    sizeof(*stats->latency_hist),
+                                    gf_io_stats_mt_ios_latency_hist);
+    if (!stats->latency_hist)
+        return -1;
+
     stats->started_at = gf_time();
+
+    return 0;
 }
 
 int
@@ -3912,8 +4047,13 @@ init(xlator_t *this)
     LOCK_INIT(&conf->lock);
     LOCK_INIT(&conf->ios_sampling_lock);
 
-    ios_init_stats(&conf->cumulative);
-    ios_init_stats(&conf->incremental);
+    ret = ios_init_stats(&conf->cumulative);
+    if (ret)
+        goto out;
+
+    ret = ios_init_stats(&conf->incremental);
+    if (ret)
+        goto out;
 
     ret = ios_init_top_stats(conf);
     if (ret)
@@ -85,7 +85,7 @@ out:
 
 int32_t
 bitd_scrub_post_compute_check(xlator_t *this, br_child_t *child, fd_t *fd,
-                              unsigned long version,
+                              unsigned long version, int8_t signaturetype,
                               br_isignature_out_t **signature,
                               br_scrub_stats_t *scrub_stat,
                               gf_boolean_t skip_stat)
@@ -110,7 +110,8 @@ bitd_scrub_post_compute_check(xlator_t *this, br_child_t *child, fd_t *fd,
      *
      * The log entry looks pretty ugly, but helps in debugging..
      */
-    if (signptr->stale || (signptr->version != version)) {
+    if (signptr->stale || (signptr->version != version) ||
+        (signptr->signaturetype != signaturetype)) {
         if (!skip_stat)
             br_inc_unsigned_file_count(scrub_stat);
         gf_msg_debug(this->name, 0,
@@ -141,7 +142,8 @@ out:
 static int32_t
 bitd_signature_staleness(xlator_t *this, br_child_t *child, fd_t *fd,
                          int *stale, unsigned long *version,
-                         br_scrub_stats_t *scrub_stat, gf_boolean_t skip_stat)
+                         int8_t *signaturetype, br_scrub_stats_t *scrub_stat,
+                         gf_boolean_t skip_stat)
 {
     int32_t ret = -1;
     dict_t *xattr = NULL;
@@ -160,6 +162,7 @@ bitd_signature_staleness(xlator_t *this, br_child_t *child, fd_t *fd,
      */
     *stale = signptr->stale ? 1 : 0;
     *version = signptr->version;
+    *signaturetype = signptr->signaturetype;
 
     dict_unref(xattr);
 
@@ -174,10 +177,11 @@ out:
  * An object is skipped if:
  *  - it's already marked corrupted
  *  - has stale signature
+ *  - is signed with a signature type this scrubber does not know
  */
 int32_t
 bitd_scrub_pre_compute_check(xlator_t *this, br_child_t *child, fd_t *fd,
-                             unsigned long *version,
+                             unsigned long *version, int8_t *signaturetype,
                              br_scrub_stats_t *scrub_stat,
                              gf_boolean_t skip_stat)
 {
@@ -191,8 +195,8 @@ bitd_scrub_pre_compute_check(xlator_t *this, br_child_t *child, fd_t *fd,
         goto out;
     }
 
-    ret = bitd_signature_staleness(this, child, fd, &stale, version, scrub_stat,
-                                   skip_stat);
+    ret = bitd_signature_staleness(this, child, fd, &stale, version,
+                                   signaturetype, scrub_stat, skip_stat);
     if (!ret && stale) {
         if (!skip_stat)
             br_inc_unsigned_file_count(scrub_stat);
@@ -201,6 +205,12 @@ bitd_scrub_pre_compute_check(xlator_t *this, br_child_t *child, fd_t *fd,
                      "has stale signature",
                      uuid_utoa(fd->inode->gfid));
         ret = -1;
+    } else if (!ret && !br_signature_length(*signaturetype)) {
+        gf_msg(this->name, GF_LOG_WARNING, 0, BRB_MSG_SKIP_OBJECT,
+               "Object [GFID: %s] is signed with unknown signature "
+               "type %d, skipping..",
+               uuid_utoa(fd->inode->gfid), *signaturetype);
+        ret = -1;
     }
 
 out:
@@ -224,7 +234,8 @@ bitd_compare_ckum(xlator_t *this, br_isignature_out_t *sign, unsigned char *md,
     GF_VALIDATE_OR_GOTO(this->name, md, out);
     GF_VALIDATE_OR_GOTO(this->name, entry, out);
 
-    if (strncmp(sign->signature, (char *)md, sign->signaturelen) == 0) {
+    if ((sign->signaturelen == br_signature_length(sign->signaturetype)) &&
+        (memcmp(sign->signature, md, sign->signaturelen) == 0)) {
         gf_msg_debug(this->name, 0,
                      "%s [GFID: %s | Brick: %s] "
                      "matches calculated checksum",
@@ -277,9 +288,8 @@ out:
 /**
  * "The Scrubber"
  *
- * Perform signature validation for a given object with the assumption
- * that the signature is SHA256 (because signer as of now _always_
- * signs with SHA256).
+ * Perform signature validation for a given object, checksumming it with
+ * the signature type it was signed with.
  */
 int
 br_scrubber_scrub_begin(xlator_t *this, struct br_fsscan_entry *fsentry)
@@ -301,6 +311,7 @@ br_scrubber_scrub_begin(xlator_t *this, struct br_fsscan_entry *fsentry)
     inode_t *linked_inode = NULL;
     br_isignature_out_t *sign = NULL;
     unsigned long signedversion = 0;
+    int8_t signaturetype = BR_SIGNATURE_TYPE_VOID;
     gf_dirent_t *entry = NULL;
     br_private_t *priv = NULL;
     loc_t *parent = NULL;
@@ -388,16 +399,17 @@ br_scrubber_scrub_begin(xlator_t *this, struct br_fsscan_entry *fsentry)
      *  - signature staleness
      */
     ret = bitd_scrub_pre_compute_check(this, child, fd, &signedversion,
-                                       &priv->scrub_stat, skip_stat);
+                                       &signaturetype, &priv->scrub_stat,
+                                       skip_stat);
     if (ret)
         goto unrefd; /* skip this object */
 
     /* if all's good, proceed to calculate the hash */
-    md = GF_MALLOC(SHA256_DIGEST_LENGTH, gf_common_mt_char);
+    md = GF_MALLOC(BR_HASH_MAX_LENGTH, gf_common_mt_char);
     if (!md)
         goto unrefd;
 
-    ret = br_calculate_obj_checksum(md, child, fd, &iatt);
+    ret = br_calculate_obj_checksum(md, signaturetype, child, fd, &iatt);
     if (ret) {
         gf_msg(this->name, GF_LOG_ERROR, 0, BRB_MSG_CALC_ERROR,
                "error calculating hash for object [GFID: %s]",
@@ -410,7 +422,8 @@ br_scrubber_scrub_begin(xlator_t *this, struct br_fsscan_entry *fsentry)
      * perform post compute checks as an object's signature may have
      * become stale while scrubber calculated checksum.
      */
-    ret = bitd_scrub_post_compute_check(this, child, fd, signedversion, &sign,
+    ret = bitd_scrub_post_compute_check(this, child, fd, signedversion,
+                                        signaturetype, &sign,
                                         &priv->scrub_stat, skip_stat);
     if (ret)
         goto free_md;
@@ -18,6 +18,9 @@
 #include <pthread.h>
 #include "bit-rot-bitd-messages.h"
 
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
 #define BR_HASH_CALC_READ_SIZE (128 * 1024)
 
 typedef int32_t(br_child_handler)(xlator_t *, br_child_t *);
@@ -266,74 +269,187 @@ out:
 }
 
 /**
- * read 128k block from the object @object from the offset @offset
- * and return the buffer.
+ * checksum context of the signature type an object is signed with.
  */
+typedef struct br_hash_ctx {
+    int8_t type;
+    union {
+        SHA256_CTX sha256;
+        XXH64_state_t xxh64;
+    } u;
+} br_hash_ctx_t;
+
 static int32_t
-br_object_read_block_and_sign(xlator_t *this, fd_t *fd, br_child_t *child,
-                              off_t offset, size_t size, SHA256_CTX *sha256)
+br_hash_init(br_hash_ctx_t *ctx, int8_t signaturetype)
 {
-    int32_t ret = -1;
-    tbf_t *tbf = NULL;
-    struct iovec *iovec = NULL;
-    struct iobref *iobref = NULL;
-    br_private_t *priv = NULL;
-    int count = 0;
-    int i = 0;
+    ctx->type = signaturetype;
+
+    switch (signaturetype) {
+        case BR_SIGNATURE_TYPE_SHA256:
+            SHA256_Init(&ctx->u.sha256);
+            return 0;
+        case BR_SIGNATURE_TYPE_XXH64:
+            XXH64_reset(&ctx->u.xxh64, GF_XXHSUM64_DEFAULT_SEED);
+            return 0;
+        default:
+            return -1;
+    }
+}
 
-    GF_VALIDATE_OR_GOTO("bit-rot", this, out);
-    GF_VALIDATE_OR_GOTO(this->name, fd, out);
-    GF_VALIDATE_OR_GOTO(this->name, fd->inode, out);
-    GF_VALIDATE_OR_GOTO(this->name, child, out);
-    GF_VALIDATE_OR_GOTO(this->name, this->private, out);
+static void
+br_hash_update(br_hash_ctx_t *ctx, const void *buf, size_t len)
+{
+    switch (ctx->type) {
+        case BR_SIGNATURE_TYPE_SHA256:
+            SHA256_Update(&ctx->u.sha256, buf, len);
+            break;
+        case BR_SIGNATURE_TYPE_XXH64:
+            XXH64_update(&ctx->u.xxh64, buf, len);
+            break;
+    }
+}
 
-    priv = this->private;
+static void
+br_hash_final(br_hash_ctx_t *ctx, unsigned char *md)
+{
+    XXH64_canonical_t canonical;
+
+    switch (ctx->type) {
+        case BR_SIGNATURE_TYPE_SHA256:
+            SHA256_Final(md, &ctx->u.sha256);
+            break;
+        case BR_SIGNATURE_TYPE_XXH64:
+            XXH64_canonicalFromHash(&canonical,
+                                    XXH64_digest(&ctx->u.xxh64));
+            memcpy(md, canonical.digest, GF_XXH64_DIGEST_LENGTH);
+            break;
+    }
+}
 
-    GF_VALIDATE_OR_GOTO(this->name, priv->tbf, out);
-    tbf = priv->tbf;
+/**
+ * a block of an object being read for checksum calculation. Reads are
+ * wound without waiting for them, so that the next block is fetched from
+ * the brick while the current one is hashed.
+ */
+typedef struct br_hash_block {
+    syncbarrier_t barrier;
 
-    ret = syncop_readv(child->xl, fd, size, offset, 0, &iovec, &count, &iobref,
-                       NULL, NULL, NULL);
+    int32_t op_ret;
+    int32_t op_errno;
 
-    if (ret < 0) {
-        gf_smsg(this->name, GF_LOG_ERROR, errno, BRB_MSG_READV_FAILED,
-                "gfid=%s", uuid_utoa(fd->inode->gfid), NULL);
-        ret = -1;
-        goto out;
+    struct iovec *vector;
+    int count;
+    struct iobref *iobref;
+} br_hash_block_t;
+
+static int32_t
+br_object_readv_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                    int32_t op_ret, int32_t op_errno, struct iovec *vector,
+                    int32_t count, struct iatt *stbuf, struct iobref *iobref,
+                    dict_t *xdata)
+{
+    br_hash_block_t *block = cookie;
+
+    block->op_ret = op_ret;
+    block->op_errno = op_errno;
+
+    if (op_ret > 0) {
+        block->vector = iov_dup(vector, count);
+        block->count = count;
+        if (iobref)
+            block->iobref = iobref_ref(iobref);
+        if (!block->vector) {
+            block->op_ret = -1;
+            block->op_errno = ENOMEM;
+        }
     }
 
-    if (ret == 0)
-        goto out;
+    STACK_DESTROY(frame->root);
+    syncbarrier_wake(&block->barrier);
+
+    return 0;
+}
+
+/**
+ * start reading @size bytes of the object from the offset @offset into
+ * @block. Completion is waited for on the block's barrier.
+ */
+static int32_t
+br_object_read_block(xlator_t *this, fd_t *fd, br_child_t *child,
+                     off_t offset, size_t size, br_hash_block_t *block)
+{
+    struct synctask *task = NULL;
+    call_frame_t *frame = NULL;
+
+    task = synctask_get();
+    if (task)
+        frame = copy_frame(task->opframe);
+    else
+        frame = syncop_create_frame(this);
+    if (!frame)
+        return -1;
+
+    if (task) {
+        frame->root->uid = task->uid;
+        frame->root->gid = task->gid;
+    }
+
+    block->vector = NULL;
+    block->count = 0;
+    block->iobref = NULL;
+
+    frame->op = GF_FOP_READ;
+    STACK_WIND_COOKIE(frame, br_object_readv_cbk, block, child->xl,
+                      child->xl->fops->readv, fd, size, offset, 0, NULL);
 
-    for (i = 0; i < count; i++) {
-        TBF_THROTTLE_BEGIN(tbf, TBF_OP_HASH, iovec[i].iov_len);
+    return 0;
+}
+
+static void
+br_object_sign_block(xlator_t *this, br_hash_ctx_t *ctx,
+                     br_hash_block_t *block)
+{
+    br_private_t *priv = this->private;
+    int i = 0;
+
+    for (i = 0; i < block->count; i++) {
+        TBF_THROTTLE_BEGIN(priv->tbf, TBF_OP_HASH, block->vector[i].iov_len);
         {
-            SHA256_Update(sha256, (const unsigned char *)(iovec[i].iov_base),
-                          iovec[i].iov_len);
+            br_hash_update(ctx, block->vector[i].iov_base,
+                           block->vector[i].iov_len);
         }
-        TBF_THROTTLE_BEGIN(tbf, TBF_OP_HASH, iovec[i].iov_len);
+        TBF_THROTTLE_END(priv->tbf, TBF_OP_HASH, block->vector[i].iov_len);
     }
+}
 
-out:
-    if (iovec)
-        GF_FREE(iovec);
-
-    if (iobref)
-        iobref_unref(iobref);
+static void
+br_object_release_block(br_hash_block_t *block)
+{
+    GF_FREE(block->vector);
+    block->vector = NULL;
 
-    return ret;
+    if (block->iobref)
+        iobref_unref(block->iobref);
+    block->iobref = NULL;
 }
 
+/**
+ * calculate the checksum of an object of type @signaturetype into @md,
+ * which must hold at least BR_HASH_MAX_LENGTH bytes. The object is read in
+ * BR_HASH_CALC_READ_SIZE blocks, one ahead of the block being hashed.
+ */
 int32_t
-br_calculate_obj_checksum(unsigned char *md, br_child_t *child, fd_t *fd,
-                          struct iatt *iatt)
+br_calculate_obj_checksum(unsigned char *md, int8_t signaturetype,
+                          br_child_t *child, fd_t *fd, struct iatt *iatt)
 {
     int32_t ret = -1;
     off_t offset = 0;
     size_t block = BR_HASH_CALC_READ_SIZE;
     xlator_t *this = NULL;
-
-    SHA256_CTX sha256;
+    br_hash_ctx_t hash;
+    br_hash_block_t blocks[2];
+    br_hash_block_t *current = NULL;
+    int cur = 0;
 
     GF_VALIDATE_OR_GOTO("bit-rot", child, out);
     GF_VALIDATE_OR_GOTO("bit-rot", iatt, out);
@@ -341,15 +457,38 @@ br_calculate_obj_checksum(unsigned char *md, br_child_t *child, fd_t *fd,
 
     this = child->this;
 
-    SHA256_Init(&sha256);
+    GF_VALIDATE_OR_GOTO(this->name, this->private, out);
+
+    if (br_hash_init(&hash, signaturetype)) {
+        gf_smsg(this->name, GF_LOG_ERROR, EINVAL, BRB_MSG_CALC_CHECKSUM_FAILED,
+                "signature-type=%d", signaturetype, "object-gfid=%s",
+                uuid_utoa(fd->inode->gfid), NULL);
+        goto out;
+    }
+
+    if (syncbarrier_init(&blocks[0].barrier))
+        goto out;
+    if (syncbarrier_init(&blocks[1].barrier))
+        goto destroy_barrier;
+
+    ret = br_object_read_block(this, fd, child, offset, block, &blocks[cur]);
+    if (ret < 0)
+        goto destroy_barriers;
 
     while (1) {
-        ret = br_object_read_block_and_sign(this, fd, child, offset, block,
-                                            &sha256);
+        current = &blocks[cur];
+
+        syncbarrier_wait(&current->barrier, 1);
+
+        ret = current->op_ret;
         if (ret < 0) {
+            gf_smsg(this->name, GF_LOG_ERROR, current->op_errno,
+                    BRB_MSG_READV_FAILED, "gfid=%s",
+                    uuid_utoa(fd->inode->gfid), NULL);
             gf_smsg(this->name, GF_LOG_ERROR, 0, BRB_MSG_BLOCK_READ_FAILED,
                     "offset=%" PRIu64, offset, "object-gfid=%s",
                     uuid_utoa(fd->inode->gfid), NULL);
+            ret = -1;
             break;
         }
 
@@ -357,20 +496,37 @@ br_calculate_obj_checksum(unsigned char *md, br_child_t *child, fd_t *fd,
             break;
 
         offset += ret;
+
+        ret = br_object_read_block(this, fd, child, offset, block,
+                                   &blocks[!cur]);
+        if (ret < 0) {
+            br_object_release_block(current);
+            break;
+        }
+
+        br_object_sign_block(this, &hash, current);
+        br_object_release_block(current);
+
+        cur = !cur;
     }
 
     if (ret == 0)
-        SHA256_Final(md, &sha256);
+        br_hash_final(&hash, md);
 
+destroy_barriers:
+    syncbarrier_destroy(&blocks[1].barrier);
+destroy_barrier:
+    syncbarrier_destroy(&blocks[0].barrier);
 out:
     return ret;
 }
 
 static int32_t
-br_object_checksum(unsigned char *md, br_object_t *object, fd_t *fd,
-                   struct iatt *iatt)
+br_object_checksum(unsigned char *md, int8_t signaturetype,
+                   br_object_t *object, fd_t *fd, struct iatt *iatt)
 {
-    return br_calculate_obj_checksum(md, object->child, fd, iatt);
+    return br_calculate_obj_checksum(md, signaturetype, object->child, fd,
+                                     iatt);
 }
 
 static int32_t
@@ -382,29 +538,36 @@ br_object_read_sign(inode_t *linked_inode, fd_t *fd, br_object_t *object,
     dict_t *xattr = NULL;
     unsigned char *md = NULL;
     br_isignature_t *sign = NULL;
+    br_private_t *priv = NULL;
+    int8_t signaturetype = BR_SIGNATURE_TYPE_VOID;
+    size_t signaturelen = 0;
 
     GF_VALIDATE_OR_GOTO("bit-rot", object, out);
     GF_VALIDATE_OR_GOTO("bit-rot", linked_inode, out);
     GF_VALIDATE_OR_GOTO("bit-rot", fd, out);
 
     this = object->this;
+    priv = this->private;
 
-    md = GF_MALLOC(SHA256_DIGEST_LENGTH, gf_common_mt_char);
+    /* sample once, signature-type may be reconfigured while signing */
+    signaturetype = priv->signature_type;
+    signaturelen = br_signature_length(signaturetype);
+
+    md = GF_MALLOC(BR_HASH_MAX_LENGTH, gf_common_mt_char);
     if (!md) {
         gf_smsg(this->name, GF_LOG_ERROR, ENOMEM, BRB_MSG_SAVING_HASH_FAILED,
                 "object-gfid=%s", uuid_utoa(fd->inode->gfid), NULL);
         goto out;
     }
 
-    ret = br_object_checksum(md, object, fd, iatt);
+    ret = br_object_checksum(md, signaturetype, object, fd, iatt);
     if (ret) {
         gf_smsg(this->name, GF_LOG_ERROR, 0, BRB_MSG_CALC_CHECKSUM_FAILED,
                 "object-gfid=%s", uuid_utoa(linked_inode->gfid), NULL);
         goto free_signature;
     }
 
-    sign = br_prepare_signature(md, SHA256_DIGEST_LENGTH,
-                                BR_SIGNATURE_TYPE_SHA256, object);
+    sign = br_prepare_signature(md, signaturelen, signaturetype, object);
     if (!sign) {
         gf_smsg(this->name, GF_LOG_ERROR, 0, BRB_MSG_GET_SIGN_FAILED,
                 "object-gfid=%s", uuid_utoa(fd->inode->gfid), NULL);
@@ -412,7 +575,7 @@ br_object_read_sign(inode_t *linked_inode, fd_t *fd, br_object_t *object,
     }
 
     xattr = dict_for_key_value(GLUSTERFS_SET_OBJECT_SIGNATURE, (void *)sign,
-                               signature_size(SHA256_DIGEST_LENGTH), _gf_true);
+                               signature_size(signaturelen), _gf_true);
 
     if (!xattr) {
         gf_smsg(this->name, GF_LOG_ERROR, 0, BRB_MSG_SET_SIGN_FAILED,
@@ -1849,20 +2012,35 @@ br_rate_limit_signer(xlator_t *this, int child_count, int numbricks)
     return priv->tbf ? 0 : -1;
 }
 
+static int8_t
+br_signature_type_from_str(char *signature_type)
+{
+    if (strcasecmp(signature_type, "xxh64") == 0)
+        return BR_SIGNATURE_TYPE_XXH64;
+    return BR_SIGNATURE_TYPE_SHA256;
+}
+
 static int32_t
 br_signer_handle_options(xlator_t *this, br_private_t *priv, dict_t *options)
 {
+    char *signature_type = NULL;
+
     if (options) {
         GF_OPTION_RECONF("expiry-time", priv->expiry_time, options, uint32,
                          error_return);
         GF_OPTION_RECONF("signer-threads", priv->signer_th_count, options,
                          uint32, error_return);
+        GF_OPTION_RECONF("signature-type", signature_type, options, str,
+                         error_return);
     } else {
         GF_OPTION_INIT("expiry-time", priv->expiry_time, uint32, error_return);
         GF_OPTION_INIT("signer-threads", priv->signer_th_count, uint32,
                        error_return);
+        GF_OPTION_INIT("signature-type", signature_type, str, error_return);
     }
 
+    priv->signature_type = br_signature_type_from_str(signature_type);
+
     return 0;
 
 error_return:
@@ -1879,7 +2057,6 @@ br_signer_init(xlator_t *this, br_private_t *priv)
     GF_OPTION_INIT("brick-count", numbricks, int32, error_return);
     GF_OPTION_INIT("signer-threads", priv->signer_th_count, uint32,
                    error_return);
-
     ret = br_rate_limit_signer(this, priv->child_count, numbricks);
     if (ret)
         goto error_return;
@@ -2214,6 +2391,19 @@ struct volume_options options[] = {
         .description = "Number of signing process threads. As a best "
                        "practice, set this to the number of processor cores",
     },
+    {
+        .key = {"signature-type"},
+        .type = GF_OPTION_TYPE_STR,
+        .value = {"sha256", "xxh64"},
+        .default_value = BR_SIGNATURE_HASH,
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_SETTABLE,
+        .description = "Hash used to sign objects. xxh64 is a much faster, "
+                       "non-cryptographic checksum which still detects "
+                       "silent corruption. Objects keep the type they were "
+                       "signed with until they are signed again, and the "
+                       "scrubber verifies each object with its own type.",
+    },
     {.key = {NULL}},
 };
 
@@ -50,6 +50,9 @@ typedef enum scrub_freq {
 
 #define signature_size(hl) (sizeof(br_isignature_t) + hl + 1)
 
+/* longest digest of all supported signature types */
+#define BR_HASH_MAX_LENGTH SHA256_DIGEST_LENGTH
+
 struct br_scanfs {
     gf_lock_t entrylock;
 
@@ -205,6 +208,8 @@ struct br_private {
 
     uint32_t signer_th_count; /* Number of signing process threads */
 
+    int8_t signature_type; /* hash used to sign objects */
+
     tbf_t *tbf; /* token bucket filter */
 
     gf_boolean_t iamscrubber; /* function as a fs scrubber */
@@ -242,7 +247,21 @@ void
 br_log_object_path(xlator_t *, char *, const char *, int32_t);
 
 int32_t
-br_calculate_obj_checksum(unsigned char *, br_child_t *, fd_t *, struct iatt *);
+br_calculate_obj_checksum(unsigned char *, int8_t, br_child_t *, fd_t *,
+                          struct iatt *);
+
+static inline size_t
+br_signature_length(int8_t signaturetype)
+{
+    switch (signaturetype) {
+        case BR_SIGNATURE_TYPE_SHA256:
+            return SHA256_DIGEST_LENGTH;
+        case BR_SIGNATURE_TYPE_XXH64:
+            return GF_XXH64_DIGEST_LENGTH;
+        default:
+            return 0;
+    }
+}
 
 int32_t
 br_prepare_loc(xlator_t *, br_child_t *, loc_t *, gf_dirent_t *, loc_t *);
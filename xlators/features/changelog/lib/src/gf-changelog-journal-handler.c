@@ -424,6 +424,223 @@ out:
     return ret;
 }
 
+/**
+ * compact decoder: the type and the binary gfid, followed by varint fop
+ * numbers and length prefixed names (see changelog_encode_compact()).
+ * Produces the same output as the ascii decoder.
+ */
+static int
+gf_changelog_compact_varint(char **mover, off_t *nleft, uint32_t *value)
+{
+    size_t len = 0;
+
+    len = changelog_get_varint(*mover, *nleft, value);
+    if (len == 0)
+        return -1;
+
+    MOVER_MOVE(*mover, *nleft, len);
+    return 0;
+}
+
+static int
+gf_changelog_compact_string(char **mover, off_t *nleft, char *str)
+{
+    uint32_t len = 0;
+
+    if (gf_changelog_compact_varint(mover, nleft, &len))
+        return -1;
+    if ((len >= PATH_MAX) || (len > *nleft))
+        return -1;
+
+    memcpy(str, *mover, len);
+    str[len] = '\0';
+
+    MOVER_MOVE(*mover, *nleft, len);
+    return 0;
+}
+
+static int
+gf_changelog_parse_compact(xlator_t *this, gf_changelog_journal_t *jnl,
+                           int from_fd, int to_fd, size_t start_offset,
+                           struct stat *stbuf, int version_idx)
+{
+    int i = 0;
+    int ng = 0;
+    int ret = -1;
+    int len = 0;
+    off_t off = 0;
+    off_t nleft = 0;
+    uint32_t nr = 0;
+    uint32_t fop = 0;
+    uuid_t uuid = {
+        0,
+    };
+    char *ptr = NULL;
+    void *start = NULL;
+    char *mover = NULL;
+    int parse_err = 0;
+    char current_mover = ' ';
+    char *ascii = NULL;
+    char *name = NULL;
+    char *eptr = NULL;
+    char number[16] = {
+        0,
+    };
+    const char *fopname = NULL;
+
+    ascii = GF_CALLOC(LINE_BUFSIZE, sizeof(char), gf_common_mt_char);
+    /* room for "<pargfid>/<bname>" or a path, and for its encoding */
+    name = GF_CALLOC(PATH_MAX + UUID_CANONICAL_FORM_LEN + 2, sizeof(char),
+                     gf_common_mt_char);
+    eptr = GF_CALLOC(3 * (PATH_MAX + UUID_CANONICAL_FORM_LEN + 2),
+                     sizeof(char), gf_common_mt_char);
+    if (!ascii || !name || !eptr)
+        goto out;
+
+    nleft = stbuf->st_size;
+
+    start = mmap(NULL, nleft, PROT_READ, MAP_PRIVATE, from_fd, 0);
+    if (start == MAP_FAILED) {
+        gf_msg(this->name, GF_LOG_ERROR, errno, CHANGELOG_LIB_MSG_MMAP_FAILED,
+               "mmap() error");
+        goto out;
+    }
+
+    mover = start;
+
+    MOVER_MOVE(mover, nleft, start_offset);
+
+    while (nleft > 0) {
+        off = 0;
+        current_mover = *mover;
+
+        MOVER_MOVE(mover, nleft, 1);
+        if (nleft < sizeof(uuid_t)) {
+            parse_err = 1;
+            break;
+        }
+
+        /* target gfid */
+        PARSE_GFID_MOVE(ptr, uuid, mover, nleft, parse_err);
+
+        GF_CHANGELOG_FILL_BUFFER(&current_mover, ascii, off, 1);
+        GF_CHANGELOG_FILL_BUFFER(" ", ascii, off, 1);
+        GF_CHANGELOG_FILL_BUFFER(ptr, ascii, off, strlen(ptr));
+
+        switch (current_mover) {
+            case 'D':
+                break;
+
+            case 'M':
+            case 'E':
+                /* fop */
+                if (gf_changelog_compact_varint(&mover, &nleft, &fop) ||
+                    (fop >= GF_FOP_MAXVALUE) || !gf_fop_list[fop]) {
+                    parse_err = 1;
+                    break;
+                }
+
+                fopname = gf_fop_list[fop];
+                GF_CHANGELOG_FILL_BUFFER(" ", ascii, off, 1);
+                GF_CHANGELOG_FILL_BUFFER(fopname, ascii, off, strlen(fopname));
+
+                if (current_mover == 'M')
+                    break;
+
+                ng = nr_extra_recs[version_idx][fop];
+                for (; ng > 0; ng--) {
+                    if (gf_changelog_compact_varint(&mover, &nleft, &nr)) {
+                        parse_err = 1;
+                        break;
+                    }
+
+                    len = snprintf(number, sizeof(number), " %u", nr);
+                    GF_CHANGELOG_FILL_BUFFER(number, ascii, off, len);
+                }
+
+                if (parse_err)
+                    break;
+
+                /**
+                 * pargfid + bname, the second record of an unlink or
+                 * rmdir is the path of the deleted entry, if captured.
+                 */
+                ng = nr_gfids[version_idx][fop];
+                for (i = 0; i < ng; i++) {
+                    if ((i > 0) &&
+                        ((fop == GF_FOP_UNLINK) || (fop == GF_FOP_RMDIR))) {
+                        if (gf_changelog_compact_string(&mover, &nleft,
+                                                        name)) {
+                            parse_err = 1;
+                            break;
+                        }
+                        if (name[0] == '\0')
+                            continue;
+                    } else {
+                        if (nleft < sizeof(uuid_t)) {
+                            parse_err = 1;
+                            break;
+                        }
+                        PARSE_GFID_MOVE(ptr, uuid, mover, nleft, parse_err);
+
+                        len = strlen(ptr);
+                        memcpy(name, ptr, len);
+                        name[len++] = '/';
+                        if (gf_changelog_compact_string(&mover, &nleft,
+                                                        name + len)) {
+                            parse_err = 1;
+                            break;
+                        }
+                    }
+
+                    eptr[0] = '\0';
+                    gf_rfc3986_encode_space_newline((unsigned char *)name, eptr,
+                                                    jnl->rfc3986_space_newline);
+                    len = strlen(eptr);
+                    if (off + len + 2 > LINE_BUFSIZE) {
+                        parse_err = 1;
+                        break;
+                    }
+
+                    GF_CHANGELOG_FILL_BUFFER(" ", ascii, off, 1);
+                    GF_CHANGELOG_FILL_BUFFER(eptr, ascii, off, len);
+                }
+
+                break;
+
+            default:
+                parse_err = 1;
+        }
+
+        if (parse_err)
+            break;
+
+        GF_CHANGELOG_FILL_BUFFER("\n", ascii, off, 1);
+
+        if (gf_changelog_write(to_fd, ascii, off) != off) {
+            gf_msg(this->name, GF_LOG_ERROR, errno,
+                   CHANGELOG_LIB_MSG_ASCII_ERROR,
+                   "processing compact changelog failed due to "
+                   " error in writing change");
+            break;
+        }
+    }
+
+    if ((nleft == 0) && (!parse_err))
+        ret = 0;
+
+    if (munmap(start, stbuf->st_size))
+        gf_msg(this->name, GF_LOG_ERROR, errno, CHANGELOG_LIB_MSG_MUNMAP_FAILED,
+               "munmap() error");
+
+out:
+    GF_FREE(ascii);
+    GF_FREE(name);
+    GF_FREE(eptr);
+
+    return ret;
+}
+
 static int
 gf_changelog_decode(xlator_t *this, gf_changelog_journal_t *jnl, int from_fd,
                     int to_fd, struct stat *stbuf, int *zerob)
@@ -486,6 +703,11 @@ gf_changelog_decode(xlator_t *this, gf_changelog_journal_t *jnl, int from_fd,
             ret = gf_changelog_parse_ascii(this, jnl, from_fd, to_fd, elen,
                                            stbuf, version_idx);
             break;
+
+        case CHANGELOG_ENCODE_COMPACT:
+            ret = gf_changelog_parse_compact(this, jnl, from_fd, to_fd, elen,
+                                             stbuf, version_idx);
+            break;
     }
 
 out:
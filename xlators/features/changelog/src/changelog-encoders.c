@@ -10,8 +10,24 @@
 
 #include "changelog-encoders.h"
 
+/**
+ * compact strings are prefixed with their length instead of being
+ * separated or terminated.
+ */
+static size_t
+changelog_fill_compact_string(char *buffer, const char *str)
+{
+    size_t bufsz = 0;
+    size_t len = strlen(str);
+
+    bufsz = changelog_put_varint(buffer, len);
+    CHANGELOG_FILL_BUFFER(buffer, bufsz, str, len);
+
+    return bufsz;
+}
+
 size_t
-entry_fn(void *data, char *buffer, gf_boolean_t encode)
+entry_fn(void *data, char *buffer, changelog_encoder_t encoder)
 {
     char *tmpbuf = NULL;
     size_t bufsz = 0;
@@ -19,20 +35,25 @@ entry_fn(void *data, char *buffer, gf_boolean_t encode)
 
     ce = (struct changelog_entry_fields *)data;
 
-    if (encode) {
+    if (encoder == CHANGELOG_ENCODE_ASCII) {
         tmpbuf = uuid_utoa(ce->cef_uuid);
         CHANGELOG_FILL_BUFFER(buffer, bufsz, tmpbuf, strlen(tmpbuf));
     } else {
         CHANGELOG_FILL_BUFFER(buffer, bufsz, ce->cef_uuid, sizeof(uuid_t));
     }
 
+    if (encoder == CHANGELOG_ENCODE_COMPACT) {
+        bufsz += changelog_fill_compact_string(buffer + bufsz, ce->cef_bname);
+        return bufsz;
+    }
+
     CHANGELOG_FILL_BUFFER(buffer, bufsz, "/", 1);
     CHANGELOG_FILL_BUFFER(buffer, bufsz, ce->cef_bname, strlen(ce->cef_bname));
     return bufsz;
 }
 
 size_t
-del_entry_fn(void *data, char *buffer, gf_boolean_t encode)
+del_entry_fn(void *data, char *buffer, changelog_encoder_t encoder)
 {
     char *tmpbuf = NULL;
     size_t bufsz = 0;
@@ -40,13 +61,20 @@ del_entry_fn(void *data, char *buffer, gf_boolean_t encode)
 
     ce = (struct changelog_entry_fields *)data;
 
-    if (encode) {
+    if (encoder == CHANGELOG_ENCODE_ASCII) {
         tmpbuf = uuid_utoa(ce->cef_uuid);
         CHANGELOG_FILL_BUFFER(buffer, bufsz, tmpbuf, strlen(tmpbuf));
     } else {
         CHANGELOG_FILL_BUFFER(buffer, bufsz, ce->cef_uuid, sizeof(uuid_t));
     }
 
+    /* an empty path is stored as a zero length */
+    if (encoder == CHANGELOG_ENCODE_COMPACT) {
+        bufsz += changelog_fill_compact_string(buffer + bufsz, ce->cef_bname);
+        bufsz += changelog_fill_compact_string(buffer + bufsz, ce->cef_path);
+        return bufsz;
+    }
+
     CHANGELOG_FILL_BUFFER(buffer, bufsz, "/", 1);
     CHANGELOG_FILL_BUFFER(buffer, bufsz, ce->cef_bname, strlen(ce->cef_bname));
     CHANGELOG_FILL_BUFFER(buffer, bufsz, "\0", 1);
@@ -62,7 +90,7 @@ del_entry_fn(void *data, char *buffer, gf_boolean_t encode)
 }
 
 size_t
-fop_fn(void *data, char *buffer, gf_boolean_t encode)
+fop_fn(void *data, char *buffer, changelog_encoder_t encoder)
 {
     char buf[10] = {
         0,
@@ -72,17 +100,19 @@ fop_fn(void *data, char *buffer, gf_boolean_t encode)
 
     fop = *(glusterfs_fop_t *)data;
 
-    if (encode) {
+    if (encoder == CHANGELOG_ENCODE_ASCII) {
         (void)snprintf(buf, sizeof(buf), "%d", fop);
         CHANGELOG_FILL_BUFFER(buffer, bufsz, buf, strlen(buf));
-    } else
+    } else if (encoder == CHANGELOG_ENCODE_COMPACT)
+        bufsz = changelog_put_varint(buffer, fop);
+    else
         CHANGELOG_FILL_BUFFER(buffer, bufsz, &fop, sizeof(fop));
 
     return bufsz;
 }
 
 size_t
-number_fn(void *data, char *buffer, gf_boolean_t encode)
+number_fn(void *data, char *buffer, changelog_encoder_t encoder)
 {
     size_t bufsz = 0;
     unsigned int nr = 0;
@@ -92,10 +122,12 @@ number_fn(void *data, char *buffer, gf_boolean_t encode)
 
     nr = *(unsigned int *)data;
 
-    if (encode) {
+    if (encoder == CHANGELOG_ENCODE_ASCII) {
         (void)snprintf(buf, sizeof(buf), "%u", nr);
         CHANGELOG_FILL_BUFFER(buffer, bufsz, buf, strlen(buf));
-    } else
+    } else if (encoder == CHANGELOG_ENCODE_COMPACT)
+        bufsz = changelog_put_varint(buffer, nr);
+    else
         CHANGELOG_FILL_BUFFER(buffer, bufsz, &nr, sizeof(unsigned int));
 
     return bufsz;
@@ -130,7 +162,7 @@ del_entry_free_fn(void *data)
 
 static void
 changelog_encode_write_xtra(changelog_log_data_t *cld, char *buffer,
-                            size_t *off, gf_boolean_t encode)
+                            size_t *off, changelog_encoder_t encoder)
 {
     int i = 0;
     size_t offset = 0;
@@ -142,7 +174,9 @@ changelog_encode_write_xtra(changelog_log_data_t *cld, char *buffer,
     co = (changelog_opt_t *)cld->cld_ptr;
 
     for (; i < cld->cld_xtra_records; i++, co++) {
-        CHANGELOG_FILL_BUFFER(buffer, offset, "\0", 1);
+        /* compact records are self delimiting */
+        if (encoder != CHANGELOG_ENCODE_COMPACT)
+            CHANGELOG_FILL_BUFFER(buffer, offset, "\0", 1);
 
         switch (co->co_type) {
             case CHANGELOG_OPT_REC_FOP:
@@ -157,7 +191,7 @@ changelog_encode_write_xtra(changelog_log_data_t *cld, char *buffer,
         }
 
         if (co->co_convert)
-            offset += co->co_convert(data, buffer + offset, encode);
+            offset += co->co_convert(data, buffer + offset, encoder);
         else /* no coversion: write it out as it is */
             CHANGELOG_FILL_BUFFER(buffer, offset, data, co->co_len);
     }
@@ -184,7 +218,8 @@ changelog_encode_ascii(xlator_t *this, changelog_log_data_t *cld)
     CHANGELOG_STORE_ASCII(priv, buffer, off, gfid_str, gfid_len, cld);
 
     if (cld->cld_xtra_records)
-        changelog_encode_write_xtra(cld, buffer, &off, _gf_true);
+        changelog_encode_write_xtra(cld, buffer, &off,
+                                    CHANGELOG_ENCODE_ASCII);
 
     CHANGELOG_FILL_BUFFER(buffer, off, "\0", 1);
 
@@ -205,13 +240,39 @@ changelog_encode_binary(xlator_t *this, changelog_log_data_t *cld)
     CHANGELOG_STORE_BINARY(priv, buffer, off, cld->cld_gfid, cld);
 
     if (cld->cld_xtra_records)
-        changelog_encode_write_xtra(cld, buffer, &off, _gf_false);
+        changelog_encode_write_xtra(cld, buffer, &off,
+                                    CHANGELOG_ENCODE_BINARY);
 
     CHANGELOG_FILL_BUFFER(buffer, off, "\0", 1);
 
     return changelog_write_change(priv, buffer, off);
 }
 
+/**
+ * compact encoding: the type, the binary gfid and the optional records,
+ * with numbers and lengths as varints and no separators or terminator.
+ */
+int
+changelog_encode_compact(xlator_t *this, changelog_log_data_t *cld)
+{
+    size_t off = 0;
+    char *buffer = NULL;
+    changelog_priv_t *priv = NULL;
+
+    priv = this->private;
+
+    /* a varint may take one byte more than the record it encodes */
+    buffer = alloca(sizeof(uuid_t) + cld->cld_ptr_len +
+                    (2 * cld->cld_xtra_records) + 10);
+    CHANGELOG_STORE_BINARY(priv, buffer, off, cld->cld_gfid, cld);
+
+    if (cld->cld_xtra_records)
+        changelog_encode_write_xtra(cld, buffer, &off,
+                                    CHANGELOG_ENCODE_COMPACT);
+
+    return changelog_write_change(priv, buffer, off);
+}
+
 static struct changelog_encoder cb_encoder[] = {
     [CHANGELOG_ENCODE_BINARY] =
         {
@@ -223,6 +284,11 @@ static struct changelog_encoder cb_encoder[] = {
             .encoder = CHANGELOG_ENCODE_ASCII,
             .encode = changelog_encode_ascii,
         },
+    [CHANGELOG_ENCODE_COMPACT] =
+        {
+            .encoder = CHANGELOG_ENCODE_COMPACT,
+            .encode = changelog_encode_compact,
+        },
 };
 
 void
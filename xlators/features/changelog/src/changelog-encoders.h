@@ -29,13 +29,13 @@
     } while (0)
 
 size_t
-entry_fn(void *data, char *buffer, gf_boolean_t encode);
+entry_fn(void *data, char *buffer, changelog_encoder_t encoder);
 size_t
-del_entry_fn(void *data, char *buffer, gf_boolean_t encode);
+del_entry_fn(void *data, char *buffer, changelog_encoder_t encoder);
 size_t
-fop_fn(void *data, char *buffer, gf_boolean_t encode);
+fop_fn(void *data, char *buffer, changelog_encoder_t encoder);
 size_t
-number_fn(void *data, char *buffer, gf_boolean_t encode);
+number_fn(void *data, char *buffer, changelog_encoder_t encoder);
 void
 entry_free_fn(void *data);
 void
@@ -44,6 +44,8 @@ int
 changelog_encode_binary(xlator_t *, changelog_log_data_t *);
 int
 changelog_encode_ascii(xlator_t *, changelog_log_data_t *);
+int
+changelog_encode_compact(xlator_t *, changelog_log_data_t *);
 void
 changelog_encode_change(changelog_priv_t *);
 
@@ -402,6 +402,7 @@ changelog_rollover_changelog(xlator_t *this, changelog_priv_t *priv, time_t ts)
     };
 
     if (priv->changelog_fd != -1) {
+        (void)changelog_journal_drain(this, priv);
         ret = sys_fsync(priv->changelog_fd);
         if (ret < 0) {
             gf_smsg(this->name, GF_LOG_ERROR, errno,
@@ -930,9 +931,8 @@ changelog_open_journal(xlator_t *this, changelog_priv_t *priv)
     (void)snprintf(changelog_path, PATH_MAX, "%s/" CHANGELOG_FILE_NAME,
                    priv->changelog_dir);
 
+    /* with fsync-interval 0 every batch of records is synced on its own */
     flags |= (O_CREAT | O_RDWR);
-    if (priv->fsync_interval == 0)
-        flags |= O_SYNC;
 
     fd = open(changelog_path, flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
     if (fd < 0) {
@@ -945,7 +945,7 @@ changelog_open_journal(xlator_t *this, changelog_priv_t *priv)
 
     (void)snprintf(buffer, 1024, CHANGELOG_HEADER, CHANGELOG_VERSION_MAJOR,
                    CHANGELOG_VERSION_MINOR, priv->ce->encoder);
-    ret = changelog_write_change(priv, buffer, strlen(buffer));
+    ret = changelog_write(priv->changelog_fd, buffer, strlen(buffer));
     if (ret) {
         sys_close(priv->changelog_fd);
         priv->changelog_fd = -1;
@@ -995,10 +995,241 @@ changelog_snap_write_change(changelog_priv_t *priv, char *buffer, size_t len)
     return changelog_write(priv->c_snap_fd, buffer, len);
 }
 
+#define CHANGELOG_JOURNAL_BUFSIZE (64 * GF_UNIT_KB)
+
+int
+changelog_journal_init(xlator_t *this, changelog_journal_t *jnl)
+{
+    int ret = 0;
+
+    INIT_LIST_HEAD(&jnl->waiters);
+
+    if ((ret = pthread_mutex_init(&jnl->lock, NULL)) != 0) {
+        gf_smsg(this->name, GF_LOG_ERROR, errno,
+                CHANGELOG_MSG_PTHREAD_MUTEX_INIT_FAILED, "name=journal",
+                "ret=%d", ret, NULL);
+        return -1;
+    }
+
+    if ((ret = pthread_cond_init(&jnl->cond, NULL)) != 0) {
+        gf_smsg(this->name, GF_LOG_ERROR, errno,
+                CHANGELOG_MSG_PTHREAD_COND_INIT_FAILED, "name=journal",
+                "ret=%d", ret, NULL);
+        pthread_mutex_destroy(&jnl->lock);
+        return -1;
+    }
+
+    return 0;
+}
+
+void
+changelog_journal_fini(changelog_journal_t *jnl)
+{
+    pthread_mutex_destroy(&jnl->lock);
+    pthread_cond_destroy(&jnl->cond);
+
+    GF_FREE(jnl->buf);
+    GF_FREE(jnl->spare);
+}
+
+/**
+ * append a record to the journal. Callers hold the dispatcher lock, which
+ * orders the records and keeps them apart from rollovers.
+ */
 int
 changelog_write_change(changelog_priv_t *priv, char *buffer, size_t len)
 {
-    return changelog_write(priv->changelog_fd, buffer, len);
+    int ret = -1;
+    char *buf = NULL;
+    size_t size = 0;
+    changelog_journal_t *jnl = &priv->jnl;
+
+    pthread_mutex_lock(&jnl->lock);
+    {
+        if (jnl->len + len > jnl->size) {
+            size = max(jnl->size * 2, jnl->len + len);
+            size = max(size, CHANGELOG_JOURNAL_BUFSIZE);
+
+            if (jnl->buf)
+                buf = GF_REALLOC(jnl->buf, size);
+            else
+                buf = GF_MALLOC(size, gf_changelog_mt_journal_buf_t);
+            if (!buf)
+                goto unlock;
+
+            jnl->buf = buf;
+            jnl->size = size;
+        }
+
+        memcpy(jnl->buf + jnl->len, buffer, len);
+        jnl->len += len;
+        jnl->appended++;
+        ret = 0;
+    }
+unlock:
+    pthread_mutex_unlock(&jnl->lock);
+
+    return ret;
+}
+
+/**
+ * register @waiter before it appends its records: a batch that fails while
+ * the records are being appended may already hold some of them.
+ */
+void
+changelog_journal_enlist(changelog_priv_t *priv,
+                         changelog_journal_waiter_t *waiter)
+{
+    changelog_journal_t *jnl = &priv->jnl;
+
+    pthread_mutex_lock(&jnl->lock);
+    {
+        waiter->from = jnl->appended + 1;
+        waiter->to = UINT64_MAX;
+        waiter->failed = _gf_false;
+        list_add_tail(&waiter->list, &jnl->waiters);
+    }
+    pthread_mutex_unlock(&jnl->lock);
+}
+
+/* @waiter has appended all its records, they are the last ones so far */
+void
+changelog_journal_appended(changelog_priv_t *priv,
+                           changelog_journal_waiter_t *waiter)
+{
+    changelog_journal_t *jnl = &priv->jnl;
+
+    pthread_mutex_lock(&jnl->lock);
+    {
+        waiter->to = jnl->appended;
+    }
+    pthread_mutex_unlock(&jnl->lock);
+}
+
+/**
+ * write out (and sync if needed) everything appended so far. The journal
+ * lock is dropped around the I/O, the other committers wait for @writing
+ * to be cleared.
+ */
+static void
+__changelog_journal_write(xlator_t *this, changelog_priv_t *priv)
+{
+    int fd = -1;
+    int ret = 0;
+    char *buf = NULL;
+    size_t len = 0;
+    size_t size = 0;
+    uint64_t first = 0;
+    uint64_t last = 0;
+    gf_boolean_t sync = _gf_false;
+    changelog_journal_t *jnl = &priv->jnl;
+    changelog_journal_waiter_t *waiter = NULL;
+
+    buf = jnl->buf;
+    len = jnl->len;
+    size = jnl->size;
+    first = jnl->committed + 1;
+    last = jnl->appended;
+
+    jnl->buf = jnl->spare;
+    jnl->size = jnl->spare_size;
+    jnl->len = 0;
+    jnl->spare = NULL;
+    jnl->spare_size = 0;
+
+    jnl->writing = _gf_true;
+    fd = priv->changelog_fd;
+    sync = (priv->fsync_interval == 0);
+
+    pthread_mutex_unlock(&jnl->lock);
+    {
+        ret = changelog_write(fd, buf, len);
+        if (ret) {
+            gf_smsg(this->name, GF_LOG_ERROR, errno,
+                    CHANGELOG_MSG_WRITE_FAILED, "changelog", NULL);
+        } else if (sync) {
+            ret = sys_fdatasync(fd);
+            if (ret)
+                gf_smsg(this->name, GF_LOG_ERROR, errno,
+                        CHANGELOG_MSG_FSYNC_OP_FAILED, NULL);
+        }
+    }
+    pthread_mutex_lock(&jnl->lock);
+
+    if (ret) {
+        list_for_each_entry(waiter, &jnl->waiters, list)
+        {
+            if ((waiter->from <= last) && (waiter->to >= first))
+                waiter->failed = _gf_true;
+        }
+    }
+
+    jnl->committed = last;
+    jnl->writing = _gf_false;
+
+    /* keep one buffer around, the other is being filled */
+    if (jnl->buf) {
+        jnl->spare = buf;
+        jnl->spare_size = size;
+    } else {
+        jnl->buf = buf;
+        jnl->size = size;
+    }
+
+    pthread_cond_broadcast(&jnl->cond);
+}
+
+/**
+ * wait until the records of @waiter are written to the journal, writing
+ * them along with every other pending record if no one else is doing so.
+ * Returns -1 if any of them could not be written.
+ */
+int
+changelog_journal_commit(xlator_t *this, changelog_priv_t *priv,
+                         changelog_journal_waiter_t *waiter)
+{
+    int ret = 0;
+    changelog_journal_t *jnl = &priv->jnl;
+
+    pthread_mutex_lock(&jnl->lock);
+    {
+        while (jnl->committed < waiter->to) {
+            if (jnl->writing)
+                pthread_cond_wait(&jnl->cond, &jnl->lock);
+            else
+                __changelog_journal_write(this, priv);
+        }
+
+        list_del_init(&waiter->list);
+        if (waiter->failed)
+            ret = -1;
+    }
+    pthread_mutex_unlock(&jnl->lock);
+
+    return ret;
+}
+
+/**
+ * write out every pending record. Called with the dispatcher lock held
+ * before the journal is synced or closed.
+ */
+int
+changelog_journal_drain(xlator_t *this, changelog_priv_t *priv)
+{
+    changelog_journal_waiter_t waiter = {
+        {0},
+    };
+    changelog_journal_t *jnl = &priv->jnl;
+
+    pthread_mutex_lock(&jnl->lock);
+    {
+        waiter.from = jnl->committed + 1;
+        waiter.to = jnl->appended;
+        list_add_tail(&waiter.list, &jnl->waiters);
+    }
+    pthread_mutex_unlock(&jnl->lock);
+
+    return changelog_journal_commit(this, priv, &waiter);
 }
 
 /*
@@ -1077,6 +1308,7 @@ changelog_handle_change(xlator_t *this, changelog_priv_t *priv,
         return 0;
 
     if (CHANGELOG_TYPE_IS_FSYNC(cld->cld_type)) {
+        (void)changelog_journal_drain(this, priv);
         ret = sys_fsync(priv->changelog_fd);
         if (ret < 0) {
             gf_smsg(this->name, GF_LOG_ERROR, errno,
@@ -182,6 +182,45 @@ typedef struct changelog_ev_selector {
     unsigned int ref[CHANGELOG_EV_SELECTION_RANGE];
 } changelog_ev_selector_t;
 
+/**
+ * Group commit of the journal: encoded records are appended to @buf under
+ * the dispatcher lock. The first thread that has to wait for its records
+ * to reach the journal writes everything appended so far in one go (and
+ * syncs it when fsync-interval is 0), the others wait for it and end up
+ * committed by the same batch or by the next one.
+ */
+typedef struct changelog_journal {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    /* records appended and not yet written */
+    char *buf;
+    size_t len;
+    size_t size;
+
+    /* buffer of the last batch, reused by the next one */
+    char *spare;
+    size_t spare_size;
+
+    /* sequence number of the last appended and last written record */
+    uint64_t appended;
+    uint64_t committed;
+
+    /* a batch is being written */
+    gf_boolean_t writing;
+
+    /* committers whose records are not written yet */
+    struct list_head waiters;
+} changelog_journal_t;
+
+/* a committer and the records it appended, told if they failed */
+typedef struct changelog_journal_waiter {
+    struct list_head list;
+    uint64_t from;
+    uint64_t to; /* UINT64_MAX until the committer is done appending */
+    gf_boolean_t failed;
+} changelog_journal_waiter_t;
+
 /* changelog's private structure */
 struct changelog_priv {
     /* changelog journalling */
@@ -202,6 +241,9 @@ struct changelog_priv {
     /* one file for all changelog types */
     int changelog_fd;
 
+    /* records on their way to changelog_fd */
+    changelog_journal_t jnl;
+
     /* htime fd for current changelog session */
     int htime_fd;
 
@@ -375,7 +417,8 @@ typedef struct {
      * it's persisted to the CHANGELOG. If this is NULL, then the record
      * is persisted as per it's in memory format.
      */
-    size_t (*co_convert)(void *data, char *buffer, gf_boolean_t encode);
+    size_t (*co_convert)(void *data, char *buffer,
+                         changelog_encoder_t encoder);
 
     /* release routines */
     void (*co_free)(void *data);
@@ -433,6 +476,21 @@ changelog_write(int fd, char *buffer, size_t len);
 int
 changelog_write_change(changelog_priv_t *priv, char *buffer, size_t len);
 int
+changelog_journal_init(xlator_t *this, changelog_journal_t *jnl);
+void
+changelog_journal_fini(changelog_journal_t *jnl);
+void
+changelog_journal_enlist(changelog_priv_t *priv,
+                         changelog_journal_waiter_t *waiter);
+void
+changelog_journal_appended(changelog_priv_t *priv,
+                           changelog_journal_waiter_t *waiter);
+int
+changelog_journal_commit(xlator_t *this, changelog_priv_t *priv,
+                         changelog_journal_waiter_t *waiter);
+int
+changelog_journal_drain(xlator_t *this, changelog_priv_t *priv);
+int
 changelog_handle_change(xlator_t *this, changelog_priv_t *priv,
                         changelog_log_data_t *cld);
 void
@@ -118,12 +118,52 @@ typedef enum {
     CHANGELOG_ENCODE_MIN = 0,
     CHANGELOG_ENCODE_BINARY,
     CHANGELOG_ENCODE_ASCII,
+    CHANGELOG_ENCODE_COMPACT,
     CHANGELOG_ENCODE_MAX,
 } changelog_encoder_t;
 
 #define CHANGELOG_VALID_ENCODING(enc)                                          \
     (enc > CHANGELOG_ENCODE_MIN && enc < CHANGELOG_ENCODE_MAX)
 
+/**
+ * compact encoding stores numbers and string lengths as unsigned LEB128
+ * varints: seven bits per byte, least significant group first, with the
+ * high bit set on every byte but the last.
+ */
+#define CHANGELOG_VARINT_MAX 5
+
+static inline size_t
+changelog_put_varint(char *buffer, uint32_t value)
+{
+    size_t len = 0;
+
+    while (value >= 0x80) {
+        buffer[len++] = (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer[len++] = (char)value;
+
+    return len;
+}
+
+/* returns the number of bytes consumed, 0 if @buffer is truncated */
+static inline size_t
+changelog_get_varint(const char *buffer, size_t len, uint32_t *value)
+{
+    size_t i = 0;
+    uint32_t byte = 0;
+
+    *value = 0;
+    for (i = 0; (i < len) && (i < CHANGELOG_VARINT_MAX); i++) {
+        byte = (unsigned char)buffer[i];
+        *value |= (byte & 0x7f) << (7 * i);
+        if (!(byte & 0x80))
+            return i + 1;
+    }
+
+    return 0;
+}
+
 #define CHANGELOG_TYPE_IS_ENTRY(type) (type == CHANGELOG_TYPE_ENTRY)
 #define CHANGELOG_TYPE_IS_ROLLOVER(type) (type == CHANGELOG_TYPE_ROLLOVER)
 #define CHANGELOG_TYPE_IS_FSYNC(type) (type == CHANGELOG_TYPE_FSYNC)
@@ -50,17 +50,32 @@ changelog_rt_enqueue(xlator_t *this, changelog_priv_t *priv, void *cbatch,
                      changelog_log_data_t *cld_0, changelog_log_data_t *cld_1)
 {
     int ret = 0;
+    int cret = 0;
+    changelog_journal_waiter_t waiter = {
+        {0},
+    };
     changelog_rt_t *crt = NULL;
 
     crt = (changelog_rt_t *)cbatch;
 
     LOCK(&crt->lock);
     {
+        changelog_journal_enlist(priv, &waiter);
         ret = changelog_handle_change(this, priv, cld_0);
         if (!ret && cld_1)
             ret = changelog_handle_change(this, priv, cld_1);
+        changelog_journal_appended(priv, &waiter);
     }
     UNLOCK(&crt->lock);
 
+    /**
+     * records are only appended under the lock, the journal is written
+     * outside of it so that the records of concurrent fops share a write
+     * (and a sync).
+     */
+    cret = changelog_journal_commit(this, priv, &waiter);
+    if (!ret)
+        ret = cret;
+
     return ret;
 }
@@ -1920,6 +1920,8 @@ changelog_assign_encoding(changelog_priv_t *priv, char *enc)
         priv->encode_mode = CHANGELOG_ENCODE_BINARY;
     } else if (strncmp(enc, "ascii", 5) == 0) {
         priv->encode_mode = CHANGELOG_ENCODE_ASCII;
+    } else if (strncmp(enc, "compact", 7) == 0) {
+        priv->encode_mode = CHANGELOG_ENCODE_COMPACT;
     }
 }
 
@@ -2752,10 +2754,14 @@ init(xlator_t *this)
     INIT_LIST_HEAD(&priv->xprt_list);
     priv->htime_fd = -1;
 
-    ret = changelog_init_options(this, priv);
+    ret = changelog_journal_init(this, &priv->jnl);
     if (ret)
         goto cleanup_mempool;
 
+    ret = changelog_init_options(this, priv);
+    if (ret)
+        goto cleanup_journal;
+
     /* snap dependency changes */
     priv->dm.black_fop_cnt = 0;
     priv->dm.white_fop_cnt = 0;
@@ -2803,6 +2809,8 @@ cleanup_barrier:
     changelog_barrier_pthread_destroy(priv);
 cleanup_options:
     changelog_freeup_options(this, priv);
+cleanup_journal:
+    changelog_journal_fini(&priv->jnl);
 cleanup_mempool:
     mem_pool_destroy(this->local_pool);
     this->local_pool = NULL;
@@ -2842,6 +2850,8 @@ fini(xlator_t *this)
         /* cleanup allocated options */
         changelog_freeup_options(this, priv);
 
+        changelog_journal_fini(&priv->jnl);
+
         /* deallocate mempool */
         mem_pool_destroy(this->local_pool);
 
@@ -2929,8 +2939,9 @@ struct volume_options options[] = {
     {.key = {"encoding"},
      .type = GF_OPTION_TYPE_STR,
      .default_value = "ascii",
-     .value = {"binary", "ascii"},
-     .description = "encoding type for changelogs",
+     .value = {"binary", "ascii", "compact"},
+     .description = "encoding type for changelogs. compact is a binary "
+                    "encoding with variable length numbers and lengths",
      .op_version = {3},
      .flags = OPT_FLAG_SETTABLE,
      .level = OPT_STATUS_ADVANCED,
@@ -2946,8 +2957,9 @@ struct volume_options options[] = {
     {.key = {"fsync-interval"},
      .type = GF_OPTION_TYPE_TIME,
      .default_value = "5",
-     .description = "do not open CHANGELOG file with O_SYNC mode."
-                    " instead perform fsync() at specified intervals",
+     .description = "perform fsync() at specified intervals. when 0, "
+                    "every batch of changes is synced before the fops "
+                    "recording them complete",
      .op_version = {3},
      .flags = OPT_FLAG_SETTABLE,
      .level = OPT_STATUS_ADVANCED,
@@ -177,7 +177,7 @@ clrlk_clear_posixlk(xlator_t *this, pl_inode_t *pl_inode, clrlk_args *args,
                               plock->user_flock.l_len != ulock.l_len))
                 continue;
 
-            list_del_init(&plock->list);
+            __delete_lock(plock);
             if (plock->blocked) {
                 bcount++;
                 pl_trace_out(this, plock->frame, NULL, NULL, F_SETLKW,
@@ -255,6 +255,7 @@ blkd:
             bcount++;
             list_del_init(&ilock->client_list);
             list_del_init(&ilock->blocked_locks);
+            pl_itree_remove(&ilock->range);
             list_add(&ilock->blocked_locks, &released);
         }
     }
@@ -289,7 +290,7 @@ granted:
 
             gcount++;
             list_del_init(&ilock->client_list);
-            list_del_init(&ilock->list);
+            __delete_inode_lock(ilock);
             list_add(&ilock->list, &released);
         }
     }
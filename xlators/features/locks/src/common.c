@@ -49,6 +49,8 @@ __allocate_domain(const char *volume)
     INIT_LIST_HEAD(&dom->blocked_entrylks);
     INIT_LIST_HEAD(&dom->inodelk_list);
     INIT_LIST_HEAD(&dom->blocked_inodelks);
+    pl_itree_init(&dom->inodelk_ranges);
+    pl_itree_init(&dom->blocked_inodelk_ranges);
 
 out:
     if (dom && (NULL == dom->domain)) {
@@ -454,6 +456,8 @@ pl_inode_get(xlator_t *this, inode_t *inode, pl_local_t *local)
 
         INIT_LIST_HEAD(&pl_inode->dom_list);
         INIT_LIST_HEAD(&pl_inode->ext_list);
+        pl_itree_init(&pl_inode->ext_ranges);
+        pl_itree_init(&pl_inode->blocked_ext_ranges);
         INIT_LIST_HEAD(&pl_inode->rw_list);
         INIT_LIST_HEAD(&pl_inode->reservelk_list);
         INIT_LIST_HEAD(&pl_inode->blocked_reservelks);
@@ -554,6 +558,7 @@ void
 __delete_lock(posix_lock_t *lock)
 {
     list_del_init(&lock->list);
+    pl_itree_remove(&lock->range);
 }
 
 /* Destroy a posix_lock */
@@ -578,8 +583,10 @@ __copy_lock(posix_lock_t *src)
             dst = NULL;
         }
 
-        if (dst != NULL)
+        if (dst != NULL) {
             INIT_LIST_HEAD(&dst->list);
+            pl_itree_node_init(&dst->range);
+        }
     }
 
     return dst;
@@ -600,16 +607,23 @@ posix_lock_to_flock(posix_lock_t *lock, struct gf_flock *flock)
         flock->l_len = lock->fl_end - lock->fl_start + 1;
 }
 
-/* Insert the lock into the inode's lock list */
+/* Insert the lock into the inode's lock list, and index its range. Only
+ * the granted locks are checked for conflicts. */
 static void
 __insert_lock(pl_inode_t *pl_inode, posix_lock_t *lock)
 {
-    if (lock->blocked)
+    pl_itree_t *ranges = NULL;
+
+    if (lock->blocked) {
         lock->blkd_time = gf_time();
-    else
+        ranges = &pl_inode->blocked_ext_ranges;
+    } else {
         lock->granted_time = gf_time();
+        ranges = &pl_inode->ext_ranges;
+    }
 
     list_add_tail(&lock->list, &pl_inode->ext_list);
+    pl_itree_insert(ranges, &lock->range, lock->fl_start, lock->fl_end);
 }
 
 /* Return true if the locks overlap, false otherwise */
@@ -633,19 +647,25 @@ same_owner(posix_lock_t *l1, posix_lock_t *l2)
             (l1->client == l2->client));
 }
 
-/* Delete all F_UNLCK locks */
-void
-__delete_unlck_locks(pl_inode_t *pl_inode)
+/* Delete all F_UNLCK locks in [start, end] */
+static void
+__delete_unlck_locks(pl_inode_t *pl_inode, off_t start, off_t end)
 {
+    pl_itree_node_t *node = NULL;
+    pl_itree_node_t *next = NULL;
     posix_lock_t *l = NULL;
-    posix_lock_t *tmp = NULL;
 
-    list_for_each_entry_safe(l, tmp, &pl_inode->ext_list, list)
-    {
+    node = pl_itree_first(&pl_inode->ext_ranges, start, end);
+    while (node != NULL) {
+        next = pl_itree_next(node, start, end);
+
+        l = pl_itree_entry(node, posix_lock_t, range);
         if (l->fl_type == F_UNLCK) {
             __delete_lock(l);
             __destroy_lock(l);
         }
+
+        node = next;
     }
 }
 
@@ -756,93 +776,88 @@ done:
 static posix_lock_t *
 first_conflicting_overlap(pl_inode_t *pl_inode, posix_lock_t *lock)
 {
+    pl_itree_node_t *node = NULL;
     posix_lock_t *l = NULL;
     posix_lock_t *conf = NULL;
 
     pthread_mutex_lock(&pl_inode->mutex);
     {
-        list_for_each_entry(l, &pl_inode->ext_list, list)
+        pl_itree_for_each(node, &pl_inode->ext_ranges, lock->fl_start,
+                          lock->fl_end)
         {
-            if (l->blocked)
-                continue;
+            l = pl_itree_entry(node, posix_lock_t, range);
 
-            if (locks_overlap(l, lock)) {
-                if (same_owner(l, lock))
-                    continue;
+            if (same_owner(l, lock))
+                continue;
 
-                if ((l->fl_type == F_WRLCK) || (lock->fl_type == F_WRLCK)) {
-                    conf = l;
-                    goto unlock;
-                }
+            if ((l->fl_type == F_WRLCK) || (lock->fl_type == F_WRLCK)) {
+                conf = l;
+                break;
             }
         }
     }
-unlock:
     pthread_mutex_unlock(&pl_inode->mutex);
 
     return conf;
 }
 
-/*
-  Start searching from {begin}, and return the first lock that
-  conflicts, NULL if no conflict
-  If {begin} is NULL, then start from the beginning of the list
-*/
+/* Return the first granted lock overlapping {lock}, NULL if none */
 static posix_lock_t *
 first_overlap(pl_inode_t *pl_inode, posix_lock_t *lock)
 {
-    posix_lock_t *l = NULL;
+    pl_itree_node_t *node = NULL;
 
-    list_for_each_entry(l, &pl_inode->ext_list, list)
-    {
-        if (l->blocked)
-            continue;
-
-        if (locks_overlap(l, lock))
-            return l;
-    }
+    node = pl_itree_first(&pl_inode->ext_ranges, lock->fl_start,
+                          lock->fl_end);
+    if (node == NULL)
+        return NULL;
 
-    return NULL;
+    return pl_itree_entry(node, posix_lock_t, range);
 }
 
 /* Return true if lock is grantable */
 static int
 __is_lock_grantable(pl_inode_t *pl_inode, posix_lock_t *lock)
 {
+    pl_itree_node_t *node = NULL;
     posix_lock_t *l = NULL;
-    int ret = 1;
 
-    list_for_each_entry(l, &pl_inode->ext_list, list)
+    if (lock->fl_type == F_UNLCK)
+        return 1;
+
+    pl_itree_for_each(node, &pl_inode->ext_ranges, lock->fl_start,
+                      lock->fl_end)
     {
-        if (!l->blocked && locks_overlap(lock, l)) {
-            if (((l->fl_type == F_WRLCK) || (lock->fl_type == F_WRLCK)) &&
-                (lock->fl_type != F_UNLCK) && !same_owner(l, lock)) {
-                ret = 0;
-                break;
-            }
-        }
+        l = pl_itree_entry(node, posix_lock_t, range);
+
+        if (((l->fl_type == F_WRLCK) || (lock->fl_type == F_WRLCK)) &&
+            !same_owner(l, lock))
+            return 0;
     }
-    return ret;
+
+    return 1;
 }
 
 extern void
 do_blocked_rw(pl_inode_t *);
 
+/* Only an overlapping lock of the same owner needs to be merged with or
+ * split by {lock}, any other overlapping lock is left alone. */
 static void
 __insert_and_merge(pl_inode_t *pl_inode, posix_lock_t *lock)
 {
+    pl_itree_node_t *node = NULL;
     posix_lock_t *conf = NULL;
-    posix_lock_t *t = NULL;
     posix_lock_t *sum = NULL;
+    off_t start = 0;
+    off_t end = 0;
     int i = 0;
     struct _values v = {.locks = {0, 0, 0}};
 
-    list_for_each_entry_safe(conf, t, &pl_inode->ext_list, list)
+    pl_itree_for_each(node, &pl_inode->ext_ranges, lock->fl_start,
+                      lock->fl_end)
     {
-        if (conf->blocked)
-            continue;
-        if (!locks_overlap(conf, lock))
-            continue;
+        conf = pl_itree_entry(node, posix_lock_t, range);
 
         if (same_owner(conf, lock)) {
             if (conf->fl_type == lock->fl_type &&
@@ -860,6 +875,8 @@ __insert_and_merge(pl_inode_t *pl_inode, posix_lock_t *lock)
                 return;
             } else {
                 sum = add_locks(lock, conf, conf);
+                start = sum->fl_start;
+                end = sum->fl_end;
 
                 v = subtract_locks(sum, lock);
 
@@ -878,19 +895,10 @@ __insert_and_merge(pl_inode_t *pl_inode, posix_lock_t *lock)
                     __insert_and_merge(pl_inode, v.locks[i]);
                 }
 
-                __delete_unlck_locks(pl_inode);
+                __delete_unlck_locks(pl_inode, start, end);
                 return;
             }
         }
-
-        if (lock->fl_type == F_UNLCK) {
-            continue;
-        }
-
-        if ((conf->fl_type == F_RDLCK) && (lock->fl_type == F_RDLCK)) {
-            __insert_lock(pl_inode, lock);
-            return;
-        }
     }
 
     /* no conflicts, so just insert */
@@ -912,6 +920,9 @@ __grant_blocked_locks(xlator_t *this, pl_inode_t *pl_inode,
 
     INIT_LIST_HEAD(&tmp_list);
 
+    if (pl_inode->blocked_ext_ranges.count == 0)
+        return;
+
     list_for_each_entry_safe(l, tmp, &pl_inode->ext_list, list)
     {
         if (l->blocked) {
@@ -920,7 +931,8 @@ __grant_blocked_locks(xlator_t *this, pl_inode_t *pl_inode,
                 continue;
 
             l->blocked = 0;
-            list_move_tail(&l->list, &tmp_list);
+            __delete_lock(l);
+            list_add_tail(&l->list, &tmp_list);
         }
     }
 
@@ -1174,7 +1186,7 @@ pl_lock_preempt(pl_inode_t *pl_inode, posix_lock_t *reqlock)
         list_for_each_entry_safe(lock, i, &pl_inode->ext_list, list)
         {
             if (lock->blocked) {
-                list_del_init(&lock->list);
+                __delete_lock(lock);
                 list_add(&lock->list, &unwind_blist);
                 continue;
             }
@@ -1184,7 +1196,6 @@ pl_lock_preempt(pl_inode_t *pl_inode, posix_lock_t *reqlock)
                     continue;
 
                 /* remove conflicting locks */
-                list_del_init(&lock->list);
                 __delete_lock(lock);
                 __destroy_lock(lock);
             }
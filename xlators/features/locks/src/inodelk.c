@@ -22,6 +22,7 @@ void
 __delete_inode_lock(pl_inode_lock_t *lock)
 {
     list_del_init(&lock->list);
+    pl_itree_remove(&lock->range);
 }
 
 static void
@@ -166,6 +167,7 @@ __inodelk_prune_stale(xlator_t *this, pl_inode_t *pinode, pl_dom_list_t *dom,
                       pl_inode_lock_t *lock)
 {
     posix_locks_private_t *priv = NULL;
+    pl_itree_node_t *node = NULL;
     pl_inode_lock_t *tmp = NULL;
     pl_inode_lock_t *lk = NULL;
     gf_boolean_t revoke_lock = _gf_false;
@@ -190,8 +192,10 @@ __inodelk_prune_stale(xlator_t *this, pl_inode_t *pinode, pl_dom_list_t *dom,
         goto out;
 
     pthread_mutex_lock(&pinode->mutex);
-    list_for_each_entry_safe(lk, tmp, &dom->inodelk_list, list)
+    /* only the locks overlapping the request can conflict with it */
+    pl_itree_for_each(node, &dom->inodelk_ranges, lock->fl_start, lock->fl_end)
     {
+        lk = pl_itree_entry(node, pl_inode_lock_t, range);
         if (__stale_inodelk(this, lk, lock, &lk_age_sec) == _gf_true) {
             revoke_lock = _gf_true;
             reason_str = "age";
@@ -337,12 +341,14 @@ static pl_inode_lock_t *
 __inodelk_grantable(xlator_t *this, pl_dom_list_t *dom, pl_inode_lock_t *lock,
                     struct timespec *now, struct list_head *contend)
 {
+    pl_itree_node_t *node = NULL;
     pl_inode_lock_t *l = NULL;
     pl_inode_lock_t *ret = NULL;
 
-    list_for_each_entry(l, &dom->inodelk_list, list)
+    pl_itree_for_each(node, &dom->inodelk_ranges, lock->fl_start, lock->fl_end)
     {
-        if (inodelk_conflict(lock, l) && !same_inodelk_owner(lock, l)) {
+        l = pl_itree_entry(node, pl_inode_lock_t, range);
+        if (inodelk_type_conflict(lock, l) && !same_inodelk_owner(lock, l)) {
             if (ret == NULL) {
                 ret = l;
                 if (contend == NULL) {
@@ -359,11 +365,14 @@ __inodelk_grantable(xlator_t *this, pl_dom_list_t *dom, pl_inode_lock_t *lock,
 static pl_inode_lock_t *
 __blocked_lock_conflict(pl_dom_list_t *dom, pl_inode_lock_t *lock)
 {
+    pl_itree_node_t *node = NULL;
     pl_inode_lock_t *l = NULL;
 
-    list_for_each_entry(l, &dom->blocked_inodelks, blocked_locks)
+    pl_itree_for_each(node, &dom->blocked_inodelk_ranges, lock->fl_start,
+                      lock->fl_end)
     {
-        if (inodelk_conflict(lock, l)) {
+        l = pl_itree_entry(node, pl_inode_lock_t, range);
+        if (inodelk_type_conflict(lock, l)) {
             return l;
         }
     }
@@ -401,6 +410,8 @@ __lock_blocked_add(xlator_t *this, pl_dom_list_t *dom, pl_inode_lock_t *lock,
 
     lock->blkd_time = gf_time();
     list_add_tail(&lock->blocked_locks, &dom->blocked_inodelks);
+    pl_itree_insert(&dom->blocked_inodelk_ranges, &lock->range,
+                    lock->fl_start, lock->fl_end);
 
     gf_msg_trace(this->name, 0,
                  "%s (pid=%d) (lk-owner=%s) %" PRId64
@@ -462,6 +473,8 @@ __lock_inodelk(xlator_t *this, pl_inode_t *pl_inode, pl_inode_lock_t *lock,
     __pl_inodelk_ref(lock);
     lock->granted_time = gf_time();
     list_add(&lock->list, &dom->inodelk_list);
+    pl_itree_insert(&dom->inodelk_ranges, &lock->range, lock->fl_start,
+                    lock->fl_end);
 
     return 0;
 }
@@ -476,16 +489,24 @@ inodelks_equal(pl_inode_lock_t *l1, pl_inode_lock_t *l2)
     return 0;
 }
 
+/* Among identical locks, the most recently granted one is released, as
+ * granted locks are added at the head of the list. */
 static pl_inode_lock_t *
 find_matching_inodelk(pl_inode_lock_t *lock, pl_dom_list_t *dom)
 {
+    pl_itree_node_t *node = NULL;
     pl_inode_lock_t *l = NULL;
-    list_for_each_entry(l, &dom->inodelk_list, list)
+    pl_inode_lock_t *match = NULL;
+
+    pl_itree_for_each(node, &dom->inodelk_ranges, lock->fl_start, lock->fl_end)
     {
+        l = pl_itree_entry(node, pl_inode_lock_t, range);
+        if (l->fl_start > lock->fl_start)
+            break;
         if (inodelks_equal(l, lock) && same_inodelk_owner(l, lock))
-            return l;
+            match = l;
     }
-    return NULL;
+    return match;
 }
 
 /* Set F_UNLCK removes a lock which has the exact same lock boundaries
@@ -532,10 +553,15 @@ __grant_blocked_inode_locks(xlator_t *this, pl_inode_t *pl_inode,
 
     INIT_LIST_HEAD(&blocked_list);
     list_splice_init(&dom->blocked_inodelks, &blocked_list);
+    /* The blocked locks are checked again in the order they were blocked,
+     * each one only conflicting with the ones which are still blocked before
+     * it, so the index is rebuilt as the list is. */
+    pl_itree_init(&dom->blocked_inodelk_ranges);
 
     list_for_each_entry_safe(bl, tmp, &blocked_list, blocked_locks)
     {
         list_del_init(&bl->blocked_locks);
+        pl_itree_node_init(&bl->range);
 
         bl->status = __lock_inodelk(this, pl_inode, bl, 1, dom, now, contend);
 
@@ -695,6 +721,7 @@ pl_inodelk_client_cleanup(xlator_t *this, pl_ctx_t *ctx)
                     list_add_tail(&l->client_list, &released);
                 } else {
                     list_del_init(&l->blocked_locks);
+                    pl_itree_remove(&l->range);
                     list_add_tail(&l->client_list, &unwind);
                 }
             }
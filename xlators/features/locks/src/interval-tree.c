@@ -0,0 +1,360 @@
+/*
+   Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+   This file is part of GlusterFS.
+
+   This file is licensed to you under your choice of the GNU Lesser
+   General Public License, version 3 or any later version (LGPLv3 or
+   later), or the GNU General Public License, version 2 (GPLv2), in all
+   cases as published by the Free Software Foundation.
+*/
+#include "interval-tree.h"
+
+void
+pl_itree_init(pl_itree_t *tree)
+{
+    tree->root = NULL;
+    tree->count = 0;
+}
+
+void
+pl_itree_node_init(pl_itree_node_t *node)
+{
+    node->parent = NULL;
+    node->left = NULL;
+    node->right = NULL;
+    node->tree = NULL;
+}
+
+static void
+pl_itree_update(pl_itree_node_t *node)
+{
+    off_t max = node->end;
+
+    if ((node->left != NULL) && (node->left->max > max))
+        max = node->left->max;
+    if ((node->right != NULL) && (node->right->max > max))
+        max = node->right->max;
+
+    node->max = max;
+}
+
+static void
+pl_itree_propagate(pl_itree_node_t *node)
+{
+    while (node != NULL) {
+        pl_itree_update(node);
+        node = node->parent;
+    }
+}
+
+static void
+pl_itree_replace_child(pl_itree_t *tree, pl_itree_node_t *parent,
+                       pl_itree_node_t *old, pl_itree_node_t *new)
+{
+    if (parent == NULL)
+        tree->root = new;
+    else if (parent->left == old)
+        parent->left = new;
+    else
+        parent->right = new;
+}
+
+/* The rotated subtree keeps the same nodes, so its new root inherits the max
+ * of the old one, and only the node moving down needs to be recomputed. */
+static void
+pl_itree_rotate_left(pl_itree_t *tree, pl_itree_node_t *node)
+{
+    pl_itree_node_t *right = node->right;
+
+    node->right = right->left;
+    if (right->left != NULL)
+        right->left->parent = node;
+
+    right->parent = node->parent;
+    pl_itree_replace_child(tree, node->parent, node, right);
+
+    right->left = node;
+    node->parent = right;
+
+    right->max = node->max;
+    pl_itree_update(node);
+}
+
+static void
+pl_itree_rotate_right(pl_itree_t *tree, pl_itree_node_t *node)
+{
+    pl_itree_node_t *left = node->left;
+
+    node->left = left->right;
+    if (left->right != NULL)
+        left->right->parent = node;
+
+    left->parent = node->parent;
+    pl_itree_replace_child(tree, node->parent, node, left);
+
+    left->right = node;
+    node->parent = left;
+
+    left->max = node->max;
+    pl_itree_update(node);
+}
+
+static int
+pl_itree_is_red(pl_itree_node_t *node)
+{
+    return (node != NULL) && node->red;
+}
+
+void
+pl_itree_insert(pl_itree_t *tree, pl_itree_node_t *node, off_t start,
+                off_t end)
+{
+    pl_itree_node_t **link = &tree->root;
+    pl_itree_node_t *parent = NULL;
+    pl_itree_node_t *grand = NULL;
+    pl_itree_node_t *uncle = NULL;
+
+    node->start = start;
+    node->end = end;
+    node->max = end;
+    node->left = NULL;
+    node->right = NULL;
+    node->red = 1;
+    node->tree = tree;
+
+    while (*link != NULL) {
+        parent = *link;
+        if (parent->max < end)
+            parent->max = end;
+        /* equal starts go right to keep the insertion order */
+        if (start < parent->start)
+            link = &parent->left;
+        else
+            link = &parent->right;
+    }
+
+    node->parent = parent;
+    *link = node;
+    tree->count++;
+
+    while (pl_itree_is_red(parent = node->parent)) {
+        grand = parent->parent;
+        if (parent == grand->left) {
+            uncle = grand->right;
+            if (pl_itree_is_red(uncle)) {
+                parent->red = 0;
+                uncle->red = 0;
+                grand->red = 1;
+                node = grand;
+                continue;
+            }
+            if (node == parent->right) {
+                pl_itree_rotate_left(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->red = 0;
+            grand->red = 1;
+            pl_itree_rotate_right(tree, grand);
+        } else {
+            uncle = grand->left;
+            if (pl_itree_is_red(uncle)) {
+                parent->red = 0;
+                uncle->red = 0;
+                grand->red = 1;
+                node = grand;
+                continue;
+            }
+            if (node == parent->left) {
+                pl_itree_rotate_right(tree, parent);
+                node = parent;
+                parent = node->parent;
+            }
+            parent->red = 0;
+            grand->red = 1;
+            pl_itree_rotate_left(tree, grand);
+        }
+    }
+
+    tree->root->red = 0;
+}
+
+static void
+pl_itree_remove_fixup(pl_itree_t *tree, pl_itree_node_t *node,
+                      pl_itree_node_t *parent)
+{
+    pl_itree_node_t *sibling = NULL;
+
+    while ((node != tree->root) && !pl_itree_is_red(node)) {
+        if (node == parent->left) {
+            sibling = parent->right;
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                pl_itree_rotate_left(tree, parent);
+                sibling = parent->right;
+            }
+            if (!pl_itree_is_red(sibling->left) &&
+                !pl_itree_is_red(sibling->right)) {
+                sibling->red = 1;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (!pl_itree_is_red(sibling->right)) {
+                sibling->left->red = 0;
+                sibling->red = 1;
+                pl_itree_rotate_right(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->right->red = 0;
+            pl_itree_rotate_left(tree, parent);
+        } else {
+            sibling = parent->left;
+            if (sibling->red) {
+                sibling->red = 0;
+                parent->red = 1;
+                pl_itree_rotate_right(tree, parent);
+                sibling = parent->left;
+            }
+            if (!pl_itree_is_red(sibling->left) &&
+                !pl_itree_is_red(sibling->right)) {
+                sibling->red = 1;
+                node = parent;
+                parent = node->parent;
+                continue;
+            }
+            if (!pl_itree_is_red(sibling->left)) {
+                sibling->right->red = 0;
+                sibling->red = 1;
+                pl_itree_rotate_left(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->red = parent->red;
+            parent->red = 0;
+            sibling->left->red = 0;
+            pl_itree_rotate_right(tree, parent);
+        }
+        node = tree->root;
+        break;
+    }
+
+    if (node != NULL)
+        node->red = 0;
+}
+
+void
+pl_itree_remove(pl_itree_node_t *node)
+{
+    pl_itree_t *tree = node->tree;
+    pl_itree_node_t *next = NULL;
+    pl_itree_node_t *child = NULL;
+    pl_itree_node_t *parent = NULL;
+    int red = 0;
+
+    if (tree == NULL)
+        return;
+
+    if ((node->left == NULL) || (node->right == NULL)) {
+        child = (node->left != NULL) ? node->left : node->right;
+        parent = node->parent;
+        red = node->red;
+
+        if (child != NULL)
+            child->parent = parent;
+        pl_itree_replace_child(tree, parent, node, child);
+    } else {
+        /* a node with two children is replaced by its successor, which is
+         * unlinked from its own position instead */
+        next = node->right;
+        while (next->left != NULL)
+            next = next->left;
+
+        child = next->right;
+        red = next->red;
+
+        if (next->parent == node) {
+            parent = next;
+        } else {
+            parent = next->parent;
+            parent->left = child;
+            if (child != NULL)
+                child->parent = parent;
+
+            next->right = node->right;
+            next->right->parent = next;
+        }
+
+        next->left = node->left;
+        next->left->parent = next;
+        next->parent = node->parent;
+        next->red = node->red;
+        pl_itree_replace_child(tree, node->parent, node, next);
+    }
+
+    pl_itree_propagate(parent);
+
+    if (!red)
+        pl_itree_remove_fixup(tree, child, parent);
+
+    tree->count--;
+    pl_itree_node_init(node);
+}
+
+/* Returns the first node of the subtree overlapping [start, end]. The
+ * subtree must contain a range ending at or after start. */
+static pl_itree_node_t *
+pl_itree_subtree_first(pl_itree_node_t *node, off_t start, off_t end)
+{
+    for (;;) {
+        if ((node->left != NULL) && (node->left->max >= start)) {
+            node = node->left;
+            continue;
+        }
+        /* everything from here on starts too late */
+        if (node->start > end)
+            return NULL;
+        if (node->end >= start)
+            return node;
+        if ((node->right != NULL) && (node->right->max >= start)) {
+            node = node->right;
+            continue;
+        }
+        return NULL;
+    }
+}
+
+pl_itree_node_t *
+pl_itree_first(pl_itree_t *tree, off_t start, off_t end)
+{
+    if ((tree->root == NULL) || (tree->root->max < start))
+        return NULL;
+
+    return pl_itree_subtree_first(tree->root, start, end);
+}
+
+pl_itree_node_t *
+pl_itree_next(pl_itree_node_t *node, off_t start, off_t end)
+{
+    pl_itree_node_t *prev = NULL;
+
+    for (;;) {
+        if ((node->right != NULL) && (node->right->max >= start))
+            return pl_itree_subtree_first(node->right, start, end);
+
+        /* go up until coming from a left child */
+        do {
+            prev = node;
+            node = node->parent;
+            if (node == NULL)
+                return NULL;
+        } while (prev == node->right);
+
+        if (node->start > end)
+            return NULL;
+        if (node->end >= start)
+            return node;
+    }
+}
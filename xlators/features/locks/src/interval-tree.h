@@ -0,0 +1,78 @@
+/*
+   Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+   This file is part of GlusterFS.
+
+   This file is licensed to you under your choice of the GNU Lesser
+   General Public License, version 3 or any later version (LGPLv3 or
+   later), or the GNU General Public License, version 2 (GPLv2), in all
+   cases as published by the Free Software Foundation.
+*/
+#ifndef __INTERVAL_TREE_H__
+#define __INTERVAL_TREE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/* An interval tree indexing the byte ranges of locks.
+ *
+ * It is a red-black tree ordered by the start of the ranges, where every
+ * node also records the largest end found in its subtree. This allows to
+ * find all the ranges overlapping a given one in O(log n + k) instead of
+ * walking the whole lock list.
+ *
+ * Nodes are embedded in the locks. A node knows the tree it belongs to, so
+ * that it can be removed without looking up its lock domain, and removing a
+ * node which is not in any tree does nothing. Ranges sharing the same start
+ * are kept in insertion order.
+ *
+ * The tree doesn't do any locking on its own: all the calls must be done
+ * with pl_inode->mutex held. */
+
+struct _pl_itree;
+
+typedef struct _pl_itree_node {
+    struct _pl_itree_node *parent;
+    struct _pl_itree_node *left;
+    struct _pl_itree_node *right;
+    struct _pl_itree *tree; /* NULL when not indexed */
+    off_t start;
+    off_t end; /* inclusive */
+    off_t max; /* largest end in the subtree */
+    int red;
+} pl_itree_node_t;
+
+typedef struct _pl_itree {
+    pl_itree_node_t *root;
+    uint32_t count;
+} pl_itree_t;
+
+#define pl_itree_entry(node, type, member)                                     \
+    ((type *)((char *)(node)-offsetof(type, member)))
+
+/* Walks all the nodes overlapping [start, end], ordered by their start. The
+ * current node must not be removed while iterating. */
+#define pl_itree_for_each(node, tree, start, end)                              \
+    for (node = pl_itree_first(tree, start, end); node != NULL;                \
+         node = pl_itree_next(node, start, end))
+
+void
+pl_itree_init(pl_itree_t *tree);
+
+void
+pl_itree_node_init(pl_itree_node_t *node);
+
+void
+pl_itree_insert(pl_itree_t *tree, pl_itree_node_t *node, off_t start,
+                off_t end);
+
+void
+pl_itree_remove(pl_itree_node_t *node);
+
+pl_itree_node_t *
+pl_itree_first(pl_itree_t *tree, off_t start, off_t end);
+
+pl_itree_node_t *
+pl_itree_next(pl_itree_node_t *node, off_t start, off_t end);
+
+#endif /* __INTERVAL_TREE_H__ */
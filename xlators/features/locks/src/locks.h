@@ -18,6 +18,8 @@
 
 #include <glusterfs/lkowner.h>
 
+#include "interval-tree.h"
+
 typedef enum {
     MLK_NONE,
     MLK_FILE_BASED,
@@ -29,6 +31,7 @@ struct __pl_fd;
 
 struct __posix_lock {
     struct list_head list;
+    pl_itree_node_t range; /* indexed in ext_ranges or blocked_ext_ranges */
 
     off_t fl_start;
     off_t fl_end;
@@ -71,6 +74,7 @@ struct __pl_inode_lock {
     struct list_head list;
     struct list_head blocked_locks; /* list_head pointing to blocked_inodelks */
     struct list_head contend;       /* list of contending locks */
+    pl_itree_node_t range; /* indexed in the granted or blocked ranges */
     int ref;
 
     off_t fl_start;
@@ -121,6 +125,8 @@ struct _pl_dom_list {
     struct list_head blocked_entrylks; /* List of all blocked entrylks */
     struct list_head inodelk_list;     /* List of inode locks */
     struct list_head blocked_inodelks; /* List of all blocked inodelks */
+    pl_itree_t inodelk_ranges;         /* Inode locks by range */
+    pl_itree_t blocked_inodelk_ranges; /* Blocked inodelks by range */
 };
 typedef struct _pl_dom_list pl_dom_list_t;
 
@@ -163,6 +169,8 @@ struct __pl_inode {
 
     struct list_head dom_list;           /* list of domains */
     struct list_head ext_list;           /* list of fcntl locks */
+    pl_itree_t ext_ranges;               /* granted fcntl locks by range */
+    pl_itree_t blocked_ext_ranges;       /* blocked fcntl locks by range */
     struct list_head rw_list;            /* list of waiting r/w requests */
     struct list_head reservelk_list;     /* list of reservelks */
     struct list_head blocked_reservelks; /* list of blocked reservelks */
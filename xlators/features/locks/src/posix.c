@@ -1172,7 +1172,8 @@ delete_locks_of_fd(xlator_t *this, pl_inode_t *pl_inode, fd_t *fd)
         {
             if (l->fd_num == fd_to_fdnum(fd)) {
                 if (l->blocked) {
-                    list_move_tail(&l->list, &blocked_list);
+                    __delete_lock(l);
+                    list_add_tail(&l->list, &blocked_list);
                     continue;
                 }
                 __delete_lock(l);
@@ -2082,6 +2083,7 @@ gf_boolean_t static within_range(posix_lock_t *existing, posix_lock_t *new)
 static int
 __rw_allowable(pl_inode_t *pl_inode, posix_lock_t *region, glusterfs_fop_t op)
 {
+    pl_itree_node_t *node = NULL;
     posix_lock_t *l = NULL;
     posix_locks_private_t *priv = THIS->private;
     int ret = 1;
@@ -2127,9 +2129,11 @@ __rw_allowable(pl_inode_t *pl_inode, posix_lock_t *region, glusterfs_fop_t op)
         return 0;
     }
 
-    list_for_each_entry(l, &pl_inode->ext_list, list)
+    pl_itree_for_each(node, &pl_inode->ext_ranges, region->fl_start,
+                      region->fl_end)
     {
-        if (!l->blocked && locks_overlap(l, region) && !same_owner(l, region)) {
+        l = pl_itree_entry(node, posix_lock_t, range);
+        if (!same_owner(l, region)) {
             if ((op == GF_FOP_READ) && (l->fl_type != F_WRLCK))
                 continue;
             /* Check for mandatory lock under optimal
@@ -3423,7 +3427,7 @@ __unwind_blocked_locks(pl_inode_t *pl_inode, struct list_head *tmp_list)
         if (!lock->blocking)
             continue;
 
-        list_del_init(&lock->list);
+        __delete_lock(lock);
         list_add_tail(&lock->list, tmp_list);
     }
 }
@@ -4349,6 +4353,8 @@ pl_write_active_locks(call_frame_t *frame, pl_inode_t *pl_inode,
                 goto out;
             }
             list_add_tail(&newlock->list, &pl_inode->ext_list);
+            pl_itree_insert(&pl_inode->ext_ranges, &newlock->range,
+                            newlock->fl_start, newlock->fl_end);
         }
     }
     /*TODO: What if few lock add failed with ENOMEM. Should the already
@@ -0,0 +1,280 @@
+/*
+  Copyright (c) 2026 Red Hat, Inc. <http://www.redhat.com>
+  This file is part of GlusterFS.
+
+  This file is licensed to you under your choice of the GNU Lesser
+  General Public License, version 3 or any later version (LGPLv3 or
+  later), or the GNU General Public License, version 2 (GPLv2), in all
+  cases as published by the Free Software Foundation.
+*/
+
+/*
+ * Grant latency benchmark for inodelks and fcntl locks.
+ *
+ * For several numbers of locks already held on a file by different owners,
+ * each on its own range, the benchmark measures:
+ *
+ *   - "grant": acquiring a lock on a free range and releasing it,
+ *   - "conflict": a non-blocking attempt on a range which is already held,
+ *     which fails with EAGAIN.
+ *
+ * Inodelks go through the same functions as an inodelk fop, taken with the
+ * inode mutex held, and fcntl locks through pl_setlk(). Latencies are
+ * reported in ns per operation.
+ *
+ * inodelk.c is included by this file to reach its static functions, so it
+ * must be left out of the sources. Built by "make check" in
+ * xlators/features/locks/src.
+ *
+ * Usage: locks_benchmark [operations per test]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "glusterfs/glusterfs.h"
+#include "glusterfs/globals.h"
+#include "glusterfs/xlator.h"
+
+#include "../inodelk.c"
+
+#define BENCH_RANGE 4096
+
+static int bench_held[] = {0, 100, 1000, 10000};
+
+static xlator_t *bench_xl;
+static call_stack_t bench_stack;
+static call_frame_t bench_frame;
+
+static double
+bench_elapsed(struct timespec *start)
+{
+    struct timespec end;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return (end.tv_sec - start->tv_sec) * 1e9 +
+           (end.tv_nsec - start->tv_nsec);
+}
+
+static pl_inode_t *
+bench_pl_inode(void)
+{
+    pl_inode_t *pl_inode = NULL;
+
+    pl_inode = GF_CALLOC(1, sizeof(*pl_inode), gf_locks_mt_pl_inode_t);
+    if (!pl_inode)
+        abort();
+
+    pthread_mutex_init(&pl_inode->mutex, NULL);
+    INIT_LIST_HEAD(&pl_inode->dom_list);
+    INIT_LIST_HEAD(&pl_inode->ext_list);
+    INIT_LIST_HEAD(&pl_inode->rw_list);
+    INIT_LIST_HEAD(&pl_inode->reservelk_list);
+    INIT_LIST_HEAD(&pl_inode->blocked_reservelks);
+    INIT_LIST_HEAD(&pl_inode->blocked_calls);
+    INIT_LIST_HEAD(&pl_inode->metalk_list);
+    INIT_LIST_HEAD(&pl_inode->queued_locks);
+    INIT_LIST_HEAD(&pl_inode->waiting);
+
+    return pl_inode;
+}
+
+/* Held locks use the even ranges, the odd ones are left free. */
+static void
+bench_flock(struct gf_flock *flock, short type, long range)
+{
+    memset(flock, 0, sizeof(*flock));
+    flock->l_type = type;
+    flock->l_whence = SEEK_SET;
+    flock->l_start = range * BENCH_RANGE;
+    flock->l_len = BENCH_RANGE;
+}
+
+static int
+bench_inodelk(pl_inode_t *pl_inode, pl_dom_list_t *dom, short type,
+              long range, uint64_t owner)
+{
+    struct gf_flock flock;
+    pl_inode_lock_t *lock = NULL;
+    pl_inode_lock_t *conf = NULL;
+    int32_t op_errno = 0;
+    int ret = 0;
+
+    bench_flock(&flock, type, range);
+    set_lk_owner_from_uint64(&bench_stack.lk_owner, owner);
+
+    lock = new_inode_lock(&flock, NULL, 1, &bench_frame, bench_xl, "bench",
+                          NULL, &op_errno);
+    if (!lock)
+        abort();
+    lock->pl_inode = pl_inode;
+
+    pthread_mutex_lock(&pl_inode->mutex);
+    {
+        if (type != F_UNLCK) {
+            ret = __lock_inodelk(bench_xl, pl_inode, lock, 0, dom, NULL,
+                                 NULL);
+            if (ret == 0)
+                lock->frame = NULL;
+        } else {
+            conf = __inode_unlock_lock(bench_xl, lock, dom);
+            if (!conf)
+                abort();
+            __pl_inodelk_unref(conf);
+        }
+        __pl_inodelk_unref(lock);
+    }
+    pthread_mutex_unlock(&pl_inode->mutex);
+
+    return ret;
+}
+
+static void
+bench_inodelks(long ops, int held)
+{
+    pl_inode_t *pl_inode = bench_pl_inode();
+    pl_dom_list_t *dom = get_domain(pl_inode, "bench");
+    struct timespec start;
+    double grant = 0;
+    double conflict = 0;
+    long i = 0;
+
+    for (i = 0; i < held; i++) {
+        if (bench_inodelk(pl_inode, dom, F_WRLCK, i * 2, i + 1) != 0)
+            abort();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < ops; i++) {
+        long range = (random() % (held + 1)) * 2 + 1;
+
+        if (bench_inodelk(pl_inode, dom, F_WRLCK, range, held + 1) != 0)
+            abort();
+        bench_inodelk(pl_inode, dom, F_UNLCK, range, held + 1);
+    }
+    grant = bench_elapsed(&start) / ops;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; (held > 0) && (i < ops); i++) {
+        long range = (random() % held) * 2;
+
+        if (bench_inodelk(pl_inode, dom, F_WRLCK, range, held + 1) != -EAGAIN)
+            abort();
+    }
+    conflict = bench_elapsed(&start) / ops;
+
+    printf("inodelk  held: %6d  grant ns: %9.1f  conflict ns: %9.1f\n", held,
+           grant, conflict);
+
+    for (i = 0; i < held; i++)
+        bench_inodelk(pl_inode, dom, F_UNLCK, i * 2, i + 1);
+}
+
+static int
+bench_posixlk(pl_inode_t *pl_inode, client_t *client, short type, long range,
+              uint64_t owner)
+{
+    struct gf_flock flock;
+    gf_lkowner_t lk_owner;
+    posix_lock_t *lock = NULL;
+    int32_t op_errno = 0;
+    int ret = 0;
+
+    bench_flock(&flock, type, range);
+    set_lk_owner_from_uint64(&lk_owner, owner);
+
+    lock = new_posix_lock(&flock, client, 1, &lk_owner, (fd_t *)client, 0, 0,
+                          &op_errno);
+    if (!lock)
+        abort();
+
+    ret = pl_setlk(bench_xl, pl_inode, lock, 0);
+    if (ret != 0)
+        __destroy_lock(lock);
+
+    return ret;
+}
+
+static void
+bench_posixlks(long ops, int held)
+{
+    pl_inode_t *pl_inode = bench_pl_inode();
+    client_t *client = NULL;
+    struct timespec start;
+    double grant = 0;
+    double conflict = 0;
+    long i = 0;
+
+    client = GF_CALLOC(1, sizeof(*client), gf_common_mt_client_t);
+    if (!client)
+        abort();
+    client->client_uid = "bench";
+
+    for (i = 0; i < held; i++) {
+        if (bench_posixlk(pl_inode, client, F_WRLCK, i * 2, i + 1) != 0)
+            abort();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < ops; i++) {
+        long range = (random() % (held + 1)) * 2 + 1;
+
+        if (bench_posixlk(pl_inode, client, F_WRLCK, range, held + 1) != 0)
+            abort();
+        bench_posixlk(pl_inode, client, F_UNLCK, range, held + 1);
+    }
+    grant = bench_elapsed(&start) / ops;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; (held > 0) && (i < ops); i++) {
+        long range = (random() % held) * 2;
+
+        if (bench_posixlk(pl_inode, client, F_WRLCK, range, held + 1) == 0)
+            abort();
+    }
+    conflict = bench_elapsed(&start) / ops;
+
+    printf("posixlk  held: %6d  grant ns: %9.1f  conflict ns: %9.1f\n", held,
+           grant, conflict);
+
+    for (i = 0; i < held; i++)
+        bench_posixlk(pl_inode, client, F_UNLCK, i * 2, i + 1);
+}
+
+int
+main(int argc, char *argv[])
+{
+    glusterfs_ctx_t *ctx = NULL;
+    posix_locks_private_t *priv = NULL;
+    long ops = 0;
+    int i = 0;
+
+    ops = (argc > 1) ? atol(argv[1]) : 100000;
+
+    ctx = glusterfs_ctx_new();
+    if (!ctx || glusterfs_globals_init(ctx))
+        return EXIT_FAILURE;
+    THIS->ctx = ctx;
+    mem_pools_init();
+
+    priv = calloc(1, sizeof(*priv));
+    bench_xl = calloc(1, sizeof(*bench_xl));
+    if (!priv || !bench_xl)
+        return EXIT_FAILURE;
+    bench_xl->name = "bench";
+    bench_xl->ctx = ctx;
+    bench_xl->private = priv;
+
+    THIS = bench_xl;
+    bench_frame.root = &bench_stack;
+    bench_frame.this = bench_xl;
+
+    for (i = 0; i < sizeof(bench_held) / sizeof(bench_held[0]); i++) {
+        bench_inodelks(ops, bench_held[i]);
+        bench_posixlks(ops, bench_held[i]);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1488,6 +1488,194 @@ out:
     return ret;
 }
 
+static int
+mq_flush_pending_task(void *opaque)
+{
+    int32_t ret = -1;
+    gf_boolean_t locked = _gf_false;
+    gf_boolean_t owned = _gf_false;
+    gf_boolean_t updated = _gf_false;
+    quota_meta_t delta = {
+        0,
+    };
+    quota_synctask_t *args = NULL;
+    xlator_t *this = NULL;
+    loc_t *loc = NULL;
+    quota_inode_ctx_t *ctx = NULL;
+
+    GF_ASSERT(opaque);
+
+    args = (quota_synctask_t *)opaque;
+    loc = &args->loc;
+    this = args->this;
+    THIS = this;
+
+    ret = mq_inode_ctx_get(loc->inode, this, &ctx);
+    if (ret < 0)
+        goto out;
+
+    ret = mq_lock(this, loc, F_WRLCK);
+    if (ret == 0)
+        locked = _gf_true;
+
+    /* Whatever happens below the pending delta is consumed here: on
+     * failure the directory is left dirty on disk and the next lookup
+     * recomputes its size from the contributions of its children.
+     */
+    LOCK(&ctx->lock);
+    {
+        delta = ctx->pending;
+        memset(&ctx->pending, 0, sizeof(ctx->pending));
+        owned = ctx->pending_dirty;
+        ctx->pending_dirty = _gf_false;
+        ctx->flush_queued = _gf_false;
+    }
+    UNLOCK(&ctx->lock);
+
+    if (!locked)
+        goto out;
+
+    ret = mq_update_size(this, loc, &delta);
+    if (ret < 0)
+        goto out;
+    updated = !quota_meta_is_null(&delta);
+
+    if (owned)
+        ret = mq_mark_dirty(this, loc, 0);
+    else
+        mq_set_ctx_dirty_status(ctx, _gf_false);
+
+out:
+    if (ret < 0 && ctx)
+        mq_set_ctx_dirty_status(ctx, _gf_false);
+
+    if (locked)
+        mq_lock(this, loc, F_UNLCK);
+
+    if (updated && !loc_is_root(loc))
+        mq_initiate_quota_blocking_txn(this, loc, NULL);
+
+    return 0;
+}
+
+static void
+mq_flush_timer_cbk(void *data)
+{
+    quota_synctask_t *args = data;
+    quota_inode_ctx_t *ctx = NULL;
+
+    THIS = args->this;
+
+    if (mq_inode_ctx_get(args->loc.inode, args->this, &ctx) == 0) {
+        LOCK(&ctx->lock);
+        {
+            ctx->flush_timer = NULL;
+        }
+        UNLOCK(&ctx->lock);
+    }
+
+    mq_synctask(args->this, mq_flush_pending_task, _gf_true, &args->loc);
+
+    loc_wipe(&args->loc);
+    GF_FREE(args);
+}
+
+static void
+mq_schedule_flush(xlator_t *this, loc_t *loc, quota_inode_ctx_t *ctx)
+{
+    marker_conf_t *priv = this->private;
+    quota_synctask_t *args = NULL;
+    struct timespec delay = {
+        0,
+    };
+    gf_boolean_t flush_now = _gf_false;
+
+    LOCK(&ctx->lock);
+    {
+        if (ctx->flush_timer == NULL) {
+            args = GF_CALLOC(1, sizeof(*args), gf_marker_mt_quota_synctask_t);
+            if (args) {
+                args->this = this;
+                loc_copy(&args->loc, loc);
+                delay.tv_sec = priv->quota_flush_interval;
+                ctx->flush_timer = gf_timer_call_after(
+                    this->ctx, delay, mq_flush_timer_cbk, args);
+                if (ctx->flush_timer == NULL) {
+                    loc_wipe(&args->loc);
+                    GF_FREE(args);
+                }
+            }
+        }
+
+        if (!ctx->flush_queued &&
+            (ctx->flush_timer == NULL ||
+             (priv->quota_flush_threshold &&
+              (uint64_t)llabs(ctx->pending.size) >=
+                  priv->quota_flush_threshold))) {
+            ctx->flush_queued = _gf_true;
+            flush_now = _gf_true;
+        }
+    }
+    UNLOCK(&ctx->lock);
+
+    if (flush_now)
+        mq_synctask(this, mq_flush_pending_task, _gf_true, loc);
+}
+
+/* Called with the inodelk on the parent held. The child's contribution is
+ * updated right away, but its delta is only added to the parent's pending
+ * delta, which is applied to the size xattr (and carried further up) by
+ * the next flush. The parent stays dirty on disk meanwhile, so a crash
+ * before the flush is repaired by the usual dirty-inode healing.
+ */
+static int32_t
+mq_batch_delta(xlator_t *this, loc_t *loc, loc_t *parent_loc,
+               inode_contribution_t *contri, quota_meta_t *delta)
+{
+    int32_t ret = -1;
+    int32_t prev_dirty = 0;
+    gf_boolean_t owned = _gf_false;
+    quota_inode_ctx_t *parent_ctx = NULL;
+
+    ret = mq_inode_ctx_get(parent_loc->inode, this, &parent_ctx);
+    if (ret < 0)
+        goto out;
+
+    LOCK(&parent_ctx->lock);
+    {
+        owned = parent_ctx->pending_dirty;
+    }
+    UNLOCK(&parent_ctx->lock);
+
+    if (!owned) {
+        ret = mq_get_set_dirty(this, parent_loc, 1, &prev_dirty);
+        if (ret < 0)
+            goto out;
+
+        /* if the directory was already dirty leave it to be healed */
+        if (prev_dirty == 0) {
+            LOCK(&parent_ctx->lock);
+            {
+                parent_ctx->pending_dirty = _gf_true;
+            }
+            UNLOCK(&parent_ctx->lock);
+        }
+    }
+
+    ret = mq_update_contri(this, loc, contri, delta);
+    if (ret == 0) {
+        LOCK(&parent_ctx->lock);
+        {
+            mq_add_meta(&parent_ctx->pending, delta);
+        }
+        UNLOCK(&parent_ctx->lock);
+    }
+
+    mq_schedule_flush(this, parent_loc, parent_ctx);
+out:
+    return ret;
+}
+
 int
 mq_initiate_quota_task(void *opaque)
 {
@@ -1512,6 +1700,7 @@ mq_initiate_quota_task(void *opaque)
     quota_inode_ctx_t *ctx = NULL;
     quota_inode_ctx_t *parent_ctx = NULL;
     inode_t *tmp_parent = NULL;
+    marker_conf_t *priv = NULL;
 
     GF_VALIDATE_OR_GOTO("marker", opaque, out);
 
@@ -1521,6 +1710,7 @@ mq_initiate_quota_task(void *opaque)
 
     GF_VALIDATE_OR_GOTO("marker", this, out);
     THIS = this;
+    priv = this->private;
 
     GF_VALIDATE_OR_GOTO(this->name, loc, out);
     GF_VALIDATE_OR_GOTO(this->name, loc->inode, out);
@@ -1666,6 +1856,12 @@ mq_initiate_quota_task(void *opaque)
         if (quota_meta_is_null(&delta))
             goto out;
 
+        /* The flush of the parent carries the delta further up */
+        if (priv->quota_flush_interval) {
+            ret = mq_batch_delta(this, &child_loc, &parent_loc, contri, &delta);
+            break;
+        }
+
         ret = mq_get_set_dirty(this, &parent_loc, 1, &prev_dirty);
         if (ret < 0)
             goto out;
@@ -1881,6 +2077,16 @@ mq_update_dirty_inode_task(void *opaque)
         goto out;
     }
 
+    /* The size is recomputed from the contributions of the children,
+     * which already include any delta still waiting to be flushed.
+     */
+    LOCK(&ctx->lock);
+    {
+        memset(&ctx->pending, 0, sizeof(ctx->pending));
+        ctx->pending_dirty = _gf_false;
+    }
+    UNLOCK(&ctx->lock);
+
     fd = fd_create(loc->inode, 0);
     if (!fd) {
         gf_log(this->name, GF_LOG_ERROR, "Failed to create fd");
@@ -2039,6 +2245,7 @@ mq_inspect_directory_xattr(xlator_t *this, quota_inode_ctx_t *ctx,
     };
     int keylen = 0;
     gf_boolean_t status = _gf_false;
+    gf_boolean_t batched = _gf_false;
 
     ret = dict_get_int8(dict, QUOTA_DIRTY_KEY, &dirty);
     if (ret < 0) {
@@ -2101,7 +2308,15 @@ mq_inspect_directory_xattr(xlator_t *this, quota_inode_ctx_t *ctx,
     mq_compute_delta(&delta, &size, &contri);
 
     if (dirty) {
-        ret = mq_update_dirty_inode_txn(this, loc, ctx);
+        LOCK(&ctx->lock);
+        {
+            batched = ctx->pending_dirty;
+        }
+        UNLOCK(&ctx->lock);
+
+        /* dirty only until the pending flush of this directory */
+        if (!batched)
+            ret = mq_update_dirty_inode_txn(this, loc, ctx);
         goto out;
     }
 
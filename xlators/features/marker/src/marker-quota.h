@@ -15,6 +15,7 @@
 #include <glusterfs/refcount.h>
 #include <glusterfs/quota-common-utils.h>
 #include <glusterfs/call-stub.h>
+#include <glusterfs/timer.h>
 
 #define QUOTA_XATTR_PREFIX "trusted.glusterfs"
 #define QUOTA_DIRTY_KEY "trusted.glusterfs.quota.dirty"
@@ -92,6 +93,14 @@ struct quota_inode_ctx {
     gf_boolean_t dirty_status;
     gf_lock_t lock;
     struct list_head contribution_head;
+
+    /* children's deltas already added to their contribution but not yet
+     * to this directory's size; the directory stays dirty on disk until
+     * they are flushed */
+    quota_meta_t pending;
+    gf_boolean_t pending_dirty;
+    gf_boolean_t flush_queued;
+    gf_timer_t *flush_timer;
 };
 typedef struct quota_inode_ctx quota_inode_ctx_t;
 
@@ -3353,6 +3353,11 @@ reconfigure(xlator_t *this, dict_t *options)
                    priv->version);
     }
 
+    GF_OPTION_RECONF("quota-flush-interval", priv->quota_flush_interval,
+                     options, time, out);
+    GF_OPTION_RECONF("quota-flush-threshold", priv->quota_flush_threshold,
+                     options, size_uint64, out);
+
     data = dict_get(options, "xtime");
     if (data) {
         ret = gf_string2boolean(data->data, &flag);
@@ -3434,6 +3439,11 @@ init(xlator_t *this)
         goto err;
     }
 
+    GF_OPTION_INIT("quota-flush-interval", priv->quota_flush_interval, time,
+                   err);
+    GF_OPTION_INIT("quota-flush-threshold", priv->quota_flush_threshold,
+                   size_uint64, err);
+
     data = dict_get(options, "xtime");
     if (data) {
         ret = gf_string2boolean(data->data, &flag);
@@ -3552,6 +3562,31 @@ struct volume_options options[] = {
         .key = {"quota-version"},
         .flags = OPT_FLAG_NONE,
     },
+    {
+        .key = {"quota-flush-interval"},
+        .type = GF_OPTION_TYPE_TIME,
+        .min = 0,
+        .max = 3600,
+        .default_value = "0",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .description = "Seconds for which size changes of a directory's "
+                       "children are accumulated in memory before they are "
+                       "written to its size xattr and carried to its "
+                       "parent. 0 updates every ancestor on each change.",
+    },
+    {
+        .key = {"quota-flush-threshold"},
+        .type = GF_OPTION_TYPE_SIZET,
+        .min = 0,
+        .max = 1 * GF_UNIT_TB,
+        .default_value = "4MB",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .description = "Flush the accumulated changes of a directory as "
+                       "soon as they add up to this many bytes, without "
+                       "waiting for quota-flush-interval. 0 disables.",
+    },
     {.key = {NULL}}};
 
 xlator_api_t xlator_api = {
@@ -142,6 +142,8 @@ struct marker_conf {
     uint64_t quota_lk_owner;
     gf_lock_t lock;
     int32_t version;
+    uint32_t quota_flush_interval;
+    uint64_t quota_flush_threshold;
 };
 typedef struct marker_conf marker_conf_t;
 
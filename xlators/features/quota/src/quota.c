@@ -586,6 +586,7 @@ quota_validate_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
     quota_meta_t size = {
         0,
     };
+    int64_t reservation = 0;
 
     local = frame->local;
 
@@ -619,6 +620,10 @@ quota_validate_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
         op_errno = EINVAL;
     }
 
+    /* absent when quotad was not asked for, or could not grant, one */
+    if (dict_get_int64(xdata, QUOTA_RESERVATION_KEY, &reservation))
+        reservation = 0;
+
     local->just_validated = 1; /* so that we don't go into infinite
                                 * loop of validation and checking
                                 * limit when timeout is zero.
@@ -629,6 +634,12 @@ quota_validate_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
         ctx->validate_time = gf_time();
         ctx->file_count = size.file_count;
         ctx->dir_count = size.dir_count;
+        /* a grant answering an older validation was computed without
+         * the space given away since; drop it */
+        if (ctx->reservation_gen == local->reservation_gen) {
+            ctx->reservation = reservation;
+            ctx->reservation_time = ctx->validate_time;
+        }
     }
     UNLOCK(&ctx->lock);
 
@@ -953,6 +964,8 @@ quota_validate(call_frame_t *frame, inode_t *inode, xlator_t *this,
     int ret = 0;
     dict_t *xdata = NULL;
     quota_priv_t *priv = NULL;
+    quota_inode_ctx_t *ctx = NULL;
+    uint64_t value = 0;
 
     local = frame->local;
     priv = this->private;
@@ -998,6 +1011,30 @@ quota_validate(call_frame_t *frame, inode_t *inode, xlator_t *this,
         goto err;
     }
 
+    inode_ctx_get(inode, this, &value);
+    ctx = (quota_inode_ctx_t *)(unsigned long)value;
+    if (priv->reservation_lease && ctx && ctx->hard_lim > 0) {
+        /* Give back what is left of our reservation, so that quotad can
+         * grant it again: bricks only report their unused reservations to
+         * quotad, and ours must not be counted against ourselves. */
+        LOCK(&ctx->lock);
+        {
+            ctx->reservation = 0;
+            local->reservation_gen = ++ctx->reservation_gen;
+        }
+        UNLOCK(&ctx->lock);
+
+        ret = dict_set_int64(xdata, QUOTA_RESERVATION_KEY, ctx->hard_lim);
+        if (ret < 0) {
+            gf_msg(this->name, GF_LOG_WARNING, ENOMEM, Q_MSG_ENOMEM,
+                   "dict set failed");
+            ret = -ENOMEM;
+            goto err;
+        }
+    }
+
+    QUOTA_SAFE_INCREMENT(&priv->lock, priv->validation_count);
+
     ret = quota_enforcer_lookup(frame, this, xdata, cbk_fn);
     if (ret < 0) {
         ret = -ENOTCONN;
@@ -1156,6 +1193,7 @@ quota_check_size_limit(call_frame_t *frame, quota_inode_ctx_t *ctx,
     gf_boolean_t hard_limit_exceeded = 0;
     int64_t space_available = 0;
     int64_t wouldbe_size = 0;
+    gf_boolean_t reserved = _gf_false;
 
     GF_ASSERT(frame);
     GF_ASSERT(priv);
@@ -1164,6 +1202,33 @@ quota_check_size_limit(call_frame_t *frame, quota_inode_ctx_t *ctx,
     GF_ASSERT(local);
 
     if (ctx != NULL && (ctx->hard_lim > 0 || ctx->soft_lim > 0)) {
+        if (priv->reservation_lease && delta > 0) {
+            LOCK(&ctx->lock);
+            {
+                if (ctx->reservation >= delta &&
+                    !quota_timeout(ctx->reservation_time,
+                                   priv->reservation_lease)) {
+                    /* the write now counts as used, for the checks that
+                     * don't fit the reservation */
+                    ctx->reservation -= delta;
+                    ctx->size += delta;
+                    reserved = _gf_true;
+                } else {
+                    /* what is left is too small or has expired: give it
+                     * back and check this write against the size */
+                    ctx->reservation = 0;
+                }
+            }
+            UNLOCK(&ctx->lock);
+
+            /* quotad already set this space aside for us */
+            if (reserved) {
+                quota_log_usage(this, ctx, _inode, 0);
+                ret = 0;
+                goto out;
+            }
+        }
+
         wouldbe_size = ctx->size + delta;
 
         LOCK(&ctx->lock);
@@ -1510,6 +1575,8 @@ quota_fill_inodectx(xlator_t *this, inode_t *inode, dict_t *dict, loc_t *loc,
 
     LOCK(&ctx->lock);
     {
+        if (ctx->hard_lim != hard_lim)
+            ctx->reservation = 0;
         ctx->hard_lim = hard_lim;
         ctx->soft_lim = soft_lim;
         ctx->object_hard_lim = object_hard_limit;
@@ -1580,6 +1647,47 @@ out:
     return _gf_true;
 }
 
+/* Count the part of our reservation on this directory that is still unused
+ * as used in the size reported to quotad, so that it is not granted to
+ * another brick as well. */
+static void
+quota_add_reservation(xlator_t *this, inode_t *inode, dict_t *dict)
+{
+    quota_priv_t *priv = NULL;
+    quota_inode_ctx_t *ctx = NULL;
+    uint64_t value = 0;
+    int64_t reservation = 0;
+    quota_meta_t size = {
+        0,
+    };
+
+    priv = this->private;
+
+    inode_ctx_get(inode, this, &value);
+    ctx = (quota_inode_ctx_t *)(unsigned long)value;
+    if (!ctx || !dict)
+        return;
+
+    LOCK(&ctx->lock);
+    {
+        if (!quota_timeout(ctx->reservation_time, priv->reservation_lease))
+            reservation = ctx->reservation;
+    }
+    UNLOCK(&ctx->lock);
+
+    if (reservation <= 0)
+        return;
+
+    if (quota_dict_get_meta(dict, QUOTA_SIZE_KEY, SLEN(QUOTA_SIZE_KEY),
+                            &size) < 0)
+        return;
+
+    size.size += reservation;
+    if (quota_dict_set_meta(dict, QUOTA_SIZE_KEY, &size, IA_IFDIR) < 0)
+        gf_msg(this->name, GF_LOG_WARNING, ENOMEM, Q_MSG_ENOMEM,
+               "dict set failed");
+}
+
 int32_t
 quota_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
                  int32_t op_ret, int32_t op_errno, inode_t *inode,
@@ -1598,6 +1706,8 @@ quota_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
                                      &op_errno);
         if (op_ret < 0)
             op_errno = ENOMEM;
+        else if (local->report_reservation)
+            quota_add_reservation(this, inode, dict);
     }
 
     QUOTA_STACK_UNWIND(lookup, frame, op_ret, op_errno, inode, buf, dict,
@@ -1640,6 +1750,10 @@ quota_lookup(call_frame_t *frame, xlator_t *this, loc_t *loc, dict_t *xattr_req)
     frame->local = local;
     loc_copy(&local->loc, loc);
 
+    /* quotad validating a directory for another brick */
+    if (dict_get_sizen(xattr_req, QUOTA_RESERVATION_KEY))
+        local->report_reservation = _gf_true;
+
     ret = dict_set_int8(xattr_req, QUOTA_LIMIT_KEY, 1);
     if (ret < 0) {
         gf_msg(this->name, GF_LOG_WARNING, ENOMEM, Q_MSG_ENOMEM,
@@ -5050,6 +5164,7 @@ init(xlator_t *this)
     GF_OPTION_INIT("soft-timeout", priv->soft_timeout, time, err);
     GF_OPTION_INIT("hard-timeout", priv->hard_timeout, time, err);
     GF_OPTION_INIT("alert-time", priv->log_timeout, time, err);
+    GF_OPTION_INIT("reservation-lease", priv->reservation_lease, time, err);
     GF_OPTION_INIT("volume-uuid", priv->volume_uuid, str, err);
 
     this->local_pool = mem_pool_new(quota_local_t, 64);
@@ -5103,6 +5218,8 @@ reconfigure(xlator_t *this, dict_t *options)
     GF_OPTION_RECONF("alert-time", priv->log_timeout, options, time, out);
     GF_OPTION_RECONF("soft-timeout", priv->soft_timeout, options, time, out);
     GF_OPTION_RECONF("hard-timeout", priv->hard_timeout, options, time, out);
+    GF_OPTION_RECONF("reservation-lease", priv->reservation_lease, options,
+                     time, out);
 
     if (quota_on) {
         priv->rpc_clnt = quota_enforcer_init(this, this->options);
@@ -5165,6 +5282,8 @@ quota_priv_dump(xlator_t *this)
         gf_proc_dump_write("volume-uuid", "%s", priv->volume_uuid);
         gf_proc_dump_write("validation-count", "%" PRIu64,
                            priv->validation_count);
+        gf_proc_dump_write("reservation-lease", "%u",
+                           priv->reservation_lease);
     }
     UNLOCK(&priv->lock);
 
@@ -5319,6 +5438,23 @@ struct volume_options options[] = {
         .description = "Frequency of limit breach messages in log.",
         .tags = {},
     },
+    {
+        .key = {"reservation-lease"},
+        .type = GF_OPTION_TYPE_TIME,
+        .min = 0,
+        .max = 3600,
+        .default_value = "0",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .description = "When validating a directory with a hard limit, "
+                       "ask quotad for a share of the space left under it. "
+                       "Writes covered by that share are allowed without "
+                       "validating again, for up to this many seconds. "
+                       "Until then, the part of the share left unused is "
+                       "not available to the other bricks. "
+                       "0 disables reservations.",
+        .tags = {},
+    },
     {.key = {NULL}}};
 
 xlator_api_t xlator_api = {
@@ -5330,6 +5466,7 @@ xlator_api_t xlator_api = {
     .op_version = {1}, /* Present from the initial version */
     .fops = &fops,
     .cbks = &cbks,
+    .dumpops = &dumpops,
     .options = options,
     .identifier = "quota",
     .category = GF_MAINTAINED,
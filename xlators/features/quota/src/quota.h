@@ -136,6 +136,13 @@
 
 #define QUOTA_REG_OR_LNK_FILE(ia_type) (IA_ISREG(ia_type) || IA_ISLNK(ia_type))
 
+/* Sent to quotad with the hard limit of the directory being validated; the
+ * reply carries the bytes this brick may write under it without asking
+ * again. quotad passes the key on in its lookups, so that every brick adds
+ * the part of its reservation it has not used yet to the size it reports.
+ */
+#define QUOTA_RESERVATION_KEY "quota-reservation"
+
 struct quota_dentry {
     char *name;
     uuid_t par;
@@ -155,6 +162,9 @@ struct quota_inode_ctx {
     struct list_head parents;
     time_t validate_time;
     time_t prev_log_time;
+    int64_t reservation;
+    time_t reservation_time;
+    uint32_t reservation_gen;
     gf_boolean_t ancestry_built;
     gf_lock_t lock;
 };
@@ -195,6 +205,8 @@ struct quota_local {
     int32_t quotad_conn_retry;
     xlator_t *this;
     call_frame_t *par_frame;
+    uint32_t reservation_gen;
+    gf_boolean_t report_reservation;
 };
 typedef struct quota_local quota_local_t;
 
@@ -214,6 +226,7 @@ struct quota_priv {
     inode_table_t *itable;
     char *volume_uuid;
     uint64_t validation_count;
+    uint32_t reservation_lease;
     int32_t quotad_conn_status;
     pthread_mutex_t conn_mutex;
     pthread_cond_t conn_cond;
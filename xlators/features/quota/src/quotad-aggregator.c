@@ -17,6 +17,7 @@ static char *qd_ext_xattrs[] = {
     QUOTA_SIZE_KEY,
     QUOTA_LIMIT_KEY,
     QUOTA_LIMIT_OBJECTS_KEY,
+    QUOTA_RESERVATION_KEY,
     NULL,
 };
 
@@ -357,6 +358,10 @@ quotad_aggregator_lookup(rpcsvc_request_t *req)
         }
     }
 
+    /* kept for qd_lookup_cbk, which may have to grant a reservation */
+    state->req_xdata = dict;
+    dict = NULL;
+
     ret = qd_nameless_lookup(this, frame, args.gfid, state->xdata, volume_uuid,
                              quotad_aggregator_lookup_cbk);
     if (ret) {
@@ -364,9 +369,6 @@ quotad_aggregator_lookup(rpcsvc_request_t *req)
         goto err;
     }
 
-    if (dict)
-        dict_unref(dict);
-
     return ret;
 
 err:
@@ -42,6 +42,54 @@ mem_acct_init(xlator_t *this)
     return ret;
 }
 
+/* Grant the brick asking for it an equal share, among all the distribute
+ * subvolumes of the volume, of the space left under the limit. quotad keeps
+ * no record of its grants: the bricks add what they have not used of
+ * theirs to the size they report, so the aggregated size already counts
+ * every grant still outstanding, on this node or any other. The share keeps
+ * grants made at the same time to different bricks from adding up to more
+ * than the space left.
+ */
+static void
+qd_grant_reservation(xlator_t *this, quotad_aggregator_state_t *state,
+                     dict_t *xdata)
+{
+    int64_t hard_lim = 0;
+    int64_t reservation = 0;
+    int32_t share = 1;
+    quota_meta_t size = {
+        0,
+    };
+    char key[1024];
+    int keylen = 0;
+    char *optstr = NULL;
+
+    if (!state->req_xdata || !state->active_subvol || !xdata)
+        return;
+
+    if (dict_get_int64(state->req_xdata, QUOTA_RESERVATION_KEY, &hard_lim) ||
+        hard_lim <= 0)
+        return;
+
+    if (quota_dict_get_meta(xdata, QUOTA_SIZE_KEY, SLEN(QUOTA_SIZE_KEY),
+                            &size) < 0)
+        return;
+
+    keylen = snprintf(key, sizeof(key), "%s.distribute-count",
+                      state->active_subvol->name);
+    if (dict_get_strn(this->options, key, keylen, &optstr) == 0)
+        gf_string2int32(optstr, &share);
+    if (share < 1)
+        share = 1;
+
+    if (size.size < hard_lim)
+        reservation = (hard_lim - size.size) / share;
+
+    if (dict_set_int64(xdata, QUOTA_RESERVATION_KEY, reservation))
+        gf_msg(this->name, GF_LOG_WARNING, ENOMEM, Q_MSG_ENOMEM,
+               "dict set failed");
+}
+
 int32_t
 qd_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
               int32_t op_errno, inode_t *inode, struct iatt *buf, dict_t *xdata,
@@ -57,6 +105,9 @@ qd_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     rsp.op_ret = op_ret;
     rsp.op_errno = op_errno;
 
+    if (op_ret == 0)
+        qd_grant_reservation(this, frame->root->state, xdata);
+
     gf_stat_from_iatt(&rsp.postparent, postparent);
 
     GF_PROTOCOL_DICT_SERIALIZE(this, xdata, (&rsp.xdata.xdata_val),
@@ -142,6 +193,7 @@ qd_nameless_lookup(xlator_t *this, call_frame_t *frame, char *gfid,
         op_errno = EINVAL;
         goto out;
     }
+    state->active_subvol = subvol;
 
     STACK_WIND_COOKIE(frame, qd_lookup_cbk, lookup_cbk, subvol,
                       subvol->fops->lookup, &loc, xdata);
@@ -35,6 +35,7 @@ const char *gd_bitrot_op_list[GF_BITROT_OPTION_TYPE_MAX] = {
     [GF_BITROT_OPTION_TYPE_SCRUB] = "scrub",
     [GF_BITROT_OPTION_TYPE_EXPIRY_TIME] = "expiry-time",
     [GF_BITROT_OPTION_TYPE_SIGNER_THREADS] = "signer-threads",
+    [GF_BITROT_OPTION_TYPE_SIGNATURE_TYPE] = "signature-type",
 };
 
 int
@@ -430,6 +431,41 @@ out:
     return ret;
 }
 
+static int
+glusterd_bitrot_signature_type(glusterd_volinfo_t *volinfo, dict_t *dict,
+                               char *key, char **op_errstr)
+{
+    int32_t ret = -1;
+    char *signature_type = NULL;
+    xlator_t *this = NULL;
+
+    this = THIS;
+    GF_ASSERT(this);
+
+    ret = dict_get_str(dict, "signature-type-value", &signature_type);
+    if (ret) {
+        gf_msg(this->name, GF_LOG_ERROR, errno, GD_MSG_DICT_GET_FAILED,
+               "Unable to get bitrot signature type.");
+        goto out;
+    }
+
+    ret = dict_set_dynstr_with_alloc(volinfo->dict, key, signature_type);
+    if (ret) {
+        gf_msg(this->name, GF_LOG_ERROR, errno, GD_MSG_DICT_SET_FAILED,
+               "Failed to set option %s", key);
+        goto out;
+    }
+
+    ret = glusterd_bitdsvc_reconfigure();
+    if (ret) {
+        gf_msg(this->name, GF_LOG_ERROR, 0, GD_MSG_BITDSVC_RECONF_FAIL,
+               "Failed to reconfigure bitrot services");
+        goto out;
+    }
+out:
+    return ret;
+}
+
 static int
 glusterd_bitrot_enable(glusterd_volinfo_t *volinfo, char **op_errstr)
 {
@@ -679,6 +715,13 @@ glusterd_op_bitrot(dict_t *dict, char **op_errstr, dict_t *rsp_dict)
                 goto out;
             break;
 
+        case GF_BITROT_OPTION_TYPE_SIGNATURE_TYPE:
+            ret = glusterd_bitrot_signature_type(
+                volinfo, dict, "features.signature-type", op_errstr);
+            if (ret)
+                goto out;
+            break;
+
         case GF_BITROT_CMD_SCRUB_STATUS:
         case GF_BITROT_CMD_SCRUB_ONDEMAND:
             break;
@@ -779,6 +822,18 @@ glusterd_op_stage_bitrot(dict_t *dict, char **op_errstr, dict_t *rsp_dict)
         goto out;
     }
 
+    /* scrubbers of older versions would flag objects signed with
+     * anything but SHA256 as corrupted */
+    if ((GF_BITROT_OPTION_TYPE_SIGNATURE_TYPE == type) &&
+        (priv->op_version < GD_OP_VERSION_9_0)) {
+        ret = -1;
+        gf_asprintf(op_errstr,
+                    "Bitrot signature-type needs the cluster "
+                    "op-version to be at least %d",
+                    GD_OP_VERSION_9_0);
+        goto out;
+    }
+
     if ((GF_BITROT_OPTION_TYPE_SCRUB == type)) {
         ret = dict_get_str(volinfo->dict, "features.scrub",
                            &scrub_cmd_from_dict);
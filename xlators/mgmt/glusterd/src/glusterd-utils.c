@@ -2010,6 +2010,8 @@ glusterd_volume_start_glusterfs(glusterd_volinfo_t *volinfo,
     char *inet_family = NULL;
     char *global_threading = NULL;
     bool threading = false;
+    char *event_pinning = NULL;
+    gf_boolean_t pinning = _gf_false;
 
     GF_ASSERT(volinfo);
     GF_ASSERT(brickinfo);
@@ -2182,6 +2184,13 @@ retry:
         }
     }
 
+    if (dict_get_strn(volinfo->dict, VKEY_CONFIG_EVENT_PINNING,
+                      SLEN(VKEY_CONFIG_EVENT_PINNING), &event_pinning) == 0) {
+        if ((gf_string2boolean(event_pinning, &pinning) == 0) && pinning) {
+            runner_add_arg(&runner, "--event-pinning");
+        }
+    }
+
     runner_add_arg(&runner, "--xlator-option");
     runner_argprintf(&runner, "%s-server.listen-port=%d", volinfo->volname,
                      port);
@@ -4473,6 +4473,12 @@ bitrot_option_handler(volgen_graph_t *graph, struct volopt_map_entry *vme,
             return -1;
     }
 
+    if (!strcmp(vme->option, "signature-type")) {
+        ret = xlator_set_fixed_option(xl, "signature-type", vme->value);
+        if (ret)
+            return -1;
+    }
+
     return ret;
 }
 
@@ -5269,6 +5275,9 @@ build_quotad_graph(volgen_graph_t *graph, dict_t *mod_dict)
     int ret = 0;
     xlator_t *quotad_xl = NULL;
     char *skey = NULL;
+    char buf[16] = {
+        0,
+    };
 
     this = THIS;
     GF_ASSERT(this);
@@ -5320,6 +5329,22 @@ build_quotad_graph(volgen_graph_t *graph, dict_t *mod_dict)
         if (ret)
             goto out;
 
+        /* quotad splits reservations evenly between these */
+        ret = gf_asprintf(&skey, "%s.distribute-count", voliter->volname);
+        if (ret == -1) {
+            gf_msg("glusterd", GF_LOG_ERROR, ENOMEM, GD_MSG_NO_MEMORY,
+                   "Out of memory");
+            goto out;
+        }
+        snprintf(buf, sizeof(buf), "%d",
+                 voliter->dist_leaf_count
+                     ? voliter->brick_count / voliter->dist_leaf_count
+                     : 1);
+        ret = xlator_set_option(quotad_xl, skey, ret, buf);
+        GF_FREE(skey);
+        if (ret)
+            goto out;
+
         memset(&cgraph, 0, sizeof(cgraph));
         ret = volgen_graph_build_clients(&cgraph, voliter, set_dict, NULL);
         if (ret)
@@ -39,6 +39,7 @@
 #define VKEY_RDA_REQUEST_SIZE "performance.rda-request-size"
 #define VKEY_CONFIG_GFPROXY "config.gfproxyd"
 #define VKEY_CONFIG_GLOBAL_THREADING "config.global-threading"
+#define VKEY_CONFIG_EVENT_PINNING "config.event-pinning"
 #define VKEY_CONFIG_CLIENT_THREADS "config.client-threads"
 #define VKEY_CONFIG_BRICK_THREADS "config.brick-threads"
 
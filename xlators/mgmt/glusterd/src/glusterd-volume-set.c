@@ -961,6 +961,15 @@ struct volopt_map_entry glusterd_volopt_map[] = {
         .flags = VOLOPT_FLAG_CLIENT_OPT,
     },
 
+    {
+        .key = "cluster.rebal-inflight-blocks",
+        .voltype = "cluster/distribute",
+        .option = "rebal-inflight-blocks",
+        .value = "4",
+        .op_version = GD_OP_VERSION_9_0,
+        .flags = VOLOPT_FLAG_CLIENT_OPT,
+    },
+
     /* NUFA xlator options (Distribute special case) */
     {.key = "cluster.nufa",
      .voltype = "cluster/distribute",
@@ -1011,6 +1020,14 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .voltype = "cluster/replicate",
      .op_version = 2,
      .flags = VOLOPT_FLAG_CLIENT_OPT},
+    {.key = "cluster.read-hedge",
+     .voltype = "cluster/replicate",
+     .op_version = GD_OP_VERSION_9_0,
+     .flags = VOLOPT_FLAG_CLIENT_OPT},
+    {.key = "cluster.read-hedge-min-delay",
+     .voltype = "cluster/replicate",
+     .op_version = GD_OP_VERSION_9_0,
+     .flags = VOLOPT_FLAG_CLIENT_OPT},
     {.key = "cluster.background-self-heal-count",
      .voltype = "cluster/replicate",
      .op_version = 1,
@@ -1314,6 +1331,10 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .voltype = "performance/io-threads",
      .option = "pass-through",
      .op_version = GD_OP_VERSION_4_1_0},
+    {.key = "performance.iot-work-stealing",
+     .voltype = "performance/io-threads",
+     .option = "work-stealing",
+     .op_version = GD_OP_VERSION_9_0},
 
     /* Other perf xlators' options */
     {.key = "performance.io-cache-pass-through",
@@ -1353,6 +1374,11 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .option = "ctime-invalidation",
      .op_version = GD_OP_VERSION_5_0,
      .flags = VOLOPT_FLAG_CLIENT_OPT},
+    {.key = "performance.quick-read-cache-compression",
+     .voltype = "performance/quick-read",
+     .option = "cache-compression",
+     .op_version = GD_OP_VERSION_9_0,
+     .flags = VOLOPT_FLAG_CLIENT_OPT},
     {.key = "performance.flush-behind",
      .voltype = "performance/write-behind",
      .option = "flush-behind",
@@ -1570,6 +1596,13 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .op_version = GD_OP_VERSION_3_10_2,
      .value = "9",
      .flags = VOLOPT_FLAG_CLIENT_OPT},
+    {.key = "client.zerocopy",
+     .voltype = "protocol/client",
+     .option = "transport.socket.zerocopy",
+     .op_version = GD_OP_VERSION_9_0,
+     .value = "off",
+     .validate_fn = validate_boolean,
+     .flags = VOLOPT_FLAG_CLIENT_OPT},
     {.key = "client.strict-locks",
      .voltype = "protocol/client",
      .option = "strict-locks",
@@ -1725,6 +1758,14 @@ struct volopt_map_entry glusterd_volopt_map[] = {
         .op_version = GD_OP_VERSION_3_10_2,
         .value = "9",
     },
+    {
+        .key = "server.zerocopy",
+        .voltype = "protocol/server",
+        .option = "transport.socket.zerocopy",
+        .op_version = GD_OP_VERSION_9_0,
+        .value = "off",
+        .validate_fn = validate_boolean,
+    },
     {
         .key = "transport.listen-backlog",
         .voltype = "protocol/server",
@@ -2025,6 +2066,14 @@ struct volopt_map_entry glusterd_volopt_map[] = {
         .type = NO_DOC,
         .op_version = 3,
     },
+    {
+        .key = "features.quota-reservation-lease",
+        .voltype = "features/quota",
+        .option = "reservation-lease",
+        .value = "0",
+        .type = DOC,
+        .op_version = GD_OP_VERSION_9_0,
+    },
     {
         .key = "features.alert-time",
         .voltype = "features/quota",
@@ -2041,6 +2090,22 @@ struct volopt_map_entry glusterd_volopt_map[] = {
         .op_version = 2,
         .validate_fn = validate_quota,
     },
+    {
+        .key = "features.quota-flush-interval",
+        .voltype = "features/marker",
+        .option = "quota-flush-interval",
+        .value = "0",
+        .type = DOC,
+        .op_version = GD_OP_VERSION_9_0,
+    },
+    {
+        .key = "features.quota-flush-threshold",
+        .voltype = "features/marker",
+        .option = "quota-flush-threshold",
+        .value = "4MB",
+        .type = DOC,
+        .op_version = GD_OP_VERSION_9_0,
+    },
 
     /* Marker xlator options */
     {.key = VKEY_MARKER_XTIME,
@@ -2710,6 +2775,14 @@ struct volopt_map_entry glusterd_volopt_map[] = {
         .op_version = GD_OP_VERSION_8_0,
         .type = NO_DOC,
     },
+    {
+        .key = "features.signature-type",
+        .voltype = "features/bit-rot",
+        .value = BR_SIGNATURE_HASH,
+        .option = "signature-type",
+        .op_version = GD_OP_VERSION_9_0,
+        .type = NO_DOC,
+    },
     /* Upcall translator options */
     /* Upcall translator options */
     {
@@ -2843,7 +2916,7 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .voltype = "cluster/replicate",
      .value = "off",
      .type = DOC,
-     .op_version = GD_OP_VERSION_3_8_4,
+     .op_version = GD_OP_VERSION_9_0,
      .flags = VOLOPT_FLAG_CLIENT_OPT},
     {.key = "performance.parallel-readdir",
      .voltype = "performance/readdir-ahead",
@@ -3104,6 +3177,16 @@ struct volopt_map_entry glusterd_volopt_map[] = {
      .option = "global-threading",
      .value = "off",
      .op_version = GD_OP_VERSION_6_0},
+    {.key = VKEY_CONFIG_EVENT_PINNING,
+     .voltype = "debug/io-stats",
+     .option = "!event-pinning",
+     .value = "off",
+     .validate_fn = validate_boolean,
+     .description = "Each connection to the bricks is polled by a single "
+                    "event thread with its own epoll instance; connections "
+                    "are rebalanced when server.event-threads changes. "
+                    "Takes effect when the bricks are restarted.",
+     .op_version = GD_OP_VERSION_9_0},
     {.key = VKEY_CONFIG_CLIENT_THREADS,
      .voltype = "debug/io-stats",
      .option = "!client-threads",
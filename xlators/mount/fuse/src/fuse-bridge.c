@@ -11,6 +11,7 @@
 #include <config.h>
 
 #include <sys/wait.h>
+#include <sys/ioctl.h>
 #include "fuse-bridge.h"
 #include <glusterfs/glusterfs.h>
 #include <glusterfs/byte-order.h>
@@ -345,6 +346,42 @@ check_and_dump_fuse_W(fuse_private_t *priv, struct iovec *iov_out, int count,
     return 0;
 }
 
+/* the channel a request was read from, see struct fuse_chan */
+static int
+fuse_chan_fd(fuse_private_t *priv, fuse_in_header_t *finh)
+{
+    if (!priv->fuse_chans)
+        return priv->fd;
+
+    return priv->fuse_chans[finh->padding].fd;
+}
+
+/* Notes the channel of a request in fuse_chan_history. */
+static void
+fuse_chan_record(fuse_private_t *priv, fuse_in_header_t *finh)
+{
+    GF_ATOMIC_SWAP(priv->fuse_chan_history[finh->unique % FUSE_CHAN_HISTORY],
+                   (finh->unique << FUSE_CHAN_IDX_BITS) | finh->padding);
+}
+
+/* The channel the request @unique was read from, if it is still in
+ * fuse_chan_history, or else the one @finh was read from. */
+static int
+fuse_chan_fd_of(fuse_private_t *priv, uint64_t unique, fuse_in_header_t *finh)
+{
+    uint64_t rec = 0;
+
+    if (!priv->fuse_chans)
+        return priv->fd;
+
+    rec = GF_ATOMIC_GET(priv->fuse_chan_history[unique % FUSE_CHAN_HISTORY]);
+    if ((rec >> FUSE_CHAN_IDX_BITS) !=
+        (unique & (UINT64_MAX >> FUSE_CHAN_IDX_BITS)))
+        return fuse_chan_fd(priv, finh);
+
+    return priv->fuse_chans[rec & ((1 << FUSE_CHAN_IDX_BITS) - 1)].fd;
+}
+
 /*
  * iov_out should contain a fuse_out_header at zeroth position.
  * The error value of this header is sent to kernel.
@@ -370,7 +407,7 @@ send_fuse_iov(xlator_t *this, fuse_in_header_t *finh, struct iovec *iov_out,
         fouh->len += iov_out[i].iov_len;
     fouh->unique = finh->unique;
 
-    res = sys_writev(priv->fd, iov_out, count);
+    res = sys_writev(fuse_chan_fd(priv, finh), iov_out, count);
     gf_log("glusterfs-fuse", GF_LOG_TRACE, "writev() result %d/%d %s", res,
            fouh->len, res == -1 ? strerror(errno) : "");
 
@@ -785,6 +822,9 @@ fuse_interrupt(xlator_t *this, fuse_in_header_t *finh, void *msg,
         dmsg->fuse_out_header.unique = finh->unique;
         dmsg->fuse_out_header.len = sizeof(dmsg->fuse_out_header);
         dmsg->fuse_out_header.error = -EAGAIN;
+        /* the kernel looks for the interrupted request among those read
+         * from the channel the reply is written to */
+        dmsg->fd = fuse_chan_fd_of(this->private, fii->unique, finh);
         if (ENOENT < ERRNOMASK_MAX)
             MASK_ERRNO(dmsg->errnomask, ENOENT);
         timespec_now(&dmsg->scheduled_ts);
@@ -5066,7 +5106,7 @@ timed_response_loop(void *data)
                                  sizeof(struct fuse_out_header)};
         iovs[1] = (struct iovec){dmsg->fuse_message_body,
                                  len - sizeof(struct fuse_out_header)};
-        rv = sys_writev(priv->fd, iovs, 2);
+        rv = sys_writev(dmsg->fd, iovs, 2);
         check_and_dump_fuse_W(priv, iovs, 2, rv, dmsg->errnomask);
 
         fuse_timed_message_free(dmsg);
@@ -5202,6 +5242,22 @@ fuse_init(xlator_t *this, fuse_in_header_t *finh, void *msg,
         }
     }
 
+#if FUSE_KERNEL_MINOR_VERSION >= 28
+    /* without FUSE_MAX_PAGES the kernel sends at most 32 pages per request,
+     * whatever max_write says */
+    if (fini->minor >= 28 && (fini->flags & FUSE_MAX_PAGES) &&
+        priv->max_write > fino.max_write) {
+        fino.flags |= FUSE_MAX_PAGES;
+        fino.max_write = priv->max_write;
+        fino.max_readahead = priv->max_write;
+        fino.max_pages = (priv->max_write + sysconf(_SC_PAGESIZE) - 1) /
+                         sysconf(_SC_PAGESIZE);
+        gf_log("glusterfs-fuse", GF_LOG_DEBUG,
+               "requests of up to %u bytes (%u pages)", fino.max_write,
+               fino.max_pages);
+    }
+#endif
+
     if (fini->minor >= 13) {
         fino.max_background = priv->background_qlen;
         fino.congestion_threshold = priv->congestion_threshold;
@@ -5268,6 +5324,13 @@ fuse_init(xlator_t *this, fuse_in_header_t *finh, void *msg,
         fino.flags |= FUSE_ASYNC_DIO;
 #endif
 
+#if FUSE_KERNEL_MINOR_VERSION >= 25
+    /* lookups and readdirs of one directory need not wait for each other,
+     * each is answered on its own */
+    if (fini->minor >= 25 && (fini->flags & FUSE_PARALLEL_DIROPS))
+        fino.flags |= FUSE_PARALLEL_DIROPS;
+#endif
+
     size = sizeof(fino);
 #if FUSE_KERNEL_MINOR_VERSION >= 23
     /* FUSE 7.23 and newer added attributes to the fuse_init_out struct */
@@ -5284,6 +5347,9 @@ fuse_init(xlator_t *this, fuse_in_header_t *finh, void *msg,
     }
 #endif
 
+    /* the readers size their buffers from it from now on */
+    priv->init_max_write = fino.max_write;
+
     ret = send_fuse_data(this, finh, &fino, size);
     if (ret == 0)
         gf_log("glusterfs-fuse", GF_LOG_INFO,
@@ -5889,6 +5955,11 @@ fuse_graph_sync(xlator_t *this)
 
     priv = this->private;
 
+    /* checked on every request by every reader; a graph set up right after
+     * this is picked up with the next one */
+    if (!priv->next_graph)
+        return 0;
+
     pthread_mutex_lock(&priv->sync_mutex);
     {
         if (!priv->next_graph)
@@ -5979,19 +6050,55 @@ fuse_dispatch(xlator_t *xl, gf_async_t *async)
 
     priv->fuse_ops[finh->opcode](xl, finh, fasync->msg, iobuf);
 
-    iobuf_unref(iobuf);
+    /* only WRITE requests carry their payload in an iobuf */
+    if (iobuf)
+        iobuf_unref(iobuf);
 }
 
 /* We need 512 extra buffer size for BATCH_FORGET fop. By tests, it is
  * found to be reduces 'REALLOC()' in the loop */
 #define FUSE_EXTRA_ALLOC 512
 
+/* Give a reader its own channel, so that requests are handed out to the
+ * readers by the kernel instead of all of them contending for the mount
+ * fd. Only possible once the mount is done; on failure the reader just
+ * keeps sharing the mount fd. */
+static void
+fuse_chan_clone(xlator_t *this, fuse_chan_t *chan)
+{
+#ifdef FUSE_DEV_IOC_CLONE
+    fuse_private_t *priv = this->private;
+    uint32_t masterfd = priv->fd;
+    int fd = -1;
+
+    fd = sys_open("/dev/fuse", O_RDWR | O_CLOEXEC, 0);
+    if (fd == -1)
+        goto err;
+
+    if (ioctl(fd, FUSE_DEV_IOC_CLONE, &masterfd) == -1) {
+        sys_close(fd);
+        goto err;
+    }
+
+    chan->fd = fd;
+    gf_log(this->name, GF_LOG_DEBUG, "reader %u reads from cloned fd %d",
+           chan->idx, fd);
+    return;
+
+err:
+    gf_log(this->name, GF_LOG_INFO,
+           "could not clone /dev/fuse (%s), reader %u shares the mount fd",
+           strerror(errno), chan->idx);
+#endif
+}
+
 static void *
 fuse_thread_proc(void *data)
 {
     char *mount_point = NULL;
     xlator_t *this = NULL;
     fuse_private_t *priv = NULL;
+    fuse_chan_t *chan = NULL;
     ssize_t res = 0;
     struct iobuf *iobuf = NULL;
     fuse_in_header_t *finh = NULL;
@@ -6007,22 +6114,29 @@ fuse_thread_proc(void *data)
     struct pollfd pfd[2] = {{
         0,
     }};
-    uint32_t psize;
-
-    this = data;
+    uint32_t psize = 0;
+    uint32_t negotiated = 0;
+    uint32_t wsize = 0;
+    struct iobuf *wbuf = NULL;
+    gf_boolean_t clone = _gf_false;
+
+    chan = data;
+    this = chan->this;
     priv = this->private;
+    clone = (chan->idx > 0);
 
     THIS = this;
 
-    psize = ((struct iobuf_pool *)this->ctx->iobuf_pool)->default_page_size;
     priv->msg0_len_p = &msg0_size;
 
     for (;;) {
         /* THIS has to be reset here */
         THIS = this;
 
-        pthread_mutex_lock(&priv->sync_mutex);
-        {
+        /* mount_finished never goes back to false, so once it is set the
+         * readers get to readv without taking sync_mutex */
+        if (!priv->mount_finished) {
+            pthread_mutex_lock(&priv->sync_mutex);
             if (!priv->mount_finished) {
                 memset(pfd, 0, sizeof(pfd));
                 pfd[0].fd = priv->status_pipe[0];
@@ -6052,8 +6166,13 @@ fuse_thread_proc(void *data)
                     continue;
                 }
             }
+            pthread_mutex_unlock(&priv->sync_mutex);
+        }
+
+        if (clone && priv->mount_finished) {
+            clone = _gf_false;
+            fuse_chan_clone(this, chan);
         }
-        pthread_mutex_unlock(&priv->sync_mutex);
 
         /*
          * We don't want to block on readv while we're still waiting
@@ -6066,11 +6185,27 @@ fuse_thread_proc(void *data)
         if (priv->init_recvd)
             fuse_graph_sync(this);
 
-        /* TODO: This place should always get maximum supported buffer
-           size from 'fuse', which is as of today 128KB. If we bring in
-           support for higher block sizes support, then we should be
-           changing this one too */
-        iobuf = iobuf_get(this->ctx->iobuf_pool);
+        /* The kernel never sends more than the max_write fuse_init()
+           answers with. Until then it may be offered up to max_write. */
+        if (!psize || negotiated != priv->init_max_write) {
+            if (iobuf) {
+                iobuf_unref(iobuf);
+                iobuf = NULL;
+            }
+            negotiated = priv->init_max_write;
+            psize = negotiated;
+            if (!psize) {
+                psize = ((struct iobuf_pool *)this->ctx->iobuf_pool)
+                            ->default_page_size;
+                if (priv->max_write > psize)
+                    psize = priv->max_write;
+            }
+        }
+
+        /* Only a WRITE may keep the buffer it was read into, anything else
+           leaves it to be reused for the next request */
+        if (!iobuf)
+            iobuf = iobuf_get2(this->ctx->iobuf_pool, psize);
 
         /* Add extra 512 byte to the first iov so that it can
          * accommodate "ordinary" non-write requests. It's not
@@ -6084,9 +6219,8 @@ fuse_thread_proc(void *data)
 
         if (!iobuf || !iov_in[0].iov_base) {
             gf_log(this->name, GF_LOG_ERROR, "Out of memory");
-            if (iobuf)
-                iobuf_unref(iobuf);
             GF_FREE(iov_in[0].iov_base);
+            iov_in[0].iov_base = NULL;
             sleep(10);
             continue;
         }
@@ -6096,7 +6230,7 @@ fuse_thread_proc(void *data)
         iov_in[0].iov_len = msg0_size;
         iov_in[1].iov_len = psize;
 
-        res = sys_readv(priv->fd, iov_in, 2);
+        res = sys_readv(chan->fd, iov_in, 2);
 
         if (res == -1) {
             if (errno == ENODEV || errno == EBADF) {
@@ -6141,6 +6275,11 @@ fuse_thread_proc(void *data)
         }
 
         finh = (fuse_in_header_t *)iov_in[0].iov_base;
+        /* a reader that has not cloned its channel yet answers on the
+         * mount fd, which is channel 0 */
+        finh->padding = (chan->fd == priv->fd) ? 0 : chan->idx;
+        if (priv->fuse_chans)
+            fuse_chan_record(priv, finh);
 
         if (res != finh->len
 #ifdef GF_DARWIN_HOST_OS
@@ -6171,9 +6310,21 @@ fuse_thread_proc(void *data)
         if (priv->init_recvd)
             fuse_graph_sync(this);
 
-        if (finh->opcode == FUSE_WRITE)
+        if (finh->opcode == FUSE_WRITE) {
             msg = iov_in[1].iov_base;
-        else {
+
+            /* The buffer stays with the WRITE until it has been written
+               back. A small payload is copied to a buffer of its size,
+               so that it does not hold one of max_write. */
+            wsize = res - iov_in[0].iov_len;
+            if (wsize && wsize <= psize / 4) {
+                wbuf = iobuf_get2(this->ctx->iobuf_pool, wsize);
+                if (wbuf) {
+                    memcpy(wbuf->ptr, msg, wsize);
+                    msg = wbuf->ptr;
+                }
+            }
+        } else {
             if (res > msg0_size + FUSE_EXTRA_ALLOC) {
                 void *b = GF_REALLOC(iov_in[0].iov_base,
                                      sizeof(fuse_async_t) + res);
@@ -6202,25 +6353,32 @@ fuse_thread_proc(void *data)
         if (finh->opcode >= FUSE_OP_HIGH) {
             /* turn down MacFUSE specific messages */
             fuse_enosys(this, finh, msg, NULL);
-            iobuf_unref(iobuf);
         } else {
             fasync = iov_in[0].iov_base + iov_in[0].iov_len;
             fasync->finh = finh;
             fasync->msg = msg;
-            fasync->iobuf = iobuf;
+            fasync->iobuf = NULL;
+            if (wbuf) {
+                fasync->iobuf = wbuf;
+                wbuf = NULL;
+            } else if (finh->opcode == FUSE_WRITE) {
+                fasync->iobuf = iobuf;
+                iobuf = NULL;
+            }
             gf_async(&fasync->async, this, fuse_dispatch);
         }
 
         continue;
 
     cont_err:
-        iobuf_unref(iobuf);
         GF_FREE(iov_in[0].iov_base);
         iov_in[0].iov_base = NULL;
     }
 
     if (iov_in[0].iov_base)
         GF_FREE(iov_in[0].iov_base);
+    if (iobuf)
+        iobuf_unref(iobuf);
 
     /*
      * We could be in all sorts of states with respect to iobuf and iov_in
@@ -6262,6 +6420,8 @@ int32_t
 fuse_priv_dump(xlator_t *this)
 {
     fuse_private_t *private = NULL;
+    uint32_t cloned = 0;
+    uint32_t i;
 
     if (!this)
         return -1;
@@ -6297,6 +6457,13 @@ fuse_priv_dump(xlator_t *this)
                        private->invalidate_count);
     gf_proc_dump_write("use_readdirp", "%d", private->use_readdirp);
 
+    if (private->fuse_chans) {
+        for (i = 0; i < private->reader_thread_count; i++)
+            if (private->fuse_chans[i].fd != private->fd)
+                cloned++;
+        gf_proc_dump_write("cloned_channels", "%u", cloned);
+    }
+
     return 0;
 }
 
@@ -6466,9 +6633,27 @@ notify(xlator_t *this, int32_t event, void *data, ...)
                 ->fuse_thread = GF_CALLOC(private->reader_thread_count,
                                           sizeof(pthread_t),
                                           gf_fuse_mt_pthread_t);
+               private
+                ->fuse_chans = GF_CALLOC(private->reader_thread_count,
+                                         sizeof(fuse_chan_t),
+                                         gf_fuse_mt_fuse_chan_t);
+                if (private->fuse_chans) {
+                    for (i = 0; i < private->reader_thread_count; i++)
+                       private
+                        ->fuse_chans[i] = (fuse_chan_t){this, private->fd, i};
+                } else {
+                    gf_log(this->name, GF_LOG_WARNING,
+                           "could not allocate the reader channels, all "
+                           "readers share the mount fd");
+                }
+               private
+                ->fuse_chan0 = (fuse_chan_t){this, private->fd, 0};
                 for (i = 0; i < private->reader_thread_count; i++) {
-                    ret = gf_thread_create(&private->fuse_thread[i], NULL,
-                                           fuse_thread_proc, this, "fuseproc");
+                    ret = gf_thread_create(
+                        &private->fuse_thread[i], NULL, fuse_thread_proc,
+                        private->fuse_chans ? &private->fuse_chans[i]
+                                            : &private->fuse_chan0,
+                        "fuseproc");
                     if (ret != 0) {
                         gf_log(this->name, GF_LOG_DEBUG,
                                "pthread_create() failed (%s)", strerror(errno));
@@ -6886,6 +7071,8 @@ init(xlator_t *this_xl)
     GF_OPTION_INIT("fuse-dev-eperm-ratelimit-ns",
                    priv->fuse_dev_eperm_ratelimit_ns, uint32, cleanup_exit);
 
+    GF_OPTION_INIT("max-write", priv->max_write, size_uint64, cleanup_exit);
+
     /* user has set only background-qlen, not congestion-threshold,
        use the fuse kernel driver formula to set congestion. ie, 75% */
     if (dict_get(this_xl->options, "background-qlen") &&
@@ -6938,11 +7125,11 @@ init(xlator_t *this_xl)
         goto cleanup_exit;
     }
 
-    gf_asprintf(&mnt_args, "%s%s%s%sallow_other,max_read=131072",
+    gf_asprintf(&mnt_args, "%s%s%s%sallow_other,max_read=%" PRIu64,
                 priv->acl ? "" : "default_permissions,",
                 priv->read_only ? "ro," : "",
                 priv->fuse_mountopts ? priv->fuse_mountopts : "",
-                priv->fuse_mountopts ? "," : "");
+                priv->fuse_mountopts ? "," : "", priv->max_write);
     if (!mnt_args)
         goto cleanup_exit;
 
@@ -7235,6 +7422,16 @@ struct volume_options options[] = {
         .description = "Rate limit reading from fuse device upon EPERM "
                        "failure.",
     },
+    {
+        .key = {"max-write"},
+        .type = GF_OPTION_TYPE_SIZET,
+        .default_value = "1MB",
+        .min = 128 * GF_UNIT_KB,
+        .max = 4 * GF_UNIT_MB,
+        .description = "Largest read or write request the kernel is asked "
+                       "to send. Kernels without FUSE_MAX_PAGES support "
+                       "stay at 128KB.",
+    },
     {.key = {NULL}},
 };
 
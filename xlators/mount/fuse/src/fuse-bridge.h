@@ -42,30 +42,7 @@
 
 #if defined(GF_LINUX_HOST_OS) || defined(__FreeBSD__) || defined(__NetBSD__)
 
-/*
- * TODO:
- * So, with the addition of copy_file_range support, it might
- * require a bump up of fuse kernel minor version (like it was
- * done when support for lseek fop was added. But, as of now,
- * the copy_file_range support has just landed in upstream
- * kernel fuse module. So, until, there is a release of that
- * fuse as part of a kernel, the FUSE_KERNEL_MINOR_VERSION
- * from fuse_kernel.h in the contrib might not be changed.
- * If so, then the highest op available should be based on
- * the current minor version (which is 24). So, selectively
- * determine. When, the minor version is changed to 28 in
- * fuse_kernel.h from contrib (because in upstream linux
- * kernel source tree, the kernel minor version which
- * contains support for copy_file_range is 28), then remove
- * the reference to FUSE_LSEEK below and just determine
- * FUSE_OP_HIGH based on copy_file_range.
- */
-#if FUSE_KERNEL_MINOR_VERSION >= 28
 #define FUSE_OP_HIGH (FUSE_COPY_FILE_RANGE + 1)
-#else
-#define FUSE_OP_HIGH (FUSE_LSEEK + 1)
-#endif
-
 #endif
 #ifdef GF_DARWIN_HOST_OS
 #define FUSE_OP_HIGH (FUSE_DESTROY + 1)
@@ -92,6 +69,23 @@ enum fusedev_errno {
     FUSEDEV_EMAXPLUS
 };
 
+/* A reader thread and the /dev/fuse channel it reads from. Every request
+ * has to be answered on the channel it was read from, so the reader notes
+ * the channel's index in the (otherwise unused) padding of the request
+ * header. */
+struct fuse_chan {
+    xlator_t *this;
+    int fd; /* the mount fd, or a clone of it */
+    uint32_t idx;
+};
+typedef struct fuse_chan fuse_chan_t;
+
+/* The delayed reply to an INTERRUPT has to go to the channel of the
+ * interrupted request. The channels of the last requests are kept by
+ * unique id, as (unique << FUSE_CHAN_IDX_BITS) | channel index. */
+#define FUSE_CHAN_HISTORY 4096
+#define FUSE_CHAN_IDX_BITS 6 /* up to 64 reader threads */
+
 struct fuse_private {
     int fd;
     uint32_t proto_minor;
@@ -101,6 +95,9 @@ struct fuse_private {
     struct iobuf *iobuf;
 
     pthread_t *fuse_thread;
+    fuse_chan_t *fuse_chans;
+    fuse_chan_t fuse_chan0; /* shared by the readers without fuse_chans */
+    gf_atomic_uint64_t fuse_chan_history[FUSE_CHAN_HISTORY];
     uint32_t reader_thread_count;
     char fuse_thread_started;
 
@@ -208,6 +205,12 @@ struct fuse_private {
     uint32_t invalidate_limit;
     uint32_t fuse_dev_eperm_ratelimit_ns;
 
+    /* Largest request payload asked of the kernel, used when it supports
+     * FUSE_MAX_PAGES; /dev/fuse is read into buffers of this size. */
+    uint64_t max_write;
+    /* max_write fuse_init() answered the kernel with, 0 until then */
+    uint32_t init_max_write;
+
     /* counters for fusdev errnos */
     uint8_t fusedev_errno_cnt[FUSEDEV_EMAXPLUS];
     pthread_mutex_t fusedev_errno_cnt_mutex;
@@ -236,6 +239,7 @@ struct fuse_timed_message {
     void *fuse_message_body;
     struct timespec scheduled_ts;
     errnomask_t errnomask;
+    int fd;
     struct list_head next;
 };
 typedef struct fuse_timed_message fuse_timed_message_t;
@@ -116,7 +116,7 @@ ioc_update_pages(call_frame_t *frame, ioc_inode_t *ioc_inode,
                                count, write_offset, page_end - page_offset);
             } else if (trav) {
                 if (!trav->waitq)
-                    ioc_inode->table->cache_used -= __ioc_page_destroy(trav);
+                    ioc_cache_account(ioc_inode, -__ioc_page_destroy(trav));
             }
 
             if (trav_offset == rounded_offset)
@@ -182,13 +182,8 @@ ioc_inode_flush(ioc_inode_t *ioc_inode)
     }
     ioc_inode_unlock(ioc_inode);
 
-    if (destroy_size) {
-        ioc_table_lock(ioc_inode->table);
-        {
-            ioc_inode->table->cache_used -= destroy_size;
-        }
-        ioc_table_unlock(ioc_inode->table);
-    }
+    if (destroy_size)
+        ioc_cache_account(ioc_inode, -destroy_size);
 
     return;
 }
@@ -266,13 +261,6 @@ ioc_inode_update(xlator_t *this, inode_t *inode, char *path, struct iatt *iabuf)
         ioc_inode_flush(ioc_inode);
     }
 
-    ioc_table_lock(ioc_inode->table);
-    {
-        list_move_tail(&ioc_inode->inode_lru,
-                       &table->inode_lru[ioc_inode->weight]);
-    }
-    ioc_table_unlock(ioc_inode->table);
-
 out:
     return 0;
 }
@@ -431,13 +419,8 @@ ioc_cache_validate_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
         local_stbuf = NULL;
     }
 
-    if (destroy_size) {
-        ioc_table_lock(ioc_inode->table);
-        {
-            ioc_inode->table->cache_used -= destroy_size;
-        }
-        ioc_table_unlock(ioc_inode->table);
-    }
+    if (destroy_size)
+        ioc_cache_account(ioc_inode, -destroy_size);
 
     if (op_ret < 0)
         local_stbuf = NULL;
@@ -619,13 +602,6 @@ ioc_open_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
             goto out;
         }
 
-        ioc_table_lock(ioc_inode->table);
-        {
-            list_move_tail(&ioc_inode->inode_lru,
-                           &table->inode_lru[ioc_inode->weight]);
-        }
-        ioc_table_unlock(ioc_inode->table);
-
         ioc_inode_lock(ioc_inode);
         {
             if ((table->min_file_size > ioc_inode->ia_size) ||
@@ -924,11 +900,7 @@ ioc_need_prune(ioc_table_t *table)
 {
     int64_t cache_difference = 0;
 
-    ioc_table_lock(table);
-    {
-        cache_difference = table->cache_used - table->cache_size;
-    }
-    ioc_table_unlock(table);
+    cache_difference = GF_ATOMIC_GET(table->cache_used) - table->cache_size;
 
     if (cache_difference > 0)
         return 1;
@@ -996,6 +968,7 @@ ioc_dispatch_requests(call_frame_t *frame, ioc_inode_t *ioc_inode, fd_t *fd,
                 /* page not in cache, we need to generate page
                  * fault
                  */
+                GF_ATOMIC_INC(ioc_inode->shard->misses);
                 trav = __ioc_page_create(ioc_inode, trav_offset);
                 fault = 1;
                 if (!trav) {
@@ -1006,8 +979,18 @@ ioc_dispatch_requests(call_frame_t *frame, ioc_inode_t *ioc_inode, fd_t *fd,
                     ioc_inode_unlock(ioc_inode);
                     goto out;
                 }
+            } else {
+                GF_ATOMIC_INC(ioc_inode->shard->hits);
+                /* reading again what was already read from the page
+                 * protects it, reading on past it is a sequential
+                 * scan which must not keep the page from eviction */
+                if (!trav->referenced && (local_offset < trav->served))
+                    __ioc_page_protect(trav, _gf_true);
             }
 
+            if (trav->served < local_offset + trav_size)
+                trav->served = local_offset + trav_size;
+
             __ioc_wait_on_page(trav, frame, local_offset, trav_size);
 
             if (trav->ready) {
@@ -1107,7 +1090,6 @@ ioc_readv(call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
     uint64_t tmp_ioc_inode = 0;
     ioc_inode_t *ioc_inode = NULL;
     ioc_local_t *local = NULL;
-    uint32_t weight = 0;
     ioc_table_t *table = NULL;
     int32_t op_errno = EINVAL;
 
@@ -1188,15 +1170,6 @@ ioc_readv(call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
                  "= %" PRId64 " && size = %" GF_PRI_SIZET "",
                  frame, offset, size);
 
-    weight = ioc_inode->weight;
-
-    ioc_table_lock(ioc_inode->table);
-    {
-        list_move_tail(&ioc_inode->inode_lru,
-                       &ioc_inode->table->inode_lru[weight]);
-    }
-    ioc_table_unlock(ioc_inode->table);
-
     ioc_dispatch_requests(frame, ioc_inode, fd, offset, size);
     return 0;
 
@@ -1732,8 +1705,10 @@ int32_t
 init(xlator_t *this)
 {
     ioc_table_t *table = NULL;
+    ioc_shard_t *shard = NULL;
     dict_t *xl_options = NULL;
     uint32_t index = 0;
+    uint32_t i = 0;
     int32_t ret = -1;
     glusterfs_ctx_t *ctx = NULL;
     data_t *data = 0;
@@ -1792,8 +1767,6 @@ init(xlator_t *this)
     }
     table->max_pri++;
 
-    INIT_LIST_HEAD(&table->inodes);
-
     if ((table->max_file_size <= UINT64_MAX) &&
         (table->min_file_size > table->max_file_size)) {
         gf_smsg("io-cache", GF_LOG_ERROR, 0, IO_CACHE_MSG_INVALID_ARGUMENT,
@@ -1802,14 +1775,30 @@ init(xlator_t *this)
         goto out;
     }
 
-    table->inode_lru = GF_CALLOC(table->max_pri, sizeof(struct list_head),
-                                 gf_ioc_mt_list_head);
-    if (table->inode_lru == NULL) {
-        goto out;
-    }
+    GF_ATOMIC_INIT(table->cache_used, 0);
+    GF_ATOMIC_INIT(table->protected, 0);
+    GF_ATOMIC_INIT(table->prune_hand, 0);
 
-    for (index = 0; index < (table->max_pri); index++)
-        INIT_LIST_HEAD(&table->inode_lru[index]);
+    for (i = 0; i < IOC_TABLE_SHARDS; i++) {
+        shard = &table->shards[i];
+
+        shard->inode_lru = GF_CALLOC(table->max_pri, sizeof(struct list_head),
+                                     gf_ioc_mt_list_head);
+        if (shard->inode_lru == NULL) {
+            goto out;
+        }
+
+        for (index = 0; index < (table->max_pri); index++)
+            INIT_LIST_HEAD(&shard->inode_lru[index]);
+
+        INIT_LIST_HEAD(&shard->inodes);
+        pthread_mutex_init(&shard->shard_lock, NULL);
+        GF_ATOMIC_INIT(shard->cache_used, 0);
+        GF_ATOMIC_INIT(shard->protected, 0);
+        GF_ATOMIC_INIT(shard->hits, 0);
+        GF_ATOMIC_INIT(shard->misses, 0);
+        GF_ATOMIC_INIT(shard->evictions, 0);
+    }
 
     this->local_pool = mem_pool_new(ioc_local_t, 64);
     if (!this->local_pool) {
@@ -1840,7 +1829,12 @@ init(xlator_t *this)
 out:
     if (ret == -1) {
         if (table != NULL) {
-            GF_FREE(table->inode_lru);
+            for (i = 0; i < IOC_TABLE_SHARDS; i++) {
+                if (table->shards[i].inode_lru == NULL)
+                    break;
+                GF_FREE(table->shards[i].inode_lru);
+                pthread_mutex_destroy(&table->shards[i].shard_lock);
+            }
             GF_FREE(table);
         }
     }
@@ -2029,6 +2023,44 @@ out:
     return ret;
 }
 
+static uint32_t
+ioc_shard_dump(ioc_shard_t *shard, int index)
+{
+    uint32_t inode_count = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    char key[GF_DUMP_MAX_BUF_LEN] = {
+        0,
+    };
+
+    /* the counters are atomic, only the inode count needs the lock */
+    if (pthread_mutex_trylock(&shard->shard_lock) == 0) {
+        inode_count = shard->inode_count;
+        pthread_mutex_unlock(&shard->shard_lock);
+    }
+
+    hits = GF_ATOMIC_GET(shard->hits);
+    misses = GF_ATOMIC_GET(shard->misses);
+
+    snprintf(key, sizeof(key), "shard[%d].inode_count", index);
+    gf_proc_dump_write(key, "%u", inode_count);
+    snprintf(key, sizeof(key), "shard[%d].cache_used", index);
+    gf_proc_dump_write(key, "%" PRId64, GF_ATOMIC_GET(shard->cache_used));
+    snprintf(key, sizeof(key), "shard[%d].protected", index);
+    gf_proc_dump_write(key, "%" PRId64, GF_ATOMIC_GET(shard->protected));
+    snprintf(key, sizeof(key), "shard[%d].hits", index);
+    gf_proc_dump_write(key, "%" PRIu64, hits);
+    snprintf(key, sizeof(key), "shard[%d].misses", index);
+    gf_proc_dump_write(key, "%" PRIu64, misses);
+    snprintf(key, sizeof(key), "shard[%d].hit_ratio", index);
+    gf_proc_dump_write(key, "%.2f",
+                       (hits + misses) ? (double)hits / (hits + misses) : 0.0);
+    snprintf(key, sizeof(key), "shard[%d].evictions", index);
+    gf_proc_dump_write(key, "%" PRIu64, GF_ATOMIC_GET(shard->evictions));
+
+    return inode_count;
+}
+
 int
 ioc_priv_dump(xlator_t *this)
 {
@@ -2038,6 +2070,8 @@ ioc_priv_dump(xlator_t *this)
     };
     int ret = -1;
     gf_boolean_t add_section = _gf_false;
+    uint32_t inode_count = 0;
+    int i = 0;
 
     if (!this || !this->private)
         goto out;
@@ -2054,13 +2088,20 @@ ioc_priv_dump(xlator_t *this)
     {
         gf_proc_dump_write("page_size", "%" PRIu64, priv->page_size);
         gf_proc_dump_write("cache_size", "%" PRIu64, priv->cache_size);
-        gf_proc_dump_write("cache_used", "%" PRIu64, priv->cache_used);
-        gf_proc_dump_write("inode_count", "%u", priv->inode_count);
+        gf_proc_dump_write("cache_used", "%" PRId64,
+                           GF_ATOMIC_GET(priv->cache_used));
+        gf_proc_dump_write("protected", "%" PRId64,
+                           GF_ATOMIC_GET(priv->protected));
         gf_proc_dump_write("cache_timeout", "%u", priv->cache_timeout);
         gf_proc_dump_write("min-file-size", "%" PRIu64, priv->min_file_size);
         gf_proc_dump_write("max-file-size", "%" PRIu64, priv->max_file_size);
     }
     pthread_mutex_unlock(&priv->table_lock);
+
+    for (i = 0; i < IOC_TABLE_SHARDS; i++)
+        inode_count += ioc_shard_dump(&priv->shards[i], i);
+
+    gf_proc_dump_write("inode_count", "%u", inode_count);
 out:
     if (ret && priv) {
         if (!add_section) {
@@ -2092,6 +2133,7 @@ fini(xlator_t *this)
 {
     ioc_table_t *table = NULL;
     struct ioc_priority *curr = NULL, *tmp = NULL;
+    uint32_t i = 0;
 
     table = this->private;
 
@@ -2112,15 +2154,11 @@ fini(xlator_t *this)
         GF_FREE(curr);
     }
 
-    /* inode_lru and inodes list can be empty in case fini() is
-     * called soon after init()? Hence commenting the below asserts.
-     */
-    /*for (i = 0; i < table->max_pri; i++) {
-            GF_ASSERT (list_empty (&table->inode_lru[i]));
+    for (i = 0; i < IOC_TABLE_SHARDS; i++) {
+        GF_FREE(table->shards[i].inode_lru);
+        pthread_mutex_destroy(&table->shards[i].shard_lock);
     }
 
-    GF_ASSERT (list_empty (&table->inodes));
-    */
     pthread_mutex_destroy(&table->table_lock);
     GF_FREE(table);
 
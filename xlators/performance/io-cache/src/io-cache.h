@@ -25,8 +25,10 @@
 #define IOC_PAGE_SIZE (1024 * 128) /* 128KB */
 #define IOC_CACHE_SIZE (32 * 1024 * 1024)
 #define IOC_PAGE_TABLE_BUCKET_COUNT 1
+#define IOC_TABLE_SHARDS 16
 
 struct ioc_table;
+struct ioc_shard;
 struct ioc_local;
 struct ioc_page;
 struct ioc_inode;
@@ -112,11 +114,15 @@ struct ioc_page {
     pthread_mutex_t page_lock;
     int32_t op_errno;
     char stale;
+    char referenced; /* read again, protected from eviction */
+    off_t served;    /* end of the data already read from this page */
 };
 
 struct ioc_cache {
     rbthash_table_t *page_table;
-    struct list_head page_lru;
+    struct list_head page_lru; /* clock of pages */
+    uint32_t page_count;
+    uint32_t protected_count;
     time_t mtime;           /*
                              * seconds component of file mtime
                              */
@@ -128,6 +134,7 @@ struct ioc_cache {
 
 struct ioc_inode {
     struct ioc_table *table;
+    struct ioc_shard *shard;
     off_t ia_size;
     struct ioc_cache cache;
     struct list_head inode_list; /*
@@ -144,26 +151,43 @@ struct ioc_inode {
     inode_t *inode;
 };
 
+/*
+ * ioc_shard - a slice of the inode table, picked by a hash of the inode
+ *             address (see ioc_shard_index()), with its own lock, clock
+ *             lists and accounting
+ */
+struct ioc_shard {
+    pthread_mutex_t shard_lock;
+    struct list_head inodes;     /* list of inodes cached */
+    struct list_head *inode_lru; /* clock of inodes, per priority */
+    uint32_t inode_count;
+    gf_atomic_t cache_used;
+    gf_atomic_t protected;
+    gf_atomic_uint64_t hits;
+    gf_atomic_uint64_t misses;
+    gf_atomic_uint64_t evictions;
+};
+
 struct ioc_table {
     uint64_t page_size;
     uint64_t cache_size;
-    uint64_t cache_used;
+    gf_atomic_t cache_used;
+    gf_atomic_t protected; /* size of the pages read more than once */
     uint64_t min_file_size;
     uint64_t max_file_size;
-    struct list_head inodes; /* list of inodes cached */
-    struct list_head active;
-    struct list_head *inode_lru;
+    struct ioc_shard shards[IOC_TABLE_SHARDS];
+    gf_atomic_uint32_t prune_hand; /* shard the next prune starts at */
     struct list_head priority_list;
     int32_t readv_count;
     pthread_mutex_t table_lock;
     xlator_t *xl;
-    uint32_t inode_count;
     int32_t cache_timeout;
     int32_t max_pri;
     struct mem_pool *mem_pool;
 };
 
 typedef struct ioc_table ioc_table_t;
+typedef struct ioc_shard ioc_shard_t;
 typedef struct ioc_local ioc_local_t;
 typedef struct ioc_page ioc_page_t;
 typedef struct ioc_inode ioc_inode_t;
@@ -188,6 +212,9 @@ __ioc_page_get(ioc_inode_t *ioc_inode, off_t offset);
 ioc_page_t *
 __ioc_page_create(ioc_inode_t *ioc_inode, off_t offset);
 
+void
+__ioc_page_protect(ioc_page_t *page, gf_boolean_t protect);
+
 void
 ioc_page_fault(ioc_inode_t *ioc_inode, call_frame_t *frame, fd_t *fd,
                off_t offset);
@@ -240,6 +267,18 @@ ioc_frame_fill(ioc_page_t *page, call_frame_t *frame, off_t offset, size_t size,
         pthread_mutex_unlock(&table->table_lock);                              \
     } while (0)
 
+#define ioc_shard_lock(shard)                                                  \
+    do {                                                                       \
+        gf_msg_trace("io-cache", 0, "locked shard(%p)", shard);                \
+        pthread_mutex_lock(&shard->shard_lock);                                \
+    } while (0)
+
+#define ioc_shard_unlock(shard)                                                \
+    do {                                                                       \
+        gf_msg_trace("io-cache", 0, "unlocked shard(%p)", shard);              \
+        pthread_mutex_unlock(&shard->shard_lock);                              \
+    } while (0)
+
 #define ioc_local_lock(local)                                                  \
     do {                                                                       \
         gf_msg_trace(local->inode->table->xl->name, 0, "locked local(%p)",     \
@@ -303,4 +342,12 @@ ioc_prune(ioc_table_t *table);
 int32_t
 ioc_need_prune(ioc_table_t *table);
 
+/* charge (or, with a negative @size, credit) the cache of @ioc_inode */
+static inline void
+ioc_cache_account(ioc_inode_t *ioc_inode, int64_t size)
+{
+    GF_ATOMIC_ADD(ioc_inode->shard->cache_used, size);
+    GF_ATOMIC_ADD(ioc_inode->table->cache_used, size);
+}
+
 #endif /* __IO_CACHE_H */
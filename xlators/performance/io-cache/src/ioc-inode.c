@@ -151,6 +151,21 @@ out:
     return;
 }
 
+/*
+ * ioc_shard_index - pick the shard of an inode. the gfid is not linked into
+ *                   the inode yet when the callbacks create ioc_inode, so
+ *                   hash the address instead
+ */
+static uint32_t
+ioc_shard_index(inode_t *inode)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)inode;
+
+    hash *= 0x9e3779b97f4a7c15ULL;
+
+    return (hash >> 32) % IOC_TABLE_SHARDS;
+}
+
 /*
  * ioc_inode_create - create a new ioc_inode_t structure and add it to
  *                    the table table. fill in the fields which are derived
@@ -165,6 +180,7 @@ ioc_inode_t *
 ioc_inode_create(ioc_table_t *table, inode_t *inode, uint32_t weight)
 {
     ioc_inode_t *ioc_inode = NULL;
+    ioc_shard_t *shard = NULL;
 
     GF_VALIDATE_OR_GOTO("io-cache", table, out);
 
@@ -173,19 +189,22 @@ ioc_inode_create(ioc_table_t *table, inode_t *inode, uint32_t weight)
         goto out;
     }
 
+    shard = &table->shards[ioc_shard_index(inode)];
+
     ioc_inode->inode = inode;
     ioc_inode->table = table;
+    ioc_inode->shard = shard;
     INIT_LIST_HEAD(&ioc_inode->cache.page_lru);
     pthread_mutex_init(&ioc_inode->inode_lock, NULL);
     ioc_inode->weight = weight;
 
-    ioc_table_lock(table);
+    ioc_shard_lock(shard);
     {
-        table->inode_count++;
-        list_add(&ioc_inode->inode_list, &table->inodes);
-        list_add_tail(&ioc_inode->inode_lru, &table->inode_lru[weight]);
+        shard->inode_count++;
+        list_add(&ioc_inode->inode_list, &shard->inodes);
+        list_add_tail(&ioc_inode->inode_lru, &shard->inode_lru[weight]);
     }
-    ioc_table_unlock(table);
+    ioc_shard_unlock(shard);
 
     gf_msg_trace(table->xl->name, 0, "adding to inode_lru[%d]", weight);
 
@@ -203,19 +222,19 @@ out:
 void
 ioc_inode_destroy(ioc_inode_t *ioc_inode)
 {
-    ioc_table_t *table = NULL;
+    ioc_shard_t *shard = NULL;
 
     GF_VALIDATE_OR_GOTO("io-cache", ioc_inode, out);
 
-    table = ioc_inode->table;
+    shard = ioc_inode->shard;
 
-    ioc_table_lock(table);
+    ioc_shard_lock(shard);
     {
-        table->inode_count--;
+        shard->inode_count--;
         list_del(&ioc_inode->inode_list);
         list_del(&ioc_inode->inode_lru);
     }
-    ioc_table_unlock(table);
+    ioc_shard_unlock(shard);
 
     ioc_inode_flush(ioc_inode);
     rbthash_table_destroy(ioc_inode->cache.page_table);
@@ -47,11 +47,6 @@ __ioc_page_get(ioc_inode_t *ioc_inode, off_t offset)
     page = rbthash_get(ioc_inode->cache.page_table, &rounded_offset,
                        sizeof(rounded_offset));
 
-    if (page != NULL) {
-        /* push the page to the end of the lru list */
-        list_move_tail(&page->page_lru, &ioc_inode->cache.page_lru);
-    }
-
 out:
     return page;
 }
@@ -99,6 +94,9 @@ __ioc_page_destroy(ioc_page_t *page)
         rbthash_remove(page->inode->cache.page_table, &page->offset,
                        sizeof(page->offset));
         list_del(&page->page_lru);
+        page->inode->cache.page_count--;
+        if (page->referenced)
+            __ioc_page_protect(page, _gf_false);
 
         gf_msg_trace(page->inode->table->xl->name, 0,
                      "destroying page = %p, offset = %" PRId64
@@ -145,89 +143,190 @@ out:
     return ret;
 }
 
+/*
+ * __ioc_page_protect - move a page read more than once out of (or back in
+ *                      to) probation
+ *
+ * assumes the inode lock is held
+ */
+void
+__ioc_page_protect(ioc_page_t *page, gf_boolean_t protect)
+{
+    ioc_inode_t *ioc_inode = page->inode;
+    int64_t size = ioc_inode->table->page_size;
+
+    if (!protect)
+        size = -size;
+
+    page->referenced = protect;
+    if (protect)
+        ioc_inode->cache.protected_count++;
+    else
+        ioc_inode->cache.protected_count--;
+
+    GF_ATOMIC_ADD(ioc_inode->shard->protected, size);
+    GF_ATOMIC_ADD(ioc_inode->table->protected, size);
+}
+
+/* protected pages may take up to three quarters of the cache */
+static gf_boolean_t
+ioc_over_protected(ioc_table_t *table)
+{
+    return GF_ATOMIC_GET(table->protected) > (table->cache_size / 4) * 3;
+}
+
+/*
+ * __ioc_inode_prune - sweep the clock hand over the pages of an inode,
+ *                     destroying the pages on probation until enough is
+ *                     pruned. protected pages are passed over, or demoted
+ *                     to probation when @demote is set or they take up too
+ *                     much of the cache.
+ *
+ * assumes the inode lock is held
+ */
 int32_t
 __ioc_inode_prune(ioc_inode_t *curr, uint64_t *size_pruned,
-                  uint64_t size_to_prune, uint32_t index)
+                  uint64_t size_to_prune, uint32_t index, gf_boolean_t demote)
 {
     ioc_page_t *page = NULL, *next = NULL;
-    int32_t ret = 0;
+    int64_t ret = 0;
     ioc_table_t *table = NULL;
+    struct list_head passed;
 
     if (curr == NULL) {
         goto out;
     }
 
     table = curr->table;
+    INIT_LIST_HEAD(&passed);
+
+    if (!demote && (curr->cache.protected_count == curr->cache.page_count) &&
+        !ioc_over_protected(table))
+        goto out;
 
     list_for_each_entry_safe(page, next, &curr->cache.page_lru, page_lru)
     {
+        if (page->referenced) {
+            if (demote || ioc_over_protected(table))
+                __ioc_page_protect(page, _gf_false);
+
+            list_move_tail(&page->page_lru, &passed);
+            continue;
+        }
+
         *size_pruned += page->size;
         ret = __ioc_page_destroy(page);
 
-        if (ret != -1)
-            table->cache_used -= ret;
+        if (ret != -1) {
+            ioc_cache_account(curr, -ret);
+            GF_ATOMIC_INC(curr->shard->evictions);
+        }
 
         gf_msg_trace(table->xl->name, 0,
                      "index = %d && "
-                     "table->cache_used = %" PRIu64
+                     "table->cache_used = %" PRId64
                      " && table->"
                      "cache_size = %" PRIu64,
-                     index, table->cache_used, table->cache_size);
+                     index, GF_ATOMIC_GET(table->cache_used),
+                     table->cache_size);
 
         if ((*size_pruned) >= size_to_prune)
             break;
     }
 
-    if (ioc_empty(&curr->cache)) {
-        list_del_init(&curr->inode_lru);
-    }
+    /* the hand has gone past these pages */
+    list_append(&passed, &curr->cache.page_lru);
 
 out:
     return 0;
 }
+
 /*
- * ioc_prune - prune the cache. we have a limit to the number of pages we
- *             can have in-memory.
- *
- * @table: ioc_table_t of this translator
+ * ioc_shard_prune - sweep the clock hand over the inodes of a shard, lowest
+ *                   priority first. swept inodes go behind the hand.
  *
  */
-int32_t
-ioc_prune(ioc_table_t *table)
+static void
+ioc_shard_prune(ioc_shard_t *shard, int32_t max_pri, uint64_t *size_pruned,
+                uint64_t size_to_prune, gf_boolean_t demote)
 {
     ioc_inode_t *curr = NULL, *next_ioc_inode = NULL;
+    struct list_head swept;
     int32_t index = 0;
-    uint64_t size_to_prune = 0;
-    uint64_t size_pruned = 0;
 
-    GF_VALIDATE_OR_GOTO("io-cache", table, out);
+    INIT_LIST_HEAD(&swept);
 
-    ioc_table_lock(table);
+    ioc_shard_lock(shard);
     {
-        size_to_prune = table->cache_used - table->cache_size;
-        /* take out the least recently used inode */
-        for (index = 0; index < table->max_pri; index++) {
+        for (index = 0; index < max_pri; index++) {
             list_for_each_entry_safe(curr, next_ioc_inode,
-                                     &table->inode_lru[index], inode_lru)
+                                     &shard->inode_lru[index], inode_lru)
             {
                 /* prune page-by-page for this inode, till
                  * we reach the equilibrium */
                 ioc_inode_lock(curr);
                 {
-                    __ioc_inode_prune(curr, &size_pruned, size_to_prune, index);
+                    __ioc_inode_prune(curr, size_pruned, size_to_prune, index,
+                                      demote);
                 }
                 ioc_inode_unlock(curr);
 
-                if (size_pruned >= size_to_prune)
+                list_move_tail(&curr->inode_lru, &swept);
+
+                if (*size_pruned >= size_to_prune)
                     break;
             } /* list_for_each_entry_safe (curr...) */
 
-            if (size_pruned >= size_to_prune)
+            list_append_init(&swept, &shard->inode_lru[index]);
+
+            if (*size_pruned >= size_to_prune)
                 break;
         } /* for(index=0;...) */
+    }
+    ioc_shard_unlock(shard);
+}
+
+/*
+ * ioc_prune - prune the cache. we have a limit to the number of pages we
+ *             can have in-memory.
+ *
+ * @table: ioc_table_t of this translator
+ *
+ * the shards are swept from a rotating hand. pages read only once are
+ * evicted first, the protected ones only once nothing else is left, so a
+ * large sequential read does not flush the pages which are read again.
+ */
+int32_t
+ioc_prune(ioc_table_t *table)
+{
+    uint32_t hand = 0;
+    uint32_t i = 0;
+    int pass = 0;
+    int64_t cache_difference = 0;
+    uint64_t size_to_prune = 0;
+    uint64_t size_pruned = 0;
+
+    GF_VALIDATE_OR_GOTO("io-cache", table, out);
+
+    cache_difference = GF_ATOMIC_GET(table->cache_used) - table->cache_size;
+    if (cache_difference <= 0)
+        goto out;
+
+    size_to_prune = cache_difference;
+    hand = GF_ATOMIC_INC(table->prune_hand);
 
-    } /* ioc_inode_table locked region end */
-    ioc_table_unlock(table);
+    /* the second pass demotes all the protected pages, the third one
+     * evicts them */
+    for (pass = 0; pass < 3; pass++) {
+        for (i = 0; i < IOC_TABLE_SHARDS; i++) {
+            ioc_shard_prune(&table->shards[(hand + i) % IOC_TABLE_SHARDS],
+                            table->max_pri, &size_pruned, size_to_prune,
+                            pass > 0);
+
+            if (size_pruned >= size_to_prune)
+                goto out;
+        }
+    }
 
 out:
     return 0;
@@ -274,6 +373,7 @@ __ioc_page_create(ioc_inode_t *ioc_inode, off_t offset)
                    sizeof(rounded_offset));
 
     list_add_tail(&newpage->page_lru, &ioc_inode->cache.page_lru);
+    ioc_inode->cache.page_count++;
 
     page = newpage;
 
@@ -411,7 +511,7 @@ ioc_fault_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     int32_t destroy_size = 0;
     size_t page_size = 0;
     ioc_waitq_t *waitq = NULL;
-    size_t iobref_page_size = 0;
+    int64_t iobref_page_size = 0;
     char zero_filled = 0;
 
     GF_ASSERT(frame);
@@ -463,6 +563,8 @@ ioc_fault_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
                         ioc_inode, NULL);
             } else {
                 if (page->vector) {
+                    /* the old copy is no more in the cache */
+                    iobref_page_size -= iobref_size(page->iobref);
                     iobref_unref(page->iobref);
                     GF_FREE(page->vector);
                     page->vector = NULL;
@@ -499,7 +601,7 @@ ioc_fault_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
                 page->size = page_size;
                 page->op_errno = op_errno;
 
-                iobref_page_size = iobref_size(page->iobref);
+                iobref_page_size += iobref_size(page->iobref);
 
                 if (page->waitq) {
                     /* wake up all the frames waiting on
@@ -515,21 +617,11 @@ unlock:
 
     ioc_waitq_return(waitq);
 
-    if (iobref_page_size) {
-        ioc_table_lock(table);
-        {
-            table->cache_used += iobref_page_size;
-        }
-        ioc_table_unlock(table);
-    }
+    if (iobref_page_size)
+        ioc_cache_account(ioc_inode, iobref_page_size);
 
-    if (destroy_size) {
-        ioc_table_lock(table);
-        {
-            table->cache_used -= destroy_size;
-        }
-        ioc_table_unlock(table);
-    }
+    if (destroy_size)
+        ioc_cache_account(ioc_inode, -destroy_size);
 
     if (ioc_need_prune(ioc_inode->table)) {
         ioc_prune(ioc_inode->table);
@@ -644,7 +736,6 @@ __ioc_frame_fill(ioc_page_t *page, call_frame_t *frame, off_t offset,
     off_t src_offset = 0;
     off_t dst_offset = 0;
     ssize_t copy_size = 0;
-    ioc_inode_t *ioc_inode = NULL;
     ioc_fill_t *new = NULL;
     int8_t found = 0;
     int32_t ret = -1;
@@ -662,16 +753,12 @@ __ioc_frame_fill(ioc_page_t *page, call_frame_t *frame, off_t offset,
         goto out;
     }
 
-    ioc_inode = page->inode;
-
     gf_msg_trace(frame->this->name, 0,
                  "frame (%p) offset = %" PRId64 " && size = %" GF_PRI_SIZET
                  " "
                  "&& page->size = %" GF_PRI_SIZET " && wait_count = %d",
                  frame, offset, size, page->size, local->wait_count);
 
-    /* immediately move this page to the end of the page_lru list */
-    list_move_tail(&page->page_lru, &ioc_inode->cache.page_lru);
     /* fill local->pending_size bytes from local->pending_offset */
     if (local->op_ret != -1) {
         local->op_errno = op_errno;
@@ -920,6 +1007,8 @@ __ioc_page_wakeup(ioc_page_t *page, int32_t op_errno)
 {
     ioc_waitq_t *waitq = NULL, *trav = NULL;
     call_frame_t *frame = NULL;
+    ioc_inode_t *ioc_inode = NULL;
+    int64_t size = 0;
     int32_t ret = -1;
 
     GF_VALIDATE_OR_GOTO("io-cache", page, out);
@@ -928,6 +1017,7 @@ __ioc_page_wakeup(ioc_page_t *page, int32_t op_errno)
     page->waitq = NULL;
 
     page->ready = 1;
+    ioc_inode = page->inode;
 
     gf_msg_trace(page->inode->table->xl->name, 0, "page is %p && waitq = %p",
                  page, waitq);
@@ -942,7 +1032,10 @@ __ioc_page_wakeup(ioc_page_t *page, int32_t op_errno)
     }
 
     if (page->stale) {
-        __ioc_page_destroy(page);
+        /* the pruning which marked it stale did not account for it */
+        size = __ioc_page_destroy(page);
+        if (size != -1)
+            ioc_cache_account(ioc_inode, -size);
     }
 
 out:
@@ -962,7 +1055,7 @@ __ioc_page_error(ioc_page_t *page, int32_t op_ret, int32_t op_errno)
     ioc_waitq_t *waitq = NULL, *trav = NULL;
     call_frame_t *frame = NULL;
     int64_t ret = 0;
-    ioc_table_t *table = NULL;
+    ioc_inode_t *ioc_inode = NULL;
     ioc_local_t *local = NULL;
 
     GF_VALIDATE_OR_GOTO("io-cache", page, out);
@@ -987,11 +1080,11 @@ __ioc_page_error(ioc_page_t *page, int32_t op_ret, int32_t op_errno)
         ioc_local_unlock(local);
     }
 
-    table = page->inode->table;
+    ioc_inode = page->inode;
     ret = __ioc_page_destroy(page);
 
     if (ret != -1) {
-        table->cache_used -= ret;
+        ioc_cache_account(ioc_inode, -ret);
     }
 
 out:
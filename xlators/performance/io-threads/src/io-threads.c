@@ -160,6 +160,19 @@ __iot_enqueue(iot_conf_t *conf, call_stub_t *stub, int pri)
     conf->queue_sizes[pri]++;
 }
 
+static void
+iot_run_stub(iot_conf_t *conf, call_stub_t *stub)
+{
+    if (stub->poison) {
+        gf_log(conf->this->name, GF_LOG_INFO, "Dropping poisoned request %p.",
+               stub);
+        call_stub_destroy(stub);
+    } else {
+        call_resume(stub);
+    }
+    GF_ATOMIC_DEC(conf->stub_cnt);
+}
+
 void *
 iot_worker(void *data)
 {
@@ -224,14 +237,7 @@ iot_worker(void *data)
         pthread_mutex_unlock(&conf->mutex);
 
         if (stub) { /* guard against spurious wakeups */
-            if (stub->poison) {
-                gf_log(this->name, GF_LOG_INFO, "Dropping poisoned request %p.",
-                       stub);
-                call_stub_destroy(stub);
-            } else {
-                call_resume(stub);
-            }
-            GF_ATOMIC_DEC(conf->stub_cnt);
+            iot_run_stub(conf, stub);
         }
         stub = NULL;
 
@@ -242,11 +248,490 @@ iot_worker(void *data)
     return NULL;
 }
 
+/*
+ * Work stealing mode.
+ *
+ * Every worker thread owns a run queue with its own mutex and condition
+ * variable. A new request is queued to one of the running workers, so fops
+ * don't all contend on conf->mutex. A worker serves its own queue first and
+ * takes requests from the queues of the other workers when it's empty.
+ * The priority limits are enforced with global counters of the requests
+ * being executed, and every run queue keeps per-client lists that are
+ * served in turn, like the global queues.
+ *
+ * Sleeping workers are flagged, so that a request queued behind a busy
+ * worker can wake one of them up to steal it.
+ */
+
+static __thread uint32_t iot_ws_next;
+
+void *
+iot_ws_worker(void *data);
+
+static iot_client_ctx_t *
+__iot_ws_get_ctx(iot_conf_t *conf, iot_worker_t *worker, client_t *client)
+{
+    iot_client_queues_t *queues = NULL;
+    iot_client_queues_t *setted_queues = NULL;
+    iot_client_ctx_t *ctx = NULL;
+    int i;
+
+    if (client_ctx_get(client, conf->this, (void **)&queues) != 0) {
+        queues = GF_CALLOC(1, sizeof(*queues), gf_iot_mt_client_queues_t);
+        if (!queues)
+            return NULL;
+        setted_queues = client_ctx_set(client, conf->this, queues);
+        if (queues != setted_queues) {
+            GF_FREE(queues);
+            queues = setted_queues;
+        }
+        if (!queues)
+            return NULL;
+    }
+
+    /* only this worker's queue uses this entry, and its mutex is held */
+    ctx = queues->queues[worker->index];
+    if (!ctx) {
+        ctx = GF_MALLOC(GF_FOP_PRI_MAX * sizeof(*ctx), gf_iot_mt_client_ctx_t);
+        if (!ctx)
+            return NULL;
+        for (i = 0; i < GF_FOP_PRI_MAX; ++i) {
+            INIT_LIST_HEAD(&ctx[i].clients);
+            INIT_LIST_HEAD(&ctx[i].reqs);
+        }
+        queues->queues[worker->index] = ctx;
+    }
+
+    return ctx;
+}
+
+/* Reserves one of the threads allowed for a priority. */
+static gf_boolean_t
+iot_ws_claim(iot_conf_t *conf, int pri)
+{
+    int32_t count = 0;
+
+    do {
+        count = GF_ATOMIC_GET(conf->ws_active[pri]);
+        if (count >= conf->ac_iot_limit[pri])
+            return _gf_false;
+    } while (!GF_ATOMIC_CMP_SWAP(conf->ws_active[pri], count, count + 1));
+
+    return _gf_true;
+}
+
+/* Checks if any worker could take one of the queued requests. */
+static gf_boolean_t
+iot_ws_runnable(iot_conf_t *conf)
+{
+    int i = 0;
+
+    for (i = 0; i < GF_FOP_PRI_MAX; i++) {
+        if ((GF_ATOMIC_GET(conf->ws_queue_sizes[i]) > 0) &&
+            (GF_ATOMIC_GET(conf->ws_active[i]) < conf->ac_iot_limit[i]))
+            return _gf_true;
+    }
+
+    return _gf_false;
+}
+
+static call_stub_t *
+__iot_ws_dequeue(iot_conf_t *conf, iot_worker_t *worker, int *pri)
+{
+    call_stub_t *stub = NULL;
+    iot_client_ctx_t *ctx = NULL;
+    int i = 0;
+
+    *pri = -1;
+    for (i = 0; i < GF_FOP_PRI_MAX; i++) {
+        if (list_empty(&worker->clients[i]))
+            continue;
+
+        if (!iot_ws_claim(conf, i))
+            continue;
+
+        /* First request of the first client, as in __iot_dequeue(). */
+        ctx = list_first_entry(&worker->clients[i], iot_client_ctx_t, clients);
+        stub = list_first_entry(&ctx->reqs, call_stub_t, list);
+        list_del_init(&stub->list);
+        if (list_empty(&ctx->reqs)) {
+            list_del_init(&ctx->clients);
+        } else {
+            list_rotate_left(&worker->clients[i]);
+        }
+
+        worker->queue_sizes[i]--;
+        GF_ATOMIC_DEC(worker->queue_size);
+        GF_ATOMIC_DEC(conf->ws_queue_sizes[i]);
+        conf->queue_marked[i] = _gf_false;
+        *pri = i;
+        break;
+    }
+
+    return stub;
+}
+
+static void
+__iot_ws_enqueue(iot_conf_t *conf, iot_worker_t *worker, call_stub_t *stub,
+                 int pri)
+{
+    client_t *client = stub->frame->root->client;
+    iot_client_ctx_t *ctx = NULL;
+
+    if (pri < 0 || pri >= GF_FOP_PRI_MAX)
+        pri = GF_FOP_PRI_MAX - 1;
+
+    if (client) {
+        ctx = __iot_ws_get_ctx(conf, worker, client);
+        if (ctx) {
+            ctx = &ctx[pri];
+        }
+    }
+    if (!ctx) {
+        ctx = &worker->no_client[pri];
+    }
+
+    if (list_empty(&ctx->reqs)) {
+        list_add_tail(&ctx->clients, &worker->clients[pri]);
+    }
+    list_add_tail(&stub->list, &ctx->reqs);
+
+    worker->queue_sizes[pri]++;
+    GF_ATOMIC_INC(worker->queue_size);
+    GF_ATOMIC_INC(conf->ws_queue_sizes[pri]);
+    GF_ATOMIC_INC(conf->stub_cnt);
+}
+
+/* conf->mutex and worker->mutex must be held. */
+static int
+__iot_ws_start(iot_conf_t *conf, iot_worker_t *worker)
+{
+    pthread_t thread;
+    int ret = 0;
+
+    if (worker->active)
+        return 0;
+
+    ret = gf_thread_create(&thread, &conf->w_attr, iot_ws_worker, worker,
+                           "iotwr%03hx", worker->index & 0x3ff);
+    if (ret == 0) {
+        pthread_detach(thread);
+        worker->active = _gf_true;
+        conf->curr_count++;
+        /* a slot picked just before the workers above it exited is reused
+         * past the running ones, they have to include it again for it to
+         * idle out */
+        if (GF_ATOMIC_GET(conf->ws_count) <= worker->index)
+            GF_ATOMIC_INIT(conf->ws_count, worker->index + 1);
+        gf_msg_debug(conf->this->name, 0,
+                     "started worker %d (curr_count=%d)", worker->index,
+                     conf->curr_count);
+    }
+
+    return ret;
+}
+
+static int32_t
+iot_ws_scale_needed(iot_conf_t *conf)
+{
+    int32_t scale = 0;
+    int i = 0;
+
+    for (i = 0; i < GF_FOP_PRI_MAX; i++)
+        scale += min(GF_ATOMIC_GET(conf->ws_queue_sizes[i]),
+                     conf->ac_iot_limit[i]);
+
+    if (scale < IOT_MIN_THREADS)
+        scale = IOT_MIN_THREADS;
+
+    if (scale > conf->max_count)
+        scale = conf->max_count;
+
+    return scale;
+}
+
+/* Starts the workers of the first run queues needed for the queued
+ * requests. conf->mutex must be held. Like __iot_workers_scale(), returns
+ * the number of workers that couldn't be started. */
+static int
+__iot_ws_scale(iot_conf_t *conf)
+{
+    iot_worker_t *worker = NULL;
+    int32_t scale = 0;
+    int diff = 0;
+    int i = 0;
+
+    scale = iot_ws_scale_needed(conf);
+
+    for (i = 0; i < scale; i++) {
+        worker = &conf->workers[i];
+
+        pthread_mutex_lock(&worker->mutex);
+        {
+            if (__iot_ws_start(conf, worker) != 0)
+                diff++;
+        }
+        pthread_mutex_unlock(&worker->mutex);
+    }
+
+    if (GF_ATOMIC_GET(conf->ws_count) < scale)
+        GF_ATOMIC_INIT(conf->ws_count, scale);
+
+    return diff;
+}
+
+static int
+iot_ws_scale(iot_conf_t *conf)
+{
+    int ret = 0;
+
+    if (iot_ws_scale_needed(conf) <= GF_ATOMIC_GET(conf->ws_count))
+        return 0;
+
+    pthread_mutex_lock(&conf->mutex);
+    {
+        ret = __iot_ws_scale(conf);
+    }
+    pthread_mutex_unlock(&conf->mutex);
+
+    return ret;
+}
+
+/* Picks the less loaded of two consecutive running workers. */
+static iot_worker_t *
+iot_ws_pick(iot_conf_t *conf)
+{
+    iot_worker_t *first = NULL;
+    iot_worker_t *second = NULL;
+    int32_t count = 0;
+
+    count = min(GF_ATOMIC_GET(conf->ws_count), conf->max_count);
+    if (count <= 1)
+        return &conf->workers[0];
+
+    first = &conf->workers[iot_ws_next++ % count];
+    if (GF_ATOMIC_GET(first->sleeping))
+        return first;
+
+    second = &conf->workers[iot_ws_next % count];
+    if (GF_ATOMIC_GET(second->sleeping) ||
+        (GF_ATOMIC_GET(second->queue_size) < GF_ATOMIC_GET(first->queue_size)))
+        return second;
+
+    return first;
+}
+
+/* Wakes up a sleeping worker, if any, so that it steals a request queued to
+ * a busy one. */
+static void
+iot_ws_wake(iot_conf_t *conf, iot_worker_t *busy)
+{
+    iot_worker_t *worker = NULL;
+    int i = 0;
+
+    /* Pairs with the barrier in iot_ws_wait(): either the sleeper is seen
+     * here, or it sees the new request before going to sleep. */
+    __sync_synchronize();
+    if (GF_ATOMIC_GET(conf->ws_sleepers) <= 0)
+        return;
+
+    for (i = 1; i < IOT_MAX_THREADS; i++) {
+        worker = &conf->workers[(busy->index + i) % IOT_MAX_THREADS];
+        if (!GF_ATOMIC_GET(worker->sleeping) ||
+            !GF_ATOMIC_CMP_SWAP(worker->sleeping, 1, 0))
+            continue;
+
+        GF_ATOMIC_DEC(conf->ws_sleepers);
+        pthread_mutex_lock(&worker->mutex);
+        {
+            pthread_cond_signal(&worker->cond);
+        }
+        pthread_mutex_unlock(&worker->mutex);
+        break;
+    }
+}
+
+static int
+iot_ws_schedule(iot_conf_t *conf, call_stub_t *stub, int pri)
+{
+    iot_worker_t *worker = NULL;
+    gf_boolean_t woken = _gf_false;
+
+    worker = iot_ws_pick(conf);
+
+    pthread_mutex_lock(&worker->mutex);
+    {
+        if (!worker->active) {
+            /* The worker has exited, start a new one. conf->mutex has to
+             * be taken first. */
+            pthread_mutex_unlock(&worker->mutex);
+            pthread_mutex_lock(&conf->mutex);
+            pthread_mutex_lock(&worker->mutex);
+            __iot_ws_start(conf, worker);
+            pthread_mutex_unlock(&conf->mutex);
+        }
+
+        __iot_ws_enqueue(conf, worker, stub, pri);
+
+        if (GF_ATOMIC_CMP_SWAP(worker->sleeping, 1, 0)) {
+            GF_ATOMIC_DEC(conf->ws_sleepers);
+            pthread_cond_signal(&worker->cond);
+            woken = _gf_true;
+        }
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    if (!woken)
+        iot_ws_wake(conf, worker);
+
+    return iot_ws_scale(conf);
+}
+
+/* Takes a request from the worker's own queue or, if it's empty, from the
+ * queue of another worker. */
+static call_stub_t *
+iot_ws_get(iot_conf_t *conf, iot_worker_t *worker, int *pri)
+{
+    iot_worker_t *victim = NULL;
+    call_stub_t *stub = NULL;
+    int i = 0;
+
+    pthread_mutex_lock(&worker->mutex);
+    {
+        stub = __iot_ws_dequeue(conf, worker, pri);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    for (i = 1; !stub && (i < IOT_MAX_THREADS); i++) {
+        victim = &conf->workers[(worker->index + i) % IOT_MAX_THREADS];
+        if (GF_ATOMIC_GET(victim->queue_size) == 0)
+            continue;
+
+        /* don't wait for a busy queue, the next one may do */
+        if (pthread_mutex_trylock(&victim->mutex) != 0)
+            continue;
+        stub = __iot_ws_dequeue(conf, victim, pri);
+        pthread_mutex_unlock(&victim->mutex);
+
+        if (stub)
+            GF_ATOMIC_INC(worker->steals);
+    }
+
+    return stub;
+}
+
+/* Decides if an idle worker has to terminate. Workers exit from the last
+ * one, so that the running workers are always the first ws_count. */
+static gf_boolean_t
+iot_ws_exit(iot_conf_t *conf, iot_worker_t *worker)
+{
+    gf_boolean_t bye = _gf_false;
+
+    pthread_mutex_lock(&conf->mutex);
+    pthread_mutex_lock(&worker->mutex);
+    {
+        if (conf->down) {
+            /* the remaining workers take what is still queued here */
+            bye = !iot_ws_runnable(conf);
+        } else if ((worker->index == GF_ATOMIC_GET(conf->ws_count) - 1) &&
+                   (worker->index >= IOT_MIN_THREADS) &&
+                   (GF_ATOMIC_GET(worker->queue_size) == 0) &&
+                   !iot_ws_runnable(conf)) {
+            GF_ATOMIC_DEC(conf->ws_count);
+            /* skip the slots below that have exited already */
+            while ((GF_ATOMIC_GET(conf->ws_count) > IOT_MIN_THREADS) &&
+                   !conf->workers[GF_ATOMIC_GET(conf->ws_count) - 1].active)
+                GF_ATOMIC_DEC(conf->ws_count);
+            bye = _gf_true;
+        }
+
+        if (bye) {
+            worker->active = _gf_false;
+            conf->curr_count--;
+            if (conf->curr_count == 0)
+                pthread_cond_broadcast(&conf->cond);
+            gf_msg_debug(conf->this->name, 0,
+                         "terminated worker %d. conf->curr_count=%d",
+                         worker->index, conf->curr_count);
+        }
+    }
+    pthread_mutex_unlock(&worker->mutex);
+    pthread_mutex_unlock(&conf->mutex);
+
+    return bye;
+}
+
+/* Sleeps until a request is queued or the idle time expires. Returns true
+ * if the worker has to terminate. */
+static gf_boolean_t
+iot_ws_wait(iot_conf_t *conf, iot_worker_t *worker)
+{
+    struct timespec sleep_till = {
+        0,
+    };
+    int ret = 0;
+
+    pthread_mutex_lock(&worker->mutex);
+    {
+        GF_ATOMIC_INC(conf->ws_sleepers);
+        GF_ATOMIC_SWAP(worker->sleeping, 1);
+
+        /* Pairs with the barrier in iot_ws_wake(). */
+        __sync_synchronize();
+
+        if (!conf->down && !iot_ws_runnable(conf)) {
+            clock_gettime(CLOCK_REALTIME_COARSE, &sleep_till);
+            sleep_till.tv_sec += conf->idle_time;
+
+            ret = pthread_cond_timedwait(&worker->cond, &worker->mutex,
+                                         &sleep_till);
+        }
+
+        /* unless someone else already woke us up */
+        if (GF_ATOMIC_CMP_SWAP(worker->sleeping, 1, 0))
+            GF_ATOMIC_DEC(conf->ws_sleepers);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+
+    if (conf->down || (ret == ETIMEDOUT))
+        return iot_ws_exit(conf, worker);
+
+    return _gf_false;
+}
+
+void *
+iot_ws_worker(void *data)
+{
+    iot_worker_t *worker = data;
+    iot_conf_t *conf = worker->conf;
+    call_stub_t *stub = NULL;
+    int pri = -1;
+
+    THIS = conf->this;
+
+    for (;;) {
+        stub = iot_ws_get(conf, worker, &pri);
+        if (stub) {
+            iot_run_stub(conf, stub);
+            GF_ATOMIC_DEC(conf->ws_active[pri]);
+            continue;
+        }
+
+        if (iot_ws_wait(conf, worker))
+            break;
+    }
+
+    return NULL;
+}
+
 int
 do_iot_schedule(iot_conf_t *conf, call_stub_t *stub, int pri)
 {
     int ret = 0;
 
+    if (conf->work_stealing)
+        return iot_ws_schedule(conf, stub, pri);
+
     pthread_mutex_lock(&conf->mutex);
     {
         __iot_enqueue(conf, stub, pri);
@@ -860,7 +1345,10 @@ iot_workers_scale(iot_conf_t *conf)
 
     pthread_mutex_lock(&conf->mutex);
     {
-        ret = __iot_workers_scale(conf);
+        if (conf->work_stealing)
+            ret = __iot_ws_scale(conf);
+        else
+            ret = __iot_workers_scale(conf);
     }
     pthread_mutex_unlock(&conf->mutex);
 
@@ -920,12 +1408,33 @@ mem_acct_init(xlator_t *this)
     return ret;
 }
 
+static int32_t
+iot_queue_size(iot_conf_t *conf, int pri)
+{
+    if (conf->work_stealing)
+        return GF_ATOMIC_GET(conf->ws_queue_sizes[pri]);
+
+    return conf->queue_sizes[pri];
+}
+
+static int32_t
+iot_active_count(iot_conf_t *conf, int pri)
+{
+    if (conf->work_stealing)
+        return GF_ATOMIC_GET(conf->ws_active[pri]);
+
+    return conf->ac_iot_count[pri];
+}
+
 int
 iot_priv_dump(xlator_t *this)
 {
     iot_conf_t *conf = NULL;
     char key_prefix[GF_DUMP_MAX_BUF_LEN];
     char key[GF_DUMP_MAX_BUF_LEN];
+    iot_worker_t *worker = NULL;
+    int64_t total_steals = 0;
+    int64_t steals = 0;
     int i = 0;
 
     if (!this)
@@ -953,21 +1462,43 @@ iot_priv_dump(xlator_t *this)
     gf_proc_dump_write("max_least_priority_threads", "%d",
                        conf->ac_iot_limit[GF_FOP_PRI_LEAST]);
     gf_proc_dump_write("current_high_priority_threads", "%d",
-                       conf->ac_iot_count[GF_FOP_PRI_HI]);
+                       iot_active_count(conf, GF_FOP_PRI_HI));
     gf_proc_dump_write("current_normal_priority_threads", "%d",
-                       conf->ac_iot_count[GF_FOP_PRI_NORMAL]);
+                       iot_active_count(conf, GF_FOP_PRI_NORMAL));
     gf_proc_dump_write("current_low_priority_threads", "%d",
-                       conf->ac_iot_count[GF_FOP_PRI_LO]);
+                       iot_active_count(conf, GF_FOP_PRI_LO));
     gf_proc_dump_write("current_least_priority_threads", "%d",
-                       conf->ac_iot_count[GF_FOP_PRI_LEAST]);
+                       iot_active_count(conf, GF_FOP_PRI_LEAST));
     for (i = 0; i < GF_FOP_PRI_MAX; i++) {
-        if (!conf->queue_sizes[i])
+        if (!iot_queue_size(conf, i))
             continue;
         snprintf(key, sizeof(key), "%s_priority_queue_length",
                  iot_get_pri_meaning(i));
-        gf_proc_dump_write(key, "%d", conf->queue_sizes[i]);
+        gf_proc_dump_write(key, "%d", iot_queue_size(conf, i));
     }
 
+    if (!conf->work_stealing)
+        return 0;
+
+    gf_proc_dump_write("work_stealing", "on");
+    gf_proc_dump_write("running_workers", "%d", GF_ATOMIC_GET(conf->ws_count));
+    gf_proc_dump_write("sleeping_workers", "%d",
+                       GF_ATOMIC_GET(conf->ws_sleepers));
+    for (i = 0; i < IOT_MAX_THREADS; i++) {
+        worker = &conf->workers[i];
+        steals = GF_ATOMIC_GET(worker->steals);
+        if (!worker->active && !steals &&
+            !GF_ATOMIC_GET(worker->queue_size))
+            continue;
+        total_steals += steals;
+
+        snprintf(key, sizeof(key), "worker[%d].queue_length", i);
+        gf_proc_dump_write(key, "%d", GF_ATOMIC_GET(worker->queue_size));
+        snprintf(key, sizeof(key), "worker[%d].steals", i);
+        gf_proc_dump_write(key, "%" PRId64, steals);
+    }
+    gf_proc_dump_write("steals", "%" PRId64, total_steals);
+
     return 0;
 }
 
@@ -1078,7 +1609,7 @@ iot_watchdog(void *arg)
             } else {
                 bad_times[i] = 0;
             }
-            priv->queue_marked[i] = (priv->queue_sizes[i] > 0);
+            priv->queue_marked[i] = (iot_queue_size(priv, i) > 0);
         }
         pthread_mutex_unlock(&priv->mutex);
         pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
@@ -1175,6 +1706,87 @@ out:
     return ret;
 }
 
+static int
+iot_workers_init(iot_conf_t *conf)
+{
+    iot_worker_t *worker = NULL;
+    int ret = 0;
+    int i = 0;
+    int j = 0;
+
+    conf->workers = GF_CALLOC(IOT_MAX_THREADS, sizeof(*conf->workers),
+                              gf_iot_mt_worker_t);
+    if (!conf->workers) {
+        gf_smsg(conf->this->name, GF_LOG_ERROR, ENOMEM,
+                IO_THREADS_MSG_OUT_OF_MEMORY, NULL);
+        return -1;
+    }
+
+    for (i = 0; i < IOT_MAX_THREADS; i++) {
+        worker = &conf->workers[i];
+
+        if ((ret = pthread_mutex_init(&worker->mutex, NULL)) != 0) {
+            gf_smsg(conf->this->name, GF_LOG_ERROR, 0,
+                    IO_THREADS_MSG_PTHREAD_INIT_FAILED,
+                    "pthread_mutex_init ret=%d", ret, NULL);
+            goto err;
+        }
+        if ((ret = pthread_cond_init(&worker->cond, NULL)) != 0) {
+            pthread_mutex_destroy(&worker->mutex);
+            gf_smsg(conf->this->name, GF_LOG_ERROR, 0,
+                    IO_THREADS_MSG_PTHREAD_INIT_FAILED,
+                    "pthread_cond_init ret=%d", ret, NULL);
+            goto err;
+        }
+
+        for (j = 0; j < GF_FOP_PRI_MAX; j++) {
+            INIT_LIST_HEAD(&worker->clients[j]);
+            INIT_LIST_HEAD(&worker->no_client[j].clients);
+            INIT_LIST_HEAD(&worker->no_client[j].reqs);
+        }
+        GF_ATOMIC_INIT(worker->queue_size, 0);
+        GF_ATOMIC_INIT(worker->sleeping, 0);
+        GF_ATOMIC_INIT(worker->steals, 0);
+        worker->conf = conf;
+        worker->index = i;
+    }
+
+    GF_ATOMIC_INIT(conf->ws_count, 0);
+    GF_ATOMIC_INIT(conf->ws_sleepers, 0);
+    for (j = 0; j < GF_FOP_PRI_MAX; j++) {
+        GF_ATOMIC_INIT(conf->ws_queue_sizes[j], 0);
+        GF_ATOMIC_INIT(conf->ws_active[j], 0);
+    }
+
+    return 0;
+
+err:
+    while (i-- > 0) {
+        pthread_cond_destroy(&conf->workers[i].cond);
+        pthread_mutex_destroy(&conf->workers[i].mutex);
+    }
+    GF_FREE(conf->workers);
+    conf->workers = NULL;
+
+    return -1;
+}
+
+static void
+iot_workers_fini(iot_conf_t *conf)
+{
+    int i = 0;
+
+    if (!conf->workers)
+        return;
+
+    for (i = 0; i < IOT_MAX_THREADS; i++) {
+        pthread_cond_destroy(&conf->workers[i].cond);
+        pthread_mutex_destroy(&conf->workers[i].mutex);
+    }
+    GF_FREE(conf->workers);
+    conf->workers = NULL;
+}
+
 int
 init(xlator_t *this)
 {
@@ -1244,6 +1856,8 @@ init(xlator_t *this)
 
     GF_OPTION_INIT("pass-through", this->pass_through, bool, out);
 
+    GF_OPTION_INIT("work-stealing", conf->work_stealing, bool, out);
+
     conf->this = this;
     GF_ATOMIC_INIT(conf->stub_cnt, 0);
 
@@ -1253,6 +1867,13 @@ init(xlator_t *this)
         INIT_LIST_HEAD(&conf->no_client[i].reqs);
     }
 
+    if (conf->work_stealing) {
+        ret = iot_workers_init(conf);
+        if (ret != 0)
+            goto out;
+        ret = -1;
+    }
+
     if (!this->pass_through) {
         ret = iot_workers_scale(conf);
 
@@ -1273,8 +1894,10 @@ init(xlator_t *this)
 
     ret = 0;
 out:
-    if (ret)
+    if (ret && conf) {
+        iot_workers_fini(conf);
         GF_FREE(conf);
+    }
 
     return ret;
 }
@@ -1282,11 +1905,18 @@ out:
 static void
 iot_exit_threads(iot_conf_t *conf)
 {
+    int i = 0;
+
     pthread_mutex_lock(&conf->mutex);
     {
         conf->down = _gf_true;
         /*Let all the threads know that xl is going down*/
         pthread_cond_broadcast(&conf->cond);
+        for (i = 0; conf->workers && (i < IOT_MAX_THREADS); i++) {
+            pthread_mutex_lock(&conf->workers[i].mutex);
+            pthread_cond_broadcast(&conf->workers[i].cond);
+            pthread_mutex_unlock(&conf->workers[i].mutex);
+        }
         while (conf->curr_count) /*Wait for threads to exit*/
             pthread_cond_wait(&conf->cond, &conf->mutex);
     }
@@ -1360,6 +1990,8 @@ fini(xlator_t *this)
 
     stop_iot_watchdog(this);
 
+    iot_workers_fini(conf);
+
     GF_FREE(conf);
 
     this->private = NULL;
@@ -1369,42 +2001,66 @@ fini(xlator_t *this)
 int
 iot_client_destroy(xlator_t *this, client_t *client)
 {
+    iot_conf_t *conf = this->private;
+    iot_client_queues_t *queues = NULL;
     void *tmp = NULL;
+    int i = 0;
 
     if (client_ctx_del(client, this, &tmp) == 0) {
+        if (conf && conf->work_stealing) {
+            queues = tmp;
+            for (i = 0; i < IOT_MAX_THREADS; i++)
+                GF_FREE(queues->queues[i]);
+        }
         GF_FREE(tmp);
     }
 
     return 0;
 }
 
+static void
+iot_poison_reqs(xlator_t *this, iot_client_ctx_t *ctx, client_t *client)
+{
+    call_stub_t *curr;
+    call_stub_t *next;
+
+    list_for_each_entry_safe(curr, next, &ctx->reqs, list)
+    {
+        if (curr->frame->root->client != client) {
+            continue;
+        }
+        gf_log(this->name, GF_LOG_INFO, "poisoning %s fop at %p for client %s",
+               gf_fop_list[curr->fop], curr, client->client_uid);
+        curr->poison = _gf_true;
+    }
+}
+
 static int
 iot_disconnect_cbk(xlator_t *this, client_t *client)
 {
     int i;
-    call_stub_t *curr;
-    call_stub_t *next;
+    int w;
     iot_conf_t *conf = this->private;
-    iot_client_ctx_t *ctx;
+    iot_worker_t *worker;
 
     if (!conf || !conf->cleanup_disconnected_reqs) {
         goto out;
     }
 
-    pthread_mutex_lock(&conf->mutex);
-    for (i = 0; i < GF_FOP_PRI_MAX; i++) {
-        ctx = &conf->no_client[i];
-        list_for_each_entry_safe(curr, next, &ctx->reqs, list)
-        {
-            if (curr->frame->root->client != client) {
-                continue;
-            }
-            gf_log(this->name, GF_LOG_INFO,
-                   "poisoning %s fop at %p for client %s",
-                   gf_fop_list[curr->fop], curr, client->client_uid);
-            curr->poison = _gf_true;
+    if (conf->work_stealing) {
+        for (w = 0; w < IOT_MAX_THREADS; w++) {
+            worker = &conf->workers[w];
+            pthread_mutex_lock(&worker->mutex);
+            for (i = 0; i < GF_FOP_PRI_MAX; i++)
+                iot_poison_reqs(this, &worker->no_client[i], client);
+            pthread_mutex_unlock(&worker->mutex);
         }
+        goto out;
     }
+
+    pthread_mutex_lock(&conf->mutex);
+    for (i = 0; i < GF_FOP_PRI_MAX; i++)
+        iot_poison_reqs(this, &conf->no_client[i], client);
     pthread_mutex_unlock(&conf->mutex);
 
 out:
@@ -1569,6 +2225,17 @@ struct volume_options options[] = {
      .flags = OPT_FLAG_SETTABLE | OPT_FLAG_DOC | OPT_FLAG_CLIENT_OPT,
      .tags = {"io-threads"},
      .description = "Enable/Disable io threads translator"},
+    {.key = {"work-stealing"},
+     .type = GF_OPTION_TYPE_BOOL,
+     .default_value = "off",
+     .op_version = {GD_OP_VERSION_9_0},
+     .flags = OPT_FLAG_SETTABLE | OPT_FLAG_DOC | OPT_FLAG_CLIENT_OPT,
+     .tags = {"io-threads"},
+     .description = "Give every worker thread its own request queue, and "
+                    "let idle workers take requests from the queues of busy "
+                    "ones, instead of sharing a single queue. Priority "
+                    "limits and per-client fairness are kept. Takes effect "
+                    "when the translator is initialized."},
     {
         .key = {NULL},
     },
@@ -41,6 +41,39 @@ typedef struct {
     struct list_head reqs;
 } iot_client_ctx_t;
 
+/*
+ * With work stealing every worker has its own run queue, so a client gets
+ * one array of per-priority contexts for each run queue its requests have
+ * been queued to. They are allocated on first use.
+ */
+typedef struct {
+    iot_client_ctx_t *queues[IOT_MAX_THREADS];
+} iot_client_queues_t;
+
+/*
+ * Run queue of a worker thread when work stealing is enabled. Requests are
+ * queued per priority and per client as in iot_conf, but under the mutex
+ * of the worker. Idle workers take requests from the queues of the others.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    struct list_head clients[GF_FOP_PRI_MAX];
+    iot_client_ctx_t no_client[GF_FOP_PRI_MAX];
+    int32_t queue_sizes[GF_FOP_PRI_MAX];
+
+    /* read without the mutex by other workers */
+    gf_atomic_int32_t queue_size;
+    gf_atomic_int32_t sleeping;
+
+    gf_atomic_t steals; /* requests taken from other queues */
+
+    struct iot_conf *conf;
+    int32_t index;
+    gf_boolean_t active; /* a thread is serving this queue */
+} iot_worker_t;
+
 struct iot_conf {
     pthread_mutex_t mutex;
     pthread_cond_t cond;
@@ -79,6 +112,15 @@ struct iot_conf {
     pthread_t watchdog_thread;
     gf_boolean_t queue_marked[GF_FOP_PRI_MAX];
     gf_boolean_t cleanup_disconnected_reqs;
+
+    /* Work stealing mode. The run queues [0, ws_count) are served by a
+     * thread, except while the translator is going down. */
+    gf_boolean_t work_stealing;
+    iot_worker_t *workers;
+    gf_atomic_int32_t ws_count;
+    gf_atomic_int32_t ws_sleepers;
+    gf_atomic_int32_t ws_queue_sizes[GF_FOP_PRI_MAX];
+    gf_atomic_int32_t ws_active[GF_FOP_PRI_MAX];
 };
 
 typedef struct iot_conf iot_conf_t;
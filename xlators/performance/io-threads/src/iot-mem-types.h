@@ -16,6 +16,8 @@
 enum gf_iot_mem_types_ {
     gf_iot_mt_iot_conf_t = gf_common_mt_end + 1,
     gf_iot_mt_client_ctx_t,
+    gf_iot_mt_worker_t,
+    gf_iot_mt_client_queues_t,
     gf_iot_mt_end
 };
 #endif
@@ -9,6 +9,7 @@
 */
 
 #include <math.h>
+#include <zlib.h>
 #include "quick-read.h"
 #include <glusterfs/statedump.h>
 #include "quick-read-messages.h"
@@ -73,20 +74,18 @@ qr_get_generation(xlator_t *this, inode_t *inode)
 {
     qr_inode_t *qr_inode = NULL;
     uint64_t gen = 0;
-    qr_inode_table_t *table = NULL;
     qr_private_t *priv = NULL;
 
     priv = this->private;
-    table = &priv->table;
 
     qr_inode = qr_inode_ctx_get(this, inode);
 
     if (qr_inode) {
-        LOCK(&table->lock);
+        LOCK(&qr_inode->shard->lock);
         {
             gen = __qr_get_generation(this, qr_inode);
         }
-        UNLOCK(&table->lock);
+        UNLOCK(&qr_inode->shard->lock);
     } else {
         gen = GF_ATOMIC_INC(priv->generation);
         if (gen == 0) {
@@ -173,16 +172,32 @@ out:
     return qr_inode;
 }
 
+/* inodes are allocated from a pool, so their addresses are aligned and
+ * their low bits alone would spread them badly */
+static uint32_t
+qr_shard_index(inode_t *inode)
+{
+    uint64_t hash = (uint64_t)(uintptr_t)inode;
+
+    hash *= 0x9e3779b97f4a7c15ULL;
+
+    return (hash >> 32) % QR_TABLE_SHARDS;
+}
+
 qr_inode_t *
 qr_inode_new(xlator_t *this, inode_t *inode)
 {
     qr_inode_t *qr_inode = NULL;
+    qr_private_t *priv = NULL;
+
+    priv = this->private;
 
     qr_inode = GF_CALLOC(1, sizeof(*qr_inode), gf_qr_mt_qr_inode_t);
     if (!qr_inode)
         return NULL;
 
     INIT_LIST_HEAD(&qr_inode->lru);
+    qr_inode->shard = &priv->table.shards[qr_shard_index(inode)];
 
     qr_inode->priority = 0; /* initial priority */
 
@@ -249,15 +264,18 @@ __qr_inode_register(xlator_t *this, qr_inode_table_t *table,
     if (!priv)
         return;
 
-    if (list_empty(&qr_inode->lru))
+    if (list_empty(&qr_inode->lru)) {
         /* first time addition of this qr_inode into table */
-        table->cache_used += qr_inode->size;
-    else
+        GF_ATOMIC_ADD(table->cache_used, qr_inode->stored);
+        GF_ATOMIC_ADD(priv->qr_counter.data_cached, qr_inode->size);
+        GF_ATOMIC_INC(priv->qr_counter.files_cached);
+        if (qr_inode->compressed)
+            GF_ATOMIC_INC(priv->qr_counter.files_compressed);
+    } else {
         list_del_init(&qr_inode->lru);
+    }
 
-    list_add_tail(&qr_inode->lru, &table->lru[qr_inode->priority]);
-
-    GF_ATOMIC_INC(priv->qr_counter.files_cached);
+    list_add_tail(&qr_inode->lru, &qr_inode->shard->lru[qr_inode->priority]);
 
     return;
 }
@@ -285,13 +303,13 @@ qr_inode_set_priority(xlator_t *this, inode_t *inode, const char *path)
         /* retain existing priority, just bump LRU */
         priority = qr_inode->priority;
 
-    LOCK(&table->lock);
+    LOCK(&qr_inode->shard->lock);
     {
         qr_inode->priority = priority;
 
         __qr_inode_register(this, table, qr_inode);
     }
-    UNLOCK(&table->lock);
+    UNLOCK(&qr_inode->shard->lock);
 }
 
 void
@@ -306,18 +324,23 @@ __qr_inode_prune_data(xlator_t *this, qr_inode_table_t *table,
     qr_inode->data = NULL;
 
     if (!list_empty(&qr_inode->lru)) {
-        table->cache_used -= qr_inode->size;
+        GF_ATOMIC_SUB(table->cache_used, qr_inode->stored);
+        GF_ATOMIC_SUB(priv->qr_counter.data_cached, qr_inode->size);
         qr_inode->size = 0;
+        qr_inode->stored = 0;
 
         list_del_init(&qr_inode->lru);
 
         GF_ATOMIC_DEC(priv->qr_counter.files_cached);
+        if (qr_inode->compressed)
+            GF_ATOMIC_DEC(priv->qr_counter.files_compressed);
     }
+    qr_inode->compressed = _gf_false;
 
     memset(&qr_inode->buf, 0, sizeof(qr_inode->buf));
 }
 
-/* To be called with priv->table.lock held */
+/* To be called with the lock of the shard of qr_inode held */
 void
 __qr_inode_prune(xlator_t *this, qr_inode_table_t *table, qr_inode_t *qr_inode,
                  uint64_t gen)
@@ -342,72 +365,149 @@ qr_inode_prune(xlator_t *this, inode_t *inode, uint64_t gen)
     priv = this->private;
     table = &priv->table;
 
-    LOCK(&table->lock);
+    LOCK(&qr_inode->shard->lock);
     {
         __qr_inode_prune(this, table, qr_inode, gen);
     }
-    UNLOCK(&table->lock);
+    UNLOCK(&qr_inode->shard->lock);
 }
 
-/* To be called with priv->table.lock held */
-void
-__qr_cache_prune(xlator_t *this, qr_inode_table_t *table, qr_conf_t *conf)
+/* To be called with shard->lock held. Spares @keep, the file just cached.
+ * Returns _gf_true once the cache is back under cache-size. */
+gf_boolean_t
+__qr_cache_prune(xlator_t *this, qr_inode_table_t *table, qr_shard_t *shard,
+                 qr_conf_t *conf, qr_inode_t *keep)
 {
     qr_inode_t *curr = NULL;
     qr_inode_t *next = NULL;
     int index = 0;
-    size_t size_pruned = 0;
 
     for (index = 0; index < conf->max_pri; index++) {
-        list_for_each_entry_safe(curr, next, &table->lru[index], lru)
+        list_for_each_entry_safe(curr, next, &shard->lru[index], lru)
         {
-            size_pruned += curr->size;
+            if (curr == keep)
+                continue;
 
             __qr_inode_prune(this, table, curr, 0);
 
-            if (table->cache_used < conf->cache_size)
-                return;
+            if (GF_ATOMIC_GET(table->cache_used) < conf->cache_size)
+                return _gf_true;
         }
     }
 
-    return;
+    return _gf_false;
 }
 
+/* Prunes the least recently used files of one shard after the other,
+ * starting from a different shard each time, until the cache fits. */
 void
-qr_cache_prune(xlator_t *this)
+qr_cache_prune(xlator_t *this, qr_inode_t *keep)
 {
     qr_private_t *priv = NULL;
     qr_conf_t *conf = NULL;
     qr_inode_table_t *table = NULL;
+    qr_shard_t *shard = NULL;
+    gf_boolean_t done = _gf_false;
+    uint32_t hand = 0;
+    int i = 0;
 
     priv = this->private;
     table = &priv->table;
     conf = &priv->conf;
 
-    LOCK(&table->lock);
-    {
-        if (table->cache_used > conf->cache_size)
-            __qr_cache_prune(this, table, conf);
+    if (GF_ATOMIC_GET(table->cache_used) <= conf->cache_size)
+        return;
+
+    hand = GF_ATOMIC_INC(table->prune_hand);
+
+    for (i = 0; (i < QR_TABLE_SHARDS) && !done; i++) {
+        shard = &table->shards[(hand + i) % QR_TABLE_SHARDS];
+
+        LOCK(&shard->lock);
+        {
+            if (GF_ATOMIC_GET(table->cache_used) > conf->cache_size)
+                done = __qr_cache_prune(this, table, shard, conf, keep);
+            else
+                done = _gf_true;
+        }
+        UNLOCK(&shard->lock);
+    }
+}
+
+/* Compresses the content of a file, unless that saves less than an
+ * eighth of it. */
+static void *
+qr_content_deflate(const char *content, size_t size, size_t *stored)
+{
+    void *data = NULL;
+    void *tmp = NULL;
+    uLongf len = 0;
+    int ret = 0;
+
+    len = compressBound(size);
+    data = GF_MALLOC(len, gf_qr_mt_content_t);
+    if (!data)
+        return NULL;
+
+    ret = compress2(data, &len, (const Bytef *)content, size, Z_BEST_SPEED);
+    if ((ret != Z_OK) || (len > size - (size / 8))) {
+        GF_FREE(data);
+        return NULL;
     }
-    UNLOCK(&table->lock);
+
+    tmp = GF_REALLOC(data, len);
+    if (tmp)
+        data = tmp;
+
+    *stored = len;
+    return data;
+}
+
+static int
+qr_content_inflate(void *content, size_t size, const void *data, size_t stored)
+{
+    uLongf len = size;
+    int ret = 0;
+
+    ret = uncompress(content, &len, data, stored);
+    if ((ret != Z_OK) || (len != size))
+        return -1;
+
+    return 0;
 }
 
 void *
-qr_content_extract(dict_t *xdata)
+qr_content_extract(xlator_t *this, dict_t *xdata, struct iatt *buf,
+                   size_t *stored, gf_boolean_t *compressed)
 {
+    qr_private_t *priv = NULL;
     data_t *data = NULL;
     void *content = NULL;
     int ret = 0;
 
+    priv = this->private;
+
     ret = dict_get_with_ref(xdata, GF_CONTENT_KEY, &data);
     if (ret < 0 || !data)
         return NULL;
 
+    *compressed = _gf_false;
+
+    if (priv->conf.cache_compression && (data->len == buf->ia_size) &&
+        (data->len >= QR_COMPRESS_MIN_SIZE)) {
+        content = qr_content_deflate(data->data, data->len, stored);
+        if (content) {
+            *compressed = _gf_true;
+            goto out;
+        }
+    }
+
     content = GF_MALLOC(data->len, gf_qr_mt_content_t);
     if (!content)
         goto out;
 
     memcpy(content, data->data, data->len);
+    *stored = data->len;
 
 out:
     data_unref(data);
@@ -416,7 +516,8 @@ out:
 
 void
 qr_content_update(xlator_t *this, qr_inode_t *qr_inode, void *data,
-                  struct iatt *buf, uint64_t gen)
+                  size_t stored, gf_boolean_t compressed, struct iatt *buf,
+                  uint64_t gen)
 {
     qr_private_t *priv = NULL;
     qr_inode_table_t *table = NULL;
@@ -428,7 +529,7 @@ qr_content_update(xlator_t *this, qr_inode_t *qr_inode, void *data,
     priv = this->private;
     table = &priv->table;
 
-    LOCK(&table->lock);
+    LOCK(&qr_inode->shard->lock);
     {
         if ((rollover != qr_inode->gen_rollover) ||
             (gen && qr_inode->gen && (qr_inode->gen >= gen)))
@@ -442,6 +543,8 @@ qr_content_update(xlator_t *this, qr_inode_t *qr_inode, void *data,
         qr_inode->data = data;
         data = NULL;
         qr_inode->size = buf->ia_size;
+        qr_inode->stored = stored;
+        qr_inode->compressed = compressed;
 
         qr_inode->ia_mtime = buf->ia_mtime;
         qr_inode->ia_mtime_nsec = buf->ia_mtime_nsec;
@@ -454,12 +557,12 @@ qr_content_update(xlator_t *this, qr_inode_t *qr_inode, void *data,
         __qr_inode_register(this, table, qr_inode);
     }
 unlock:
-    UNLOCK(&table->lock);
+    UNLOCK(&qr_inode->shard->lock);
 
     if (data)
         GF_FREE(data);
 
-    qr_cache_prune(this);
+    qr_cache_prune(this, qr_inode);
 }
 
 gf_boolean_t
@@ -533,17 +636,11 @@ void
 qr_content_refresh(xlator_t *this, qr_inode_t *qr_inode, struct iatt *buf,
                    uint64_t gen)
 {
-    qr_private_t *priv = NULL;
-    qr_inode_table_t *table = NULL;
-
-    priv = this->private;
-    table = &priv->table;
-
-    LOCK(&table->lock);
+    LOCK(&qr_inode->shard->lock);
     {
         __qr_content_refresh(this, qr_inode, buf, gen);
     }
-    UNLOCK(&table->lock);
+    UNLOCK(&qr_inode->shard->lock);
 }
 
 gf_boolean_t
@@ -570,6 +667,8 @@ qr_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
               dict_t *xdata, struct iatt *postparent)
 {
     void *content = NULL;
+    size_t stored = 0;
+    gf_boolean_t compressed = _gf_false;
     qr_inode_t *qr_inode = NULL;
     inode_t *inode = NULL;
     qr_local_t *local = NULL;
@@ -592,7 +691,7 @@ qr_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
         goto out;
     }
 
-    content = qr_content_extract(xdata);
+    content = qr_content_extract(this, xdata, buf, &stored, &compressed);
 
     if (content) {
         /* new content came along, always replace old content */
@@ -603,7 +702,8 @@ qr_lookup_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
             goto out;
         }
 
-        qr_content_update(this, qr_inode, content, buf, local->incident_gen);
+        qr_content_update(this, qr_inode, content, stored, compressed, buf,
+                          local->incident_gen);
     } else {
         /* purge old content if necessary */
         qr_inode = qr_inode_ctx_get(this, inode);
@@ -716,6 +816,10 @@ qr_readv_cached(call_frame_t *frame, qr_inode_t *qr_inode, size_t size,
     qr_private_t *priv = NULL;
     qr_inode_table_t *table = NULL;
     int op_ret = -1;
+    void *data = NULL;
+    size_t stored = 0;
+    size_t file_size = 0;
+    off_t skip = 0;
     struct iobuf *iobuf = NULL;
     struct iobref *iobref = NULL;
     struct iovec iov = {
@@ -729,7 +833,7 @@ qr_readv_cached(call_frame_t *frame, qr_inode_t *qr_inode, size_t size,
     priv = this->private;
     table = &priv->table;
 
-    LOCK(&table->lock);
+    LOCK(&qr_inode->shard->lock);
     {
         if (!qr_inode->data)
             goto unlock;
@@ -742,7 +846,22 @@ qr_readv_cached(call_frame_t *frame, qr_inode_t *qr_inode, size_t size,
 
         op_ret = min(size, (qr_inode->size - offset));
 
-        iobuf = iobuf_get2(this->ctx->iobuf_pool, op_ret);
+        if (qr_inode->compressed) {
+            /* take a copy of the compressed content, it is inflated
+             * outside the lock */
+            data = GF_MALLOC(qr_inode->stored, gf_qr_mt_content_t);
+            if (!data) {
+                op_ret = -1;
+                goto unlock;
+            }
+
+            memcpy(data, qr_inode->data, qr_inode->stored);
+            stored = qr_inode->stored;
+            file_size = qr_inode->size;
+            skip = offset;
+        }
+
+        iobuf = iobuf_get2(this->ctx->iobuf_pool, data ? file_size : op_ret);
         if (!iobuf) {
             op_ret = -1;
             goto unlock;
@@ -756,7 +875,8 @@ qr_readv_cached(call_frame_t *frame, qr_inode_t *qr_inode, size_t size,
 
         iobref_add(iobref, iobuf);
 
-        memcpy(iobuf->ptr, qr_inode->data + offset, op_ret);
+        if (!data)
+            memcpy(iobuf->ptr, qr_inode->data + offset, op_ret);
 
         buf = qr_inode->buf;
 
@@ -764,10 +884,17 @@ qr_readv_cached(call_frame_t *frame, qr_inode_t *qr_inode, size_t size,
         __qr_inode_register(frame->this, table, qr_inode);
     }
 unlock:
-    UNLOCK(&table->lock);
+    UNLOCK(&qr_inode->shard->lock);
+
+    if (data && (op_ret >= 0)) {
+        if (qr_content_inflate(iobuf->ptr, file_size, data, stored) < 0)
+            op_ret = -1;
+    }
+
+    GF_FREE(data);
 
     if (op_ret >= 0) {
-        iov.iov_base = iobuf->ptr;
+        iov.iov_base = iobuf->ptr + skip;
         iov.iov_len = op_ret;
 
         GF_ATOMIC_INC(priv->qr_counter.cache_hit);
@@ -1054,8 +1181,10 @@ qr_priv_dump(xlator_t *this)
     qr_inode_table_t *table = NULL;
     uint32_t file_count = 0;
     uint32_t i = 0;
+    uint32_t j = 0;
     qr_inode_t *curr = NULL;
     uint64_t total_size = 0;
+    uint64_t total_data = 0;
     char key_prefix[GF_DUMP_MAX_BUF_LEN];
 
     if (!this) {
@@ -1079,17 +1208,29 @@ qr_priv_dump(xlator_t *this)
     if (!table) {
         goto out;
     } else {
-        for (i = 0; i < conf->max_pri; i++) {
-            list_for_each_entry(curr, &table->lru[i], lru)
-            {
-                file_count++;
-                total_size += curr->size;
+        for (j = 0; j < QR_TABLE_SHARDS; j++) {
+            LOCK(&table->shards[j].lock);
+            for (i = 0; i < conf->max_pri; i++) {
+                list_for_each_entry(curr, &table->shards[j].lru[i], lru)
+                {
+                    file_count++;
+                    total_size += curr->stored;
+                    total_data += curr->size;
+                }
             }
+            UNLOCK(&table->shards[j].lock);
         }
     }
 
     gf_proc_dump_write("total_files_cached", "%d", file_count);
     gf_proc_dump_write("total_cache_used", "%" PRIu64, total_size);
+    gf_proc_dump_write("total_data_cached", "%" PRIu64, total_data);
+    gf_proc_dump_write("cache_compression", "%s",
+                       conf->cache_compression ? "on" : "off");
+    gf_proc_dump_write("files-compressed", "%" GF_PRI_ATOMIC,
+                       GF_ATOMIC_GET(priv->qr_counter.files_compressed));
+    gf_proc_dump_write("compression-ratio", "%.2f",
+                       total_size ? (double)total_data / total_size : 1.0);
     gf_proc_dump_write("cache-hit", "%" GF_PRI_ATOMIC,
                        GF_ATOMIC_GET(priv->qr_counter.cache_hit));
     gf_proc_dump_write("cache-miss", "%" GF_PRI_ATOMIC,
@@ -1112,8 +1253,12 @@ qr_dump_metrics(xlator_t *this, int fd)
 
     dprintf(fd, "%s.total_files_cached %" PRId64 "\n", this->name,
             GF_ATOMIC_GET(priv->qr_counter.files_cached));
-    dprintf(fd, "%s.total_cache_used %" PRId64 "\n", this->name,
-            table->cache_used);
+    dprintf(fd, "%s.total_cache_used %" PRIu64 "\n", this->name,
+            GF_ATOMIC_GET(table->cache_used));
+    dprintf(fd, "%s.total_data_cached %" PRId64 "\n", this->name,
+            GF_ATOMIC_GET(priv->qr_counter.data_cached));
+    dprintf(fd, "%s.files-compressed %" PRId64 "\n", this->name,
+            GF_ATOMIC_GET(priv->qr_counter.files_compressed));
     dprintf(fd, "%s.cache-hit %" PRId64 "\n", this->name,
             GF_ATOMIC_GET(priv->qr_counter.cache_hit));
     dprintf(fd, "%s.cache-miss %" PRId64 "\n", this->name,
@@ -1207,6 +1352,9 @@ qr_reconfigure(xlator_t *this, dict_t *options)
     GF_OPTION_RECONF("ctime-invalidation", conf->ctime_invalidation, options,
                      bool, out);
 
+    GF_OPTION_RECONF("cache-compression", conf->cache_compression, options,
+                     bool, out);
+
     GF_OPTION_RECONF("cache-size", cache_size_new, options, size_uint64, out);
     if (!check_cache_size_ok(this, cache_size_new)) {
         ret = -1;
@@ -1321,9 +1469,10 @@ out:
 int32_t
 qr_init(xlator_t *this)
 {
-    int32_t ret = -1, i = 0;
+    int32_t ret = -1, i = 0, j = 0;
     qr_private_t *priv = NULL;
     qr_conf_t *conf = NULL;
+    qr_shard_t *shard = NULL;
 
     if (!this->children || this->children->next) {
         gf_msg(this->name, GF_LOG_ERROR, 0,
@@ -1345,7 +1494,6 @@ qr_init(xlator_t *this)
         goto out;
     }
 
-    LOCK_INIT(&priv->table.lock);
     conf = &priv->conf;
 
     GF_OPTION_INIT("max-file-size", conf->max_file_size, size_uint64, out);
@@ -1363,6 +1511,8 @@ qr_init(xlator_t *this)
 
     GF_OPTION_INIT("ctime-invalidation", conf->ctime_invalidation, bool, out);
 
+    GF_OPTION_INIT("cache-compression", conf->cache_compression, bool, out);
+
     INIT_LIST_HEAD(&conf->priority_list);
     conf->max_pri = 1;
     if (dict_get(this->options, "priority")) {
@@ -1377,24 +1527,41 @@ qr_init(xlator_t *this)
         conf->max_pri++;
     }
 
-    priv->table.lru = GF_CALLOC(conf->max_pri, sizeof(*priv->table.lru),
-                                gf_common_mt_list_head);
-    if (priv->table.lru == NULL) {
-        ret = -1;
-        goto out;
-    }
+    for (j = 0; j < QR_TABLE_SHARDS; j++) {
+        shard = &priv->table.shards[j];
+
+        shard->lru = GF_CALLOC(conf->max_pri, sizeof(*shard->lru),
+                               gf_common_mt_list_head);
+        if (shard->lru == NULL) {
+            ret = -1;
+            goto out;
+        }
+
+        for (i = 0; i < conf->max_pri; i++) {
+            INIT_LIST_HEAD(&shard->lru[i]);
+        }
 
-    for (i = 0; i < conf->max_pri; i++) {
-        INIT_LIST_HEAD(&priv->table.lru[i]);
+        LOCK_INIT(&shard->lock);
     }
 
     ret = 0;
 
+    GF_ATOMIC_INIT(priv->table.cache_used, 0);
+    GF_ATOMIC_INIT(priv->table.prune_hand, 0);
+    GF_ATOMIC_INIT(priv->qr_counter.files_compressed, 0);
+    GF_ATOMIC_INIT(priv->qr_counter.data_cached, 0);
+
     priv->last_child_down = gf_time();
     GF_ATOMIC_INIT(priv->generation, 0);
     this->private = priv;
 out:
     if ((ret == -1) && priv) {
+        for (j = 0; j < QR_TABLE_SHARDS; j++) {
+            if (priv->table.shards[j].lru) {
+                LOCK_DESTROY(&priv->table.shards[j].lock);
+                GF_FREE(priv->table.shards[j].lru);
+            }
+        }
         GF_FREE(priv);
     }
 
@@ -1405,21 +1572,29 @@ void
 qr_inode_table_destroy(qr_private_t *priv)
 {
     int i = 0;
+    int j = 0;
     qr_conf_t *conf = NULL;
+    qr_shard_t *shard = NULL;
 
     conf = &priv->conf;
 
-    for (i = 0; i < conf->max_pri; i++) {
-        /* There is a known leak of inodes, hence until
-         * that is fixed, log the assert as warning.
-        GF_ASSERT (list_empty (&priv->table.lru[i]));*/
-        if (!list_empty(&priv->table.lru[i])) {
-            gf_msg("quick-read", GF_LOG_INFO, 0, QUICK_READ_MSG_LRU_NOT_EMPTY,
-                   "quick read inode table lru not empty");
+    for (j = 0; j < QR_TABLE_SHARDS; j++) {
+        shard = &priv->table.shards[j];
+
+        for (i = 0; i < conf->max_pri; i++) {
+            /* There is a known leak of inodes, hence until
+             * that is fixed, log the assert as warning.
+            GF_ASSERT (list_empty (&shard->lru[i]));*/
+            if (!list_empty(&shard->lru[i])) {
+                gf_msg("quick-read", GF_LOG_INFO, 0,
+                       QUICK_READ_MSG_LRU_NOT_EMPTY,
+                       "quick read inode table lru not empty");
+            }
         }
-    }
 
-    LOCK_DESTROY(&priv->table.lock);
+        LOCK_DESTROY(&shard->lock);
+        GF_FREE(shard->lru);
+    }
 
     return;
 }
@@ -1625,6 +1800,17 @@ struct volume_options qr_options[] = {
                        "changes to file data. So, use this only when mtime "
                        "is not reliable",
     },
+    {
+        .key = {"cache-compression"},
+        .type = GF_OPTION_TYPE_BOOL,
+        .default_value = "off",
+        .op_version = {GD_OP_VERSION_9_0},
+        .flags = OPT_FLAG_CLIENT_OPT | OPT_FLAG_SETTABLE | OPT_FLAG_DOC,
+        .description = "Keep the cached files compressed with zlib, and "
+                       "inflate them on each read. Lets the cache hold more "
+                       "files when they compress well, at the cost of CPU "
+                       "time on every cache hit.",
+    },
     {.key = {NULL}}};
 
 xlator_api_t xlator_api = {
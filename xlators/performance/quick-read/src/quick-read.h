@@ -29,9 +29,18 @@
 #include <fnmatch.h>
 #include "quick-read-mem-types.h"
 
+#define QR_TABLE_SHARDS 16
+
+/* files smaller than this are not worth compressing */
+#define QR_COMPRESS_MIN_SIZE 512
+
+struct qr_shard;
+
 struct qr_inode {
     void *data;
-    size_t size;
+    size_t size;   /* size of the file */
+    size_t stored; /* bytes held in data, fewer than size if compressed */
+    gf_boolean_t compressed;
     int priority;
     uint32_t ia_mtime;
     uint32_t ia_mtime_nsec;
@@ -43,6 +52,7 @@ struct qr_inode {
     struct list_head lru;
     uint64_t gen;
     uint64_t invalidation_time;
+    struct qr_shard *shard;
 };
 typedef struct qr_inode qr_inode_t;
 
@@ -60,14 +70,23 @@ struct qr_conf {
     int max_pri;
     gf_boolean_t qr_invalidation;
     gf_boolean_t ctime_invalidation;
+    gf_boolean_t cache_compression;
     struct list_head priority_list;
 };
 typedef struct qr_conf qr_conf_t;
 
-struct qr_inode_table {
-    uint64_t cache_used;
-    struct list_head *lru;
+/* the lock of a shard protects the cached content and the generations of
+ * the qr_inodes in it, and its lru lists */
+struct qr_shard {
     gf_lock_t lock;
+    struct list_head *lru;
+};
+typedef struct qr_shard qr_shard_t;
+
+struct qr_inode_table {
+    gf_atomic_uint64_t cache_used; /* bytes held, counted against cache-size */
+    gf_atomic_uint32_t prune_hand;
+    qr_shard_t shards[QR_TABLE_SHARDS];
 };
 typedef struct qr_inode_table qr_inode_table_t;
 
@@ -76,6 +95,8 @@ struct qr_statistics {
     gf_atomic_t cache_miss;
     gf_atomic_t file_data_invals; /* No. of invalidates received from upcall */
     gf_atomic_t files_cached;
+    gf_atomic_t files_compressed;
+    gf_atomic_t data_cached; /* size of the cached files */
 };
 
 struct qr_private {
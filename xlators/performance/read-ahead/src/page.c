@@ -533,6 +533,40 @@ out:
     return;
 }
 
+/*
+ * ra_page_drop - drop a page the reads have gone past. a page still dirty
+ *                was read ahead for nothing, count it and shrink the window
+ *                of the stream which read it ahead.
+ * @page:
+ *
+ * to be called with the file locked, on pages nobody waits on
+ */
+void
+ra_page_drop(ra_page_t *page)
+{
+    ra_file_t *file = NULL;
+    ra_stream_t *stream = NULL;
+
+    GF_VALIDATE_OR_GOTO("read-ahead", page, out);
+
+    file = page->file;
+
+    if (page->dirty) {
+        file->wasted++;
+        GF_ATOMIC_INC(file->conf->wasted);
+
+        if (page->stream) {
+            stream = &file->streams[page->stream - 1];
+            stream->window /= 2;
+        }
+    }
+
+    ra_page_purge(page);
+
+out:
+    return;
+}
+
 /*
  * ra_page_error -
  * @page:
@@ -593,6 +627,8 @@ ra_file_destroy(ra_file_t *file)
 
     trav = file->pages.next;
     while (trav != &file->pages) {
+        if (trav->dirty)
+            GF_ATOMIC_INC(conf->wasted);
         ra_page_error(trav, -1, EINVAL);
         trav = file->pages.next;
     }
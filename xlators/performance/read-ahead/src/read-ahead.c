@@ -26,7 +26,7 @@
 #include "read-ahead-messages.h"
 
 static void
-read_ahead(call_frame_t *frame, ra_file_t *file);
+read_ahead(call_frame_t *frame, ra_file_t *file, int idx);
 
 int
 ra_open_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
@@ -57,7 +57,6 @@ ra_open_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     if ((fd->flags & O_DIRECT) || ((fd->flags & O_ACCMODE) == O_WRONLY))
         file->disabled = 1;
 
-    file->offset = (unsigned long long)0;
     file->conf = conf;
     file->pages.next = &file->pages;
     file->pages.prev = &file->pages;
@@ -74,14 +73,9 @@ ra_open_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     ra_conf_unlock(conf);
 
     file->fd = fd;
-    file->page_count = conf->page_count;
     file->page_size = conf->page_size;
     pthread_mutex_init(&file->file_lock, NULL);
 
-    if (!file->disabled) {
-        file->page_count = 1;
-    }
-
     ret = fd_ctx_set(fd, this, (uint64_t)(long)file);
     if (ret == -1) {
         gf_msg(frame->this->name, GF_LOG_WARNING, 0, READ_AHEAD_MSG_NO_MEMORY,
@@ -131,7 +125,6 @@ ra_create_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     if ((fd->flags & O_DIRECT) || ((fd->flags & O_ACCMODE) == O_WRONLY))
         file->disabled = 1;
 
-    file->offset = (unsigned long long)0;
     // file->size = fd->inode->buf.ia_size;
     file->conf = conf;
     file->pages.next = &file->pages;
@@ -149,7 +142,6 @@ ra_create_cbk(call_frame_t *frame, void *cookie, xlator_t *this, int32_t op_ret,
     ra_conf_unlock(conf);
 
     file->fd = fd;
-    file->page_count = conf->page_count;
     file->page_size = conf->page_size;
     pthread_mutex_init(&file->file_lock, NULL);
 
@@ -250,74 +242,216 @@ out:
     return 0;
 }
 
+/*
+ * __ra_stream_drop - drop the pages a stream has read, or read ahead, below
+ *                    @offset
+ *
+ * to be called with the file locked
+ */
+static void
+__ra_stream_drop(ra_file_t *file, int idx, off_t offset)
+{
+    ra_page_t *trav = NULL;
+    ra_page_t *next = NULL;
+
+    trav = file->pages.next;
+    while (trav != &file->pages && trav->offset < offset) {
+        next = trav->next;
+        if (trav->stream == idx + 1 && !trav->waitq)
+            ra_page_drop(trav);
+        trav = next;
+    }
+}
+
+/*
+ * __ra_stream_get - find the stream a read of @size bytes at @offset
+ *                   follows, or start a new one in place of the least
+ *                   recently used stream.
+ *
+ * returns the index of the stream. to be called with the file locked
+ */
+static int
+__ra_stream_get(ra_file_t *file, off_t offset, size_t size)
+{
+    ra_stream_t *stream = NULL;
+    int idx = -1;
+    int i = 0;
+
+    for (i = 0; i < RA_STREAMS; i++) {
+        stream = &file->streams[i];
+        if (!stream->size)
+            continue;
+
+        if (offset == stream->last + stream->size) {
+            stream->stride = 0;
+            idx = i;
+            break;
+        }
+
+        if (stream->stride && (offset == stream->last + stream->stride)) {
+            idx = i;
+            break;
+        }
+    }
+
+    if (idx != -1) {
+        stream->hits++;
+        if (!stream->window)
+            stream->window = 1;
+        goto update;
+    }
+
+    /* a read past the last one of a stream which has not followed any
+     * pattern yet, guess the distance between the two as its stride */
+    for (i = 0; i < RA_STREAMS; i++) {
+        stream = &file->streams[i];
+        if (!stream->size || stream->hits || (stream->last >= offset))
+            continue;
+
+        if ((idx == -1) || (stream->last > file->streams[idx].last))
+            idx = i;
+    }
+
+    if (idx != -1) {
+        stream = &file->streams[idx];
+        stream->stride = offset - stream->last;
+        goto update;
+    }
+
+    for (i = 0; i < RA_STREAMS; i++) {
+        stream = &file->streams[i];
+        if (!stream->size) {
+            idx = i;
+            break;
+        }
+
+        if ((idx == -1) || (stream->used < file->streams[idx].used))
+            idx = i;
+    }
+
+    stream = &file->streams[idx];
+    __ra_stream_drop(file, idx, (off_t)LLONG_MAX);
+    memset(stream, 0, sizeof(*stream));
+
+update:
+    stream->last = offset;
+    stream->size = size;
+    stream->used = ++file->reads;
+
+    __ra_stream_drop(file, idx, gf_floor(offset, file->page_size));
+
+    return idx;
+}
+
+/*
+ * ra_prefetch - read the page at @offset ahead for stream @idx, unless it
+ *               is already cached
+ *
+ * returns -1 if the page could not be created
+ */
+static int
+ra_prefetch(call_frame_t *frame, ra_file_t *file, int idx, off_t offset)
+{
+    ra_page_t *trav = NULL;
+    char fault = 0;
+
+    ra_file_lock(file);
+    {
+        trav = ra_page_get(file, offset);
+        if (!trav) {
+            fault = 1;
+            trav = ra_page_create(file, offset);
+            if (trav) {
+                trav->dirty = 1;
+                trav->stream = idx + 1;
+                file->prefetched++;
+            }
+        }
+    }
+    ra_file_unlock(file);
+
+    if (!trav) {
+        /* OUT OF MEMORY */
+        return -1;
+    }
+
+    if (fault) {
+        GF_ATOMIC_INC(file->conf->prefetched);
+        gf_msg_trace(frame->this->name, 0, "RA at offset=%" PRId64, offset);
+        ra_page_fault(file, frame, offset);
+    }
+
+    return 0;
+}
+
+/*
+ * read_ahead - read ahead the window of stream @idx: the pages following
+ *              its last read, or the pages of the reads which the next
+ *              strides of a strided stream will issue.
+ */
 void
-read_ahead(call_frame_t *frame, ra_file_t *file)
+read_ahead(call_frame_t *frame, ra_file_t *file, int idx)
 {
-    off_t ra_offset = 0;
-    size_t ra_size = 0;
+    ra_stream_t stream = {
+        0,
+    };
     off_t trav_offset = 0;
-    ra_page_t *trav = NULL;
+    off_t end = 0;
     off_t cap = 0;
-    char fault = 0;
+    uint32_t count = 0;
+    int k = 0;
 
     GF_VALIDATE_OR_GOTO("read-ahead", frame, out);
     GF_VALIDATE_OR_GOTO(frame->this->name, file, out);
 
-    if (!file->page_count) {
+    ra_file_lock(file);
+    {
+        stream = file->streams[idx];
+        cap = file->stbuf.ia_size;
+    }
+    ra_file_unlock(file);
+
+    /* page-count may have been lowered since the window grew */
+    stream.window = min(stream.window, file->conf->page_count);
+    if (!stream.window) {
         goto out;
     }
 
-    ra_size = file->page_size * file->page_count;
-    ra_offset = gf_floor(file->offset, file->page_size);
-    cap = file->size ? file->size : file->offset + ra_size;
+    if (!cap) {
+        cap = LLONG_MAX;
+    }
 
-    while (ra_offset < min(file->offset + ra_size, cap)) {
-        ra_file_lock(file);
-        {
-            trav = ra_page_get(file, ra_offset);
-        }
-        ra_file_unlock(file);
+    if (!stream.stride) {
+        trav_offset = gf_roof(stream.last + stream.size, file->page_size);
 
-        if (!trav)
-            break;
+        for (count = 0; count < stream.window && trav_offset < cap; count++) {
+            if (ra_prefetch(frame, file, idx, trav_offset))
+                break;
+            trav_offset += file->page_size;
+        }
 
-        ra_offset += file->page_size;
+        goto out;
     }
 
-    if (trav) {
-        /* comfortable enough */
+    /* a stride with no read in it has no page to fetch, and would never
+     * fill the window */
+    if (stream.stride < 0 || !stream.size) {
         goto out;
     }
 
-    trav_offset = ra_offset;
-
-    cap = file->size ? file->size : ra_offset + ra_size;
-
-    while (trav_offset < min(ra_offset + ra_size, cap)) {
-        fault = 0;
-        ra_file_lock(file);
-        {
-            trav = ra_page_get(file, trav_offset);
-            if (!trav) {
-                fault = 1;
-                trav = ra_page_create(file, trav_offset);
-                if (trav)
-                    trav->dirty = 1;
-            }
-        }
-        ra_file_unlock(file);
+    for (k = 1; count < stream.window; k++) {
+        trav_offset = gf_floor(stream.last + k * stream.stride,
+                               file->page_size);
+        end = stream.last + k * stream.stride + stream.size;
 
-        if (!trav) {
-            /* OUT OF MEMORY */
+        if (trav_offset >= cap)
             break;
-        }
 
-        if (fault) {
-            gf_msg_trace(frame->this->name, 0, "RA at offset=%" PRId64,
-                         trav_offset);
-            ra_page_fault(file, frame, trav_offset);
+        for (; trav_offset < end && count < stream.window; count++) {
+            if (ra_prefetch(frame, file, idx, trav_offset))
+                goto out;
+            trav_offset += file->page_size;
         }
-        trav_offset += file->page_size;
     }
 
 out:
@@ -336,7 +470,7 @@ ra_need_atime_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
 }
 
 static void
-dispatch_requests(call_frame_t *frame, ra_file_t *file)
+dispatch_requests(call_frame_t *frame, ra_file_t *file, int idx)
 {
     ra_local_t *local = NULL;
     ra_conf_t *conf = NULL;
@@ -344,6 +478,7 @@ dispatch_requests(call_frame_t *frame, ra_file_t *file)
     off_t rounded_end = 0;
     off_t trav_offset = 0;
     ra_page_t *trav = NULL;
+    ra_stream_t *owner = NULL;
     call_frame_t *ra_frame = NULL;
     char need_atime_update = 1;
     char fault = 0;
@@ -375,7 +510,21 @@ dispatch_requests(call_frame_t *frame, ra_file_t *file)
                 fault = 1;
                 need_atime_update = 0;
             }
+
+            if (trav->dirty) {
+                /* the page was read ahead for this read, let the stream
+                 * which read it ahead read further */
+                file->prefetch_hits++;
+                GF_ATOMIC_INC(conf->prefetch_hits);
+
+                if (trav->stream) {
+                    owner = &file->streams[trav->stream - 1];
+                    owner->window = min(max(owner->window * 2, 1),
+                                        conf->page_count);
+                }
+            }
             trav->dirty = 0;
+            trav->stream = idx + 1;
 
             if (trav->ready) {
                 gf_msg_trace(frame->this->name, 0, "HIT at offset=%" PRId64 ".",
@@ -443,17 +592,14 @@ ra_readv(call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
 {
     ra_file_t *file = NULL;
     ra_local_t *local = NULL;
-    ra_conf_t *conf = NULL;
     int op_errno = EINVAL;
-    char expected_offset = 1;
     uint64_t tmp_file = 0;
+    int idx = 0;
 
     GF_ASSERT(frame);
     GF_VALIDATE_OR_GOTO(frame->this->name, this, unwind);
     GF_VALIDATE_OR_GOTO(frame->this->name, fd, unwind);
 
-    conf = this->private;
-
     gf_msg_trace(this->name, 0,
                  "NEW REQ at offset=%" PRId64 " for size=%" GF_PRI_SIZET "",
                  offset, size);
@@ -465,30 +611,6 @@ ra_readv(call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
         goto disabled;
     }
 
-    if (file->offset != offset) {
-        gf_msg_trace(this->name, 0,
-                     "unexpected offset (%" PRId64 " != %" PRId64
-                     ") "
-                     "resetting",
-                     file->offset, offset);
-
-        expected_offset = file->expected = file->page_count = 0;
-    } else {
-        gf_msg_trace(this->name, 0,
-                     "expected offset (%" PRId64 ") when page_count=%d", offset,
-                     file->page_count);
-
-        if (file->expected < (file->page_size * conf->page_count)) {
-            file->expected += size;
-            file->page_count = min((file->expected / file->page_size),
-                                   conf->page_count);
-        }
-    }
-
-    if (!expected_offset) {
-        flush_region(frame, file, 0, file->pages.prev->offset + 1, 0);
-    }
-
     local = mem_get0(this->local_pool);
     if (!local) {
         op_errno = ENOMEM;
@@ -507,13 +629,20 @@ ra_readv(call_frame_t *frame, xlator_t *this, fd_t *fd, size_t size,
 
     frame->local = local;
 
-    dispatch_requests(frame, file);
+    ra_file_lock(file);
+    {
+        idx = __ra_stream_get(file, offset, size);
+    }
+    ra_file_unlock(file);
 
-    flush_region(frame, file, 0, gf_floor(offset, file->page_size), 0);
+    gf_msg_trace(this->name, 0,
+                 "stream %d: stride=%" PRId64 " window=%u for offset=%" PRId64,
+                 idx, file->streams[idx].stride, file->streams[idx].window,
+                 offset);
 
-    read_ahead(frame, file);
+    dispatch_requests(frame, file, idx);
 
-    file->offset = offset + size;
+    read_ahead(frame, file, idx);
 
     ra_frame_return(frame);
 
@@ -641,8 +770,12 @@ ra_writev(call_frame_t *frame, xlator_t *this, fd_t *fd, struct iovec *vector,
 
             flush_region(frame, file, 0, file->pages.prev->offset + 1, 1);
 
-            /* reset the read-ahead counters too */
-            file->expected = file->page_count = 0;
+            /* reset the read-ahead streams too */
+            ra_file_lock(file);
+            {
+                memset(file->streams, 0, sizeof(file->streams));
+            }
+            ra_file_unlock(file);
         }
     }
     UNLOCK(&inode->lock);
@@ -767,7 +900,8 @@ ra_fdctx_dump(xlator_t *this, fd_t *fd)
 {
     ra_file_t *file = NULL;
     ra_page_t *page = NULL;
-    int32_t ret = 0, i = 0;
+    ra_stream_t *stream = NULL;
+    int32_t ret = 0, i = 0, j = 0;
     uint64_t tmp_file = 0;
     char *path = NULL;
     char key_prefix[GF_DUMP_MAX_BUF_LEN] = {
@@ -803,10 +937,23 @@ ra_fdctx_dump(xlator_t *this, fd_t *fd)
 
     gf_proc_dump_write("page-size", "%" PRId64, file->page_size);
 
-    gf_proc_dump_write("page-count", "%u", file->page_count);
+    gf_proc_dump_write("prefetched", "%" PRIu64, file->prefetched);
+
+    gf_proc_dump_write("prefetch-hits", "%" PRIu64, file->prefetch_hits);
+
+    gf_proc_dump_write("wasted", "%" PRIu64, file->wasted);
 
-    gf_proc_dump_write("next-expected-offset-for-sequential-reads", "%" PRId64,
-                       file->offset);
+    for (j = 0; j < RA_STREAMS; j++) {
+        stream = &file->streams[j];
+        if (!stream->size)
+            continue;
+
+        gf_proc_dump_write("stream",
+                           "%d: last=%" PRId64 " size=%" GF_PRI_SIZET
+                           " stride=%" PRId64 " hits=%u window=%u",
+                           j, stream->last, stream->size, stream->stride,
+                           stream->hits, stream->window);
+    }
 
     for (page = file->pages.next; page != &file->pages; page = page->next) {
         gf_proc_dump_write("page", "%d: %p", i++, (void *)page);
@@ -1045,6 +1192,11 @@ ra_priv_dump(xlator_t *this)
         gf_proc_dump_write("page_count", "%d", conf->page_count);
         gf_proc_dump_write("force_atime_update", "%d",
                            conf->force_atime_update);
+        gf_proc_dump_write("prefetched", "%" PRIu64,
+                           GF_ATOMIC_GET(conf->prefetched));
+        gf_proc_dump_write("prefetch_hits", "%" PRIu64,
+                           GF_ATOMIC_GET(conf->prefetch_hits));
+        gf_proc_dump_write("wasted", "%" PRIu64, GF_ATOMIC_GET(conf->wasted));
     }
     pthread_mutex_unlock(&conf->conf_lock);
 
@@ -1139,6 +1291,10 @@ init(xlator_t *this)
     conf->files.next = &conf->files;
     conf->files.prev = &conf->files;
 
+    GF_ATOMIC_INIT(conf->prefetched, 0);
+    GF_ATOMIC_INIT(conf->prefetch_hits, 0);
+    GF_ATOMIC_INIT(conf->wasted, 0);
+
     pthread_mutex_init(&conf->conf_lock, NULL);
 
     this->local_pool = mem_pool_new(ra_local_t, 64);
@@ -18,6 +18,8 @@
 #include <glusterfs/common-utils.h>
 #include "read-ahead-mem-types.h"
 
+#define RA_STREAMS 4
+
 struct ra_conf;
 struct ra_local;
 struct ra_page;
@@ -67,6 +69,21 @@ struct ra_page {
     struct ra_waitq *waitq;
     struct iobref *iobref;
     char stale;
+    int8_t stream; /* 1 + index of the stream reading it, 0 if none */
+};
+
+/*
+ * ra_stream - an access pattern followed by the reads on a fd: reads of
+ *             @size bytes, each @stride bytes after the previous one, or
+ *             right after it when @stride is 0.
+ */
+struct ra_stream {
+    off_t last;      /* offset of the last read */
+    size_t size;     /* size of the last read, 0 if the stream is unused */
+    off_t stride;
+    uint32_t hits;   /* reads which followed the pattern */
+    uint32_t window; /* pages to read ahead, grows on use, shrinks on waste */
+    uint64_t used;   /* read count of the fd when last read from */
 };
 
 struct ra_file {
@@ -75,15 +92,17 @@ struct ra_file {
     struct ra_conf *conf;
     fd_t *fd;
     int disabled;
-    size_t expected;
     struct ra_page pages;
-    off_t offset;
     size_t size;
     int32_t refcount;
     pthread_mutex_t file_lock;
     struct iatt stbuf;
     uint64_t page_size;
-    uint32_t page_count;
+    struct ra_stream streams[RA_STREAMS];
+    uint64_t reads;
+    uint64_t prefetched;    /* pages read ahead */
+    uint64_t prefetch_hits; /* of those, pages read by the application */
+    uint64_t wasted;        /* of those, pages dropped without being read */
 };
 
 struct ra_conf {
@@ -93,6 +112,9 @@ struct ra_conf {
     struct ra_file files;
     gf_boolean_t force_atime_update;
     pthread_mutex_t conf_lock;
+    gf_atomic_uint64_t prefetched;
+    gf_atomic_uint64_t prefetch_hits;
+    gf_atomic_uint64_t wasted;
 };
 
 typedef struct ra_conf ra_conf_t;
@@ -101,6 +123,7 @@ typedef struct ra_page ra_page_t;
 typedef struct ra_file ra_file_t;
 typedef struct ra_waitq ra_waitq_t;
 typedef struct ra_fill ra_fill_t;
+typedef struct ra_stream ra_stream_t;
 
 ra_page_t *
 ra_page_get(ra_file_t *file, off_t offset);
@@ -108,6 +131,9 @@ ra_page_get(ra_file_t *file, off_t offset);
 ra_page_t *
 ra_page_create(ra_file_t *file, off_t offset);
 
+void
+ra_page_drop(ra_page_t *page);
+
 void
 ra_page_fault(ra_file_t *file, call_frame_t *frame, off_t offset);
 void
@@ -15,6 +15,7 @@
 #include "glusterfs4-xdr.h"
 #include "glusterfs3.h"
 #include "client.h"
+#include <glusterfs/compat-errno.h>
 
 /* processing to be done before fops are woudn down */
 int
@@ -3587,3 +3588,159 @@ client_post_rename_v2(xlator_t *this, gfx_rename_rsp *rsp, struct iatt *stbuf,
 
     return xdr_to_dict(&rsp->xdata, xdata);
 }
+
+int
+client_pre_compound_v2(xlator_t *this, gfx_compound_req *req,
+                       compound_args_t *args)
+{
+    compound_req_v2 *item = NULL;
+    default_args_t *fop_args = NULL;
+    unsigned int writes = 0;
+    unsigned int i = 0;
+    int ret = 0;
+
+    req->compound_req_array.compound_req_array_val = GF_CALLOC(
+        args->fop_length, sizeof(*item), gf_client_mt_compound_req_t);
+    if (!req->compound_req_array.compound_req_array_val)
+        return -ENOMEM;
+
+    req->compound_req_array.compound_req_array_len = args->fop_length;
+
+    for (i = 0; i < args->fop_length; i++) {
+        item = &req->compound_req_array.compound_req_array_val[i];
+        fop_args = &args->req_list[i];
+
+        item->fop_enum = args->enum_list[i];
+        switch (item->fop_enum) {
+            case GF_FOP_INODELK:
+                ret = client_pre_inodelk_v2(
+                    this, &item->compound_req_v2_u.compound_inodelk_req,
+                    &fop_args->loc, fop_args->cmd, &fop_args->lock,
+                    fop_args->volume, fop_args->xdata);
+                break;
+            case GF_FOP_FINODELK:
+                ret = client_pre_finodelk_v2(
+                    this, &item->compound_req_v2_u.compound_finodelk_req,
+                    fop_args->fd, fop_args->cmd, &fop_args->lock,
+                    fop_args->volume, fop_args->xdata);
+                break;
+            case GF_FOP_XATTROP:
+                ret = client_pre_xattrop_v2(
+                    this, &item->compound_req_v2_u.compound_xattrop_req,
+                    &fop_args->loc, fop_args->xattr, fop_args->optype,
+                    fop_args->xdata);
+                break;
+            case GF_FOP_FXATTROP:
+                ret = client_pre_fxattrop_v2(
+                    this, &item->compound_req_v2_u.compound_fxattrop_req,
+                    fop_args->fd, fop_args->xattr, fop_args->optype,
+                    fop_args->xdata);
+                break;
+            case GF_FOP_WRITE:
+                /* the payload follows the request, it can only be the
+                 * one of a single write */
+                if (writes++) {
+                    ret = -EINVAL;
+                    break;
+                }
+                ret = client_pre_writev_v2(
+                    this, &item->compound_req_v2_u.compound_write_req,
+                    fop_args->fd, iov_length(fop_args->vector, fop_args->count),
+                    fop_args->offset, fop_args->flags, &fop_args->xdata);
+                break;
+            default:
+                ret = -ENOTSUP;
+                break;
+        }
+        if (ret)
+            return ret;
+    }
+
+    dict_to_xdr(args->xdata, &req->xdata);
+
+    return 0;
+}
+
+void
+client_compound_req_cleanup_v2(gfx_compound_req *req)
+{
+    compound_req_v2 *item = NULL;
+    unsigned int i = 0;
+
+    for (i = 0; i < req->compound_req_array.compound_req_array_len; i++) {
+        item = &req->compound_req_array.compound_req_array_val[i];
+
+        switch (item->fop_enum) {
+            case GF_FOP_INODELK:
+                GF_FREE(item->compound_req_v2_u.compound_inodelk_req.xdata
+                            .pairs.pairs_val);
+                break;
+            case GF_FOP_FINODELK:
+                GF_FREE(item->compound_req_v2_u.compound_finodelk_req.xdata
+                            .pairs.pairs_val);
+                break;
+            case GF_FOP_XATTROP:
+                GF_FREE(item->compound_req_v2_u.compound_xattrop_req.dict.pairs
+                            .pairs_val);
+                GF_FREE(item->compound_req_v2_u.compound_xattrop_req.xdata
+                            .pairs.pairs_val);
+                break;
+            case GF_FOP_FXATTROP:
+                GF_FREE(item->compound_req_v2_u.compound_fxattrop_req.dict
+                            .pairs.pairs_val);
+                GF_FREE(item->compound_req_v2_u.compound_fxattrop_req.xdata
+                            .pairs.pairs_val);
+                break;
+            case GF_FOP_WRITE:
+                GF_FREE(item->compound_req_v2_u.compound_write_req.xdata.pairs
+                            .pairs_val);
+                break;
+        }
+    }
+
+    GF_FREE(req->compound_req_array.compound_req_array_val);
+    GF_FREE(req->xdata.pairs.pairs_val);
+}
+
+int
+client_post_compound_v2(xlator_t *this, compound_rsp_v2 *item,
+                        default_args_cbk_t *rsp)
+{
+    gfx_common_rsp *lk_rsp = NULL;
+    gfx_common_dict_rsp *xattrop_rsp = NULL;
+    gfx_common_2iatt_rsp *write_rsp = NULL;
+    int ret = 0;
+
+    switch (item->fop_enum) {
+        case GF_FOP_INODELK:
+        case GF_FOP_FINODELK:
+            lk_rsp = &item->compound_rsp_v2_u.compound_inodelk_rsp;
+            rsp->op_ret = lk_rsp->op_ret;
+            rsp->op_errno = gf_error_to_errno(lk_rsp->op_errno);
+            xdr_to_dict(&lk_rsp->xdata, &rsp->xdata);
+            break;
+        case GF_FOP_XATTROP:
+        case GF_FOP_FXATTROP:
+            xattrop_rsp = &item->compound_rsp_v2_u.compound_xattrop_rsp;
+            /* as for a single xattrop, success is always 0 */
+            rsp->op_ret = (xattrop_rsp->op_ret == -1) ? -1 : 0;
+            rsp->op_errno = gf_error_to_errno(xattrop_rsp->op_errno);
+            client_post_common_dict(this, xattrop_rsp, &rsp->xattr,
+                                    &rsp->xdata);
+            break;
+        case GF_FOP_WRITE:
+            write_rsp = &item->compound_rsp_v2_u.compound_write_rsp;
+            rsp->op_ret = write_rsp->op_ret;
+            rsp->op_errno = gf_error_to_errno(write_rsp->op_errno);
+            client_post_common_2iatt(this, write_rsp, &rsp->prestat,
+                                     &rsp->poststat, &rsp->xdata);
+            break;
+        default:
+            rsp->op_ret = -1;
+            rsp->op_errno = ENOTSUP;
+            ret = -ENOTSUP;
+            break;
+    }
+
+    return ret;
+}
@@ -627,4 +627,15 @@ client_pre_copy_file_range_v2(xlator_t *this, gfx_copy_file_range_req *req,
                               off64_t off_out, size_t size, int32_t flags,
                               dict_t **xdata);
 
+int
+client_pre_compound_v2(xlator_t *this, gfx_compound_req *req,
+                       compound_args_t *args);
+
+void
+client_compound_req_cleanup_v2(gfx_compound_req *req);
+
+int
+client_post_compound_v2(xlator_t *this, compound_rsp_v2 *item,
+                        default_args_cbk_t *rsp);
+
 #endif /* __CLIENT_COMMON_H__ */
@@ -5727,6 +5727,84 @@ out:
     return 0;
 }
 
+int
+client4_0_compound_cbk(struct rpc_req *req, struct iovec *iov, int count,
+                       void *myframe)
+{
+    call_frame_t *frame = NULL;
+    gfx_compound_rsp rsp = {
+        0,
+    };
+    compound_args_cbk_t *args_cbk = NULL;
+    compound_rsp_v2 *item = NULL;
+    clnt_local_t *local = NULL;
+    xlator_t *this = NULL;
+    dict_t *xdata = NULL;
+    unsigned int length = 0;
+    unsigned int i = 0;
+    int op_errno = 0;
+    int ret = 0;
+
+    this = THIS;
+
+    frame = myframe;
+    local = frame->local;
+
+    if (-1 == req->rpc_status) {
+        rsp.op_ret = -1;
+        op_errno = ENOTCONN;
+        goto out;
+    }
+
+    ret = xdr_to_generic(*iov, &rsp, (xdrproc_t)xdr_gfx_compound_rsp);
+    if (ret < 0) {
+        gf_smsg(this->name, GF_LOG_ERROR, EINVAL, PC_MSG_XDR_DECODING_FAILED,
+                NULL);
+        rsp.op_ret = -1;
+        op_errno = EINVAL;
+        goto out;
+    }
+
+    op_errno = gf_error_to_errno(rsp.op_errno);
+    xdr_to_dict(&rsp.xdata, &xdata);
+
+    length = rsp.compound_rsp_array.compound_rsp_array_len;
+    args_cbk = compound_args_cbk_alloc(length, xdata);
+    if (!args_cbk) {
+        rsp.op_ret = -1;
+        op_errno = ENOMEM;
+        goto out;
+    }
+
+    for (i = 0; i < length; i++) {
+        item = &rsp.compound_rsp_array.compound_rsp_array_val[i];
+        args_cbk->enum_list[i] = item->fop_enum;
+        if (client_post_compound_v2(this, item, &args_cbk->rsp_list[i])) {
+            rsp.op_ret = -1;
+            op_errno = EINVAL;
+        }
+    }
+out:
+    if (rsp.op_ret == -1) {
+        gf_smsg(this->name, GF_LOG_WARNING, op_errno, PC_MSG_REMOTE_OP_FAILED,
+                NULL);
+    } else if (local && local->attempt_reopen) {
+        client_attempt_reopen(local->fd, this);
+    }
+
+    CLIENT_STACK_UNWIND(compound, frame, rsp.op_ret, op_errno,
+                        (rsp.op_ret == -1) ? NULL : args_cbk, xdata);
+
+    free(rsp.compound_rsp_array.compound_rsp_array_val);
+
+    compound_args_cbk_cleanup(args_cbk);
+
+    if (xdata)
+        dict_unref(xdata);
+
+    return 0;
+}
+
 int32_t
 client4_0_namelink(call_frame_t *frame, xlator_t *this, void *data)
 {
@@ -6048,6 +6126,97 @@ unwind:
     return 0;
 }
 
+int32_t
+client4_0_compound(call_frame_t *frame, xlator_t *this, void *data)
+{
+    compound_args_t *args = NULL;
+    clnt_conf_t *conf = NULL;
+    gfx_compound_req req = {
+        {
+            0,
+        },
+    };
+    gfx_finodelk_req *lk_req = NULL;
+    gfx_fxattrop_req *xattrop_req = NULL;
+    gfx_write_req *write_req = NULL;
+    default_args_t *fop_args = NULL;
+    client_payload_t cp;
+    int64_t remote_fd = -1;
+    unsigned int i = 0;
+    int op_errno = EINVAL;
+    int ret = 0;
+
+    if (!frame || !this || !data)
+        goto unwind;
+
+    args = data;
+    conf = this->private;
+
+    ret = client_pre_compound_v2(this, &req, args);
+    if (ret) {
+        op_errno = -ret;
+        goto unwind;
+    }
+
+    /* the fd of the first fd based fop is reopened if needed, as it would
+     * be by the fop sent on its own */
+    for (i = 0; i < args->fop_length; i++) {
+        fop_args = &args->req_list[i];
+        if (args->enum_list[i] == GF_FOP_FINODELK) {
+            lk_req = &req.compound_req_array.compound_req_array_val[i]
+                          .compound_req_v2_u.compound_finodelk_req;
+            remote_fd = lk_req->fd;
+        } else if (args->enum_list[i] == GF_FOP_FXATTROP) {
+            xattrop_req = &req.compound_req_array.compound_req_array_val[i]
+                               .compound_req_v2_u.compound_fxattrop_req;
+            remote_fd = xattrop_req->fd;
+        } else if (args->enum_list[i] == GF_FOP_WRITE) {
+            write_req = &req.compound_req_array.compound_req_array_val[i]
+                             .compound_req_v2_u.compound_write_req;
+            remote_fd = write_req->fd;
+        } else {
+            continue;
+        }
+
+        ret = client_fd_fop_prepare_local(frame, fop_args->fd, remote_fd);
+        if (ret) {
+            op_errno = -ret;
+            goto unwind;
+        }
+        break;
+    }
+
+    /* the data of the write, if any, is sent after the request */
+    memset(&cp, 0, sizeof(client_payload_t));
+    for (i = 0; i < args->fop_length; i++) {
+        if (args->enum_list[i] != GF_FOP_WRITE)
+            continue;
+
+        cp.iobref = args->req_list[i].iobref;
+        cp.payload = args->req_list[i].vector;
+        cp.payload_cnt = args->req_list[i].count;
+        break;
+    }
+
+    ret = client_submit_request(this, &req, frame, conf->fops, GFS3_OP_COMPOUND,
+                                client4_0_compound_cbk, &cp,
+                                (xdrproc_t)xdr_gfx_compound_req);
+    if (ret) {
+        gf_smsg(this->name, GF_LOG_WARNING, 0, PC_MSG_FOP_SEND_FAILED, NULL);
+    } else {
+        GF_ATOMIC_INC(conf->compound_fops);
+    }
+
+    client_compound_req_cleanup_v2(&req);
+
+    return 0;
+unwind:
+    CLIENT_STACK_UNWIND(compound, frame, -1, op_errno, NULL, NULL);
+    client_compound_req_cleanup_v2(&req);
+
+    return 0;
+}
+
 /* Used From RPC-CLNT library to log proper name of procedure based on number */
 char *clnt4_0_fop_names[GFS3_OP_MAXVALUE] = {
     [GFS3_OP_NULL] = "NULL",
@@ -6161,7 +6330,7 @@ rpc_clnt_procedure_t clnt4_0_fop_actors[GF_FOP_MAXVALUE] = {
     [GF_FOP_LEASE] = {"LEASE", client4_0_lease},
     [GF_FOP_GETACTIVELK] = {"GETACTIVELK", client4_0_getactivelk},
     [GF_FOP_SETACTIVELK] = {"SETACTIVELK", client4_0_setactivelk},
-    [GF_FOP_COMPOUND] = {"COMPOUND", NULL},
+    [GF_FOP_COMPOUND] = {"COMPOUND", client4_0_compound},
     [GF_FOP_ICREATE] = {"ICREATE", client4_0_icreate},
     [GF_FOP_NAMELINK] = {"NAMELINK", client4_0_namelink},
     [GF_FOP_COPY_FILE_RANGE] = {"COPY-FILE-RANGE", client4_0_copy_file_range},
@@ -2619,6 +2619,7 @@ init(xlator_t *this)
     INIT_LIST_HEAD(&conf->saved_fds);
 
     conf->child_up = _gf_false;
+    GF_ATOMIC_INIT(conf->compound_fops, 0);
 
     /* Set event threads to the configured default */
     GF_OPTION_INIT("event-threads", conf->event_threads, int32, out);
@@ -2786,6 +2787,8 @@ client_priv_dump(xlator_t *this)
     pthread_spin_unlock(&conf->fd_lock);
 
     gf_proc_dump_write("connected", "%d", conf->connected);
+    gf_proc_dump_write("compound_fops", "%" PRIu64,
+                       GF_ATOMIC_GET(conf->compound_fops));
 
     if (conf->rpc) {
         conn = &conf->rpc->conn;
@@ -2794,6 +2797,18 @@ client_priv_dump(xlator_t *this)
         gf_proc_dump_write("ping_timeout", "%" PRIu32, conn->ping_timeout);
         gf_proc_dump_write("total_bytes_written", "%" PRIu64,
                            conn->trans->total_bytes_write);
+        gf_proc_dump_write("total_writes", "%" PRIu64,
+                           conn->trans->total_writes);
+        if (conn->trans->total_writes)
+            gf_proc_dump_write("bytes_per_write", "%" PRIu64,
+                               conn->trans->total_bytes_write /
+                                   conn->trans->total_writes);
+        gf_proc_dump_write("zerocopy_sends", "%" PRIu64,
+                           conn->trans->zerocopy_sends);
+        gf_proc_dump_write("zerocopy_completions", "%" PRIu64,
+                           conn->trans->zerocopy_completions);
+        gf_proc_dump_write("zerocopy_copied", "%" PRIu64,
+                           conn->trans->zerocopy_copied);
         gf_proc_dump_write("ping_msgs_sent", "%" PRIu64, conn->pingcnt);
         gf_proc_dump_write("msgs_sent", "%" PRIu64, conn->msgcnt);
     }
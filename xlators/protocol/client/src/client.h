@@ -159,6 +159,8 @@ typedef struct clnt_conf {
 
     gf_boolean_t connection_to_brick; /*True from attempt to connect to brick
                                         till disconnection to brick*/
+
+    gf_atomic_t compound_fops; /* COMPOUND requests sent to the brick */
 } clnt_conf_t;
 
 typedef struct _client_fd_ctx {
@@ -165,4 +165,5 @@ GLFS_MSGID(
 #define PS_MSG_REMOTE_SUBVOL_NOT_SPECIFIED_STR "remote-subvolume not specified"
 #define PS_MSG_LOGIN_ERROR_STR "wrong password for user"
 #define PS_MSG_NO_MEM_STR "No memory"
+#define PS_MSG_COMPOUND_INFO_STR "refusing compound with too many fops"
 #endif /* !_PS_MESSAGES_H__ */
@@ -5872,11 +5872,654 @@ out:
     return ret;
 }
 
+/* AFR sends at most two fops in a compound: an xattrop and an unlock, or an
+ * xattrop and a write. Longer requests are refused. */
+#define SERVER4_COMPOUND_MAX_FOPS 8
+
+/* The fops of a compound are run one after the other, each on a frame of its
+ * own, whatever the result of the previous ones but for a write. The reply of
+ * each fop is kept until the last one is done and all of them are sent
+ * together. */
+typedef struct {
+    call_frame_t *frame; /* frame of the compound, replied with */
+    gfx_compound_req args;
+    ssize_t len; /* of the request, the payload of its write follows */
+    gfx_compound_rsp rsp;
+    dict_t **dicts; /* referenced by the replies until they are sent */
+    unsigned int dict_count;
+    unsigned int next;
+    /* The fop just started and the loop starting it both drop a count
+     * when they are done with it; the last one runs the next fop. This
+     * keeps fops completing in the loop from recursing into it. */
+    gf_atomic_t pending;
+} server_compound_t;
+
+static void
+server4_compound_run(server_compound_t *compound);
+
+static void
+server4_compound_keep(server_compound_t *compound, dict_t *dict)
+{
+    if (dict)
+        compound->dicts[compound->dict_count++] = dict_ref(dict);
+}
+
+static compound_rsp_v2 *
+server4_compound_current(server_compound_t *compound)
+{
+    return &compound->rsp.compound_rsp_array
+                .compound_rsp_array_val[compound->next - 1];
+}
+
+/* Releases the frame of a fop of the compound, and runs the next one. */
+static void
+server4_compound_fop_done(call_frame_t *frame)
+{
+    server_compound_t *compound = frame->local;
+    server_state_t *state = CALL_STATE(frame);
+    client_t *client = frame->root->client;
+
+    frame->local = NULL;
+
+    if (client)
+        gf_client_unref(client);
+
+    STACK_DESTROY(frame->root);
+    free_state(state);
+
+    if (GF_ATOMIC_DEC(compound->pending) == 0)
+        server4_compound_run(compound);
+}
+
+static int
+server4_compound_lk_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                        int32_t op_ret, int32_t op_errno, dict_t *xdata)
+{
+    server_compound_t *compound = frame->local;
+    server_state_t *state = NULL;
+    gfx_common_rsp *rsp = NULL;
+
+    rsp = &server4_compound_current(compound)
+               ->compound_rsp_v2_u.compound_inodelk_rsp;
+
+    if (op_ret < 0) {
+        state = CALL_STATE(frame);
+        gf_smsg(this->name, fop_log_level(frame->root->op, op_errno), op_errno,
+                PS_MSG_INODELK_INFO, "frame=%" PRId64, frame->root->unique,
+                "fop=%s", gf_fop_list[frame->root->op], "uuid_utoa=%s",
+                uuid_utoa(state->resolve.gfid), "client=%s",
+                STACK_CLIENT_NAME(frame->root), "error-xlator=%s",
+                STACK_ERR_XL_NAME(frame->root), NULL);
+    }
+
+    server4_compound_keep(compound, xdata);
+    dict_to_xdr(xdata, &rsp->xdata);
+
+    rsp->op_ret = op_ret;
+    rsp->op_errno = gf_errno_to_error(op_errno);
+
+    server4_compound_fop_done(frame);
+
+    return 0;
+}
+
+static int
+server4_compound_xattrop_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                             int32_t op_ret, int32_t op_errno, dict_t *dict,
+                             dict_t *xdata)
+{
+    server_compound_t *compound = frame->local;
+    server_state_t *state = NULL;
+    gfx_common_dict_rsp *rsp = NULL;
+
+    rsp = &server4_compound_current(compound)
+               ->compound_rsp_v2_u.compound_xattrop_rsp;
+
+    if (op_ret < 0) {
+        state = CALL_STATE(frame);
+        gf_smsg(this->name, fop_log_level(frame->root->op, op_errno), op_errno,
+                PS_MSG_XATTROP_INFO, "frame=%" PRId64, frame->root->unique,
+                "fop=%s", gf_fop_list[frame->root->op], "uuid_utoa=%s",
+                uuid_utoa(state->resolve.gfid), "client=%s",
+                STACK_CLIENT_NAME(frame->root), "error-xlator=%s",
+                STACK_ERR_XL_NAME(frame->root), NULL);
+        dict_to_xdr(NULL, &rsp->dict);
+    } else {
+        server4_compound_keep(compound, dict);
+        dict_to_xdr(dict, &rsp->dict);
+    }
+
+    server4_compound_keep(compound, xdata);
+    dict_to_xdr(xdata, &rsp->xdata);
+
+    rsp->op_ret = op_ret;
+    rsp->op_errno = gf_errno_to_error(op_errno);
+
+    server4_compound_fop_done(frame);
+
+    return 0;
+}
+
+static int
+server4_compound_write_cbk(call_frame_t *frame, void *cookie, xlator_t *this,
+                           int32_t op_ret, int32_t op_errno,
+                           struct iatt *prebuf, struct iatt *postbuf,
+                           dict_t *xdata)
+{
+    server_compound_t *compound = frame->local;
+    server_state_t *state = NULL;
+    gfx_common_2iatt_rsp *rsp = NULL;
+
+    rsp = &server4_compound_current(compound)
+               ->compound_rsp_v2_u.compound_write_rsp;
+
+    if (op_ret < 0) {
+        state = CALL_STATE(frame);
+        gf_smsg(this->name, fop_log_level(GF_FOP_WRITE, op_errno), op_errno,
+                PS_MSG_WRITE_INFO, "frame=%" PRId64, frame->root->unique,
+                "WRITEV_fd_no=%" PRId64, state->resolve.fd_no, "uuid_utoa=%s",
+                uuid_utoa(state->resolve.gfid), "client=%s",
+                STACK_CLIENT_NAME(frame->root), "error-xlator=%s",
+                STACK_ERR_XL_NAME(frame->root), NULL);
+    } else {
+        server4_post_common_2iatt(rsp, prebuf, postbuf);
+    }
+
+    server4_compound_keep(compound, xdata);
+    dict_to_xdr(xdata, &rsp->xdata);
+
+    rsp->op_ret = op_ret;
+    rsp->op_errno = gf_errno_to_error(op_errno);
+
+    server4_compound_fop_done(frame);
+
+    return 0;
+}
+
+static int
+server4_compound_inodelk_resume(call_frame_t *frame, xlator_t *bound_xl)
+{
+    GF_UNUSED int ret = -1;
+    server_state_t *state = NULL;
+
+    state = CALL_STATE(frame);
+
+    if (state->resolve.op_ret != 0)
+        goto err;
+
+    if (!state->xdata)
+        state->xdata = dict_new();
+
+    if (state->xdata)
+        ret = dict_set_str(state->xdata, "connection-id",
+                           frame->root->client->client_uid);
+
+    if (frame->root->op == GF_FOP_FINODELK)
+        STACK_WIND(frame, server4_compound_lk_cbk, bound_xl,
+                   bound_xl->fops->finodelk, state->volume, state->fd,
+                   state->cmd, &state->flock, state->xdata);
+    else
+        STACK_WIND(frame, server4_compound_lk_cbk, bound_xl,
+                   bound_xl->fops->inodelk, state->volume, &state->loc,
+                   state->cmd, &state->flock, state->xdata);
+    return 0;
+err:
+    server4_compound_lk_cbk(frame, NULL, frame->this, state->resolve.op_ret,
+                            state->resolve.op_errno, NULL);
+    return 0;
+}
+
+static int
+server4_compound_xattrop_resume(call_frame_t *frame, xlator_t *bound_xl)
+{
+    server_state_t *state = NULL;
+
+    state = CALL_STATE(frame);
+
+    if (state->resolve.op_ret != 0)
+        goto err;
+
+    if (frame->root->op == GF_FOP_FXATTROP)
+        STACK_WIND(frame, server4_compound_xattrop_cbk, bound_xl,
+                   bound_xl->fops->fxattrop, state->fd, state->flags,
+                   state->dict, state->xdata);
+    else
+        STACK_WIND(frame, server4_compound_xattrop_cbk, bound_xl,
+                   bound_xl->fops->xattrop, &state->loc, state->flags,
+                   state->dict, state->xdata);
+    return 0;
+err:
+    server4_compound_xattrop_cbk(frame, NULL, frame->this,
+                                 state->resolve.op_ret,
+                                 state->resolve.op_errno, NULL, NULL);
+    return 0;
+}
+
+static int
+server4_compound_write_resume(call_frame_t *frame, xlator_t *bound_xl)
+{
+    server_state_t *state = NULL;
+
+    state = CALL_STATE(frame);
+
+    if (state->resolve.op_ret != 0)
+        goto err;
+
+    STACK_WIND(frame, server4_compound_write_cbk, bound_xl,
+               bound_xl->fops->writev, state->fd, state->payload_vector,
+               state->payload_count, state->offset, state->flags,
+               state->iobref, state->xdata);
+    return 0;
+err:
+    server4_compound_write_cbk(frame, NULL, frame->this, state->resolve.op_ret,
+                               state->resolve.op_errno, NULL, NULL, NULL);
+    return 0;
+}
+
+static void
+server4_compound_lk_args(server_state_t *state, unsigned int cmd,
+                         unsigned int type, gf_proto_flock *flock,
+                         char *volume)
+{
+    switch (cmd) {
+        case GF_LK_GETLK:
+            state->cmd = F_GETLK;
+            break;
+        case GF_LK_SETLK:
+            state->cmd = F_SETLK;
+            break;
+        case GF_LK_SETLKW:
+            state->cmd = F_SETLKW;
+            break;
+    }
+
+    state->type = type;
+    state->volume = gf_strdup(volume);
+
+    gf_proto_flock_to_flock(flock, &state->flock);
+
+    switch (state->type) {
+        case GF_LK_F_RDLCK:
+            state->flock.l_type = F_RDLCK;
+            break;
+        case GF_LK_F_WRLCK:
+            state->flock.l_type = F_WRLCK;
+            break;
+        case GF_LK_F_UNLCK:
+            state->flock.l_type = F_UNLCK;
+            break;
+    }
+
+    free(volume);
+    free(flock->lk_owner.lk_owner_val);
+}
+
+/* Points the payload of the write of the compound at the data following the
+ * request. Returns -1 if its size is not the one of the write. */
+static int
+server4_compound_write_args(server_state_t *state, server_compound_t *compound)
+{
+    rpcsvc_request_t *req = compound->frame->local;
+    int i = 0;
+
+    state->iobref = iobref_ref(req->iobref);
+
+    if (compound->len < req->msg[0].iov_len) {
+        state->payload_vector[0].iov_base = (req->msg[0].iov_base +
+                                             compound->len);
+        state->payload_vector[0].iov_len = req->msg[0].iov_len -
+                                           compound->len;
+        state->payload_count = 1;
+    }
+
+    for (i = 1; i < req->count; i++) {
+        state->payload_vector[state->payload_count++] = req->msg[i];
+    }
+
+    if (iov_length(state->payload_vector, state->payload_count) !=
+        state->size)
+        return -1;
+
+    return 0;
+}
+
+/* Decodes the arguments of a fop of the compound into the state of @frame,
+ * returns the function resuming it. */
+static server_resume_fn_t
+server4_compound_fop_args(call_frame_t *frame, compound_req_v2 *item, int *ret)
+{
+    server_state_t *state = CALL_STATE(frame);
+    client_t *client = frame->root->client;
+    gfx_inodelk_req *inodelk = NULL;
+    gfx_finodelk_req *finodelk = NULL;
+    gfx_xattrop_req *xattrop = NULL;
+    gfx_fxattrop_req *fxattrop = NULL;
+    gfx_write_req *write = NULL;
+
+    switch (item->fop_enum) {
+        case GF_FOP_INODELK:
+            inodelk = &item->compound_req_v2_u.compound_inodelk_req;
+            state->resolve.type = RESOLVE_EXACT;
+            set_resolve_gfid(client, state->resolve.gfid, inodelk->gfid);
+            server4_compound_lk_args(state, inodelk->cmd, inodelk->type,
+                                     &inodelk->flock, inodelk->volume);
+            *ret = xdr_to_dict(&inodelk->xdata, &state->xdata);
+            return server4_compound_inodelk_resume;
+
+        case GF_FOP_FINODELK:
+            finodelk = &item->compound_req_v2_u.compound_finodelk_req;
+            state->resolve.type = RESOLVE_EXACT;
+            state->resolve.fd_no = finodelk->fd;
+            set_resolve_gfid(client, state->resolve.gfid, finodelk->gfid);
+            server4_compound_lk_args(state, finodelk->cmd, finodelk->type,
+                                     &finodelk->flock, finodelk->volume);
+            *ret = xdr_to_dict(&finodelk->xdata, &state->xdata);
+            return server4_compound_inodelk_resume;
+
+        case GF_FOP_XATTROP:
+            xattrop = &item->compound_req_v2_u.compound_xattrop_req;
+            state->resolve.type = RESOLVE_MUST;
+            state->flags = xattrop->flags;
+            set_resolve_gfid(client, state->resolve.gfid, xattrop->gfid);
+            *ret = xdr_to_dict(&xattrop->dict, &state->dict);
+            *ret |= xdr_to_dict(&xattrop->xdata, &state->xdata);
+            return server4_compound_xattrop_resume;
+
+        case GF_FOP_FXATTROP:
+            fxattrop = &item->compound_req_v2_u.compound_fxattrop_req;
+            state->resolve.type = RESOLVE_MUST;
+            state->resolve.fd_no = fxattrop->fd;
+            state->flags = fxattrop->flags;
+            set_resolve_gfid(client, state->resolve.gfid, fxattrop->gfid);
+            *ret = xdr_to_dict(&fxattrop->dict, &state->dict);
+            *ret |= xdr_to_dict(&fxattrop->xdata, &state->xdata);
+            return server4_compound_xattrop_resume;
+
+        case GF_FOP_WRITE:
+            write = &item->compound_req_v2_u.compound_write_req;
+            state->resolve.type = RESOLVE_MUST;
+            state->resolve.fd_no = write->fd;
+            state->offset = write->offset;
+            state->size = write->size;
+            state->flags = write->flag;
+            memcpy(state->resolve.gfid, write->gfid, 16);
+            *ret = server4_compound_write_args(state, frame->local);
+            *ret |= xdr_to_dict(&write->xdata, &state->xdata);
+            return server4_compound_write_resume;
+    }
+
+    /* the XDR decoding rejects any other fop */
+    *ret = -1;
+    return NULL;
+}
+
+static void
+server4_compound_reply(server_compound_t *compound)
+{
+    compound_rsp_v2 *item = NULL;
+    rpcsvc_request_t *req = NULL;
+    unsigned int i = 0;
+
+    req = compound->frame->local;
+    server_submit_reply(compound->frame, req, &compound->rsp, NULL, 0, NULL,
+                        (xdrproc_t)xdr_gfx_compound_rsp);
+
+    for (i = 0; i < compound->rsp.compound_rsp_array.compound_rsp_array_len;
+         i++) {
+        item = &compound->rsp.compound_rsp_array.compound_rsp_array_val[i];
+        if ((item->fop_enum == GF_FOP_XATTROP) ||
+            (item->fop_enum == GF_FOP_FXATTROP)) {
+            GF_FREE(item->compound_rsp_v2_u.compound_xattrop_rsp.dict.pairs
+                        .pairs_val);
+            GF_FREE(item->compound_rsp_v2_u.compound_xattrop_rsp.xdata.pairs
+                        .pairs_val);
+        } else if (item->fop_enum == GF_FOP_WRITE) {
+            GF_FREE(item->compound_rsp_v2_u.compound_write_rsp.xdata.pairs
+                        .pairs_val);
+        } else {
+            GF_FREE(item->compound_rsp_v2_u.compound_inodelk_rsp.xdata.pairs
+                        .pairs_val);
+        }
+    }
+
+    for (i = 0; i < compound->dict_count; i++)
+        dict_unref(compound->dicts[i]);
+
+    GF_FREE(compound->rsp.compound_rsp_array.compound_rsp_array_val);
+    free(compound->args.compound_req_array.compound_req_array_val);
+    GF_FREE(compound->dicts);
+    GF_FREE(compound);
+}
+
+static void
+server4_compound_fail(compound_rsp_v2 *item, int op_errno)
+{
+    gfx_common_rsp *lk_rsp = &item->compound_rsp_v2_u.compound_inodelk_rsp;
+    gfx_common_dict_rsp *xattrop_rsp =
+        &item->compound_rsp_v2_u.compound_xattrop_rsp;
+    gfx_common_2iatt_rsp *write_rsp =
+        &item->compound_rsp_v2_u.compound_write_rsp;
+
+    if ((item->fop_enum == GF_FOP_XATTROP) ||
+        (item->fop_enum == GF_FOP_FXATTROP)) {
+        xattrop_rsp->op_ret = -1;
+        xattrop_rsp->op_errno = gf_errno_to_error(op_errno);
+        dict_to_xdr(NULL, &xattrop_rsp->dict);
+        dict_to_xdr(NULL, &xattrop_rsp->xdata);
+    } else if (item->fop_enum == GF_FOP_WRITE) {
+        write_rsp->op_ret = -1;
+        write_rsp->op_errno = gf_errno_to_error(op_errno);
+        dict_to_xdr(NULL, &write_rsp->xdata);
+    } else {
+        lk_rsp->op_ret = -1;
+        lk_rsp->op_errno = gf_errno_to_error(op_errno);
+        dict_to_xdr(NULL, &lk_rsp->xdata);
+    }
+}
+
+/* Returns the error of the first fop of the compound which failed before the
+ * current one, 0 if all of them succeeded. */
+static int
+server4_compound_error(server_compound_t *compound)
+{
+    compound_rsp_v2 *item = NULL;
+    int op_ret = 0;
+    int op_errno = 0;
+    unsigned int i = 0;
+
+    for (i = 0; i + 1 < compound->next; i++) {
+        item = &compound->rsp.compound_rsp_array.compound_rsp_array_val[i];
+        switch (item->fop_enum) {
+            case GF_FOP_XATTROP:
+            case GF_FOP_FXATTROP:
+                op_ret = item->compound_rsp_v2_u.compound_xattrop_rsp.op_ret;
+                op_errno =
+                    item->compound_rsp_v2_u.compound_xattrop_rsp.op_errno;
+                break;
+            case GF_FOP_WRITE:
+                op_ret = item->compound_rsp_v2_u.compound_write_rsp.op_ret;
+                op_errno = item->compound_rsp_v2_u.compound_write_rsp.op_errno;
+                break;
+            default:
+                op_ret = item->compound_rsp_v2_u.compound_inodelk_rsp.op_ret;
+                op_errno =
+                    item->compound_rsp_v2_u.compound_inodelk_rsp.op_errno;
+                break;
+        }
+        if (op_ret < 0)
+            return op_errno ? gf_error_to_errno(op_errno) : EIO;
+    }
+
+    return 0;
+}
+
+/* Starts the next fop of the compound, returns once it is running. */
+static void
+server4_compound_next(server_compound_t *compound)
+{
+    call_frame_t *frame = NULL;
+    server_state_t *state = NULL;
+    compound_req_v2 *item = NULL;
+    server_resume_fn_t resume = NULL;
+    rpcsvc_request_t *req = NULL;
+    int op_errno = 0;
+    int ret = 0;
+
+    req = compound->frame->local;
+    item = &compound->args.compound_req_array
+                .compound_req_array_val[compound->next++];
+    server4_compound_current(compound)->fop_enum = item->fop_enum;
+
+    /* no data is written on a brick where the fops meant to go before it,
+     * e.g. the changelog of a transaction, did not succeed */
+    if (item->fop_enum == GF_FOP_WRITE) {
+        op_errno = server4_compound_error(compound);
+        if (op_errno) {
+            server4_compound_fail(server4_compound_current(compound),
+                                  op_errno);
+            GF_ATOMIC_DEC(compound->pending);
+            return;
+        }
+    }
+
+    frame = get_frame_from_request(req);
+    if (!frame) {
+        /* out of memory, fail the fop without running it */
+        server4_compound_fail(server4_compound_current(compound), ENOMEM);
+        GF_ATOMIC_DEC(compound->pending);
+        return;
+    }
+
+    frame->root->op = item->fop_enum;
+    frame->local = compound;
+    state = CALL_STATE(frame);
+
+    resume = server4_compound_fop_args(frame, item, &ret);
+    if (ret) {
+        state->resolve.op_ret = -1;
+        state->resolve.op_errno = EINVAL;
+        resume(frame, frame->root->client->bound_xl);
+        return;
+    }
+
+    resolve_and_resume(frame, resume);
+}
+
+/* Runs the fops of the compound from the one after the last one done, for as
+ * long as they complete before returning, and replies after the last one. */
+static void
+server4_compound_run(server_compound_t *compound)
+{
+    do {
+        if (compound->next ==
+            compound->rsp.compound_rsp_array.compound_rsp_array_len) {
+            server4_compound_reply(compound);
+            return;
+        }
+
+        GF_ATOMIC_INIT(compound->pending, 2);
+        server4_compound_next(compound);
+    } while (GF_ATOMIC_DEC(compound->pending) == 0);
+}
+
+static unsigned int
+server4_compound_writes(gfx_compound_req *args)
+{
+    unsigned int writes = 0;
+    unsigned int i = 0;
+
+    for (i = 0; i < args->compound_req_array.compound_req_array_len; i++)
+        if (args->compound_req_array.compound_req_array_val[i].fop_enum ==
+            GF_FOP_WRITE)
+            writes++;
+
+    return writes;
+}
+
+/* Frees the decoded arguments of the fops of a compound which are not run,
+ * with the array holding them. */
+static void
+server4_compound_args_free(gfx_compound_req *args)
+{
+    unsigned int i = 0;
+
+    for (i = 0; i < args->compound_req_array.compound_req_array_len; i++)
+        xdr_free((xdrproc_t)xdr_compound_req_v2,
+                 (char *)&args->compound_req_array.compound_req_array_val[i]);
+
+    free(args->compound_req_array.compound_req_array_val);
+    args->compound_req_array.compound_req_array_val = NULL;
+    args->compound_req_array.compound_req_array_len = 0;
+}
+
 int
 server4_0_compound(rpcsvc_request_t *req)
 {
+    server_state_t *state = NULL;
+    call_frame_t *frame = NULL;
+    server_compound_t *compound = NULL;
+    unsigned int length = 0;
     int ret = -1;
-    SERVER_REQ_SET_ERROR(req, ret);
+
+    if (!req)
+        return ret;
+
+    compound = GF_CALLOC(1, sizeof(*compound), gf_server_mt_compound_rsp_t);
+    if (!compound) {
+        SERVER_REQ_SET_ERROR(req, ret);
+        return ret;
+    }
+
+    ret = rpc_receive_common(req, &frame, &state, &compound->len,
+                             &compound->args, xdr_gfx_compound_req,
+                             GF_FOP_COMPOUND);
+    if (ret != 0) {
+        goto out;
+    }
+
+    if (xdr_to_dict(&compound->args.xdata, &state->xdata)) {
+        SERVER_REQ_SET_ERROR(req, ret);
+        goto out;
+    }
+
+    /* there is a single payload, for a single write */
+    length = compound->args.compound_req_array.compound_req_array_len;
+    if ((length > SERVER4_COMPOUND_MAX_FOPS) ||
+        (server4_compound_writes(&compound->args) > 1)) {
+        gf_smsg(THIS->name, GF_LOG_WARNING, EINVAL, PS_MSG_COMPOUND_INFO,
+                "frame=%" PRId64, frame->root->unique, "client=%s",
+                STACK_CLIENT_NAME(frame->root), "fops=%u", length, NULL);
+        /* reply without running any of them */
+        compound->rsp.op_ret = -1;
+        compound->rsp.op_errno = gf_errno_to_error(EINVAL);
+        server4_compound_args_free(&compound->args);
+        length = 0;
+    }
+
+    compound->rsp.compound_rsp_array.compound_rsp_array_val = GF_CALLOC(
+        length, sizeof(compound_rsp_v2), gf_server_mt_compound_rsp_t);
+    /* every fop replies with at most an xdata and a dict */
+    compound->dicts = GF_CALLOC(length * 2, sizeof(dict_t *),
+                                gf_server_mt_compound_rsp_t);
+    if ((length && !compound->rsp.compound_rsp_array.compound_rsp_array_val) ||
+        (length && !compound->dicts)) {
+        SERVER_REQ_SET_ERROR(req, ret);
+        goto out;
+    }
+
+    compound->rsp.compound_rsp_array.compound_rsp_array_len = length;
+    dict_to_xdr(NULL, &compound->rsp.xdata);
+    compound->frame = frame;
+
+    ret = 0;
+    server4_compound_run(compound);
+    return ret;
+out:
+    GF_FREE(compound->rsp.compound_rsp_array.compound_rsp_array_val);
+    GF_FREE(compound->dicts);
+    server4_compound_args_free(&compound->args);
+    GF_FREE(compound);
+
     return ret;
 }
 
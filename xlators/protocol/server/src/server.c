@@ -238,6 +238,10 @@ server_priv(xlator_t *this)
     };
     uint64_t total_read = 0;
     uint64_t total_write = 0;
+    uint64_t total_writes = 0;
+    uint64_t zerocopy_sends = 0;
+    uint64_t zerocopy_completions = 0;
+    uint64_t zerocopy_copied = 0;
     int32_t ret = -1;
 
     GF_VALIDATE_OR_GOTO("server", this, out);
@@ -257,6 +261,10 @@ server_priv(xlator_t *this)
         {
             total_read += xprt->total_bytes_read;
             total_write += xprt->total_bytes_write;
+            total_writes += xprt->total_writes;
+            zerocopy_sends += xprt->zerocopy_sends;
+            zerocopy_completions += xprt->zerocopy_completions;
+            zerocopy_copied += xprt->zerocopy_copied;
         }
     }
     pthread_mutex_unlock(&conf->mutex);
@@ -267,6 +275,23 @@ server_priv(xlator_t *this)
     gf_proc_dump_build_key(key, "server", "total-bytes-write");
     gf_proc_dump_write(key, "%" PRIu64, total_write);
 
+    gf_proc_dump_build_key(key, "server", "total-writes");
+    gf_proc_dump_write(key, "%" PRIu64, total_writes);
+
+    if (total_writes) {
+        gf_proc_dump_build_key(key, "server", "bytes-per-write");
+        gf_proc_dump_write(key, "%" PRIu64, total_write / total_writes);
+    }
+
+    gf_proc_dump_build_key(key, "server", "zerocopy-sends");
+    gf_proc_dump_write(key, "%" PRIu64, zerocopy_sends);
+
+    gf_proc_dump_build_key(key, "server", "zerocopy-completions");
+    gf_proc_dump_write(key, "%" PRIu64, zerocopy_completions);
+
+    gf_proc_dump_build_key(key, "server", "zerocopy-copied");
+    gf_proc_dump_write(key, "%" PRIu64, zerocopy_copied);
+
     rpcsvc_statedump(conf->rpc);
 
     ret = 0;